@@ -228,6 +228,10 @@ bool SPIInit(SPIDEV *pDev, const SPICFG *pCfgData)
 	pDev->DevIntrf.IntPrio = pCfgData->IntPrio;
 	pDev->DevIntrf.EvtCB = pCfgData->EvtCB;
     pDev->DevIntrf.Reset = CySPIReset;
+    pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+    pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.Busy = false;
 	pDev->DevIntrf.EnCnt = 1;
 	pDev->DevIntrf.MaxRetry = pCfgData->MaxRetry;
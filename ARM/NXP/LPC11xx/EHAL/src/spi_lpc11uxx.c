@@ -117,6 +117,10 @@ bool SPIInit(SPIDEV *pDev, const SPICFG *pCfgData)
 	pDev->DevIntrf.StartTx = LpcSSPStartTx;
 	pDev->DevIntrf.TxData = LpcSSPTxData;
 	pDev->DevIntrf.StopTx = LpcSSPStopTx;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.Busy = false;
 	pDev->DevIntrf.MaxRetry = 0;
 
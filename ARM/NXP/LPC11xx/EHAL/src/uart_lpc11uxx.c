@@ -335,6 +335,10 @@ bool UARTInit(UARTDEV *pDev, const UARTCFG *pCfg)
 	pDev->DevIntrf.StartTx = LpcUARTStartTx;
 	pDev->DevIntrf.TxData = LpcUARTTxData;
 	pDev->DevIntrf.StopTx = LpcUARTStopTx;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.Busy = false;
 	pDev->DevIntrf.MaxRetry = 0;
 	pDev->EvtCallback = pCfg->EvtCallback;
@@ -314,6 +314,10 @@ bool I2CInit(I2CDEV *pDev, const I2CCFG *pCfgData)
 	pDev->DevIntrf.TxData = LpcI2CTxData;
 	pDev->DevIntrf.StopTx = LpcI2CStopTx;
 	pDev->DevIntrf.Reset = NULL;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.IntPrio = pCfgData->IntPrio;
 	pDev->DevIntrf.EvtCB = pCfgData->EvtCB;
 	pDev->DevIntrf.Busy = false;
@@ -235,6 +235,10 @@ bool LpcUARTInit(UARTDEV *pDev, const UARTCFG *pCfg)
 	pDev->DevIntrf.StartTx = LpcUARTStartTx;
 	pDev->DevIntrf.TxData = LpcUARTTxData;
 	pDev->DevIntrf.StopTx = LpcUARTStopTx;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->EvtCallback = pCfg->EvtCallback;
 	pDev->DevIntrf.Busy = false;
 
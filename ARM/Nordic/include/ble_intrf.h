@@ -85,8 +85,6 @@ typedef struct __BleDeviceInterf {
     int			PacketSize;	//!< BLE packet size
     HCFIFO		hRxFifo;
     HCFIFO		hTxFifo;
-    uint8_t     TransBuff[BLEINTRF_TRANSBUFF_MAXLEN];  //
-    int         TransBuffLen;   //!< Data length
 } BLEINTRF;
 #pragma pack(pop)
 
@@ -336,6 +336,10 @@ bool I2CInit(I2CDEV *pDev, const I2CCFG *pCfgData)
 	pDev->DevIntrf.TxData = nRF51I2CTxData;
 	pDev->DevIntrf.StopTx = nRF51I2CStopTx;
 	pDev->DevIntrf.Reset = nRF51I2CReset;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.IntPrio = pCfgData->IntPrio;
 	pDev->DevIntrf.EvtCB = pCfgData->EvtCB;
 	pDev->DevIntrf.Busy = false;
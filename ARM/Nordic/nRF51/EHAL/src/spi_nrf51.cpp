@@ -343,6 +343,10 @@ bool SPIInit(SPIDEV *pDev, const SPICFG *pCfgData)
 	pDev->DevIntrf.TxData = nRF51SPITxData;
 	pDev->DevIntrf.StopTx = nRF51SPIStopTx;
 	pDev->DevIntrf.Reset = nRF51SPIReset;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.IntPrio = pCfgData->IntPrio;
 	pDev->DevIntrf.EvtCB = pCfgData->EvtCB;
 	pDev->DevIntrf.Busy = false;
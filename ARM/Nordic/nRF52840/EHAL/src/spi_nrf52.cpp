@@ -327,6 +327,10 @@ bool SPIInit(SPIDEV *pDev, const SPICFG *pCfgData)
 	pDev->DevIntrf.StartTx = nRF52SPIStartTx;
 	pDev->DevIntrf.TxData = nRF52SPITxData;
 	pDev->DevIntrf.StopTx = nRF52SPIStopTx;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.IntPrio = pCfgData->IntPrio;
 	pDev->DevIntrf.EvtCB = pCfgData->EvtCB;
 	pDev->DevIntrf.Busy = false;
@@ -147,13 +147,16 @@ int BleIntrfRxData(DEVINTRF *pDevIntrf, uint8_t *pBuff, int BuffLen)
 {
 	BLEINTRF *intrf = (BLEINTRF*)pDevIntrf->pDevData;
 	BLEINTRF_PKT *pkt;
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
 	int cnt = 0;
 
-	pkt = (BLEINTRF_PKT *)CFifoGet(intrf->hRxFifo);
-	if (pkt != NULL)
+	// Copy packet out before releasing it so it can't be overwritten while reading
+	if (CFifoPeek(intrf->hRxFifo, 1, span) > 0)
 	{
+		pkt = (BLEINTRF_PKT *)span[0].pBlk;
 	    cnt = min(BuffLen, pkt->Len);
 		memcpy(pBuff, pkt->Data, cnt);
+		CFifoRelease(intrf->hRxFifo, 1);
 	}
 
 	return cnt;
@@ -197,28 +200,20 @@ bool BleIntrfStartTx(DEVINTRF *pDevIntrf, int DevAddr)
 bool BleIntrfNotify(BLEINTRF *pIntrf)
 {
     BLEINTRF_PKT *pkt;
-    uint32_t res = NRF_SUCCESS;
+    CFIFOSPAN span[CFIFO_SPAN_MAX];
+    uint32_t res;
 
-    if (pIntrf->TransBuffLen > 0)
+    // Notify directly from FIFO memory.  Packet is only released once
+    // the stack accepted it, otherwise it stays in the FIFO for next retry
+    while (CFifoPeek(pIntrf->hTxFifo, 1, span) > 0)
     {
-        res = BleSrvcCharNotify(pIntrf->pBleSrv, pIntrf->TxCharIdx, pIntrf->TransBuff, pIntrf->TransBuffLen);
-    }
-    if (res != NRF_ERROR_RESOURCES)
-    {
-        pIntrf->TransBuffLen = 0;
-        do {
-            pkt = (BLEINTRF_PKT *)CFifoGet(pIntrf->hTxFifo);
-            if (pkt != NULL)
-            {
-                uint32_t res = BleSrvcCharNotify(pIntrf->pBleSrv, pIntrf->TxCharIdx, pkt->Data, pkt->Len);
-                if (res == NRF_ERROR_RESOURCES)
-                {
-                    memcpy(pIntrf->TransBuff, pkt->Data, pkt->Len);
-                    pIntrf->TransBuffLen = pkt->Len;
-                    break;
-                }
-            }
-        } while (pkt != NULL);
+        pkt = (BLEINTRF_PKT *)span[0].pBlk;
+        res = BleSrvcCharNotify(pIntrf->pBleSrv, pIntrf->TxCharIdx, pkt->Data, pkt->Len);
+        if (res == NRF_ERROR_RESOURCES)
+        {
+            break;
+        }
+        CFifoRelease(pIntrf->hTxFifo, 1);
     }
 
     return true;
@@ -243,14 +238,18 @@ int BleIntrfTxData(DEVINTRF *pDevIntrf, uint8_t *pData, int DataLen)
     int maxlen = intrf->hTxFifo->BlkSize - sizeof(pkt->Len);
 	int cnt = 0;
 
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
+
 	while (DataLen > 0)
 	{
-		pkt = (BLEINTRF_PKT *)CFifoPut(intrf->hTxFifo);
-		if (pkt == NULL)
+		// Packet is only visible to the consumer once it is complete
+		if (CFifoReserve(intrf->hTxFifo, 1, span) <= 0)
 			break;
+		pkt = (BLEINTRF_PKT *)span[0].pBlk;
         int l = min(DataLen, maxlen);
 		memcpy(pkt->Data, pData, l);
 		pkt->Len = l;
+		CFifoCommit(intrf->hTxFifo, 1);
 		DataLen -= l;
 		pData += l;
 		cnt += l;
@@ -306,13 +305,16 @@ void BleIntrfRxWrCB(BLESRVC *pBleSvc, uint8_t *pData, int Offset, int Len)
     BLEINTRF_PKT *pkt;
     //int maxlen = intrf->hTxFifo->BlkSize - sizeof(pkt->Len);
 
+    CFIFOSPAN span[CFIFO_SPAN_MAX];
+
 	while (Len > 0) {
-		pkt = (BLEINTRF_PKT *)CFifoPut(intrf->hRxFifo);
-		if (pkt == NULL)
+		if (CFifoReserve(intrf->hRxFifo, 1, span) <= 0)
 			break;
+		pkt = (BLEINTRF_PKT *)span[0].pBlk;
 		int l = min(intrf->PacketSize, Len);
 		memcpy(pkt->Data, pData, l);
 		pkt->Len = l;
+		CFifoCommit(intrf->hRxFifo, 1);
 		Len -= l;
 		pData += l;
 	}
@@ -368,10 +370,13 @@ bool BleIntrfInit(BLEINTRF *pBleIntrf, const BLEINTRF_CFG *pCfg)
 	pBleIntrf->DevIntrf.StartTx = BleIntrfStartTx;
 	pBleIntrf->DevIntrf.TxData = BleIntrfTxData;
 	pBleIntrf->DevIntrf.StopTx = BleIntrfStopTx;
+	pBleIntrf->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pBleIntrf->DevIntrf.pTrace = NULL;
+#endif
 	pBleIntrf->DevIntrf.Busy = false;
 	pBleIntrf->DevIntrf.MaxRetry = 0;
 	pBleIntrf->DevIntrf.EvtCB = pCfg->EvtCB;
-	pBleIntrf->TransBuffLen = 0;
 
 	return true;
 }
@@ -424,6 +424,10 @@ bool EsbIntrfInit(ESBINTRF *pEsbIntrf, const ESBINTRF_CFG *pCfg)
     pEsbIntrf->DevIntrf.StartTx = EsbIntrfStartTx;
     pEsbIntrf->DevIntrf.TxData = EsbIntrfTxData;
     pEsbIntrf->DevIntrf.StopTx = EsbIntrfStopTx;
+    pEsbIntrf->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+    pEsbIntrf->DevIntrf.pTrace = NULL;
+#endif
     pEsbIntrf->DevIntrf.Busy = false;
     pEsbIntrf->DevIntrf.MaxRetry = 0;
     pEsbIntrf->DevIntrf.EvtCB = pCfg->EvtCB;
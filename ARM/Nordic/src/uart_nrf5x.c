@@ -485,6 +485,10 @@ bool UARTInit(UARTDEV *pDev, const UARTCFG *pCfg)
 	pDev->DevIntrf.StartTx = nRFUARTStartTx;
 	pDev->DevIntrf.TxData = nRFUARTTxData;
 	pDev->DevIntrf.StopTx = nRFUARTStopTx;
+	pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+	pDev->DevIntrf.pTrace = NULL;
+#endif
 	pDev->DevIntrf.Busy = false;
 	pDev->DevIntrf.MaxRetry = UART_RETRY_MAX;
 
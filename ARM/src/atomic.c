@@ -52,6 +52,25 @@ int __atomic_fetch_sub_4(int *d, int val, int mem)
 
 	return *d;
 }
+
+bool __atomic_compare_exchange_4(int *d, int *pExp, int val, bool weak, int smem, int fmem)
+{
+	bool retval = false;
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	if (*d == *pExp)
+	{
+		*d = val;
+		retval = true;
+	}
+	else
+	{
+		*pExp = *d;
+	}
+	__set_PRIMASK(primask);
+
+	return retval;
+}
 /*
 uint32_t DisableInterrupt()
 {
@@ -0,0 +1,73 @@
+/**-------------------------------------------------------------------------
+@file	idelay.h
+
+@brief	Delay functions for Linux host build.
+
+Same interface as the ARM delay loop functions so that device drivers can be
+compiled and run on a workstation.  Delays use nanosleep.
+
+@author Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __IDELAY_H__
+#define __IDELAY_H__
+
+#include <stdint.h>
+#include <time.h>
+#include <errno.h>
+
+/** @addtogroup Utilities
+  * @{
+  */
+
+/**
+ * @brief	Nanosecond delay.
+ *
+ * @param	cnt : nanosecond count
+ */
+static inline void nsDelay(uint32_t cnt) {
+	struct timespec ts = { (time_t)(cnt / 1000000000UL), (long)(cnt % 1000000000UL) };
+
+	while (nanosleep(&ts, &ts) != 0 && errno == EINTR);
+}
+
+/**
+ * @brief	Microsecond delay.
+ *
+ * @param	cnt : microsecond delay count
+ */
+static inline void usDelay(uint32_t cnt) {
+	struct timespec ts = { (time_t)(cnt / 1000000UL), (long)(cnt % 1000000UL) * 1000L };
+
+	while (nanosleep(&ts, &ts) != 0 && errno == EINTR);
+}
+
+/** @} End of group Utilities */
+
+#endif	// __IDELAY_H__
+
@@ -0,0 +1,108 @@
+/**-------------------------------------------------------------------------
+@file	bench.h
+
+@brief	Benchmark helpers for host build
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+/// Benchmark function
+typedef void (*BENCHFCT)(void);
+
+/**
+ * @brief	Get monotonic time.
+ *
+ * @return	Time in seconds
+ */
+static inline double BenchTime(void) {
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief	Get cycle count.
+ *
+ * Falls back to nanoseconds on non x86 host.
+ *
+ * @return	Cycle count
+ */
+static inline uint64_t BenchCycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+/**
+ * @brief	Print throughput result line.
+ *
+ * @param	pName	: Name of measured item
+ * @param	NbBytes	: Number of bytes processed
+ * @param	Sec		: Elapsed time in seconds
+ */
+static inline void BenchReport(const char *pName, double NbBytes, double Sec) {
+	printf("  %-28s %10.1f MB/s\n", pName, NbBytes / Sec / (1024. * 1024.));
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void CFifoBench(void);
+void CrcBench(void);
+void ShaBench(void);
+void CodecBench(void);
+void BusBench(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BENCH_H__
@@ -0,0 +1,352 @@
+/**-------------------------------------------------------------------------
+@file	bus_bench.cpp
+
+@brief	Driver bus efficiency benchmark
+
+Runs EHAL drivers on the simulated device interface and reports bus
+transaction count, bytes on the bus and effective payload throughput based on
+simulated bus & device time.  Bus clocks are 8MHz SPI and 400KHz I2C.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sim_intrf.h"
+#include "diskio_flash.h"
+#include "sdcard.h"
+#include "sensors/tph_bme280.h"
+#include "bench.h"
+
+#define BUSBENCH_NBSECT			64
+#define BUSBENCH_FLASH_SIZE		(256 * 1024)
+#define BUSBENCH_SD_NBSECT		1024
+#define BUSBENCH_EEP_SIZE		4096
+#define BUSBENCH_EEP_PAGE		32
+#define BUSBENCH_NBSAMPLE		100
+#define BUSBENCH_CACHE_NBSECT	32
+#define BUSBENCH_FAT_SECT		64
+#define BUSBENCH_FILE_SECT		128
+#define BUSBENCH_FILE_NBSECT	512
+#define BUSBENCH_WORKNS			200000	// Application processing per sample set
+
+static uint8_t s_FlashMem[BUSBENCH_FLASH_SIZE];
+static uint8_t s_SDMem[BUSBENCH_SD_NBSECT * 512];
+static uint8_t s_EepMem[BUSBENCH_EEP_SIZE];
+static uint8_t s_Buff[BUSBENCH_NBSECT * 512];
+
+static const SIMINTRF_CFG s_SpiCfg = {
+	SIMINTRF_BUS_SPI, 8000000, 1000, 0, 5, 0
+};
+
+static const SIMINTRF_CFG s_I2cCfg = {
+	SIMINTRF_BUS_I2C, 400000, 2000, 0, 5, 0
+};
+
+// Report bus activity, simulated time & payload throughput
+static void BusReport(const char *pName, SimDevIntrf &Intrf, double NbBytes)
+{
+	const SIMINTRF_STATS &st = Intrf.Stats();
+	double sec = Intrf.Time() * 1e-9;
+
+	printf("  %-24s %6u xfers %7llu bytes %9.2f ms", pName, (unsigned)st.XferCnt,
+		   (unsigned long long)(st.TxBytes + st.RxBytes), sec * 1e3);
+	if (NbBytes > 0)
+	{
+		printf(" %8.1f KB/s", NbBytes / sec / 1024.);
+	}
+	printf("\n");
+}
+
+static void BusBenchFlash(void)
+{
+	SimDevIntrf spi;
+	SIMFLASH flash;
+	FlashDiskIO disk;
+	FLASHDISKIO_CFG cfg = { 0, BUSBENCH_FLASH_SIZE, 4096, 256, 3, NULL, NULL };
+
+	spi.Init(s_SpiCfg);
+	spi.Attach(0, SimFlashInit(&flash, s_FlashMem, BUSBENCH_FLASH_SIZE, 3));
+	disk.Init(cfg, &spi);
+
+	spi.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSECT; i++)
+	{
+		disk.SectWrite(i, &s_Buff[i * 512]);
+	}
+	BusReport("Flash SectWrite", spi, sizeof(s_Buff));
+
+	spi.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSECT; i++)
+	{
+		disk.SectRead(i, &s_Buff[i * 512]);
+	}
+	BusReport("Flash SectRead", spi, sizeof(s_Buff));
+}
+
+static void BusBenchSDCard(void)
+{
+	SimDevIntrf spi;
+	SIMSDCARD card;
+	SDCard sd;
+
+	spi.Init(s_SpiCfg);
+	spi.Attach(0, SimSDCardInit(&card, s_SDMem, BUSBENCH_SD_NBSECT));
+
+	spi.ResetStats();
+	sd.Init(&spi, (uint8_t*)NULL, 0);
+	BusReport("SD Init", spi, 0);
+
+	spi.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSECT; i++)
+	{
+		sd.SectWrite(i, &s_Buff[i * 512]);
+	}
+	BusReport("SD SectWrite", spi, sizeof(s_Buff));
+
+	spi.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSECT; i++)
+	{
+		sd.SectRead(i, &s_Buff[i * 512]);
+	}
+	BusReport("SD SectRead", spi, sizeof(s_Buff));
+}
+
+// File read as FatFS does it : one sector at a time with a FAT entry lookup
+// at each cluster.  File is contiguous, 8 sectors per cluster
+static void BusBenchFileRead(SDCard &Sd, SimDevIntrf &Intrf, const char *pName)
+{
+	uint32_t fat;
+
+	Intrf.ResetStats();
+	Sd.ResetCacheStats();
+	for (int i = 0; i < BUSBENCH_FILE_NBSECT; i++)
+	{
+		if ((i & 7) == 0)
+		{
+			Sd.Read((uint64_t)BUSBENCH_FAT_SECT * 512 + (i >> 3) * 4, (uint8_t*)&fat, 4);
+		}
+		Sd.Read((uint64_t)(BUSBENCH_FILE_SECT + i) * 512, &s_Buff[(i & (BUSBENCH_NBSECT - 1)) * 512], 512);
+	}
+	BusReport(pName, Intrf, BUSBENCH_FILE_NBSECT * 512.);
+
+	const DISKIO_CACHE_STATS &st = Sd.CacheStats();
+	printf("  %-24s %6u miss %7u read ahead %6u used\n", "", (unsigned)st.MissCnt,
+		   (unsigned)st.PrefetchCnt, (unsigned)st.PrefetchHitCnt);
+}
+
+static void BusBenchReadAhead(void)
+{
+	SimDevIntrf spi;
+	SIMSDCARD card;
+	SDCard sd;
+	static uint8_t cache[DISKIO_CACHE_MEMSIZE(BUSBENCH_CACHE_NBSECT)];
+
+	spi.Init(s_SpiCfg);
+	spi.Attach(0, SimSDCardInit(&card, s_SDMem, BUSBENCH_SD_NBSECT));
+	sd.Init(&spi, cache, sizeof(cache));
+
+	BusBenchFileRead(sd, spi, "SD file read");
+
+	sd.Reset();
+	sd.SetPrefetch(16);
+	BusBenchFileRead(sd, spi, "SD file read ahead 16");
+
+	sd.Reset();
+	sd.SetPrefetch(0);
+}
+
+static void BusBenchEeprom(void)
+{
+	SimDevIntrf i2c;
+	SIMEEPROM eep;
+	uint8_t ad[2];
+
+	i2c.Init(s_I2cCfg);
+	i2c.Attach(0x50, SimEepromInit(&eep, s_EepMem, BUSBENCH_EEP_SIZE, BUSBENCH_EEP_PAGE, 2, 5000000));
+
+	// Page writes, same as SeepWrite
+	i2c.ResetStats();
+	for (int addr = 0; addr < BUSBENCH_EEP_SIZE; addr += BUSBENCH_EEP_PAGE)
+	{
+		ad[0] = addr >> 8;
+		ad[1] = addr & 0xFF;
+		DeviceIntrfWrite(i2c, 0x50, ad, 2, &s_Buff[addr], BUSBENCH_EEP_PAGE);
+	}
+	BusReport("EEPROM page write", i2c, BUSBENCH_EEP_SIZE);
+
+	i2c.ResetStats();
+	ad[0] = ad[1] = 0;
+	DeviceIntrfRead(i2c, 0x50, ad, 2, s_Buff, BUSBENCH_EEP_SIZE);
+	BusReport("EEPROM sequential read", i2c, BUSBENCH_EEP_SIZE);
+}
+
+static void BusBenchBme280(void)
+{
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	TphBme280 tph;
+	TPHSENSOR_CFG cfg = {
+		BME280_I2C_DEV_ADDR0, SENSOR_OPMODE_SINGLE, 1000, 1, 1, 1, 0, NULL
+	};
+	TPHSENSOR_DATA data;
+
+	i2c.Init(s_I2cCfg);
+	i2c.Attach(BME280_I2C_DEV_ADDR0, SimBme280Init(&reg, false));
+
+	i2c.ResetStats();
+	tph.Init(cfg, &i2c, NULL);
+	BusReport("BME280 Init", i2c, 0);
+
+	i2c.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSAMPLE; i++)
+	{
+		tph.StartSampling();
+		tph.Read(data);
+	}
+	BusReport("BME280 sample", i2c, 0);
+	printf("  %-24s %6.0f samples/s max\n", "", BUSBENCH_NBSAMPLE / (i2c.Time() * 1e-9));
+}
+
+// Register file device for raw register access
+class BusBenchRegDev : public Device {
+public:
+	bool Enable() { return true; }
+	void Disable() {}
+	void Reset() {}
+	void Init(DeviceIntrf *pIntrf, int DevAddr) {
+		Interface(pIntrf);
+		DeviceAddess(DevAddr);
+	}
+};
+
+// BME680 sample register layout : status, press/temp/hum & gas ADC fetched
+// with a read each vs the burst read planner
+static void BusBenchRegRead(void)
+{
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	BusBenchRegDev dev;
+	uint8_t status, d[8], g[2];
+	DEVREG_READ req[3] = {
+		{ 0x1D, 1, &status, 0 },
+		{ 0x1F, 8, d, 0 },
+		{ 0x2A, 2, g, 0 },
+	};
+
+	i2c.Init(s_I2cCfg);
+	i2c.Attach(0x76, SimRegFileInit(&reg, 0xFF, 0));
+	dev.Init(&i2c, 0x76);
+
+	i2c.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSAMPLE; i++)
+	{
+		for (int j = 0; j < 3; j++)
+		{
+			uint8_t addr = req[j].Addr;
+			dev.Read(&addr, 1, req[j].pBuff, req[j].Len);
+		}
+	}
+	BusReport("3 reg reads x100", i2c, 0);
+
+	i2c.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSAMPLE; i++)
+	{
+		dev.ReadRegs(req, 3);
+	}
+	BusReport("ReadRegs planner x100", i2c, 0);
+}
+
+static void BusAsyncReport(const char *pName, uint64_t BusNs, uint64_t WallNs)
+{
+	printf("  %-24s %9.2f ms elapsed %5.1f%% bus utilization\n", pName, WallNs * 1e-6,
+		   100. * BusNs / WallNs);
+}
+
+// Flash, BME280 & MPU sharing one SPI bus.  Each sample set reads all three
+// then spends BUSBENCH_WORKNS processing.  Blocking reads serialize bus &
+// processing.  Queued reads let the bus run while the previous set is processed
+static void BusBenchAsync(void)
+{
+	SimDevIntrf spi;
+	SIMFLASH flash;
+	SIMREGFILE bme, mpu;
+	DEVINTRFQUE que;
+	DEVINTRF_XACT xact[3];
+	uint8_t flcmd[4] = { 3, 0, 0, 0 }, bmereg = 0xF7 | 0x80, mpureg = 0x3B;
+	uint8_t flbuf[128], bmebuf[8], mpubuf[14];
+
+	spi.Init(s_SpiCfg);
+	spi.Attach(0, SimFlashInit(&flash, s_FlashMem, BUSBENCH_FLASH_SIZE, 3));
+	spi.Attach(1, SimBme280Init(&bme, true));
+	spi.Attach(2, SimRegFileInit(&mpu, 0xFF, 0));
+
+	spi.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSAMPLE; i++)
+	{
+		DeviceIntrfRead(spi, 0, flcmd, 4, flbuf, sizeof(flbuf));
+		DeviceIntrfRead(spi, 1, &bmereg, 1, bmebuf, sizeof(bmebuf));
+		DeviceIntrfRead(spi, 2, &mpureg, 1, mpubuf, sizeof(mpubuf));
+	}
+	BusAsyncReport("3 devices blocking", spi.Stats().BusNs,
+				   spi.Stats().BusNs + (uint64_t)BUSBENCH_NBSAMPLE * BUSBENCH_WORKNS);
+
+	spi.QueInit(que);
+	spi.ResetStats();
+	for (int i = 0; i < BUSBENCH_NBSAMPLE; i++)
+	{
+		DevIntrfXactRead(&xact[0], 0, flcmd, 4, flbuf, sizeof(flbuf), NULL, NULL);
+		DevIntrfXactRead(&xact[1], 1, &bmereg, 1, bmebuf, sizeof(bmebuf), NULL, NULL);
+		DevIntrfXactRead(&xact[2], 2, &mpureg, 1, mpubuf, sizeof(mpubuf), NULL, NULL);
+		for (int j = 0; j < 3; j++)
+		{
+			DevIntrfQueSubmit(&que, &xact[j]);
+		}
+		spi.Run(BUSBENCH_WORKNS);
+		spi.RunIdle();
+	}
+	BusAsyncReport("3 devices queued", spi.Stats().BusNs, spi.Stats().WallNs);
+}
+
+void BusBench(void)
+{
+	for (int i = 0; i < (int)sizeof(s_Buff); i++)
+	{
+		s_Buff[i] = i;
+	}
+
+	BusBenchFlash();
+	BusBenchSDCard();
+	BusBenchReadAhead();
+	BusBenchEeprom();
+	BusBenchBme280();
+	BusBenchRegRead();
+	BusBenchAsync();
+}
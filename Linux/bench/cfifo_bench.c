@@ -0,0 +1,127 @@
+/**-------------------------------------------------------------------------
+@file	cfifo_bench.c
+
+@brief	CFIFO throughput benchmark
+
+Measures CFIFO transfer rate in MB/s on host.  Block at a time transfer
+using CFifoPut/CFifoGet, as done by drivers, is compared to the bulk
+CFifoWrite/CFifoRead path for byte (UART), 20 bytes (BLE packet) and
+512 bytes (disk sector) block sizes.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "cfifo.h"
+#include "bench.h"
+
+#define BENCH_FIFO_SIZE			(64 * 1024)
+#define BENCH_XFER_SIZE			4096
+#define BENCH_TOTAL_SIZE		(64LL * 1024LL * 1024LL)
+
+static uint8_t s_FifoMem[CFIFO_MEMSIZE(BENCH_FIFO_SIZE)];
+static uint8_t s_SrcBuff[BENCH_XFER_SIZE];
+static uint8_t s_DstBuff[BENCH_XFER_SIZE];
+
+// Block at a time transfer, the way drivers use CFifoPut/CFifoGet
+static double BenchBlock(HCFIFO hFifo, int XferLen)
+{
+	int nblk = XferLen / hFifo->BlkSize;
+	long long total = 0;
+	double t = BenchTime();
+
+	while (total < BENCH_TOTAL_SIZE)
+	{
+		for (int i = 0; i < nblk; i++)
+		{
+			uint8_t *p = CFifoPut(hFifo);
+			memcpy(p, &s_SrcBuff[i * hFifo->BlkSize], hFifo->BlkSize);
+		}
+		for (int i = 0; i < nblk; i++)
+		{
+			uint8_t *p = CFifoGet(hFifo);
+			memcpy(&s_DstBuff[i * hFifo->BlkSize], p, hFifo->BlkSize);
+		}
+		total += XferLen;
+	}
+
+	return BenchTime() - t;
+}
+
+// Bulk transfer
+static double BenchBulk(HCFIFO hFifo, int XferLen)
+{
+	long long total = 0;
+	double t = BenchTime();
+
+	while (total < BENCH_TOTAL_SIZE)
+	{
+		CFifoWrite(hFifo, s_SrcBuff, XferLen);
+		CFifoRead(hFifo, s_DstBuff, XferLen);
+		total += XferLen;
+	}
+
+	return BenchTime() - t;
+}
+
+void CFifoBench(void)
+{
+	static const int blksize[] = { 1, 20, 512 };
+	char name[40];
+
+	for (int i = 0; i < BENCH_XFER_SIZE; i++)
+	{
+		s_SrcBuff[i] = i;
+	}
+
+	for (int i = 0; i < sizeof(blksize) / sizeof(int); i++)
+	{
+		HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), blksize[i], true);
+		// Whole number of blocks, not aligned to FIFO size so that data wraps
+		int xferlen = (BENCH_XFER_SIZE / blksize[i]) * blksize[i];
+
+		sprintf(name, "Put/Get %d bytes blocks", blksize[i]);
+		BenchReport(name, BENCH_TOTAL_SIZE, BenchBlock(hfifo, xferlen));
+
+		CFifoFlush(hfifo);
+
+		double t = BenchBulk(hfifo, xferlen);
+
+		if (memcmp(s_SrcBuff, s_DstBuff, xferlen) != 0)
+		{
+			printf("  Data mismatch\n");
+		}
+
+		sprintf(name, "Write/Read %d bytes blocks", blksize[i]);
+		BenchReport(name, BENCH_TOTAL_SIZE, t);
+	}
+}
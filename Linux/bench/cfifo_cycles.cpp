@@ -0,0 +1,96 @@
+/**-------------------------------------------------------------------------
+@file	cfifo_cycles.cpp
+
+@brief	CFIFO index math benchmark
+
+Measures CPU cycles per CFifoPut + CFifoGet pair on host for :
+	- C API, arbitrary and power of 2 geometry (compare & wrap, multiply)
+	- CFifo<BlkSize, NbBlk> template (constant folded mask & shift)
+	- C API on the template memory
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+
+#include "cfifo.h"
+#include "bench.h"
+
+#define BENCH_LOOP			10000000
+
+static uint8_t s_FifoMem[CFIFO_TOTAL_MEMSIZE(100, 20)];
+static uint8_t s_Pow2FifoMem[CFIFO_TOTAL_MEMSIZE(128, 32)];
+static CFifo<32, 128> s_Fifo;
+
+static double BenchCFifo(HCFIFO hFifo)
+{
+	uint64_t t = BenchCycles();
+
+	for (int i = 0; i < BENCH_LOOP; i++)
+	{
+		uint8_t *p = CFifoPut(hFifo);
+		p[0] = (uint8_t)i;
+		p = CFifoGet(hFifo);
+		if (p[0] != (uint8_t)i)
+			return -1;
+	}
+
+	return (double)(BenchCycles() - t) / BENCH_LOOP;
+}
+
+template <uint32_t BlkSize, int32_t NbBlk>
+static double BenchTemplate(CFifo<BlkSize, NbBlk> &Fifo)
+{
+	uint64_t t = BenchCycles();
+
+	for (int i = 0; i < BENCH_LOOP; i++)
+	{
+		uint8_t *p = Fifo.Put();
+		p[0] = (uint8_t)i;
+		p = Fifo.Get();
+		if (p[0] != (uint8_t)i)
+			return -1;
+	}
+
+	return (double)(BenchCycles() - t) / BENCH_LOOP;
+}
+
+int main()
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 20, true);
+	HCFIFO hpow2 = CFifoInit(s_Pow2FifoMem, sizeof(s_Pow2FifoMem), 32, true);
+
+	printf("CFIFO Put + Get cost (cycles)\n");
+	printf("C API 100 x 20         : %6.2f\n", BenchCFifo(hfifo));
+	printf("C API 128 x 32         : %6.2f\n", BenchCFifo(hpow2));
+	printf("CFifo<32, 128>         : %6.2f\n", BenchTemplate(s_Fifo));
+	printf("C API on CFifo<32, 128>: %6.2f\n", BenchCFifo(s_Fifo));
+
+	return 0;
+}
@@ -0,0 +1,101 @@
+/**-------------------------------------------------------------------------
+@file	codec_bench.c
+
+@brief	Base64, UTF-8 & Intel Hex throughput benchmark
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <wchar.h>
+
+#include "base64.h"
+#include "utf8.h"
+#include "intelhex.h"
+#include "bench.h"
+
+#define BENCH_DATA_SIZE			3072
+#define BENCH_LOOP				4096
+
+static uint8_t s_Data[BENCH_DATA_SIZE];
+static char s_Text[BENCH_DATA_SIZE * 2];
+static wchar_t s_WText[BENCH_DATA_SIZE];
+
+void CodecBench(void)
+{
+	double t;
+	int srclen, dstlen;
+
+	for (int i = 0; i < BENCH_DATA_SIZE; i++)
+	{
+		s_Data[i] = i;
+	}
+
+	t = BenchTime();
+	for (int i = 0; i < BENCH_LOOP; i++)
+		Base64Encode(s_Data, BENCH_DATA_SIZE, s_Text, sizeof(s_Text));
+	BenchReport("Base64Encode", (double)BENCH_DATA_SIZE * BENCH_LOOP, BenchTime() - t);
+
+	// Mixed 1, 2 & 3 bytes UTF-8 sequences
+	int l = 0;
+	while (l < BENCH_DATA_SIZE - 6)
+	{
+		memcpy(&s_Text[l], "a\xc3\xa9\xe2\x82\xac", 6);
+		l += 6;
+	}
+
+	t = BenchTime();
+	for (int i = 0; i < BENCH_LOOP; i++)
+	{
+		srclen = l;
+		dstlen = BENCH_DATA_SIZE;
+		utf8towcs(s_Text, &srclen, s_WText, &dstlen);
+	}
+	BenchReport("utf8towcs", (double)l * BENCH_LOOP, BenchTime() - t);
+
+	int nwc = dstlen;
+
+	t = BenchTime();
+	for (int i = 0; i < BENCH_LOOP; i++)
+	{
+		srclen = nwc;
+		dstlen = sizeof(s_Text);
+		wcstoutf8(s_WText, &srclen, s_Text, &dstlen);
+	}
+	BenchReport("wcstoutf8", (double)dstlen * BENCH_LOOP, BenchTime() - t);
+
+	char rec[] = ":10010000214601360121470136007EFE09D2190140";
+	IHEXDATA hex;
+
+	t = BenchTime();
+	for (int i = 0; i < BENCH_LOOP * 64; i++)
+		IHexParseRecord(rec, &hex);
+	BenchReport("IHexParseRecord", (double)strlen(rec) * BENCH_LOOP * 64, BenchTime() - t);
+}
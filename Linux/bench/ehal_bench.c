@@ -0,0 +1,79 @@
+/**-------------------------------------------------------------------------
+@file	ehal_bench.c
+
+@brief	EHAL host benchmark runner
+
+Usage : ehal_bench [benchmark name]...
+
+Runs all benchmarks when no name is given.  Results are reported as
+throughput per component.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "bench.h"
+
+typedef struct {
+	const char *pName;
+	BENCHFCT Bench;
+} BENCHENTRY;
+
+static const BENCHENTRY s_BenchTbl[] = {
+	{ "cfifo", CFifoBench },
+	{ "crc", CrcBench },
+	{ "sha", ShaBench },
+	{ "codec", CodecBench },
+	{ "bus", BusBench },
+};
+
+static const int s_NbBench = sizeof(s_BenchTbl) / sizeof(BENCHENTRY);
+
+int main(int argc, char **argv)
+{
+	for (int i = 0; i < s_NbBench; i++)
+	{
+		bool run = argc < 2;
+
+		for (int j = 1; j < argc && run == false; j++)
+		{
+			run = strcmp(argv[j], s_BenchTbl[i].pName) == 0;
+		}
+
+		if (run)
+		{
+			printf("%s\n", s_BenchTbl[i].pName);
+			s_BenchTbl[i].Bench();
+		}
+	}
+
+	return 0;
+}
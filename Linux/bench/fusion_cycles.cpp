@@ -0,0 +1,142 @@
+/**-------------------------------------------------------------------------
+@file	fusion_cycles.cpp
+
+@brief	AGM sensor fusion benchmark
+
+Measures CPU cycles per filter update on host for Madgwick & Mahony, float
+and Q8.24 fixed point kernels, 6 axis (accel, gyro) and 9 axis (with mag).
+Host cycles only compare the kernels with each other, the fixed point kernel
+is meant for cores without FPU.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+
+#include "sensors/agm_fusion.h"
+#include "bench.h"
+
+#define BENCH_LOOP			1000000
+#define BENCH_NBSAMPLE		64
+
+static int16_t s_Accel[BENCH_NBSAMPLE][3];
+static int16_t s_Gyro[BENCH_NBSAMPLE][3];
+static int16_t s_Mag[BENCH_NBSAMPLE][3];
+
+// Slowly moving sensor so that the filters stay in the correction path
+static void BenchSamples()
+{
+	for (int i = 0; i < BENCH_NBSAMPLE; i++)
+	{
+		s_Accel[i][0] = 2000 + i * 10;
+		s_Accel[i][1] = -1500 + i * 5;
+		s_Accel[i][2] = 16000 - i * 3;
+		s_Gyro[i][0] = 20 - i;
+		s_Gyro[i][1] = i;
+		s_Gyro[i][2] = 100;
+		s_Mag[i][0] = 2500;
+		s_Mag[i][1] = -600 + i * 4;
+		s_Mag[i][2] = 3000;
+	}
+}
+
+static double BenchFloat(AGMFUSION_ALGO Algo, bool bMag, float &Res)
+{
+	AGMFUSION_CFG cfg = { Algo, 1000, 0.00106f, 0.1f, 0.005f };
+	AGMFUSIONF fus;
+
+	AgmFusionInitF(&fus, &cfg);
+
+	uint64_t t = BenchCycles();
+
+	for (int i = 0; i < BENCH_LOOP; i++)
+	{
+		int j = i & (BENCH_NBSAMPLE - 1);
+
+		AgmFusionUpdateF(&fus, s_Accel[j], s_Gyro[j], bMag ? s_Mag[j] : NULL);
+	}
+
+	t = BenchCycles() - t;
+
+	// Keep result alive
+	Res += fus.q[0];
+
+	return (double)t / BENCH_LOOP;
+}
+
+static double BenchFixed(AGMFUSION_ALGO Algo, bool bMag, float &Res)
+{
+	AGMFUSION_CFG cfg = { Algo, 1000, 0.00106f, 0.1f, 0.005f };
+	AGMFUSIONQ fus;
+
+	AgmFusionInitQ(&fus, &cfg);
+
+	uint64_t t = BenchCycles();
+
+	for (int i = 0; i < BENCH_LOOP; i++)
+	{
+		int j = i & (BENCH_NBSAMPLE - 1);
+
+		AgmFusionUpdateQ(&fus, s_Accel[j], s_Gyro[j], bMag ? s_Mag[j] : NULL);
+	}
+
+	t = BenchCycles() - t;
+
+	Res += fus.q[0];
+
+	return (double)t / BENCH_LOOP;
+}
+
+int main()
+{
+	static const struct {
+		const char *pName;
+		AGMFUSION_ALGO Algo;
+	} algo[] = {
+		{ "Madgwick", AGMFUSION_ALGO_MADGWICK },
+		{ "Mahony", AGMFUSION_ALGO_MAHONY },
+	};
+	float res = 0;
+
+	BenchSamples();
+
+	printf("Fusion update cost (cycles)        float    Q8.24\n");
+	for (int i = 0; i < 2; i++)
+	{
+		for (int mag = 0; mag < 2; mag++)
+		{
+			double f = BenchFloat(algo[i].Algo, mag, res);
+			double q = BenchFixed(algo[i].Algo, mag, res);
+
+			printf("%-8s %d axis                  : %8.1f %8.1f\n", algo[i].pName, mag ? 9 : 6, f, q);
+		}
+	}
+
+	return res == 0;
+}
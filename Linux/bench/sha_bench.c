@@ -0,0 +1,65 @@
+/**-------------------------------------------------------------------------
+@file	sha_bench.c
+
+@brief	SHA-1 & SHA-256 throughput benchmark
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "isha1.h"
+#include "isha256.h"
+#include "bench.h"
+
+#define BENCH_DATA_SIZE			4096
+#define BENCH_LOOP				2048
+
+static uint8_t s_Data[BENCH_DATA_SIZE];
+
+void ShaBench(void)
+{
+	char res[80];
+	double t;
+
+	for (int i = 0; i < BENCH_DATA_SIZE; i++)
+	{
+		s_Data[i] = i;
+	}
+
+	t = BenchTime();
+	for (int i = 0; i < BENCH_LOOP; i++)
+		Sha1(s_Data, BENCH_DATA_SIZE, i == BENCH_LOOP - 1, res);
+	BenchReport("Sha1", (double)BENCH_DATA_SIZE * BENCH_LOOP, BenchTime() - t);
+
+	t = BenchTime();
+	for (int i = 0; i < BENCH_LOOP; i++)
+		Sha256(s_Data, BENCH_DATA_SIZE, i == BENCH_LOOP - 1, res);
+	BenchReport("Sha256", (double)BENCH_DATA_SIZE * BENCH_LOOP, BenchTime() - t);
+}
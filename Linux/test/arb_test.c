@@ -0,0 +1,245 @@
+/**-------------------------------------------------------------------------
+@file	arb_test.c
+
+@brief	DEVINTRF bus arbiter unit tests
+
+Other threads are played by the wait hook, which advances a fake clock and
+acquires or releases the bus on behalf of other clients.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include "device_intrf_arb.h"
+#include "sim_intrf.h"
+#include "test.h"
+
+#define ARBTEST_TICK		10		// Clock advance per wait hook call
+
+static SIMINTRFDEV s_SimDev;
+static SIMREGFILE s_RegFile;
+static DEVINTRFARB s_Arb;
+static DEVINTRFARB_CLIENT s_Imu, s_Eep, s_Log;
+static uint32_t s_Now;
+static uint32_t s_ReleaseAt;		// Time the hook releases s_Eep, 0 for never
+static DEVINTRFARB_CLIENT *s_pGrant;// Client the hook serves once bus is free
+static DEVINTRFARB_CLIENT *s_pOrder[2];
+static int s_NbOrder;
+
+static const SIMINTRF_CFG s_I2cCfg = {
+	SIMINTRF_BUS_I2C, 400000, 2000, 0, 0, 0
+};
+
+static uint32_t ArbTestClock(void)
+{
+	return s_Now;
+}
+
+static void ArbTestYield(DEVINTRFARB *pArb)
+{
+	s_Now += ARBTEST_TICK;
+
+	if (s_ReleaseAt && s_Now >= s_ReleaseAt)
+	{
+		s_ReleaseAt = 0;
+		DevIntrfArbRelease(pArb, &s_Eep);
+	}
+
+	// Other client waiting thread getting the bus
+	if (s_pGrant && pArb->pOwner == NULL)
+	{
+		DEVINTRFARB_CLIENT *c = s_pGrant;
+
+		s_pGrant = NULL;
+		if (DevIntrfArbAcquire(pArb, c))
+		{
+			s_pOrder[s_NbOrder++] = c;
+			s_Now += 2 * ARBTEST_TICK;
+			DevIntrfArbRelease(pArb, c);
+		}
+	}
+}
+
+// Client thread getting in line at time Since
+static void ArbTestWaiting(DEVINTRFARB_CLIENT *pClient, uint32_t Since)
+{
+	uint32_t now = s_Now;
+
+	s_Now = Since;
+	DevIntrfArbRequest(&s_Arb, pClient);
+	s_Now = now;
+}
+
+static bool ArbTestReset(uint32_t Slice, uint32_t Aging)
+{
+	s_Now = 1000;
+	s_ReleaseAt = 0;
+	s_pGrant = NULL;
+	s_NbOrder = 0;
+
+	TEST_ASSERT(DevIntrfArbInit(&s_Arb, &s_SimDev.DevIntrf, ArbTestClock, ArbTestYield, Slice, Aging));
+	DevIntrfArbAddClient(&s_Arb, &s_Imu, 0, 100);
+	DevIntrfArbAddClient(&s_Arb, &s_Eep, 5, DEVINTRFARB_WAIT_FOREVER);
+	DevIntrfArbAddClient(&s_Arb, &s_Log, 5, 1000);
+
+	return true;
+}
+
+static bool ArbTestPriority(void)
+{
+	uint8_t reg = 0x10, d = 0x5A, rd = 0;
+
+	TEST_ASSERT(ArbTestReset(0, 0));
+
+	// Uncontended
+	TEST_ASSERT(DevIntrfArbWrite(&s_Arb, &s_Eep, 0x76, &reg, 1, &d, 1) == 1);
+	TEST_ASSERT(DevIntrfArbRead(&s_Arb, &s_Imu, 0x76, &reg, 1, &rd, 1) == 1 && rd == 0x5A);
+	TEST_ASSERT(s_Imu.Stats.AcqCnt == 1 && s_Imu.Stats.WaitTotal == 0);
+	TEST_ASSERT(s_Arb.pOwner == NULL);
+
+	// Bus held by EEPROM, released after 30 ticks.  Log waits longer but
+	// IMU has the better priority
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Eep));
+	ArbTestWaiting(&s_Log, s_Now - 500);
+	s_ReleaseAt = s_Now + 30;
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Imu));
+	TEST_ASSERT(s_Imu.Stats.WaitMax == 30);
+	DevIntrfArbRelease(&s_Arb, &s_Imu);
+	DevIntrfArbCancel(&s_Arb, &s_Log);
+
+	// Bounded wait
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Eep));
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Imu) == false);
+	TEST_ASSERT(s_Imu.Stats.TimeoutCnt == 1 && s_Imu.Stats.WaitMax == 100);
+	TEST_ASSERT(s_Imu.bWaiting == false);
+	DevIntrfArbRelease(&s_Arb, &s_Eep);
+	TEST_ASSERT(s_Eep.Stats.HoldMax == 100);
+
+	return true;
+}
+
+static bool ArbTestFairness(void)
+{
+	// Equal priority, longest waiting first
+	TEST_ASSERT(ArbTestReset(0, 0));
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Imu));
+	ArbTestWaiting(&s_Log, s_Now);
+	s_pGrant = &s_Log;
+	s_Now += 50;
+	DevIntrfArbRelease(&s_Arb, &s_Imu);
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Eep));
+	TEST_ASSERT(s_NbOrder == 1 && s_pOrder[0] == &s_Log);
+	TEST_ASSERT(s_Log.Stats.WaitMax == 60);
+	DevIntrfArbRelease(&s_Arb, &s_Eep);
+
+	// Aging, log waiting 60 ticks gains 6 levels and beats IMU
+	TEST_ASSERT(ArbTestReset(0, 10));
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Eep));
+	ArbTestWaiting(&s_Log, s_Now - 50);
+	s_pGrant = &s_Log;
+	s_ReleaseAt = s_Now + 10;
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Imu));
+	TEST_ASSERT(s_NbOrder == 1 && s_pOrder[0] == &s_Log);
+	DevIntrfArbRelease(&s_Arb, &s_Imu);
+
+	return true;
+}
+
+static bool ArbTestSlice(void)
+{
+	TEST_ASSERT(ArbTestReset(200, 0));
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Eep));
+
+	// Slice not expired
+	s_Now += 150;
+	ArbTestWaiting(&s_Imu, s_Now);
+	s_pGrant = &s_Imu;
+	TEST_ASSERT(DevIntrfArbSlice(&s_Arb, &s_Eep));
+	TEST_ASSERT(s_NbOrder == 0 && s_Eep.Stats.SliceCnt == 0);
+
+	// Expired, IMU gets the bus in between
+	s_Now += 50;
+	TEST_ASSERT(DevIntrfArbSlice(&s_Arb, &s_Eep));
+	TEST_ASSERT(s_Arb.pOwner == &s_Eep);
+	TEST_ASSERT(s_NbOrder == 1 && s_pOrder[0] == &s_Imu);
+	TEST_ASSERT(s_Eep.Stats.SliceCnt == 1 && s_Imu.Stats.WaitMax == 50 + ARBTEST_TICK);
+
+	// Expired, nobody waiting, slice restarts
+	s_Now += 300;
+	TEST_ASSERT(DevIntrfArbSlice(&s_Arb, &s_Eep));
+	TEST_ASSERT(s_Eep.Stats.SliceCnt == 1 && s_Arb.SliceStart == s_Now);
+	DevIntrfArbRelease(&s_Arb, &s_Eep);
+
+	return true;
+}
+
+static bool ArbTestStaleRequest(void)
+{
+	// Request never followed by acquire, expires after log max wait.  EEPROM
+	// has same priority and would otherwise wait behind it
+	TEST_ASSERT(ArbTestReset(200, 0));
+	s_Eep.MaxWait = 500;
+	DevIntrfArbRequest(&s_Arb, &s_Log);
+	s_Now += 1500;
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Eep));
+	TEST_ASSERT(s_Eep.Stats.WaitMax == 0);
+
+	// Expired request does not take the slice
+	s_Now += 300;
+	TEST_ASSERT(DevIntrfArbSlice(&s_Arb, &s_Eep));
+	TEST_ASSERT(s_Eep.Stats.SliceCnt == 0);
+	DevIntrfArbRelease(&s_Arb, &s_Eep);
+
+	// Acquire after expiry starts a new wait
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Log));
+	TEST_ASSERT(s_Log.Stats.WaitMax == 0);
+	DevIntrfArbRelease(&s_Arb, &s_Log);
+
+	// Cancelled request
+	DevIntrfArbRequest(&s_Arb, &s_Log);
+	DevIntrfArbCancel(&s_Arb, &s_Log);
+	TEST_ASSERT(DevIntrfArbAcquire(&s_Arb, &s_Eep));
+	TEST_ASSERT(s_NbOrder == 0);
+	DevIntrfArbRelease(&s_Arb, &s_Eep);
+
+	return true;
+}
+
+bool ArbTest(void)
+{
+	TEST_ASSERT(SimIntrfInit(&s_SimDev, &s_I2cCfg));
+	TEST_ASSERT(SimIntrfAttach(&s_SimDev, 0x76, SimRegFileInit(&s_RegFile, 0xFF, 0)));
+
+	return ArbTestPriority() && ArbTestFairness() && ArbTestSlice() &&
+		   ArbTestStaleRequest();
+}
@@ -0,0 +1,180 @@
+/**-------------------------------------------------------------------------
+@file	async_test.c
+
+@brief	DEVINTRF asynchronous transaction queue unit tests
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "device_intrf_async.h"
+#include "sim_intrf.h"
+#include "test.h"
+
+#define ASYNCTEST_NBXACT		4
+
+static SIMINTRFDEV s_SimDev;
+static SIMREGFILE s_RegFile[2];
+static DEVINTRFQUE s_Que;
+static DEVINTRF_XACT s_Xact[ASYNCTEST_NBXACT];
+static int s_DoneOrder[ASYNCTEST_NBXACT];
+static int s_NbDone;
+
+static const SIMINTRF_CFG s_SpiCfg = {
+	SIMINTRF_BUS_SPI, 8000000, 1000, 0, 0, 0
+};
+
+static void AsyncTestDone(DEVINTRF_XACT *pXact)
+{
+	s_DoneOrder[s_NbDone++] = (int)(pXact - s_Xact);
+}
+
+// Chains a read of what was just written
+static void AsyncTestChain(DEVINTRF_XACT *pXact)
+{
+	AsyncTestDone(pXact);
+	DevIntrfQueSubmit(&s_Que, &s_Xact[1]);
+}
+
+static bool AsyncTestBlocking(void)
+{
+	uint8_t reg = 0x20, d[4] = { 1, 2, 3, 4 }, rd[4] = { 0 };
+
+	TEST_ASSERT(DevIntrfQueInit(&s_Que, &s_SimDev.DevIntrf, NULL, NULL));
+
+	s_NbDone = 0;
+	DevIntrfXactWrite(&s_Xact[0], 0, &reg, 1, d, 4, AsyncTestChain, NULL);
+	DevIntrfXactRead(&s_Xact[1], 0, &reg, 1, rd, 4, AsyncTestDone, NULL);
+
+	// Chained transaction is run by the submitting loop before returning
+	TEST_ASSERT(DevIntrfQueSubmit(&s_Que, &s_Xact[0]));
+	TEST_ASSERT(DevIntrfQueIdle(&s_Que));
+	TEST_ASSERT(s_NbDone == 2 && s_DoneOrder[0] == 0 && s_DoneOrder[1] == 1);
+	TEST_ASSERT(s_Xact[0].Count == 4 && s_Xact[1].Count == 4);
+	TEST_ASSERT(memcmp(rd, d, 4) == 0);
+	TEST_ASSERT(s_Que.Stats.SubmitCnt == 2 && s_Que.Stats.DoneCnt == 2 && s_Que.Stats.MaxDepth == 1);
+
+	return true;
+}
+
+static bool AsyncTestCompletion(void)
+{
+	uint8_t reg[2] = { 0x20, 0x80 }, rd[3][4];
+	uint64_t t;
+
+	TEST_ASSERT(SimIntrfQueInit(&s_SimDev, &s_Que));
+	SimIntrfResetStats(&s_SimDev);
+
+	s_NbDone = 0;
+	DevIntrfXactRead(&s_Xact[0], 0, &reg[0], 1, rd[0], 4, AsyncTestDone, NULL);
+	DevIntrfXactRead(&s_Xact[1], 1, &reg[1], 1, rd[1], 4, AsyncTestDone, NULL);
+	DevIntrfXactRead(&s_Xact[2], 0, &reg[0], 1, rd[2], 2, AsyncTestDone, NULL);
+	DevIntrfXactRead(&s_Xact[3], 2, &reg[0], 1, rd[2], 2, AsyncTestDone, NULL);
+
+	// First starts right away, others queue behind it
+	for (int i = 0; i < ASYNCTEST_NBXACT; i++)
+	{
+		TEST_ASSERT(DevIntrfQueSubmit(&s_Que, &s_Xact[i]));
+	}
+	TEST_ASSERT(s_NbDone == 0 && DevIntrfQueIdle(&s_Que) == false);
+	TEST_ASSERT(s_Que.Stats.Depth == 4 && s_Que.Stats.MaxDepth == 4);
+
+	// 1000ns setup + 5 bytes at 1000ns
+	t = 1000 + 5 * 1000;
+	SimIntrfRun(&s_SimDev, t - 1);
+	TEST_ASSERT(s_NbDone == 0);
+	SimIntrfRun(&s_SimDev, 1);
+	TEST_ASSERT(s_NbDone == 1 && s_Xact[0].Count == 4);
+
+	SimIntrfRunIdle(&s_SimDev);
+	TEST_ASSERT(DevIntrfQueIdle(&s_Que));
+	TEST_ASSERT(s_NbDone == 4);
+	for (int i = 0; i < ASYNCTEST_NBXACT; i++)
+	{
+		TEST_ASSERT(s_DoneOrder[i] == i);
+	}
+	TEST_ASSERT(memcmp(rd[0], &s_RegFile[0].Reg[0x20], 4) == 0);
+	TEST_ASSERT(memcmp(rd[1], &s_RegFile[1].Reg[0x80], 4) == 0);
+
+	// Absent device
+	TEST_ASSERT(s_Xact[3].Count == 0 && s_Que.Stats.FailCnt == 1);
+
+	// Back to back, bus never idle
+	TEST_ASSERT(s_SimDev.Stats.WallNs == s_SimDev.Stats.BusNs);
+	SimIntrfRun(&s_SimDev, 1000);
+	TEST_ASSERT(s_SimDev.Stats.WallNs == s_SimDev.Stats.BusNs + 1000);
+
+	return true;
+}
+
+static bool AsyncTestCancel(void)
+{
+	uint8_t reg = 0x20, rd[3][4];
+
+	TEST_ASSERT(SimIntrfQueInit(&s_SimDev, &s_Que));
+
+	s_NbDone = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		DevIntrfXactRead(&s_Xact[i], 0, &reg, 1, rd[i], 4, AsyncTestDone, NULL);
+		TEST_ASSERT(DevIntrfQueSubmit(&s_Que, &s_Xact[i]));
+	}
+
+	// Queued one is removed
+	TEST_ASSERT(DevIntrfQueCancel(&s_Que, &s_Xact[1]));
+	TEST_ASSERT(s_NbDone == 1 && s_DoneOrder[0] == 1 && s_Xact[1].Count == 0);
+	TEST_ASSERT(DevIntrfQueCancel(&s_Que, &s_Xact[1]) == false);
+
+	// In progress one completes normally
+	TEST_ASSERT(DevIntrfQueCancel(&s_Que, &s_Xact[0]) == false);
+	TEST_ASSERT(s_NbDone == 1);
+
+	SimIntrfRunIdle(&s_SimDev);
+	TEST_ASSERT(DevIntrfQueIdle(&s_Que));
+	TEST_ASSERT(s_NbDone == 3 && s_DoneOrder[1] == 0 && s_DoneOrder[2] == 2);
+	TEST_ASSERT(s_Xact[0].Count == 4 && s_Xact[2].Count == 4);
+	TEST_ASSERT(s_Que.Stats.DoneCnt == 3 && s_Que.Stats.FailCnt == 1 && s_Que.Stats.Depth == 0);
+
+	return true;
+}
+
+bool AsyncTest(void)
+{
+	TEST_ASSERT(SimIntrfInit(&s_SimDev, &s_SpiCfg));
+	TEST_ASSERT(SimIntrfAttach(&s_SimDev, 0, SimRegFileInit(&s_RegFile[0], 0xFF, 0)));
+	TEST_ASSERT(SimIntrfAttach(&s_SimDev, 1, SimRegFileInit(&s_RegFile[1], 0xFF, 0)));
+
+	for (int i = 0; i < 256; i++)
+	{
+		s_RegFile[1].Reg[i] = ~i;
+	}
+
+	return AsyncTestBlocking() && AsyncTestCompletion() && AsyncTestCancel();
+}
@@ -0,0 +1,60 @@
+/**-------------------------------------------------------------------------
+@file	base64_test.c
+
+@brief	Base64 unit tests
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "base64.h"
+#include "test.h"
+
+bool Base64Test(void)
+{
+	// RFC 4648 test vectors
+	static const char *s_Plain[] = { "f", "fo", "foo", "foob", "fooba", "foobar" };
+	static const char *s_Encoded[] = { "Zg==", "Zm8=", "Zm9v", "Zm9vYg==", "Zm9vYmE=", "Zm9vYmFy" };
+	char res[16];
+
+	for (int i = 0; i < 6; i++)
+	{
+		int l = Base64Encode((uint8_t *)s_Plain[i], strlen(s_Plain[i]), res, sizeof(res));
+
+		TEST_ASSERT(l == (int)strlen(s_Encoded[i]));
+		TEST_ASSERT(strcmp(res, s_Encoded[i]) == 0);
+	}
+
+	uint8_t bin[] = { 0xfb, 0xff, 0xbf };
+	TEST_ASSERT(Base64Encode(bin, 3, res, sizeof(res)) == 4 && strcmp(res, "+/+/") == 0);
+
+	return true;
+}
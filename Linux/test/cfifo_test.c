@@ -0,0 +1,389 @@
+/**-------------------------------------------------------------------------
+@file	cfifo_test.c
+
+@brief	CFIFO unit tests
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "cfifo.h"
+#include "test.h"
+
+static uint8_t s_FifoMem[CFIFO_TOTAL_MEMSIZE(8, 4)];
+static uint8_t s_MpscMem[CFIFO_MPSC_TOTAL_MEMSIZE(4, 4)];
+
+static bool CFifoTestBlocking(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, true);
+
+	TEST_ASSERT(hfifo != NULL);
+	TEST_ASSERT(hfifo->MaxIdxCnt == 8);
+	TEST_ASSERT(CFifoUsed(hfifo) == 0 && CFifoAvail(hfifo) == 8);
+	TEST_ASSERT(CFifoGet(hfifo) == NULL);
+
+	for (int i = 0; i < 8; i++)
+	{
+		uint8_t *p = CFifoPut(hfifo);
+		TEST_ASSERT(p != NULL);
+		memset(p, i, 4);
+	}
+
+	TEST_ASSERT(CFifoPut(hfifo) == NULL);
+	TEST_ASSERT(CFifoUsed(hfifo) == 8 && CFifoAvail(hfifo) == 0);
+
+	for (int i = 0; i < 8; i++)
+	{
+		uint8_t *p = CFifoGet(hfifo);
+		TEST_ASSERT(p != NULL && p[0] == i && p[3] == i);
+	}
+
+	TEST_ASSERT(CFifoGet(hfifo) == NULL);
+
+	return true;
+}
+
+static bool CFifoTestDrop(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, false);
+
+	for (int i = 0; i < 11; i++)
+	{
+		uint8_t *p = CFifoPut(hfifo);
+		TEST_ASSERT(p != NULL);
+		p[0] = i;
+	}
+
+	TEST_ASSERT(CFifoUsed(hfifo) == 8);
+	TEST_ASSERT(hfifo->DropCnt == 3);
+
+	// Oldest blocks were pushed out
+	uint8_t *p = CFifoGet(hfifo);
+	TEST_ASSERT(p != NULL && p[0] == 3);
+
+	CFifoFlush(hfifo);
+	TEST_ASSERT(CFifoUsed(hfifo) == 0);
+
+	return true;
+}
+
+static bool CFifoTestDropPeek(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, false);
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
+
+	for (int i = 0; i < 9; i++)
+	{
+		uint8_t *p = CFifoPut(hfifo);
+		TEST_ASSERT(p != NULL);
+		p[0] = i;
+	}
+
+	// Holds 1..8, peek at 1
+	TEST_ASSERT(CFifoPeek(hfifo, 1, span) == 1);
+	TEST_ASSERT(span[0].pBlk[0] == 1);
+
+	// Producer pushes out the peeked block
+	uint8_t *p = CFifoPut(hfifo);
+	TEST_ASSERT(p != NULL);
+	p[0] = 9;
+	TEST_ASSERT(hfifo->DropCnt == 2);
+
+	// Already dropped, nothing more must be removed
+	CFifoRelease(hfifo, 1);
+	TEST_ASSERT(CFifoUsed(hfifo) == 8);
+
+	// Peek 2..4, producer drops 2 only
+	TEST_ASSERT(CFifoPeek(hfifo, 3, span) == 3);
+	p = CFifoPut(hfifo);
+	TEST_ASSERT(p != NULL);
+	p[0] = 10;
+
+	CFifoRelease(hfifo, 3);
+	TEST_ASSERT(CFifoUsed(hfifo) == 6);
+
+	for (int i = 5; i <= 10; i++)
+	{
+		p = CFifoGet(hfifo);
+		TEST_ASSERT(p != NULL && p[0] == i);
+	}
+	TEST_ASSERT(CFifoUsed(hfifo) == 0);
+
+	return true;
+}
+
+static bool CFifoTestMultiple(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, true);
+	int cnt = 5;
+
+	// Move indices close to the end so that data wraps
+	uint8_t *p = CFifoPutMultiple(hfifo, &cnt);
+	TEST_ASSERT(p != NULL && cnt == 5);
+	p = CFifoGetMultiple(hfifo, &cnt);
+	TEST_ASSERT(p != NULL && cnt == 5);
+
+	// Only consecutive blocks are returned
+	cnt = 6;
+	p = CFifoPutMultiple(hfifo, &cnt);
+	TEST_ASSERT(p != NULL && cnt == 3);
+	cnt = 6;
+	p = CFifoPutMultiple(hfifo, &cnt);
+	TEST_ASSERT(p == hfifo->pMemStart && cnt == 5);
+	TEST_ASSERT(CFifoAvail(hfifo) == 0);
+
+	cnt = 8;
+	p = CFifoGetMultiple(hfifo, &cnt);
+	TEST_ASSERT(cnt == 3);
+	cnt = 8;
+	p = CFifoGetMultiple(hfifo, &cnt);
+	TEST_ASSERT(p == hfifo->pMemStart && cnt == 5);
+
+	return true;
+}
+
+static bool CFifoTestSpan(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, true);
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
+
+	TEST_ASSERT(CFifoReserve(hfifo, 6, span) == 6);
+	TEST_ASSERT(span[0].Cnt == 6 && span[1].Cnt == 0);
+
+	// Nothing visible before commit
+	TEST_ASSERT(CFifoPeek(hfifo, 8, span) == 0);
+	CFifoCommit(hfifo, 6);
+	TEST_ASSERT(CFifoPeek(hfifo, 8, span) == 6);
+	CFifoRelease(hfifo, 6);
+
+	// Reservation wrapping around the end
+	TEST_ASSERT(CFifoReserve(hfifo, 5, span) == 5);
+	TEST_ASSERT(span[0].Cnt == 2 && span[1].Cnt == 3 && span[1].pBlk == hfifo->pMemStart);
+	CFifoCommit(hfifo, 5);
+
+	TEST_ASSERT(CFifoPeek(hfifo, 4, span) == 4);
+	TEST_ASSERT(span[0].Cnt == 2 && span[1].Cnt == 2);
+	CFifoRelease(hfifo, 4);
+	TEST_ASSERT(CFifoUsed(hfifo) == 1);
+
+	return true;
+}
+
+static bool CFifoTestReadWrite(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, true);
+	uint8_t src[32], dst[40];
+
+	for (int i = 0; i < 32; i++)
+	{
+		src[i] = i;
+	}
+
+	// Partial last block
+	TEST_ASSERT(CFifoWrite(hfifo, src, 10) == 10);
+	TEST_ASSERT(CFifoUsed(hfifo) == 3);
+
+	// Whole blocks only, nothing discarded
+	memset(dst, 0xff, sizeof(dst));
+	TEST_ASSERT(CFifoRead(hfifo, dst, 10) == 8);
+	TEST_ASSERT(memcmp(src, dst, 8) == 0 && dst[8] == 0xff);
+	TEST_ASSERT(CFifoUsed(hfifo) == 1);
+	TEST_ASSERT(CFifoRead(hfifo, dst, 3) == 0);
+	TEST_ASSERT(CFifoRead(hfifo, &dst[8], 4) == 4);
+	TEST_ASSERT(memcmp(src, dst, 10) == 0);
+	TEST_ASSERT(CFifoUsed(hfifo) == 0);
+
+	// Wrap around, limited by FIFO size
+	TEST_ASSERT(CFifoWrite(hfifo, src, 32) == 32);
+	TEST_ASSERT(CFifoWrite(hfifo, src, 4) == 0);
+	TEST_ASSERT(CFifoRead(hfifo, dst, 40) == 32);
+	TEST_ASSERT(memcmp(src, dst, 32) == 0);
+
+	return true;
+}
+
+static bool CFifoTestMpsc(void)
+{
+	HCFIFO hfifo = CFifoInitMpsc(s_MpscMem, sizeof(s_MpscMem), 4);
+
+	TEST_ASSERT(hfifo != NULL && hfifo->MaxIdxCnt == 4);
+
+	// Single producer calls are not allowed
+	TEST_ASSERT(CFifoPut(hfifo) == NULL);
+
+	uint8_t *p1 = CFifoClaim(hfifo);
+	uint8_t *p2 = CFifoClaim(hfifo);
+	TEST_ASSERT(p1 != NULL && p2 != NULL && p1 != p2);
+
+	// Published out of order, consumer waits for first claim
+	p2[0] = 2;
+	CFifoPublish(hfifo, p2);
+	TEST_ASSERT(CFifoGet(hfifo) == NULL);
+
+	p1[0] = 1;
+	CFifoPublish(hfifo, p1);
+
+	uint8_t *p = CFifoGet(hfifo);
+	TEST_ASSERT(p != NULL && p[0] == 1);
+	p = CFifoGet(hfifo);
+	TEST_ASSERT(p != NULL && p[0] == 2);
+	TEST_ASSERT(CFifoGet(hfifo) == NULL);
+
+	// Fill up with laps
+	uint8_t src[16] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 }, dst[16];
+
+	for (int i = 0; i < 3; i++)
+	{
+		TEST_ASSERT(CFifoWrite(hfifo, src, 16) == 16);
+		TEST_ASSERT(CFifoClaim(hfifo) == NULL);
+		TEST_ASSERT(CFifoRead(hfifo, dst, 16) == 16);
+		TEST_ASSERT(memcmp(src, dst, 16) == 0);
+	}
+
+	return true;
+}
+
+#ifdef CFIFO_STATS
+static uint32_t s_StatsClock;
+
+static uint32_t CFifoTestClock(void)
+{
+	return s_StatsClock;
+}
+
+static bool CFifoTestStatsBlocking(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, true);
+	CFIFOSTATS stats;
+	uint32_t ts[8];
+
+	CFifoStatsInit(hfifo, &stats, ts, CFifoTestClock);
+	s_StatsClock = 100;
+
+	for (int i = 0; i < 8; i++)
+	{
+		TEST_ASSERT(CFifoPut(hfifo) != NULL);
+	}
+	TEST_ASSERT(CFifoPut(hfifo) == NULL);
+
+	// First block waits 5 ticks, the others 0
+	s_StatsClock += 5;
+	TEST_ASSERT(CFifoGet(hfifo) != NULL);
+	s_StatsClock -= 5;
+	while (CFifoGet(hfifo) != NULL);
+
+	CFIFOSTATS res;
+	TEST_ASSERT(CFifoGetStats(hfifo, &res));
+	TEST_ASSERT(res.PutCnt == 8 && res.GetCnt == 8);
+	TEST_ASSERT(res.FullCnt == 1 && res.DropCnt == 0);
+	TEST_ASSERT(res.HighWater == 8);
+	TEST_ASSERT(res.DwellHist[3] == 1 && res.DwellHist[0] == 7);
+
+	// Disabled statistics are not updated
+	CFifoStatsInit(hfifo, NULL, NULL, NULL);
+	TEST_ASSERT(CFifoPut(hfifo) != NULL);
+	TEST_ASSERT(CFifoGetStats(hfifo, &res) == false);
+	TEST_ASSERT(stats.PutCnt == 8);
+
+	return true;
+}
+
+static bool CFifoTestStatsDrop(void)
+{
+	HCFIFO hfifo = CFifoInit(s_FifoMem, sizeof(s_FifoMem), 4, false);
+	CFIFOSTATS stats, res;
+
+	CFifoStatsInit(hfifo, &stats, NULL, NULL);
+
+	for (int i = 0; i < 11; i++)
+	{
+		TEST_ASSERT(CFifoPut(hfifo) != NULL);
+	}
+
+	TEST_ASSERT(CFifoGetStats(hfifo, &res));
+	TEST_ASSERT(res.PutCnt == 11 && res.DropCnt == 3 && res.FullCnt == 0);
+	TEST_ASSERT(res.HighWater == 8);
+
+	return true;
+}
+
+static bool CFifoTestStatsMpsc(void)
+{
+	HCFIFO hfifo = CFifoInitMpsc(s_MpscMem, sizeof(s_MpscMem), 4);
+	CFIFOSTATS stats, res;
+	uint32_t ts[4];
+
+	CFifoStatsInit(hfifo, &stats, ts, CFifoTestClock);
+
+	// Laps move the free running index past the slot number
+	for (int lap = 0; lap < 3; lap++)
+	{
+		uint8_t *p[4];
+
+		for (int i = 0; i < 4; i++)
+		{
+			p[i] = CFifoClaim(hfifo);
+			TEST_ASSERT(p[i] != NULL);
+		}
+		TEST_ASSERT(CFifoClaim(hfifo) == NULL);
+
+		for (int i = 0; i < 4; i++)
+		{
+			CFifoPublish(hfifo, p[i]);
+		}
+
+		TEST_ASSERT(CFifoGetStats(hfifo, &res));
+		TEST_ASSERT(res.HighWater == 4);
+
+		// Drain before next lap
+		while (CFifoGet(hfifo) != NULL);
+	}
+
+	TEST_ASSERT(CFifoGetStats(hfifo, &res));
+	TEST_ASSERT(res.PutCnt == 12 && res.GetCnt == 12 && res.FullCnt == 3);
+	TEST_ASSERT(res.HighWater == 4);
+	TEST_ASSERT(res.DwellHist[0] == 12);
+
+	return true;
+}
+
+bool CFifoStatsTest(void)
+{
+	return CFifoTest() && CFifoTestStatsBlocking() && CFifoTestStatsDrop() &&
+		   CFifoTestStatsMpsc();
+}
+#endif // CFIFO_STATS
+
+bool CFifoTest(void)
+{
+	return CFifoTestBlocking() && CFifoTestDrop() && CFifoTestDropPeek() &&
+		   CFifoTestMultiple() && CFifoTestSpan() && CFifoTestReadWrite() && CFifoTestMpsc();
+}
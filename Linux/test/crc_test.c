@@ -0,0 +1,67 @@
+/**-------------------------------------------------------------------------
+@file	crc_test.c
+
+@brief	CRC unit tests
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "crc.h"
+#include "test.h"
+
+bool CrcTest(void)
+{
+	uint8_t data[] = "123456789";
+	uint8_t buf[1000];
+
+	// Standard check values
+	TEST_ASSERT(crc16_ccitt(data, 9, 0xFFFF) == 0x29B1);	// CRC-16/CCITT-FALSE
+	TEST_ASSERT(crc16_ccitt(data, 9, 0) == 0x31C3);			// CRC-16/XMODEM
+	TEST_ASSERT(crc16_ansi(data, 9, 0) == 0xFEE8);			// CRC-16/BUYPASS
+	TEST_ASSERT(crc8_ccitt(data, 9, 0) == 0xEA);			// CRC-7/MMC << 1
+
+	// Incremental calculation
+	TEST_ASSERT(crc16_ccitt(&data[4], 5, crc16_ccitt(data, 4, 0xFFFF)) == 0x29B1);
+
+	// Length longer than 255 bytes
+	for (int i = 0; i < (int)sizeof(buf); i++)
+	{
+		buf[i] = i;
+	}
+	uint8_t crc = 0;
+	for (int i = 0; i < (int)sizeof(buf); i += 100)
+	{
+		crc = crc8_ccitt(&buf[i], 100, crc);
+	}
+	TEST_ASSERT(crc8_ccitt(buf, sizeof(buf), 0) == crc);
+
+	return true;
+}
@@ -0,0 +1,112 @@
+/**-------------------------------------------------------------------------
+@file	ehal_test.c
+
+@brief	EHAL host unit test runner
+
+Usage : ehal_test [suite name]...
+
+Runs all test suites when no name is given.  Returns non zero if any suite
+fails.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "test.h"
+
+typedef struct {
+	const char *pName;
+	TESTSUITE Suite;
+} TESTENTRY;
+
+static const TESTENTRY s_TestTbl[] = {
+	{ "cfifo", CFifoTest },
+	{ "crc", CrcTest },
+	{ "sha", ShaTest },
+	{ "base64", Base64Test },
+	{ "utf8", Utf8Test },
+	{ "intelhex", IHexTest },
+	{ "sim", SimIntrfTest },
+	{ "trace", TraceTest },
+	{ "async", AsyncTest },
+	{ "arb", ArbTest },
+	{ "fusion", FusionTest },
+};
+
+static const int s_NbTest = sizeof(s_TestTbl) / sizeof(TESTENTRY);
+
+static bool RunTest(const TESTENTRY *pTest)
+{
+	bool res = pTest->Suite();
+
+	printf("%-12s %s\n", pTest->pName, res ? "PASS" : "FAIL");
+
+	return res;
+}
+
+int main(int argc, char **argv)
+{
+	int nfail = 0;
+
+	if (argc < 2)
+	{
+		for (int i = 0; i < s_NbTest; i++)
+		{
+			if (RunTest(&s_TestTbl[i]) == false)
+				nfail++;
+		}
+
+		return nfail;
+	}
+
+	for (int j = 1; j < argc; j++)
+	{
+		int i;
+
+		for (i = 0; i < s_NbTest; i++)
+		{
+			if (strcmp(argv[j], s_TestTbl[i].pName) == 0)
+				break;
+		}
+
+		if (i >= s_NbTest)
+		{
+			printf("%-12s not found\n", argv[j]);
+			nfail++;
+		}
+		else if (RunTest(&s_TestTbl[i]) == false)
+		{
+			nfail++;
+		}
+	}
+
+	return nfail;
+}
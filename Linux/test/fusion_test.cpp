@@ -0,0 +1,203 @@
+/**-------------------------------------------------------------------------
+@file	fusion_test.cpp
+
+@brief	AGM sensor fusion unit tests
+
+Synthetic samples from a known orientation.  Each filter, float & fixed
+point, must converge to it from identity and integrate gyro rates.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <math.h>
+
+#include "sensors/agm_fusion.h"
+#include "test.h"
+
+#define FUSTEST_FREQ		100
+#define FUSTEST_ACCEL_1G	16384
+#define FUSTEST_MAG_1		4000
+
+// Target orientation, not normalized
+static const float s_FusTestQ[4] = { 0.8f, 0.2f, -0.3f, 0.4f };
+
+// Earth vector in sensor frame
+static void FusTestRotate(const float *q, const float *e, int16_t *pOut, float Scale)
+{
+	float q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+	float r[3] = {
+		e[0] * (1 - 2 * (q2 * q2 + q3 * q3)) + e[1] * 2 * (q1 * q2 + q0 * q3) + e[2] * 2 * (q1 * q3 - q0 * q2),
+		e[0] * 2 * (q1 * q2 - q0 * q3) + e[1] * (1 - 2 * (q1 * q1 + q3 * q3)) + e[2] * 2 * (q2 * q3 + q0 * q1),
+		e[0] * 2 * (q1 * q3 + q0 * q2) + e[1] * 2 * (q2 * q3 - q0 * q1) + e[2] * (1 - 2 * (q1 * q1 + q2 * q2))
+	};
+
+	for (int i = 0; i < 3; i++)
+	{
+		pOut[i] = (int16_t)lrintf(r[i] * Scale);
+	}
+}
+
+static float FusTestDot(const float *pA, const float *pB)
+{
+	return fabsf(pA[0] * pB[0] + pA[1] * pB[1] + pA[2] * pB[2] + pA[3] * pB[3]);
+}
+
+// Converge from identity to target orientation with accel & mag
+static bool FusTestConverge(AGMFUSION_ALGO Algo, float Gain, bool bFixed)
+{
+	static const float grav[3] = { 0, 0, 1 };
+	static const float field[3] = { 0.6f, 0, 0.8f };
+	AGMFUSION_CFG cfg = { Algo, FUSTEST_FREQ, 0.001f, Gain, 0.0f };
+	ACCELSENSOR_DATA accel[FUSTEST_FREQ];
+	GYROSENSOR_DATA gyro[FUSTEST_FREQ];
+	MAGSENSOR_DATA mag[FUSTEST_FREQ];
+	AGMFUSION_QUAT out[FUSTEST_FREQ];
+	AgmFusion fus;
+	float qt[4], q[4];
+	int16_t v[3];
+
+	memcpy(qt, s_FusTestQ, sizeof(qt));
+	float n = sqrtf(qt[0] * qt[0] + qt[1] * qt[1] + qt[2] * qt[2] + qt[3] * qt[3]);
+	for (int i = 0; i < 4; i++)
+	{
+		qt[i] /= n;
+	}
+
+	memset(gyro, 0, sizeof(gyro));
+	for (int i = 0; i < FUSTEST_FREQ; i++)
+	{
+		FusTestRotate(qt, grav, v, FUSTEST_ACCEL_1G);
+		accel[i].x = v[0];
+		accel[i].y = v[1];
+		accel[i].z = v[2];
+		FusTestRotate(qt, field, v, FUSTEST_MAG_1);
+		mag[i].x = v[0];
+		mag[i].y = v[1];
+		mag[i].z = v[2];
+		gyro[i].Timestamp = i * 10000;
+	}
+
+	TEST_ASSERT(fus.Init(cfg, bFixed));
+
+	// 10 sec
+	for (int i = 0; i < 10; i++)
+	{
+		TEST_ASSERT(fus.Update(accel, gyro, mag, FUSTEST_FREQ, out) == FUSTEST_FREQ);
+	}
+
+	fus.Read(q);
+	TEST_ASSERT(FusTestDot(q, qt) > 0.9999f);
+
+	// Q15 output of last sample
+	TEST_ASSERT(out[FUSTEST_FREQ - 1].Timestamp == (FUSTEST_FREQ - 1) * 10000);
+	for (int i = 0; i < 4; i++)
+	{
+		int16_t x = (&out[FUSTEST_FREQ - 1].w)[i];
+		TEST_ASSERT(fabsf(x / 32768.0f - q[i]) < 0.0001f);
+	}
+
+	return true;
+}
+
+// Yaw 90 deg from gyro alone, gravity unchanged
+static bool FusTestGyro(AGMFUSION_ALGO Algo, bool bFixed)
+{
+	AGMFUSION_CFG cfg = { Algo, FUSTEST_FREQ, 0.001f, 0.1f, 0.0f };
+	ACCELSENSOR_DATA accel = { 0, 0, 0, FUSTEST_ACCEL_1G };
+	GYROSENSOR_DATA gyro = { 0, 0, 0, 0 };
+	AgmFusion fus;
+	float q[4];
+	float e = sqrtf(0.5f);
+
+	// 1000 mrad/s * 1000 counts for pi/2 rad over 1 sec
+	gyro.z = 1571;
+
+	TEST_ASSERT(fus.Init(cfg, bFixed));
+	for (int i = 0; i < FUSTEST_FREQ; i++)
+	{
+		TEST_ASSERT(fus.Update(&accel, &gyro, NULL, 1) == 1);
+	}
+
+	fus.Read(q);
+	TEST_ASSERT(fabsf(q[0] - e) < 0.001f && fabsf(q[3] - e) < 0.001f);
+	TEST_ASSERT(fabsf(q[1]) < 0.001f && fabsf(q[2]) < 0.001f);
+
+	return true;
+}
+
+// Float & fixed point kernels follow the same path
+static bool FusTestKernel(AGMFUSION_ALGO Algo)
+{
+	AGMFUSION_CFG cfg = { Algo, 500, 0.00106f, 0.2f, 0.01f };
+	AGMFUSIONF ff;
+	AGMFUSIONQ fq;
+	int32_t q31[4];
+
+	AgmFusionInitF(&ff, &cfg);
+	AgmFusionInitQ(&fq, &cfg);
+
+	for (int i = 0; i < 2000; i++)
+	{
+		int16_t a[3] = { (int16_t)(3000 + (i % 7) * 50), -2000, 15000 };
+		int16_t g[3] = { (int16_t)(i % 200 - 100), 40, (int16_t)(300 - i % 50) };
+		int16_t m[3] = { 2500, (int16_t)(-800 + i % 30), 3000 };
+
+		AgmFusionUpdateF(&ff, a, g, m);
+		AgmFusionUpdateQ(&fq, a, g, m);
+	}
+
+	AgmFusionQ31(&fq, q31);
+	for (int i = 0; i < 4; i++)
+	{
+		TEST_ASSERT(fabsf(q31[i] / 2147483648.0f - ff.q[i]) < 0.001f);
+	}
+
+	// No accel, gyro only
+	int16_t zero[3] = { 0, 0, 0 }, g[3] = { 0, 0, 0 };
+	AgmFusionUpdateQ(&fq, zero, g, NULL);
+	AgmFusionUpdateF(&ff, zero, g, NULL);
+	TEST_ASSERT(fabsf(fq.q[0] / (float)AGMFUSION_Q24_ONE - ff.q[0]) < 0.001f);
+
+	return true;
+}
+
+bool FusionTest(void)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		bool fixed = i == 1;
+
+		TEST_ASSERT(FusTestConverge(AGMFUSION_ALGO_MADGWICK, 0.5f, fixed));
+		TEST_ASSERT(FusTestConverge(AGMFUSION_ALGO_MAHONY, 2.0f, fixed));
+		TEST_ASSERT(FusTestGyro(AGMFUSION_ALGO_MADGWICK, fixed));
+		TEST_ASSERT(FusTestGyro(AGMFUSION_ALGO_MAHONY, fixed));
+	}
+
+	return FusTestKernel(AGMFUSION_ALGO_MADGWICK) && FusTestKernel(AGMFUSION_ALGO_MAHONY);
+}
@@ -0,0 +1,64 @@
+/**-------------------------------------------------------------------------
+@file	intelhex_test.c
+
+@brief	Intel Hex parser unit tests
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "intelhex.h"
+#include "test.h"
+
+bool IHexTest(void)
+{
+	IHEXDATA rec;
+	char data[] = ":10010000214601360121470136007EFE09D2190140";
+	char badcs[] = ":10010000214601360121470136007EFE09D2190141";
+	char eof[] = ":00000001FF";
+	char extaddr[] = ":020000040800F2";
+
+	TEST_ASSERT(IHexParseRecord(data, &rec) == true);
+	TEST_ASSERT(rec.Count == 16 && rec.Offset == 0x100 && rec.Type == IHEX_RECTYPE_DATA);
+	TEST_ASSERT(rec.Data[0] == 0x21 && rec.Data[15] == 0x01);
+
+	TEST_ASSERT(IHexParseRecord(badcs, &rec) == false);
+
+	TEST_ASSERT(IHexParseRecord(eof, &rec) == true);
+	TEST_ASSERT(rec.Count == 0 && rec.Type == IHEX_RECTYPE_EOF);
+
+	TEST_ASSERT(IHexParseRecord(extaddr, &rec) == true);
+	TEST_ASSERT(rec.Type == IHEX_RECTYPE_EXTLADDR && rec.Data[0] == 0x08 && rec.Data[1] == 0x00);
+
+	TEST_ASSERT(IHexParseRecord((char *)"10010000", &rec) == false);
+
+	return true;
+}
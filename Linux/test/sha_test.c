@@ -0,0 +1,86 @@
+/**-------------------------------------------------------------------------
+@file	sha_test.c
+
+@brief	SHA-1 & SHA-256 unit tests
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include "isha1.h"
+#include "isha256.h"
+#include "test.h"
+
+typedef char *(*SHAFCT)(uint8_t *pData, int DataLen, bool bLast, char *pRes);
+
+// Feed data in chunks of ChunkLen bytes
+static char *ShaChunk(SHAFCT Sha, const char *pData, int DataLen, int ChunkLen, char *pRes)
+{
+	while (DataLen > ChunkLen)
+	{
+		Sha((uint8_t *)pData, ChunkLen, false, pRes);
+		pData += ChunkLen;
+		DataLen -= ChunkLen;
+	}
+
+	return Sha((uint8_t *)pData, DataLen, true, pRes);
+}
+
+bool ShaTest(void)
+{
+	static const char s_Msg448[] = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	static const char s_Msg896[] = "abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmnhijklmno"
+								   "ijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu";
+	static char s_Million[1000000];
+	char res[80];
+
+	memset(s_Million, 'a', sizeof(s_Million));
+
+	TEST_ASSERT(strcmp(Sha1((uint8_t *)"", 0, true, res), "DA39A3EE5E6B4B0D3255BFEF95601890AFD80709") == 0);
+	TEST_ASSERT(strcmp(Sha1((uint8_t *)"abc", 3, true, res), "A9993E364706816ABA3E25717850C26C9CD0D89D") == 0);
+	TEST_ASSERT(strcmp(Sha1((uint8_t *)s_Msg448, 56, true, res), "84983E441C3BD26EBAAE4AA1F95129E5E54670F1") == 0);
+	TEST_ASSERT(strcmp(Sha1((uint8_t *)s_Msg896, 112, true, res), "A49B2446A02C645BF419F995B67091253A04A259") == 0);
+	TEST_ASSERT(strcmp(ShaChunk(Sha1, s_Msg896, 112, 7, res), "A49B2446A02C645BF419F995B67091253A04A259") == 0);
+	TEST_ASSERT(strcmp(ShaChunk(Sha1, s_Million, sizeof(s_Million), 1000, res), "34AA973CD4C4DAA4F61EEB2BDBAD27316534016F") == 0);
+
+	TEST_ASSERT(strcmp(Sha256((uint8_t *)"", 0, true, res),
+					   "E3B0C44298FC1C149AFBF4C8996FB92427AE41E4649B934CA495991B7852B855") == 0);
+	TEST_ASSERT(strcmp(Sha256((uint8_t *)"abc", 3, true, res),
+					   "BA7816BF8F01CFEA414140DE5DAE2223B00361A396177A9CB410FF61F20015AD") == 0);
+	TEST_ASSERT(strcmp(Sha256((uint8_t *)s_Msg448, 56, true, res),
+					   "248D6A61D20638B8E5C026930C3E6039A33CE45964FF2167F6ECEDD419DB06C1") == 0);
+	TEST_ASSERT(strcmp(ShaChunk(Sha256, s_Msg896, 112, 3, res),
+					   "CF5B16A778AF8380036CE59E7B0492370B249B11E8F07A51AFAC45037AFEE9D1") == 0);
+	TEST_ASSERT(strcmp(ShaChunk(Sha256, s_Million, sizeof(s_Million), 1000, res),
+					   "CDC76E5C9914FB9281A1C7E284D73E67F1809A48A497200E046D39CCC7112CD0") == 0);
+
+	return true;
+}
@@ -0,0 +1,1407 @@
+/**-------------------------------------------------------------------------
+@file	sim_test.cpp
+
+@brief	Simulated device interface unit tests
+
+Runs the EHAL flash, SD card and BME280 drivers and raw EEPROM transfers on
+the simulated bus and checks the cost model accounting, the register
+cache, burst read planner & register script transaction savings.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/time.h>
+
+#include "sim_intrf.h"
+#include "sim_iopin.h"
+#include "diskio_flash.h"
+#include "sdcard.h"
+#include "sensors/tph_bme280.h"
+#include "sensors/agm_mpu9250.h"
+#include "test.h"
+
+#define SIMTEST_FLASH_SIZE		(256 * 1024)
+#define SIMTEST_SD_NBSECT		1024
+#define SIMTEST_EEP_SIZE		4096
+
+static uint8_t s_FlashMem[SIMTEST_FLASH_SIZE];
+static uint8_t s_SDMem[SIMTEST_SD_NBSECT * 512];
+static uint8_t s_EepMem[SIMTEST_EEP_SIZE];
+
+static const SIMINTRF_CFG s_SpiCfg = {
+	SIMINTRF_BUS_SPI, 8000000, 1000, 0, 5, 0
+};
+
+static const SIMINTRF_CFG s_I2cCfg = {
+	SIMINTRF_BUS_I2C, 400000, 2000, 0, 5, 0
+};
+
+static bool SimTestFlash(void)
+{
+	SimDevIntrf spi;
+	SIMFLASH flash;
+	FlashDiskIO disk;
+	FLASHDISKIO_CFG cfg = { 0, SIMTEST_FLASH_SIZE, 4096, 256, 3, NULL, NULL };
+	uint8_t wr[512], rd[512];
+
+	TEST_ASSERT(spi.Init(s_SpiCfg));
+	TEST_ASSERT(spi.Attach(0, SimFlashInit(&flash, s_FlashMem, SIMTEST_FLASH_SIZE, 3)));
+	TEST_ASSERT(disk.Init(cfg, &spi));
+	TEST_ASSERT(disk.ReadId() == 0x1840EF);
+
+	for (int i = 0; i < 512; i++)
+	{
+		wr[i] = i * 7;
+	}
+
+	spi.ResetStats();
+	TEST_ASSERT(disk.SectWrite(3, wr));
+	TEST_ASSERT(memcmp(&s_FlashMem[3 * 512], wr, 512) == 0);
+	TEST_ASSERT((flash.Status & 2) == 0);
+	// 2 pages programmed
+	TEST_ASSERT(spi.Stats().DevNs == 2 * flash.ProgNs);
+
+	// One status poll + one read : 1 + 4 bytes out, 1 + 512 bytes in
+	spi.ResetStats();
+	TEST_ASSERT(disk.SectRead(3, rd));
+	TEST_ASSERT(memcmp(rd, wr, 512) == 0);
+	TEST_ASSERT(spi.Stats().XferCnt == 2);
+	TEST_ASSERT(spi.Stats().TxBytes == 5 && spi.Stats().RxBytes == 513);
+	TEST_ASSERT(spi.Time() == 2 * 1000 + 518 * 1000);
+
+	// Program without write enable is ignored, erase restores
+	uint8_t cmd[4] = { 2, 0, 0, 0 }, d = 0;
+	TEST_ASSERT(DeviceIntrfWrite(spi, 0, cmd, 4, &d, 1) == 1);
+	TEST_ASSERT(s_FlashMem[0] == 0xFF);
+	disk.EraseBlock(0, 1);
+	TEST_ASSERT(s_FlashMem[3 * 512] == 0xFF);
+
+	return true;
+}
+
+static bool SimTestSDCard(void)
+{
+	SimDevIntrf spi;
+	SIMSDCARD card;
+	SDCard sd;
+	uint8_t wr[512], rd[512];
+
+	TEST_ASSERT(spi.Init(s_SpiCfg));
+	TEST_ASSERT(spi.Attach(0, SimSDCardInit(&card, s_SDMem, SIMTEST_SD_NBSECT)));
+	TEST_ASSERT(sd.Init(&spi, (uint8_t*)NULL, 0));
+	TEST_ASSERT(card.bIdle == false);
+	TEST_ASSERT(sd.GetNbSect() == SIMTEST_SD_NBSECT);
+
+	for (int i = 0; i < 512; i++)
+	{
+		wr[i] = i * 3;
+	}
+
+	TEST_ASSERT(sd.SectWrite(5, wr));
+	TEST_ASSERT(memcmp(&s_SDMem[5 * 512], wr, 512) == 0);
+	memset(rd, 0, sizeof(rd));
+	TEST_ASSERT(sd.SectRead(5, rd));
+	TEST_ASSERT(memcmp(rd, wr, 512) == 0);
+	TEST_ASSERT(sd.SectRead(SIMTEST_SD_NBSECT, rd) == false);
+
+	return true;
+}
+
+// Hashed CLOCK cache : hits without bus traffic, hot FAT sector survives a
+// sequential scan, pinned entries are never evicted
+static bool SimTestDiskCache(void)
+{
+	SimDevIntrf spi;
+	SIMSDCARD card;
+	SDCard sd;
+	uint8_t cache[DISKIO_CACHE_MEMSIZE(8)];
+	uint8_t rd[512];
+	uint32_t seed = 1;
+
+	for (int i = 0; i < SIMTEST_SD_NBSECT * 512; i++)
+	{
+		s_SDMem[i] = (i >> 9) + (i & 0xFF);
+	}
+
+	TEST_ASSERT(spi.Init(s_SpiCfg));
+	TEST_ASSERT(spi.Attach(0, SimSDCardInit(&card, s_SDMem, SIMTEST_SD_NBSECT)));
+	TEST_ASSERT(sd.Init(&spi, cache, sizeof(cache)));
+
+	for (int i = 0; i < 8; i++)
+	{
+		TEST_ASSERT(sd.Read((uint64_t)i * 512, rd, 512) == 512);
+	}
+	spi.ResetStats();
+	for (int i = 0; i < 8; i++)
+	{
+		TEST_ASSERT(sd.Read((uint64_t)i * 512 + 10, rd, 4) == 4);
+		TEST_ASSERT(rd[0] == (uint8_t)(i + 10));
+	}
+	TEST_ASSERT(spi.Stats().XferCnt == 0);
+	TEST_ASSERT(sd.CacheStats().MissCnt == 8 && sd.CacheStats().HitCnt == 8);
+
+	// FAT sector looked up between each data sector
+	sd.ResetCacheStats();
+	for (int i = 0; i < 100; i++)
+	{
+		TEST_ASSERT(sd.Read((uint64_t)1 * 512, rd, 4) == 4);
+		TEST_ASSERT(sd.Read((uint64_t)(100 + i) * 512, rd, 512) == 512);
+		TEST_ASSERT(rd[0] == (uint8_t)(100 + i));
+	}
+	TEST_ASSERT(sd.CacheStats().HitCnt == 100 && sd.CacheStats().MissCnt == 100);
+
+	// Random access, hash deletes must keep every cached sector reachable
+	sd.ResetCacheStats();
+	for (int i = 0; i < 4000; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		uint32_t sect = (seed >> 16) % 24;
+
+		TEST_ASSERT(sd.Read((uint64_t)sect * 512 + 3, rd, 1) == 1);
+		TEST_ASSERT(rd[0] == (uint8_t)(sect + 3));
+	}
+	TEST_ASSERT(sd.CacheStats().HitCnt + sd.CacheStats().MissCnt == 4000);
+	TEST_ASSERT(sd.CacheStats().HitCnt > 1000 && sd.CacheStats().FullCnt == 0);
+
+	// All pinned, reads go straight to the card
+	int idx[8];
+	for (int i = 0; i < 8; i++)
+	{
+		idx[i] = sd.GetCacheSect(200 + i);
+		TEST_ASSERT(idx[i] >= 0 && sd.CacheSectData(idx[i])[0] == (uint8_t)(200 + i));
+	}
+	TEST_ASSERT(sd.GetCacheSect(300) < 0 && sd.CacheStats().FullCnt == 1);
+	TEST_ASSERT(sd.Read((uint64_t)300 * 512, rd, 512) == 512 && rd[0] == (uint8_t)300);
+
+	// Write through pinned entry reaches the card on flush
+	sd.CacheSectData(idx[3])[0] = 0xA5;
+	for (int i = 0; i < 8; i++)
+	{
+		sd.ReleaseCacheSect(idx[i], i == 3);
+	}
+	TEST_ASSERT(s_SDMem[203 * 512] != 0xA5);
+	sd.Flush();
+	TEST_ASSERT(s_SDMem[203 * 512] == 0xA5);
+
+	return true;
+}
+
+// RAM disk recording write runs
+class SimTestRamDisk : public DiskIO {
+public:
+	uint8_t vMem[64 * 512];
+	uint32_t vRunSect[16];
+	int vRunLen[16];
+	int vNbRun;
+	int vNbRead;
+	int vNbReadRun;
+	bool vbWrFail;		// Writes fail, device error
+
+	SimTestRamDisk() : vNbRun(0), vNbRead(0), vNbReadRun(0), vbWrFail(false) { memset(vMem, 0, sizeof(vMem)); }
+	uint64_t GetSize(void) { return sizeof(vMem); }
+	bool SectRead(uint32_t SectNo, uint8_t *pBuff) {
+		vNbRead++;
+		memcpy(pBuff, &vMem[SectNo * 512], 512);
+		return true;
+	}
+	bool SectReadMulti(uint32_t SectNo, uint8_t * const *ppBuff, int NbSect) {
+		vNbReadRun++;
+		for (int i = 0; i < NbSect; i++)
+		{
+			SectRead(SectNo + i, ppBuff[i]);
+		}
+		return true;
+	}
+	bool SectWrite(uint32_t SectNo, uint8_t *pData) {
+		return SectWriteMulti(SectNo, &pData, 1);
+	}
+	bool SectWriteMulti(uint32_t SectNo, uint8_t * const *ppData, int NbSect) {
+		if (vbWrFail)
+			return false;
+		if (vNbRun < 16)
+		{
+			vRunSect[vNbRun] = SectNo;
+			vRunLen[vNbRun++] = NbSect;
+		}
+		for (int i = 0; i < NbSect; i++)
+		{
+			memcpy(&vMem[(SectNo + i) * 512], ppData[i], 512);
+		}
+		return true;
+	}
+};
+
+static uint32_t s_SimTestClock;
+
+static uint32_t SimTestClock(void)
+{
+	return s_SimTestClock;
+}
+
+static bool SimTestWriteBack(void)
+{
+	static SimTestRamDisk disk;
+	uint8_t cache[DISKIO_CACHE_MEMSIZE(12)];
+	uint8_t wr[512];
+	const uint32_t order[] = { 7, 3, 5, 4, 6, 20, 21, 2 };
+
+	TEST_ASSERT(disk.SetCacheMem(cache, sizeof(cache)) == 12);
+
+	// Out of order full sector writes, no read-modify-write
+	for (int i = 0; i < 8; i++)
+	{
+		memset(wr, order[i], sizeof(wr));
+		TEST_ASSERT(disk.Write((uint64_t)order[i] * 512, wr, 512) == 512);
+	}
+	TEST_ASSERT(disk.vNbRead == 0 && disk.vNbRun == 0 && disk.DirtyCount() == 8);
+
+	// Two runs, ascending
+	disk.Flush();
+	TEST_ASSERT(disk.vNbRun == 2 && disk.DirtyCount() == 0);
+	TEST_ASSERT(disk.vRunSect[0] == 2 && disk.vRunLen[0] == 6);
+	TEST_ASSERT(disk.vRunSect[1] == 20 && disk.vRunLen[1] == 2);
+	TEST_ASSERT(disk.CacheStats().WriteBackCnt == 8 && disk.CacheStats().WriteRunCnt == 2);
+	for (int i = 0; i < 8; i++)
+	{
+		TEST_ASSERT(disk.vMem[order[i] * 512 + 511] == order[i]);
+	}
+
+	// Partial write reads the sector first
+	TEST_ASSERT(disk.Write((uint64_t)40 * 512 + 4, wr, 4) == 4 && disk.vNbRead == 1);
+
+	// Dirty count limit
+	disk.Flush();
+	disk.vNbRun = 0;
+	disk.SetWriteBack(4);
+	for (int i = 0; i < 4; i++)
+	{
+		TEST_ASSERT(disk.Write((uint64_t)(10 + i) * 512, wr, 512) == 512);
+		TEST_ASSERT(disk.vNbRun == (i == 3 ? 1 : 0));
+	}
+	TEST_ASSERT(disk.vRunSect[0] == 10 && disk.vRunLen[0] == 4 && disk.DirtyCount() == 0);
+
+	// Age limit, counted from oldest dirty sector
+	disk.vNbRun = 0;
+	s_SimTestClock = 100;
+	disk.SetWriteBack(0, 50, SimTestClock);
+	TEST_ASSERT(disk.Write((uint64_t)30 * 512, wr, 512) == 512);
+	s_SimTestClock = 140;
+	TEST_ASSERT(disk.Write((uint64_t)31 * 512, wr, 512) == 512);
+	disk.FlushAged();
+	TEST_ASSERT(disk.vNbRun == 0 && disk.DirtyCount() == 2);
+	s_SimTestClock = 150;
+	disk.FlushAged();
+	TEST_ASSERT(disk.vNbRun == 1 && disk.vRunSect[0] == 30 && disk.vRunLen[0] == 2);
+
+	// Dirty victim evicted with its neighbours
+	disk.vNbRun = 0;
+	disk.SetWriteBack(0);
+	for (int i = 0; i < 3; i++)
+	{
+		TEST_ASSERT(disk.Write((uint64_t)(50 + i) * 512, wr, 512) == 512);
+	}
+	for (int i = 0; i < 40 && disk.vNbRun == 0; i++)
+	{
+		TEST_ASSERT(disk.Read((uint64_t)i * 512, wr, 1) == 1);
+	}
+	TEST_ASSERT(disk.vNbRun == 1 && disk.vRunSect[0] == 50 && disk.vRunLen[0] == 3);
+
+	// Failed write back keeps the run dirty
+	TEST_ASSERT(disk.Flush());
+	disk.vNbRun = 0;
+	memset(wr, 0x60, sizeof(wr));
+	TEST_ASSERT(disk.Write((uint64_t)60 * 512, wr, 512) == 512);
+	TEST_ASSERT(disk.Write((uint64_t)61 * 512, wr, 512) == 512);
+	disk.vbWrFail = true;
+	TEST_ASSERT(disk.Flush() == false);
+	TEST_ASSERT(disk.DirtyCount() == 2 && disk.vMem[61 * 512] != 0x60);
+	disk.vbWrFail = false;
+	TEST_ASSERT(disk.Flush() && disk.DirtyCount() == 0);
+	TEST_ASSERT(disk.vNbRun == 1 && disk.vRunSect[0] == 60 && disk.vRunLen[0] == 2);
+	TEST_ASSERT(disk.vMem[60 * 512] == 0x60 && disk.vMem[61 * 512 + 511] == 0x60);
+
+	// Failed bypass write leaves the dirty cached copy as is
+	static uint8_t big[8 * 512];
+
+	memset(wr, 0x62, sizeof(wr));
+	TEST_ASSERT(disk.Write((uint64_t)62 * 512, wr, 512) == 512);
+	memset(big, 0x70, sizeof(big));
+	disk.vbWrFail = true;
+	TEST_ASSERT(disk.Write((uint64_t)56 * 512, big, sizeof(big)) == 0);
+	TEST_ASSERT(disk.DirtyCount() == 1 && disk.CacheStats().BypassCnt == 0);
+	TEST_ASSERT(disk.Read((uint64_t)62 * 512, wr, 512) == 512 && wr[0] == 0x62);
+	disk.vbWrFail = false;
+	TEST_ASSERT(disk.Write((uint64_t)56 * 512, big, sizeof(big)) == (int)sizeof(big));
+	TEST_ASSERT(disk.DirtyCount() == 0 && disk.CacheStats().BypassCnt == 8);
+	TEST_ASSERT(disk.Read((uint64_t)62 * 512, wr, 512) == 512 && wr[0] == 0x70);
+	TEST_ASSERT(disk.vMem[62 * 512] == 0x70);
+
+	return true;
+}
+
+// Multi block transfers bypassing cache
+static bool SimTestMultiSect(void)
+{
+	SimDevIntrf spi;
+	SIMSDCARD card;
+	SDCard sd;
+	SIMFLASH flash;
+	FlashDiskIO disk;
+	FLASHDISKIO_CFG cfg = { 0, SIMTEST_FLASH_SIZE, 4096, 256, 3, NULL, NULL };
+	uint8_t cache[DISKIO_CACHE_MEMSIZE(8)];
+	static uint8_t wr[40 * 512], rd[40 * 512];
+
+	for (int i = 0; i < (int)sizeof(wr); i++)
+	{
+		wr[i] = (i >> 9) ^ (i * 13);
+	}
+
+	TEST_ASSERT(spi.Init(s_SpiCfg));
+	TEST_ASSERT(spi.Attach(0, SimSDCardInit(&card, s_SDMem, SIMTEST_SD_NBSECT)));
+	TEST_ASSERT(sd.Init(&spi, cache, sizeof(cache)));
+
+	// 32 + 8 sectors, one CMD25 each
+	card.CmdCnt = 0;
+	TEST_ASSERT(sd.Write((uint64_t)100 * 512, wr, sizeof(wr)) == sizeof(wr));
+	TEST_ASSERT(memcmp(&s_SDMem[100 * 512], wr, sizeof(wr)) == 0);
+	TEST_ASSERT(card.CmdCnt == 2 && sd.CacheStats().BypassCnt == 40);
+
+	// Unaligned, head & tail through cache, 39 sectors with CMD18 & CMD12
+	card.CmdCnt = 0;
+	TEST_ASSERT(sd.Read((uint64_t)100 * 512 + 100, rd, sizeof(rd) - 100) == sizeof(rd) - 100);
+	TEST_ASSERT(memcmp(rd, &wr[100], sizeof(rd) - 100) == 0);
+	TEST_ASSERT(card.CmdCnt == 2 * 2 + 1 && sd.CacheStats().BypassCnt == 40 + 39);
+
+	// Rejected block ends CMD25 with stop token before status is read
+	uint8_t *blk[4] = { &wr[0], &wr[512], &wr[1024], &wr[1536] };
+
+	card.WrErrSect = 302;
+	card.CmdCnt = 0;
+	TEST_ASSERT(sd.WriteMultiBlock(300, blk, 4) == 2);
+	TEST_ASSERT(card.CmdCnt == 2 && card.bWrMulti == false);
+	TEST_ASSERT(memcmp(&s_SDMem[300 * 512], wr, 2 * 512) == 0);
+	card.WrErrSect = (uint32_t)-1;
+
+	// Dirty cached sector is newer than card
+	uint8_t d = 0x5A;
+	TEST_ASSERT(sd.Write((uint64_t)110 * 512 + 7, &d, 1) == 1 && sd.DirtyCount() == 1);
+	TEST_ASSERT(sd.Read((uint64_t)100 * 512, rd, 16 * 512) == 16 * 512);
+	TEST_ASSERT(rd[10 * 512 + 7] == 0x5A && s_SDMem[110 * 512 + 7] != 0x5A);
+
+	// Bypass write supersedes it and updates cached copy
+	TEST_ASSERT(sd.Write((uint64_t)100 * 512, wr, 16 * 512) == 16 * 512);
+	TEST_ASSERT(sd.DirtyCount() == 0);
+	TEST_ASSERT(sd.Read((uint64_t)110 * 512 + 7, &d, 1) == 1 && d == wr[10 * 512 + 7]);
+	sd.Flush();
+	TEST_ASSERT(memcmp(&s_SDMem[100 * 512], wr, 16 * 512) == 0);
+
+	// Below threshold goes through cache
+	sd.SetCacheBypass(0);
+	sd.ResetCacheStats();
+	TEST_ASSERT(sd.Read((uint64_t)200 * 512, rd, 16 * 512) == 16 * 512);
+	TEST_ASSERT(sd.CacheStats().BypassCnt == 0 && sd.CacheStats().MissCnt == 16);
+
+	// Flash, one status poll & one read command for 16 sectors
+	SimDevIntrf fspi;
+	TEST_ASSERT(fspi.Init(s_SpiCfg));
+	TEST_ASSERT(fspi.Attach(0, SimFlashInit(&flash, s_FlashMem, SIMTEST_FLASH_SIZE, 3)));
+	TEST_ASSERT(disk.Init(cfg, &fspi));
+	memcpy(s_FlashMem, wr, 16 * 512);
+	fspi.ResetStats();
+	TEST_ASSERT(disk.Read((uint64_t)0, rd, 16 * 512) == 16 * 512);
+	TEST_ASSERT(memcmp(rd, wr, 16 * 512) == 0);
+	TEST_ASSERT(fspi.Stats().XferCnt == 2 && fspi.Stats().RxBytes == 1 + 16 * 512);
+
+	// Interface returning partial chunks, still one read command
+	SIMINTRF_CFG capcfg = s_SpiCfg;
+
+	capcfg.RxMax = 100;
+	TEST_ASSERT(fspi.Init(capcfg));
+	TEST_ASSERT(fspi.Attach(0, SimFlashInit(&flash, s_FlashMem, SIMTEST_FLASH_SIZE, 3)));
+	memcpy(s_FlashMem, wr, 16 * 512);
+	memset(rd, 0, 16 * 512);
+	TEST_ASSERT(disk.Read((uint64_t)0, rd, 16 * 512) == 16 * 512);
+	TEST_ASSERT(memcmp(rd, wr, 16 * 512) == 0);
+	TEST_ASSERT(fspi.Stats().XferCnt == 2);
+
+	return true;
+}
+
+// Sequential read ahead
+static bool SimTestPrefetch(void)
+{
+	static SimTestRamDisk disk;
+	uint8_t cache[DISKIO_CACHE_MEMSIZE(16)];
+	uint8_t rd[128];
+	uint32_t seed = 7;
+
+	for (int i = 0; i < (int)sizeof(disk.vMem); i++)
+	{
+		disk.vMem[i] = (i >> 9) + i;
+	}
+
+	TEST_ASSERT(disk.SetCacheMem(cache, sizeof(cache)) == 16);
+	disk.SetPrefetch(8);
+
+	// File data in 128 bytes reads with FAT sector looked up every 8 sectors
+	for (int i = 0; i < 40 * 4; i++)
+	{
+		uint32_t off = 512 + i * 128;
+
+		if ((i & 31) == 0)
+		{
+			TEST_ASSERT(disk.Read((uint64_t)60 * 512, rd, 4) == 4);
+		}
+		TEST_ASSERT(disk.Read((uint64_t)off, rd, 128) == 128);
+		TEST_ASSERT(rd[0] == (uint8_t)((off >> 9) + off) && rd[127] == (uint8_t)((off >> 9) + off + 127));
+	}
+
+	// Sectors 3 to 40 read ahead, overshoot bounded by window
+	const DISKIO_CACHE_STATS &st = disk.CacheStats();
+	TEST_ASSERT(st.PrefetchHitCnt == 40 - 2 && st.PrefetchCnt - st.PrefetchHitCnt <= 8);
+	TEST_ASSERT(disk.vNbReadRun < 12);
+
+	// Each access counted once, demand sector read with read ahead is a miss
+	TEST_ASSERT(st.HitCnt + st.MissCnt == 40 * 4 + 5);
+
+	// Random access collapses read ahead
+	disk.ResetCacheStats();
+	for (int i = 0; i < 200; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		TEST_ASSERT(disk.Read((uint64_t)((seed >> 16) % 64) * 512 + 5, rd, 1) == 1);
+	}
+	// Only chance sequential pairs read ahead, by min window
+	TEST_ASSERT(disk.CacheStats().PrefetchCnt < 200 / 8);
+
+	// Deferred, issued from idle loop
+	disk.Reset();
+	disk.SetPrefetch(8, true);
+	disk.ResetCacheStats();
+	disk.vNbReadRun = 0;
+	for (int i = 0; i < 32; i++)
+	{
+		TEST_ASSERT(disk.Read((uint64_t)i * 512, rd, 128) == 128);
+		disk.PrefetchRun();
+	}
+	TEST_ASSERT(disk.CacheStats().MissCnt == 2 && disk.CacheStats().PrefetchHitCnt == 30);
+	TEST_ASSERT(disk.CacheStats().HitCnt == 30);
+
+	disk.SetPrefetch(0);
+
+	return true;
+}
+
+// 16 GB disk of 4 KB sectors, sector content generated from sector number
+class SimTestBigDisk : public DiskIO {
+public:
+	uint32_t vWrSect;
+	uint8_t vWrData[4096];
+	int vNbRead;
+	int vNbWrite;
+
+	SimTestBigDisk() : vWrSect(-1), vNbRead(0), vNbWrite(0) {}
+	int GetSectSize(void) { return 4096; }
+	uint64_t GetSize(void) { return 16ULL << 30; }
+	bool SectRead(uint32_t SectNo, uint8_t *pBuff) {
+		vNbRead++;
+		for (int i = 0; i < 4096; i++)
+		{
+			pBuff[i] = SectNo + i;
+		}
+		return true;
+	}
+	bool SectWrite(uint32_t SectNo, uint8_t *pData) {
+		vNbWrite++;
+		vWrSect = SectNo;
+		memcpy(vWrData, pData, 4096);
+		return true;
+	}
+};
+
+static bool SimTestSectSize(void)
+{
+	static SimTestBigDisk disk, nocache;
+	static uint8_t cache[DISKIO_CACHE_MEMSIZE_SECT(4, 4096)];
+	static uint8_t wr[4096];
+	uint8_t rd[16];
+	uint64_t off = (5ULL << 30) + 4090;		// Crosses sector 0x140000 to 0x140001
+
+	TEST_ASSERT(disk.SetCacheMem(cache, sizeof(cache)) == 4);
+
+	TEST_ASSERT(disk.Read(off, rd, 16) == 16);
+	for (int i = 0; i < 16; i++)
+	{
+		TEST_ASSERT(rd[i] == (uint8_t)(i < 6 ? 0x140000 + 4090 + i : 0x140001 + i - 6));
+	}
+	TEST_ASSERT(disk.vNbRead == 2);
+
+	// Whole sector written once, no read-modify-write
+	memset(wr, 0x3C, sizeof(wr));
+	TEST_ASSERT(disk.Write((uint64_t)0x140010 * 4096, wr, 4096) == 4096);
+	disk.Flush();
+	TEST_ASSERT(disk.vNbRead == 2 && disk.vNbWrite == 1 && disk.vWrSect == 0x140010);
+	TEST_ASSERT(disk.vWrData[0] == 0x3C && disk.vWrData[4095] == 0x3C);
+
+	// Partial write lands at offset in sector
+	TEST_ASSERT(disk.Write((uint64_t)0x140020 * 4096 + 1000, wr, 8) == 8);
+	disk.Flush();
+	TEST_ASSERT(disk.vWrSect == 0x140020 && disk.vWrData[999] == (uint8_t)(0x140020 + 999));
+	TEST_ASSERT(disk.vWrData[1000] == 0x3C && disk.vWrData[1008] == (uint8_t)(0x140020 + 1008));
+
+	// Without cache, whole sectors only
+	TEST_ASSERT(nocache.Read((uint64_t)7 * 4096, wr, 4096) == 4096 && wr[1] == 8);
+	TEST_ASSERT(nocache.Write((uint64_t)9 * 4096, wr, 4096) == 4096 && nocache.vWrSect == 9);
+	TEST_ASSERT(nocache.Read((uint64_t)7 * 4096 + 1, rd, 1) == 0);
+
+	return true;
+}
+
+// Flash disk with 4 KB sectors, one erase block each
+static bool SimTestFlashSectSize(void)
+{
+	SimDevIntrf spi;
+	SIMFLASH flash;
+	FlashDiskIO disk, nowrsize;
+	FLASHDISKIO_CFG cfg = { 0, SIMTEST_FLASH_SIZE, 4096, 256, 3, NULL, NULL, 4096 };
+	static uint8_t cache[DISKIO_CACHE_MEMSIZE_SECT(2, 4096)];
+	static uint8_t wr[4096];
+	uint8_t rd[16];
+
+	TEST_ASSERT(spi.Init(s_SpiCfg));
+	TEST_ASSERT(spi.Attach(0, SimFlashInit(&flash, s_FlashMem, SIMTEST_FLASH_SIZE, 3)));
+	TEST_ASSERT(disk.Init(cfg, &spi));
+	TEST_ASSERT(disk.GetSectSize() == 4096 && disk.GetMinWriteSize() == 256);
+
+	for (int i = 0; i < 4096; i++)
+	{
+		wr[i] = i * 3 + (i >> 8);
+	}
+
+	// Sector programmed page by page
+	disk.EraseBlock(0, 1);
+	spi.ResetStats();
+	TEST_ASSERT(disk.SectWrite(2, wr));
+	TEST_ASSERT(spi.Stats().DevNs == 16 * flash.ProgNs);
+	TEST_ASSERT(memcmp(&s_FlashMem[2 * 4096], wr, 4096) == 0);
+
+	// Byte access through the cache
+	TEST_ASSERT(disk.SetCacheMem(cache, sizeof(cache)) == 2);
+	TEST_ASSERT(disk.Read((uint64_t)2 * 4096 + 1000, rd, 16) == 16);
+	TEST_ASSERT(memcmp(rd, &wr[1000], 16) == 0);
+
+	// Program size not given defaults to DISKIO_SECT_SIZE, not the sector size
+	cfg.WriteSize = 0;
+	TEST_ASSERT(nowrsize.Init(cfg, &spi));
+	TEST_ASSERT(nowrsize.GetSectSize() == 4096 && nowrsize.GetMinWriteSize() == DISKIO_SECT_SIZE);
+
+	return true;
+}
+
+static bool SimTestEeprom(void)
+{
+	SimDevIntrf i2c;
+	SIMEEPROM eep;
+	uint8_t ad[2] = { 0, 0x1E };
+	uint8_t wr[20], rd[20];
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(0x50, SimEepromInit(&eep, s_EepMem, SIMTEST_EEP_SIZE, 32, 2, 5000000)));
+
+	for (int i = 0; i < 20; i++)
+	{
+		wr[i] = i + 1;
+	}
+
+	// Write wraps within 32 bytes page
+	TEST_ASSERT(DeviceIntrfWrite(i2c, 0x50, ad, 2, wr, 20) == 20);
+	TEST_ASSERT(s_EepMem[0x1E] == 1 && s_EepMem[0x1F] == 2);
+	TEST_ASSERT(memcmp(s_EepMem, &wr[2], 18) == 0);
+
+	// 9 bits per byte, address byte + 22 bytes, write cycle as device time
+	TEST_ASSERT(i2c.Stats().XferCnt == 1);
+	TEST_ASSERT(i2c.Stats().BusNs == 2000 + 23 * 22500);
+	TEST_ASSERT(i2c.Stats().DevNs == 5000000);
+
+	// Random read, restart keeps the address
+	ad[1] = 0;
+	TEST_ASSERT(DeviceIntrfRead(i2c, 0x50, ad, 2, rd, 18) == 18);
+	TEST_ASSERT(memcmp(rd, &wr[2], 18) == 0);
+	TEST_ASSERT(i2c.Stats().StartCnt == 3);
+
+	// No device
+	TEST_ASSERT(i2c.StartTx(0x51) == false);
+	TEST_ASSERT(i2c.Stats().NackCnt == 1);
+
+	return true;
+}
+
+static bool SimTestBme280(void)
+{
+	SimDevIntrf i2c, spi;
+	SIMREGFILE regi2c, regspi;
+	TphBme280 tphi2c, tphspi;
+	TPHSENSOR_CFG cfg = {
+		BME280_I2C_DEV_ADDR0, SENSOR_OPMODE_SINGLE, 1000, 1, 1, 1, 0, NULL
+	};
+	TPHSENSOR_DATA data;
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(BME280_I2C_DEV_ADDR0, SimBme280Init(&regi2c, false)));
+	TEST_ASSERT(tphi2c.Init(cfg, &i2c, NULL));
+	TEST_ASSERT(regi2c.Reg[BME280_REG_CTRL_HUM] == 1);
+	TEST_ASSERT(tphi2c.Read(data));
+	TEST_ASSERT(data.Temperature == 2508);
+	TEST_ASSERT(data.Pressure > 100600 && data.Pressure < 100700);
+
+	// SPI, register address bit 7 is read flag
+	cfg.DevAddr = 1;
+	TEST_ASSERT(spi.Init(s_SpiCfg));
+	TEST_ASSERT(spi.Attach(1, SimBme280Init(&regspi, true)));
+	TEST_ASSERT(tphspi.Init(cfg, &spi, NULL));
+	TEST_ASSERT(regspi.Reg[BME280_REG_CTRL_HUM] == 1);
+	TEST_ASSERT(tphspi.Read(data));
+	TEST_ASSERT(data.Temperature == 2508);
+
+	// NVM copy never completes
+	SIMREGFILE regstuck;
+	TphBme280 tphstuck;
+
+	cfg.DevAddr = BME280_I2C_DEV_ADDR1;
+	TEST_ASSERT(i2c.Attach(BME280_I2C_DEV_ADDR1, SimBme280Init(&regstuck, false)));
+	regstuck.Reg[BME280_REG_STATUS] = BME280_REG_STATUS_IM_UPDATE;
+	TEST_ASSERT(tphstuck.Init(cfg, &i2c, NULL) == false);
+
+	return true;
+}
+
+// Minimal device exposing the register cache
+class SimTestRegDev : public Device {
+public:
+	bool Enable() { return true; }
+	void Disable() {}
+	void Reset() { RegCacheReset(); }
+	bool Init(DeviceIntrf *pIntrf, int DevAddr, const DEVREG_DESC *pDesc, int NbDesc) {
+		Interface(pIntrf);
+		DeviceAddess(DevAddr);
+		return RegCacheInit(&vCache, pDesc, NbDesc, vMem, sizeof(vMem), true);
+	}
+	using Device::RegCacheDefer;
+	using Device::RegCacheInvalidate;
+	using Device::Queue;
+
+private:
+	DEVREGCACHE vCache;
+	uint8_t vMem[DEVREGCACHE_MEMSIZE(16)];
+};
+
+static bool SimTestRegCache(void)
+{
+	static const DEVREG_DESC desc[] = {
+		{ 0x10, 4, DEVREG_ATTR_CACHED | DEVREG_ATTR_RSTVAL, 0x5A },
+		{ 0x15, 2, DEVREG_ATTR_CACHED, 0 },
+		{ 0x18, 1, DEVREG_ATTR_WRONLY | DEVREG_ATTR_RSTVAL, 0 },
+		{ 0x19, 1, DEVREG_ATTR_WRONLY, 0 },
+		{ 0x1A, 1, DEVREG_ATTR_CACHED | DEVREG_ATTR_TRIGGER | DEVREG_ATTR_RSTVAL, 0 },
+	};
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	SimTestRegDev dev;
+	uint8_t ra;
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(0x68, SimRegFileInit(&reg, 0xFF, 0)));
+	TEST_ASSERT(dev.Init(&i2c, 0x68, desc, sizeof(desc) / sizeof(DEVREG_DESC)));
+	dev.Reset();
+	reg.Reg[0x15] = 0x33;
+	reg.Reg[0x14] = 0x44;
+
+	// Reset values & write only registers cost nothing, unknown & volatile go to the bus
+	i2c.ResetStats();
+	ra = 0x11;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0x5A);
+	ra = 0x18;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0);
+	reg.Reg[0x19] = 0x99;
+	ra = 0x19;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0);
+	TEST_ASSERT(i2c.Stats().XferCnt == 0);
+	ra = 0x15;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0x33);
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0x33);
+	ra = 0x14;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0x44);
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0x44);
+	TEST_ASSERT(i2c.Stats().XferCnt == 3);
+	TEST_ASSERT(dev.RegCache()->Stats.HitCnt == 3 && dev.RegCache()->Stats.MissCnt == 1);
+
+	// Unchanged value is not rewritten
+	i2c.ResetStats();
+	ra = 0x10;
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x5A));
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x01));
+	TEST_ASSERT(reg.Reg[0x10] == 1 && i2c.Stats().XferCnt == 1);
+	TEST_ASSERT(dev.RegCache()->Stats.ElideCnt == 1);
+
+	// Deferred writes, 0x11 is bridged with its shadow, 0x14 is volatile so
+	// 0x15 starts a new burst.  Trigger flushes pending writes first.
+	i2c.ResetStats();
+	TEST_ASSERT(dev.RegCacheDefer(true));
+	ra = 0x12;
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x22));
+	ra = 0x10;
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x02));
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x03));
+	ra = 0x15;
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x55));
+	ra = 0x18;
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x88));
+	TEST_ASSERT(i2c.Stats().XferCnt == 0 && reg.Reg[0x10] == 1);
+	ra = 0x1A;
+	TEST_ASSERT(dev.Write8(&ra, 1, 0xAA));
+	TEST_ASSERT(i2c.Stats().XferCnt == 4);
+	TEST_ASSERT(dev.Write8(&ra, 1, 0xAA));
+	TEST_ASSERT(i2c.Stats().XferCnt == 5);
+	TEST_ASSERT(reg.Reg[0x10] == 3 && reg.Reg[0x11] == 0x5A && reg.Reg[0x12] == 0x22);
+	TEST_ASSERT(reg.Reg[0x15] == 0x55 && reg.Reg[0x18] == 0x88 && reg.Reg[0x1A] == 0xAA);
+	TEST_ASSERT(dev.RegCacheDefer(false));
+	TEST_ASSERT(i2c.Stats().XferCnt == 5);
+
+	// Write only shadow once written
+	ra = 0x19;
+	TEST_ASSERT(dev.Write8(&ra, 1, 0x42));
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0x42);
+
+	// Unknown after invalidate, write only is not read from the bus
+	dev.RegCacheInvalidate();
+	reg.Reg[0x10] = 0x77;
+	ra = 0x10;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0x77);
+	i2c.ResetStats();
+	ra = 0x19;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 0 && i2c.Stats().XferCnt == 0);
+
+	return true;
+}
+
+static bool SimTestReadRegs(void)
+{
+	static const DEVREG_DESC desc[] = {
+		{ 0, 1, DEVREG_ATTR_CACHED, 0 },
+	};
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	SimTestRegDev dev;
+	uint8_t a[2], b[4], c[3], d[1], big[80];
+	DEVREG_READ req[4] = {
+		{ 0x20, 4, b, 0 },
+		{ 0x10, 2, a, 0 },
+		{ 0x22, 3, c, 0 },		// overlaps previous
+		{ 0x30, 1, d, 0 },		// gap too large
+	};
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(0x68, SimRegFileInit(&reg, 0xFF, 0)));
+	TEST_ASSERT(dev.Init(&i2c, 0x68, desc, 1));
+	for (int i = 0; i < 256; i++)
+	{
+		reg.Reg[i] = i;
+	}
+
+	// Default gap keeps 3 transactions
+	i2c.ResetStats();
+	TEST_ASSERT(dev.ReadRegs(req, 4) == 4);
+	TEST_ASSERT(i2c.Stats().XferCnt == 3);
+	TEST_ASSERT(a[1] == 0x11 && b[0] == 0x20 && b[3] == 0x23 && c[0] == 0x22 && c[2] == 0x24);
+	TEST_ASSERT(d[0] == 0x30 && req[2].Count == 3);
+
+	// Large gap allowed, single burst
+	i2c.ResetStats();
+	memset(b, 0, sizeof(b));
+	TEST_ASSERT(dev.ReadRegs(req, 4, 16) == 4);
+	TEST_ASSERT(i2c.Stats().XferCnt == 1 && i2c.Stats().RxBytes == 0x31 - 0x10);
+	TEST_ASSERT(b[0] == 0x20 && b[3] == 0x23 && d[0] == 0x30);
+
+	// Request larger than a burst is read directly, not merged
+	DEVREG_READ req2[2] = {
+		{ 0x40, 80, big, 0 },
+		{ 0x90, 1, d, 0 },
+	};
+	i2c.ResetStats();
+	TEST_ASSERT(dev.ReadRegs(req2, 2, 16) == 2);
+	TEST_ASSERT(i2c.Stats().XferCnt == 2 && big[79] == 0x8F && d[0] == 0x90);
+
+	return true;
+}
+
+static bool SimTestDevReg(void)
+{
+	typedef DevReg<uint32_t, DEVREG_ENDIAN_BIG, 0x40> RegBe32;
+	typedef DevReg<int16_t, DEVREG_ENDIAN_LITTLE, 0x44> RegLe16;
+	typedef DevReg<uint32_t, DEVREG_ENDIAN_BIG, 0x41, 3> RegBe24;
+	typedef DevRegBits<uint32_t, DEVREG_ENDIAN_BIG, 0x40, 3, 4, 20> Adc20;
+	typedef DevRegBits<int32_t, DEVREG_ENDIAN_LITTLE, 0x48, 2, 2, 12> Signed12;
+	static const uint8_t blk[] = { 0x12, 0x34, 0x56, 0x78, 0xFE, 0xFF };
+	static const DEVREG_DESC desc[] = {
+		{ 0, 1, DEVREG_ATTR_CACHED, 0 },
+	};
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	SimTestRegDev dev;
+	uint8_t d[8];
+
+	TEST_ASSERT(RegBe32::Decode(blk) == 0x12345678);
+	TEST_ASSERT(RegBe24::Decode(blk, 0x40) == 0x345678);
+	TEST_ASSERT(RegLe16::Decode(blk, 0x40) == -2);
+	TEST_ASSERT(Adc20::Decode(blk) == 0x12345);
+	TEST_ASSERT((DevRegGet<uint64_t, DEVREG_ENDIAN_LITTLE, 6>(blk)) == 0xFFFE78563412ULL);
+
+	// Sign extended from field msb
+	d[0] = 0xFC;
+	d[1] = 0x3F;
+	TEST_ASSERT(Signed12::Decode(d) == -1);
+	d[1] = 0x1F;
+	TEST_ASSERT(Signed12::Decode(d) == 0x7FF);
+
+	RegBe32::Encode(d, 0xA1B2C3D4);
+	TEST_ASSERT(d[0] == 0xA1 && d[3] == 0xD4);
+	RegLe16::Encode(d, -3);
+	TEST_ASSERT(d[0] == 0xFD && d[1] == 0xFF);
+
+	// Single burst of register width
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(0x68, SimRegFileInit(&reg, 0xFF, 0)));
+	TEST_ASSERT(dev.Init(&i2c, 0x68, desc, 1));
+	i2c.ResetStats();
+	TEST_ASSERT(RegBe32::Write(dev, 0x01020304));
+	TEST_ASSERT(reg.Reg[0x40] == 1 && reg.Reg[0x43] == 4);
+	TEST_ASSERT(RegBe32::Read(dev) == 0x01020304);
+	TEST_ASSERT(i2c.Stats().XferCnt == 2 && i2c.Stats().RxBytes == 4);
+
+	// Device::Write32 writes all 4 bytes in host order
+	uint8_t ra = 0x50;
+	uint32_t v = 0x11223344;
+	TEST_ASSERT(dev.Write32(&ra, 1, v));
+	TEST_ASSERT(memcmp(&reg.Reg[0x50], &v, 4) == 0);
+
+	return true;
+}
+
+static SimDevIntrf *s_pLateIntrf;
+static DEVINTRFQUE *s_pLateQue;
+
+// Interface interrupt of a stalled queue.  Completes the transfer in progress
+// once the script has given up on the queued ones
+static void SimTestLateDone(int Sig)
+{
+	(void)Sig;
+
+	if (s_pLateQue->pHead == NULL)
+	{
+		struct itimerval tv = {};
+
+		setitimer(ITIMER_REAL, &tv, NULL);
+		s_pLateIntrf->RunIdle();
+	}
+}
+
+static bool SimTestRegScript(void)
+{
+	static const DEVREG_DESC desc[] = {
+		{ 0x20, 4, DEVREG_ATTR_CACHED, 0 },
+	};
+	static const DEVREG_STEP script[] = {
+		DevRegWr(0x20, 1),
+		DevRegWr(0x21, 2),
+		DevRegWr(0x22, 3),
+		DevRegWr(0x30, 4),
+		DevRegRmw(0x40, 0x0F, 0x05),
+		DevRegPoll(0x41, 0x80, 0x80, 1000),
+		DevRegWr(0x23, 5),
+		DevRegEnd()
+	};
+	static const DEVREG_STEP timeout[] = {
+		DevRegPoll(0x41, 0x01, 0x01, 300),
+		DevRegWr(0x50, 1),
+		DevRegEnd()
+	};
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	SimTestRegDev dev;
+	DEVINTRFQUE que;
+	uint8_t ra;
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(0x68, SimRegFileInit(&reg, 0xFF, 0)));
+	TEST_ASSERT(dev.Init(&i2c, 0x68, desc, 1));
+
+	for (int i = 0; i < 2; i++)
+	{
+		memset(reg.Reg, 0, sizeof(reg.Reg));
+		reg.Reg[0x40] = 0xA3;
+		reg.Reg[0x41] = 0x80;
+		dev.RegCacheInvalidate();
+
+		if (i == 1)
+		{
+			// Writes through the transaction queue
+			TEST_ASSERT(DevIntrfQueInit(&que, i2c, NULL, NULL));
+			dev.Queue(&que);
+		}
+
+		// 0x20-0x22 burst, 0x30, RMW read & write, poll, 0x23
+		i2c.ResetStats();
+		TEST_ASSERT(dev.RegScriptRun(script, true));
+		TEST_ASSERT(i2c.Stats().XferCnt == 6);
+		TEST_ASSERT(reg.Reg[0x20] == 1 && reg.Reg[0x22] == 3 && reg.Reg[0x23] == 5);
+		TEST_ASSERT(reg.Reg[0x30] == 4 && reg.Reg[0x40] == 0xA5);
+
+		// Burst written values are known to the cache
+		ra = 0x21;
+		TEST_ASSERT(dev.Read8(&ra, 1) == 2 && i2c.Stats().XferCnt == 6);
+
+		// Poll timeout aborts the script
+		TEST_ASSERT(dev.RegScriptRun(timeout, true) == false);
+		TEST_ASSERT(reg.Reg[0x50] == 0);
+	}
+
+	// RMW write is not queued, it waits for the read anyway
+	TEST_ASSERT(que.Stats.SubmitCnt == 3 && que.Stats.FailCnt == 0);
+
+	// Stalled completion driven queue, the script cancels the writes not
+	// started, stops submitting & returns once the one in progress completes
+	static const DEVREG_STEP burst[] = {
+		DevRegWr(0x20, 9),
+		DevRegWr(0x22, 8),
+		DevRegWr(0x21, 7),
+		DevRegWr(0x23, 6),
+		DevRegWr(0x20, 5),
+		DevRegWr(0x22, 4),
+		DevRegEnd()
+	};
+
+	struct itimerval tv = {};
+
+	TEST_ASSERT(i2c.QueInit(que));
+	dev.Queue(&que);
+	dev.RegCacheInvalidate();
+	s_pLateIntrf = &i2c;
+	s_pLateQue = &que;
+	signal(SIGALRM, SimTestLateDone);
+	tv.it_value.tv_usec = DEVREG_SCRIPT_TIMEOUT / 4;
+	tv.it_interval.tv_usec = DEVREG_SCRIPT_TIMEOUT / 4;
+	setitimer(ITIMER_REAL, &tv, NULL);
+	TEST_ASSERT(dev.RegScriptRun(burst, true) == false);
+	signal(SIGALRM, SIG_DFL);
+	TEST_ASSERT(DevIntrfQueIdle(&que) && que.Stats.SubmitCnt == DEVREG_SCRIPT_MAXXACT);
+	TEST_ASSERT(que.Stats.DoneCnt == DEVREG_SCRIPT_MAXXACT && que.Stats.FailCnt == DEVREG_SCRIPT_MAXXACT - 1);
+	TEST_ASSERT(reg.Reg[0x20] == 9 && reg.Reg[0x22] == 3);
+
+	// Only the completed write is known to the cache
+	dev.Queue(NULL);
+	i2c.ResetStats();
+	ra = 0x20;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 9 && i2c.Stats().XferCnt == 0);
+	ra = 0x22;
+	TEST_ASSERT(dev.Read8(&ra, 1) == 3 && i2c.Stats().XferCnt == 1);
+
+	// Back to known register values
+	TEST_ASSERT(dev.RegScriptRun(script, true));
+
+	// Single writes go through the cache, unchanged 0x20-0x23 are dropped
+	dev.Queue(NULL);
+	i2c.ResetStats();
+	TEST_ASSERT(dev.RegScriptRun(script, false));
+	TEST_ASSERT(i2c.Stats().XferCnt == 4);
+
+	// No auto increment, one write per register
+	dev.RegCacheInvalidate();
+	i2c.ResetStats();
+	TEST_ASSERT(dev.RegScriptRun(script, false));
+	TEST_ASSERT(i2c.Stats().XferCnt == 8);
+
+	return true;
+}
+
+// BME280 control register re-reads & rewrites are served by the cache
+static bool SimTestBme280Cache(void)
+{
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	TphBme280 tph;
+	TPHSENSOR_CFG cfg = {
+		BME280_I2C_DEV_ADDR0, SENSOR_OPMODE_SINGLE, 1000, 1, 1, 1, 0, NULL
+	};
+	TPHSENSOR_DATA data;
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(BME280_I2C_DEV_ADDR0, SimBme280Init(&reg, false)));
+
+	// Id, reset, NVM copy status poll, 2 calibration reads, ctrl_hum &
+	// ctrl_meas writes
+	i2c.ResetStats();
+	TEST_ASSERT(tph.Init(cfg, &i2c, NULL));
+	TEST_ASSERT(i2c.Stats().XferCnt == 7);
+	TEST_ASSERT(reg.Reg[BME280_REG_CTRL_HUM] == 1 && reg.Reg[BME280_REG_CTRL_MEAS] == 0x24);
+
+	// Status, ctrl_meas, status & data burst on first sample.  ctrl_meas no
+	// longer rewritten after
+	TEST_ASSERT(tph.StartSampling());
+	TEST_ASSERT(tph.Read(data));
+	i2c.ResetStats();
+	TEST_ASSERT(tph.StartSampling());
+	TEST_ASSERT(tph.Read(data));
+	TEST_ASSERT(i2c.Stats().XferCnt == 2);
+	TEST_ASSERT(reg.Reg[BME280_REG_CTRL_MEAS] == (0x24 | BME280_REG_CTRL_MEAS_MODE_NORMAL));
+	TEST_ASSERT(data.Temperature == 2508);
+
+	return true;
+}
+
+// Sensor reading one data register, data ready output enabled by register 0x38
+class SimTestDrdySensor : public Sensor {
+public:
+	bool Init(DeviceIntrf *pIntrf, int DevAddr) {
+		Interface(pIntrf);
+		DeviceAddess(DevAddr);
+		Mode(SENSOR_OPMODE_CONTINUOUS, 100);
+		return true;
+	}
+	bool Enable() { return true; }
+	void Disable() {}
+	void Reset() {}
+	bool StartSampling() { return true; }
+	bool UpdateData() {
+		uint8_t ra = 0x3B;
+		vData = Read8(&ra, 1);
+		return true;
+	}
+
+	uint8_t vData;
+
+protected:
+	bool DataReadyEnable(bool bEnable) {
+		uint8_t ra = 0x38;
+		return Write8(&ra, 1, bEnable ? 1 : 0);
+	}
+};
+
+static int s_SimTestDrdyNotify = 0;
+
+static void SimTestDrdyNotify(Sensor *pSensor)
+{
+	s_SimTestDrdyNotify++;
+}
+
+static bool SimTestDataReady(void)
+{
+	static const IOPINCFG pin = { 0, 5, 0, IOPINDIR_INPUT, IOPINRES_NONE, IOPINTYPE_NORMAL };
+	static const IOPINCFG nopin = { -1, -1, 0, IOPINDIR_INPUT, IOPINRES_NONE, IOPINTYPE_NORMAL };
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	SimTestDrdySensor sensor, other;
+
+	SimIOPinReset();
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(0x68, SimRegFileInit(&reg, 0xFF, 0)));
+	TEST_ASSERT(sensor.Init(&i2c, 0x68));
+	TEST_ASSERT(other.Init(&i2c, 0x68));
+
+	TEST_ASSERT(sensor.DataReadyInt(pin, 2, 6, IOPINSENSE_HIGH_TRANSITION, SimTestDrdyNotify));
+	TEST_ASSERT(reg.Reg[0x38] == 1);
+	TEST_ASSERT(other.DataReadyInt(pin, 2, 6, IOPINSENSE_HIGH_TRANSITION) == false);
+
+	// No bus traffic until the device signals new data
+	i2c.ResetStats();
+	TEST_ASSERT(sensor.Process() == false);
+	TEST_ASSERT(i2c.Stats().XferCnt == 0);
+
+	reg.Reg[0x3B] = 0x42;
+	SimIOPinSet(0, 5, true);
+	SimIOPinSet(0, 5, false);
+	TEST_ASSERT(sensor.DataReady() && s_SimTestDrdyNotify == 1);
+	TEST_ASSERT(sensor.Process() && sensor.vData == 0x42);
+	TEST_ASSERT(sensor.Process() == false);
+	TEST_ASSERT(i2c.Stats().XferCnt == 1);
+
+	// Late worker reads once, lost event is counted
+	SimIOPinSet(0, 5, true);
+	SimIOPinSet(0, 5, false);
+	SimIOPinSet(0, 5, true);
+	TEST_ASSERT(sensor.Process() && sensor.Process() == false);
+	TEST_ASSERT(sensor.DataReadyOverrun() == 1 && i2c.Stats().XferCnt == 2);
+
+	// Back to timer polling, interrupt released
+	SimIOPinSet(0, 5, false);
+	TEST_ASSERT(sensor.DataReadyInt(nopin, 2, 6, IOPINSENSE_HIGH_TRANSITION) == false);
+	TEST_ASSERT(reg.Reg[0x38] == 0);
+	SimIOPinSet(0, 5, true);
+	TEST_ASSERT(sensor.DataReady() == false && SimIOPinIntCount(2) == 3);
+	TEST_ASSERT(other.DataReadyInt(pin, 2, 6, IOPINSENSE_HIGH_TRANSITION));
+
+	return true;
+}
+
+// Timer with manually advanced 1 usec tick
+class SimTestTimer : public Timer {
+public:
+	SimTestTimer() : vTick(0) { vnsPeriod = 1000; }
+	bool Init(const TIMER_CFG &Cfg) { return true; }
+	bool Enable() { return true; }
+	void Disable() {}
+	void Reset() { vTick = 0; }
+	uint64_t TickCount() { return vTick; }
+	uint32_t Frequency(uint32_t Freq) { return 1000000; }
+	int MaxTimerTrigger() { return 0; }
+	uint64_t EnableTimerTrigger(int TrigNo, uint64_t nsPeriod, TIMER_TRIG_TYPE Type,
+								TIMER_TRIGCB Handler, void *pContext) { return 0; }
+	void DisableTimerTrigger(int TrigNo) {}
+	int FindAvailTimerTrigger(void) { return -1; }
+
+	uint64_t vTick;
+};
+
+#define SIMTEST_IMU_NBSAMPLE	1000
+
+static ACCELSENSOR_DATA s_SimTestAccel[SIMTEST_IMU_NBSAMPLE];
+static int s_SimTestAccelCnt = 0;
+static int s_SimTestGyroCnt = 0;
+static bool s_SimTestGyroOk = true;
+
+static void SimTestAccelBatch(AccelSensor *pSensor, const ACCELSENSOR_DATA *pData, int Count)
+{
+	for (int i = 0; i < Count && s_SimTestAccelCnt < SIMTEST_IMU_NBSAMPLE; i++)
+	{
+		s_SimTestAccel[s_SimTestAccelCnt++] = pData[i];
+	}
+}
+
+static void SimTestGyroBatch(GyroSensor *pSensor, const GYROSENSOR_DATA *pData, int Count)
+{
+	for (int i = 0; i < Count; i++)
+	{
+		if (pData[i].x != -(s_SimTestGyroCnt + i) || pData[i].z != 7)
+		{
+			s_SimTestGyroOk = false;
+		}
+	}
+	s_SimTestGyroCnt += Count;
+}
+
+static bool SimTestImuFifo(void)
+{
+	static const IOPINCFG pin = { 0, 7, 0, IOPINDIR_INPUT, IOPINRES_NONE, IOPINTYPE_NORMAL };
+	ACCELSENSOR_CFG cfg = {
+		MPU9250_I2C_DEV_ADDR0, SENSOR_OPMODE_CONTINUOUS, 500, false, -1, -1, NULL
+	};
+	SimDevIntrf i2c;
+	SIMMPU9250 mpu;
+	SimTestTimer timer;
+	AgmMpu9250 imu;
+	ACCELSENSOR_DATA data;
+	int wakeup = 0;
+
+	SimIOPinReset();
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(MPU9250_I2C_DEV_ADDR0, SimMpu9250Init(&mpu, false)));
+	TEST_ASSERT(imu.Init(cfg, &i2c, &timer));
+
+	// Wake on motion interrupt stays enabled
+	mpu.RegFile.Reg[MPU9250_AG_INT_ENABLE] = MPU9250_AG_INT_ENABLE_WOM_EN;
+	TEST_ASSERT(imu.DataReadyInt(pin, 3, 6, IOPINSENSE_HIGH_TRANSITION));
+	TEST_ASSERT(mpu.RegFile.Reg[MPU9250_AG_INT_ENABLE] ==
+				(MPU9250_AG_INT_ENABLE_WOM_EN | MPU9250_AG_INT_ENABLE_RAW_RDY_EN));
+
+	// 1 kHz, drained by 10
+	TEST_ASSERT(imu.FifoWatermark(10, SimTestAccelBatch) == 10);
+	TEST_ASSERT(imu.FifoWatermark(10, SimTestGyroBatch) == 10);
+
+	i2c.ResetStats();
+	for (int i = 0; i < SIMTEST_IMU_NBSAMPLE; i++)
+	{
+		int16_t a[3] = { (int16_t)i, (int16_t)(i * 2), -3 };
+		int16_t g[3] = { (int16_t)-i, 0, 7 };
+
+		timer.vTick += 1000;
+		SimMpu9250Sample(&mpu, a, g);
+		SimIOPinSet(0, 7, true);
+		SimIOPinSet(0, 7, false);
+
+		// One drain late by 4 frames
+		if (imu.DataReady() && (i < 499 || i > 502))
+		{
+			wakeup++;
+			TEST_ASSERT(imu.Process());
+		}
+	}
+
+	// FIFO count & 1 burst per watermark instead of 1 read per sample
+	TEST_ASSERT(wakeup == SIMTEST_IMU_NBSAMPLE / 10);
+	TEST_ASSERT(i2c.Stats().XferCnt == 2 * SIMTEST_IMU_NBSAMPLE / 10);
+	TEST_ASSERT(s_SimTestAccelCnt == SIMTEST_IMU_NBSAMPLE && s_SimTestGyroCnt == SIMTEST_IMU_NBSAMPLE);
+	TEST_ASSERT(s_SimTestGyroOk);
+	for (int i = 0; i < SIMTEST_IMU_NBSAMPLE; i++)
+	{
+		TEST_ASSERT(s_SimTestAccel[i].x == i && s_SimTestAccel[i].y == (int16_t)(i * 2) &&
+					s_SimTestAccel[i].z == -3);
+	}
+
+	// Watermark frame at interrupt time, others at measured period once
+	// two watermarks were seen
+	TEST_ASSERT(s_SimTestAccel[9].Timestamp == 10000);
+	for (int i = 10; i < SIMTEST_IMU_NBSAMPLE; i++)
+	{
+		TEST_ASSERT(s_SimTestAccel[i].Timestamp == (uint32_t)(i + 1) * 1000);
+	}
+
+	GYROSENSOR_DATA gdata;
+
+	TEST_ASSERT(imu.Read(&gdata));
+	TEST_ASSERT(gdata.x == -(SIMTEST_IMU_NBSAMPLE - 1) && gdata.z == 7);
+	TEST_ASSERT(gdata.Timestamp == SIMTEST_IMU_NBSAMPLE * 1000);
+
+	// Back to single sample reads
+	TEST_ASSERT(imu.FifoWatermark(0, (ACCELBATCHCB)NULL) == 0);
+	int16_t a[3] = { 100, 200, 300 }, g[3] = { 0, 0, 0 };
+	SimMpu9250Sample(&mpu, a, g);
+	TEST_ASSERT(mpu.FifoCnt == 0);
+	TEST_ASSERT(imu.Read(&data));
+	TEST_ASSERT(data.x == 100 && data.y == 200 && data.z == 300);
+
+	return true;
+}
+
+// Samples queued with timestamps, read in place across the wrap around
+static bool SimTestSampleQueue(void)
+{
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	TphBme280 tph;
+	TPHSENSOR_CFG cfg = {
+		BME280_I2C_DEV_ADDR0, SENSOR_OPMODE_SINGLE, 1000, 1, 1, 1, 0, NULL
+	};
+	TPHSENSOR_DATA data, *p;
+	uint8_t mem[SENSOR_SAMPLEQUE_MEMSIZE(4, sizeof(TPHSENSOR_DATA))];
+	uint64_t t;
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(BME280_I2C_DEV_ADDR0, SimBme280Init(&reg, false)));
+	TEST_ASSERT(tph.Init(cfg, &i2c, NULL));
+
+	// Not enabled
+	TEST_ASSERT(tph.StartSampling() && tph.Read(data));
+	TEST_ASSERT(tph.TphPeek(&p, 4) == 0);
+
+	TEST_ASSERT(tph.TphQueue(mem, sizeof(mem)));
+
+	// 6 samples in a queue of 4, last 2 dropped
+	for (int i = 0; i < 6; i++)
+	{
+		TEST_ASSERT(tph.StartSampling() && tph.Read(data));
+	}
+	TEST_ASSERT(tph.TphQueStat().PutCnt == 4 && tph.TphQueStat().OvrCnt == 2);
+	TEST_ASSERT(tph.TphPeek(&p, 8) == 4);
+	TEST_ASSERT(p[0].Temperature == 2508 && p[3].Timestamp > p[0].Timestamp);
+	t = p[3].Timestamp;
+	tph.TphRelease(3);
+
+	// Wraps around, contiguous samples first
+	TEST_ASSERT(tph.StartSampling() && tph.Read(data));
+	TEST_ASSERT(tph.StartSampling() && tph.Read(data));
+	TEST_ASSERT(tph.TphPeek(&p, 8) == 1);
+	TEST_ASSERT(p[0].Timestamp == t);
+	tph.TphRelease(1);
+	TEST_ASSERT(tph.TphPeek(&p, 8) == 2);
+	TEST_ASSERT(p[0].Timestamp > t && p[1].Timestamp == data.Timestamp);
+	tph.TphRelease(2);
+	TEST_ASSERT(tph.TphPeek(&p, 8) == 0);
+
+	return true;
+}
+
+// Native scatter-gather and legacy fallback must look the same on the bus
+static bool SimTestTransfer(void)
+{
+	SimDevIntrf i2c;
+	SIMREGFILE reg;
+	uint8_t ad = 0x10, d0[2] = { 1, 2 }, d1[2] = { 3, 4 }, rd0[1], rd1[3];
+	DEVINTRF_SEG wrseg[3] = { { &ad, 1, false }, { d0, 2, false }, { d1, 2, false } };
+	DEVINTRF_SEG rdseg[3] = { { &ad, 1, false }, { rd0, 1, true }, { rd1, 3, true } };
+	SIMINTRF_STATS stats = {};
+
+	TEST_ASSERT(i2c.Init(s_I2cCfg));
+	TEST_ASSERT(i2c.Attach(0x76, SimRegFileInit(&reg, 0xFF, 0)));
+
+	for (int i = 0; i < 2; i++)
+	{
+		if (i == 1)
+		{
+			// Legacy interface
+			((DEVINTRF *)i2c)->Transfer = NULL;
+			memset(reg.Reg, 0, sizeof(reg.Reg));
+		}
+
+		i2c.ResetStats();
+		TEST_ASSERT(i2c.Transfer(0x76, wrseg, 3) == 5);
+		TEST_ASSERT(reg.Reg[0x10] == 1 && reg.Reg[0x13] == 4);
+
+		memset(rd1, 0, sizeof(rd1));
+		TEST_ASSERT(i2c.Transfer(0x76, rdseg, 3) == 5);
+		TEST_ASSERT(rd0[0] == 1 && rd1[0] == 2 && rd1[2] == 4);
+
+		// Start + restart for the read
+		TEST_ASSERT(i2c.Stats().XferCnt == 2 && i2c.Stats().StartCnt == 3);
+
+		if (i == 0)
+		{
+			stats = i2c.Stats();
+		}
+		else
+		{
+			TEST_ASSERT(i2c.Stats().BusNs == stats.BusNs);
+		}
+	}
+
+	// No device
+	TEST_ASSERT(i2c.Transfer(0x77, wrseg, 3) == 0);
+
+	return true;
+}
+
+bool SimIntrfTest(void)
+{
+	return SimTestFlash() && SimTestSDCard() && SimTestDiskCache() && SimTestWriteBack() && SimTestMultiSect() &&
+		   SimTestPrefetch() && SimTestSectSize() && SimTestFlashSectSize() &&
+		   SimTestEeprom() && SimTestBme280() &&
+		   SimTestTransfer() && SimTestRegCache() && SimTestReadRegs() &&
+		   SimTestDevReg() && SimTestRegScript() && SimTestBme280Cache() && SimTestDataReady() &&
+		   SimTestImuFifo() && SimTestSampleQueue();
+}
@@ -0,0 +1,80 @@
+/**-------------------------------------------------------------------------
+@file	test.h
+
+@brief	Minimal unit test framework for host build
+
+Each test suite is a function returning true on success.  Suites are listed
+in ehal_test.c and can be run individually by name.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+/// Fail current test suite if condition is false
+#define TEST_ASSERT(Cond)	do { if (!(Cond)) { \
+								printf("%s:%d: FAIL: %s\n", __FILE__, __LINE__, #Cond); \
+								return false; } } while (0)
+
+/// Test suite function
+typedef bool (*TESTSUITE)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool CFifoTest(void);
+bool CrcTest(void);
+bool ShaTest(void);
+bool Base64Test(void);
+bool Utf8Test(void);
+bool IHexTest(void);
+bool SimIntrfTest(void);
+bool TraceTest(void);
+bool AsyncTest(void);
+bool ArbTest(void);
+bool FusionTest(void);
+
+#ifdef CFIFO_STATS
+bool CFifoStatsTest(void);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TEST_H__
@@ -0,0 +1,155 @@
+/**-------------------------------------------------------------------------
+@file	trace_test.c
+
+@brief	DEVINTRF transaction tracer unit tests
+
+Traffic is generated on the simulated bus with simulated bus time as trace
+clock.  Tests are skipped when the library is built without DEVINTRF_TRACE.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "device_intrf.h"
+#include "sim_intrf.h"
+#include "test.h"
+
+#ifdef DEVINTRF_TRACE
+
+#define TRACETEST_NBREC		8
+#define TRACETEST_ADDR		0x76
+
+static SIMINTRFDEV s_SimDev;
+static SIMREGFILE s_RegFile;
+static uint32_t s_TraceMem[DEVTRACE_MEMSIZE(TRACETEST_NBREC) / 4 + 1];
+static uint8_t s_DumpBuff[sizeof(DEVTRACE_HDR) + TRACETEST_NBREC * sizeof(DEVTRACE_REC)];
+
+static const SIMINTRF_CFG s_I2cCfg = {
+	SIMINTRF_BUS_I2C, 400000, 2000, 0, 2, 0
+};
+
+static uint32_t TraceTestClock(void)
+{
+	return (uint32_t)SimIntrfTime(&s_SimDev);
+}
+
+static DEVTRACE_REC *TraceTestRec(int Idx)
+{
+	return (DEVTRACE_REC *)&s_DumpBuff[sizeof(DEVTRACE_HDR) + Idx * sizeof(DEVTRACE_REC)];
+}
+
+bool TraceTest(void)
+{
+	DEVTRACE trace;
+	DEVINTRF *intrf = &s_SimDev.DevIntrf;
+	DEVTRACE_HDR *hdr = (DEVTRACE_HDR *)s_DumpBuff;
+	DEVTRACE_REC *rec;
+	uint8_t reg = 0x10, d[4] = { 1, 2, 3, 4 }, rd[4];
+	uint32_t t;
+
+	TEST_ASSERT(SimIntrfInit(&s_SimDev, &s_I2cCfg));
+	TEST_ASSERT(SimIntrfAttach(&s_SimDev, TRACETEST_ADDR, SimRegFileInit(&s_RegFile, 0xFF, 0)));
+	TEST_ASSERT(DevTraceInit(&trace, (uint8_t *)s_TraceMem, DEVTRACE_MEMSIZE(TRACETEST_NBREC),
+							 TraceTestClock, 1000000000));
+
+	// Not traced until attached
+	TEST_ASSERT(DeviceIntrfWrite(intrf, TRACETEST_ADDR, &reg, 1, d, 4) == 4);
+	DeviceIntrfTrace(intrf, &trace);
+	TEST_ASSERT(DevTraceDump(&trace, s_DumpBuff, sizeof(s_DumpBuff)) == sizeof(DEVTRACE_HDR));
+	TEST_ASSERT(hdr->Magic == DEVTRACE_MAGIC && hdr->NbRec == 0);
+
+	t = TraceTestClock();
+	TEST_ASSERT(DeviceIntrfWrite(intrf, TRACETEST_ADDR, &reg, 1, d, 4) == 4);
+	t = TraceTestClock() - t;
+	TEST_ASSERT(DeviceIntrfRead(intrf, TRACETEST_ADDR, &reg, 1, rd, 4) == 4);
+	TEST_ASSERT(memcmp(rd, d, 4) == 0);
+
+	// Absent device, all retries used
+	TEST_ASSERT(DeviceIntrfRx(intrf, 0x50, rd, 4) == 0);
+
+	// Contention, one busy record per attempt
+	intrf->Busy = 1;
+	TEST_ASSERT(DeviceIntrfTx(intrf, TRACETEST_ADDR, d, 2) == 0);
+	intrf->Busy = 0;
+
+	TEST_ASSERT(DevTraceDump(&trace, s_DumpBuff, sizeof(s_DumpBuff)) ==
+				sizeof(DEVTRACE_HDR) + 7 * sizeof(DEVTRACE_REC));
+	TEST_ASSERT(hdr->Magic == DEVTRACE_MAGIC && hdr->Version == DEVTRACE_VERSION);
+	TEST_ASSERT(hdr->RecSize == sizeof(DEVTRACE_REC) && hdr->ClockRate == 1000000000);
+	TEST_ASSERT(hdr->NbRec == 7 && hdr->DropCnt == 0);
+
+	rec = TraceTestRec(0);
+	TEST_ASSERT(rec->Evt == DEVTRACE_EVT_WRITE && rec->DevAddr == TRACETEST_ADDR);
+	TEST_ASSERT(rec->ReqLen == 4 && rec->Len == 4 && rec->Retry == 0);
+	TEST_ASSERT(rec->Dur == t && t > 0);
+
+	rec = TraceTestRec(1);
+	TEST_ASSERT(rec->Evt == DEVTRACE_EVT_READ && rec->Len == 4 && rec->Retry == 0);
+	TEST_ASSERT(rec->Time == TraceTestRec(0)->Time + t);
+
+	rec = TraceTestRec(2);
+	TEST_ASSERT(rec->Evt == DEVTRACE_EVT_RX && rec->DevAddr == 0x50);
+	TEST_ASSERT(rec->ReqLen == 4 && rec->Len == 0 && rec->Retry == 2);
+
+	for (int i = 3; i < 6; i++)
+	{
+		TEST_ASSERT(TraceTestRec(i)->Evt == DEVTRACE_EVT_BUSY);
+	}
+	rec = TraceTestRec(6);
+	TEST_ASSERT(rec->Evt == DEVTRACE_EVT_TX && rec->Len == 0 && rec->Retry == 2);
+	TEST_ASSERT(rec->Dur == 0);
+
+	// Overflow drops newest records, partial dump leaves the rest
+	for (int i = 0; i < TRACETEST_NBREC + 3; i++)
+	{
+		TEST_ASSERT(DeviceIntrfRead(intrf, TRACETEST_ADDR, &reg, 1, rd, 1) == 1);
+	}
+	TEST_ASSERT(DevTraceDump(&trace, s_DumpBuff, sizeof(DEVTRACE_HDR) + 3 * sizeof(DEVTRACE_REC) + 1) ==
+				sizeof(DEVTRACE_HDR) + 3 * sizeof(DEVTRACE_REC));
+	TEST_ASSERT(hdr->NbRec == 3 && hdr->DropCnt == 3);
+	TEST_ASSERT(DevTraceDump(&trace, s_DumpBuff, sizeof(s_DumpBuff)) ==
+				sizeof(DEVTRACE_HDR) + (TRACETEST_NBREC - 3) * sizeof(DEVTRACE_REC));
+	TEST_ASSERT(hdr->NbRec == TRACETEST_NBREC - 3 && hdr->DropCnt == 0);
+
+	DeviceIntrfTrace(intrf, NULL);
+	TEST_ASSERT(DeviceIntrfRead(intrf, TRACETEST_ADDR, &reg, 1, rd, 1) == 1);
+	TEST_ASSERT(DevTraceDump(&trace, s_DumpBuff, sizeof(s_DumpBuff)) == sizeof(DEVTRACE_HDR));
+
+	return true;
+}
+
+#else
+
+bool TraceTest(void)
+{
+	return true;
+}
+
+#endif // DEVINTRF_TRACE
@@ -0,0 +1,61 @@
+/**-------------------------------------------------------------------------
+@file	utf8_test.c
+
+@brief	UTF-8 conversion unit tests
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include <wchar.h>
+
+#include "utf8.h"
+#include "test.h"
+
+bool Utf8Test(void)
+{
+	// 'a', e acute, euro sign
+	static const char s_Utf8[] = "a\xc3\xa9\xe2\x82\xac";
+	wchar_t wc[8];
+	char utf[16];
+	int srclen = 6, dstlen = 8;
+
+	TEST_ASSERT(utf8towcs(s_Utf8, &srclen, wc, &dstlen) == 0);
+	TEST_ASSERT(srclen == 6 && dstlen == 3);
+	TEST_ASSERT(wc[0] == L'a' && wc[1] == 0xe9 && wc[2] == 0x20ac);
+
+	srclen = 3;
+	dstlen = sizeof(utf);
+	TEST_ASSERT(wcstoutf8(wc, &srclen, utf, &dstlen) == 0);
+	TEST_ASSERT(srclen == 3 && dstlen == 6);
+	TEST_ASSERT(memcmp(utf, s_Utf8, 6) == 0);
+
+	return true;
+}
@@ -0,0 +1,222 @@
+/**-------------------------------------------------------------------------
+@file	devtrace.c
+
+@brief	DEVINTRF binary trace summary
+
+Usage : devtrace [trace file]...
+
+Reads traces made of chunks dumped with DevTraceDump and prints per device
+address transfer counts, bytes, retries, busy contention & timing.  Reads
+stdin when no file is given.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "device_intrf_trace.h"
+
+#define DEVTRACE_MAX_ADDR		64
+
+/// Per device address summary
+typedef struct {
+	int DevAddr;
+	uint32_t Cnt[DEVTRACE_EVT_MAX];	//!< Records per event type
+	uint32_t FailCnt;				//!< Transfers returning 0 byte
+	uint32_t ShortCnt;				//!< Transfers returning less than requested
+	uint32_t RetryCnt;				//!< Total retries used
+	uint64_t RxBytes;
+	uint64_t TxBytes;
+	uint64_t XferBytes;				//!< Scatter-gather, both directions
+	uint64_t TotalDur;				//!< Total transfer duration in ticks
+	uint32_t MaxDur;				//!< Longest transfer in ticks
+} DEVTRACE_SUM;
+
+static const char * const s_EvtName[DEVTRACE_EVT_MAX] = {
+	"rx", "tx", "read", "write", "busy", "xfer"
+};
+
+static DEVTRACE_SUM s_Sum[DEVTRACE_MAX_ADDR];
+static int s_NbSum = 0;
+static uint64_t s_NbRec = 0;
+static uint64_t s_DropCnt = 0;
+static uint32_t s_ClockRate = 0;
+
+static DEVTRACE_SUM *FindSum(int DevAddr)
+{
+	for (int i = 0; i < s_NbSum; i++)
+	{
+		if (s_Sum[i].DevAddr == DevAddr)
+			return &s_Sum[i];
+	}
+
+	if (s_NbSum >= DEVTRACE_MAX_ADDR)
+		return NULL;
+
+	memset(&s_Sum[s_NbSum], 0, sizeof(DEVTRACE_SUM));
+	s_Sum[s_NbSum].DevAddr = DevAddr;
+
+	return &s_Sum[s_NbSum++];
+}
+
+static void AddRecord(const DEVTRACE_REC *pRec)
+{
+	DEVTRACE_SUM *sum = FindSum(pRec->DevAddr);
+
+	if (sum == NULL || pRec->Evt >= DEVTRACE_EVT_MAX)
+		return;
+
+	sum->Cnt[pRec->Evt]++;
+
+	if (pRec->Evt == DEVTRACE_EVT_BUSY)
+		return;
+
+	if (pRec->Len == 0)
+		sum->FailCnt++;
+	else if (pRec->Len < pRec->ReqLen)
+		sum->ShortCnt++;
+
+	if (pRec->Evt == DEVTRACE_EVT_RX || pRec->Evt == DEVTRACE_EVT_READ)
+		sum->RxBytes += pRec->Len;
+	else if (pRec->Evt == DEVTRACE_EVT_XFER)
+		sum->XferBytes += pRec->Len;
+	else
+		sum->TxBytes += pRec->Len;
+
+	sum->RetryCnt += pRec->Retry;
+	sum->TotalDur += pRec->Dur;
+	if (pRec->Dur > sum->MaxDur)
+		sum->MaxDur = pRec->Dur;
+}
+
+// Returns false on malformed trace
+static bool ReadTrace(FILE *pFile, const char *pName)
+{
+	DEVTRACE_HDR hdr;
+	DEVTRACE_REC rec;
+
+	while (fread(&hdr, sizeof(DEVTRACE_HDR), 1, pFile) == 1)
+	{
+		if (hdr.Magic != DEVTRACE_MAGIC || hdr.Version != DEVTRACE_VERSION ||
+			hdr.RecSize != sizeof(DEVTRACE_REC))
+		{
+			fprintf(stderr, "%s : bad chunk header\n", pName);
+
+			return false;
+		}
+
+		if (s_ClockRate == 0)
+			s_ClockRate = hdr.ClockRate;
+
+		s_DropCnt += hdr.DropCnt;
+
+		for (uint32_t i = 0; i < hdr.NbRec; i++)
+		{
+			if (fread(&rec, sizeof(DEVTRACE_REC), 1, pFile) != 1)
+			{
+				fprintf(stderr, "%s : truncated chunk\n", pName);
+
+				return false;
+			}
+			AddRecord(&rec);
+			s_NbRec++;
+		}
+	}
+
+	return true;
+}
+
+// Ticks to usec, raw ticks when clock rate unknown
+static double TickUs(uint64_t Ticks)
+{
+	return s_ClockRate ? (double)Ticks * 1000000.0 / s_ClockRate : (double)Ticks;
+}
+
+static void PrintSummary(void)
+{
+	printf("%llu records, %llu dropped, time in %s\n\n", (unsigned long long)s_NbRec,
+		   (unsigned long long)s_DropCnt, s_ClockRate ? "usec" : "ticks");
+
+	printf("%6s", "addr");
+	for (int j = 0; j < DEVTRACE_EVT_MAX; j++)
+		printf(" %7s", s_EvtName[j]);
+	printf(" %6s %6s %6s %10s %10s %10s %10s %10s %10s\n", "fail", "short", "retry",
+		   "rx bytes", "tx bytes", "xfer bytes", "total", "avg", "max");
+
+	for (int i = 0; i < s_NbSum; i++)
+	{
+		DEVTRACE_SUM *sum = &s_Sum[i];
+		uint32_t nxfer = 0;
+
+		printf("0x%04x", sum->DevAddr);
+		for (int j = 0; j < DEVTRACE_EVT_MAX; j++)
+		{
+			printf(" %7u", sum->Cnt[j]);
+			if (j != DEVTRACE_EVT_BUSY)
+				nxfer += sum->Cnt[j];
+		}
+
+		printf(" %6u %6u %6u %10llu %10llu %10llu %10.1f %10.1f %10.1f\n", sum->FailCnt,
+			   sum->ShortCnt, sum->RetryCnt, (unsigned long long)sum->RxBytes,
+			   (unsigned long long)sum->TxBytes, (unsigned long long)sum->XferBytes,
+			   TickUs(sum->TotalDur), nxfer ? TickUs(sum->TotalDur) / nxfer : 0.0,
+			   TickUs(sum->MaxDur));
+	}
+}
+
+int main(int argc, char **argv)
+{
+	bool res = true;
+
+	if (argc < 2)
+	{
+		res = ReadTrace(stdin, "stdin");
+	}
+
+	for (int i = 1; i < argc; i++)
+	{
+		FILE *fp = fopen(argv[i], "rb");
+
+		if (fp == NULL)
+		{
+			fprintf(stderr, "%s : can't open\n", argv[i]);
+			res = false;
+			continue;
+		}
+
+		res &= ReadTrace(fp, argv[i]);
+		fclose(fp);
+	}
+
+	PrintSummary();
+
+	return res ? 0 : 1;
+}
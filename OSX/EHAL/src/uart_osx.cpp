@@ -295,6 +295,10 @@ bool UARTInit(UARTDEV *pDev, const UARTCFG *pCfgData)
     pDev->DevIntrf.StartTx = OsxUARTStartTx;
     pDev->DevIntrf.TxData = OsxUARTTxData;
     pDev->DevIntrf.StopTx = OsxUARTStopTx;
+    pDev->DevIntrf.Transfer = NULL;
+#ifdef DEVINTRF_TRACE
+    pDev->DevIntrf.pTrace = NULL;
+#endif
     pDev->DevIntrf.Busy = false;
     
     return true;
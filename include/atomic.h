@@ -267,6 +267,97 @@ static inline void AtomicClear(void *pVar) {
 }
 #endif // __TSOK__
 
+/**
+ * Atomic load with acquire ordering
+ *
+ * Memory accesses after this load can not be reordered before it.  Pair it
+ * with AtomicStoreRelease on the writer side.
+ *
+ * @Param   pVar   : Pointer to data value to be read
+ *
+ * @Return  Value read
+ */
+#if defined(__TSOK__) || defined(__ADSPBLACKFIN__)
+
+sig_atomic_t AtomicLoadAcquire(sig_atomic_t *pVar);
+
+#else
+
+static inline sig_atomic_t AtomicLoadAcquire(sig_atomic_t *pVar) {
+
+#if defined(_WIN32) || defined(WIN32)
+	sig_atomic_t val = *(volatile sig_atomic_t *)pVar;
+	MemoryBarrier();
+	return val;
+#elif defined(__TCS__)
+	return *(volatile sig_atomic_t *)pVar;
+#elif defined(__GNUC__)
+   return __atomic_load_n(pVar, __ATOMIC_ACQUIRE);
+#endif
+}
+#endif // __TSOK__
+
+/**
+ * Atomic store with release ordering
+ *
+ * Memory accesses before this store can not be reordered after it.  Used to
+ * publish data written before the store to a reader using AtomicLoadAcquire.
+ *
+ * @Param   pVar   : Pointer to data value to be assigned
+ * @param   NewVal : New value to be assigned to pVar
+ */
+#if defined(__TSOK__) || defined(__ADSPBLACKFIN__)
+
+void AtomicStoreRelease(sig_atomic_t *pVar, sig_atomic_t NewVal);
+
+#else
+
+static inline void AtomicStoreRelease(sig_atomic_t *pVar, sig_atomic_t NewVal) {
+
+#if defined(_WIN32) || defined(WIN32)
+	MemoryBarrier();
+	*(volatile sig_atomic_t *)pVar = NewVal;
+#elif defined(__TCS__)
+	*(volatile sig_atomic_t *)pVar = NewVal;
+#elif defined(__GNUC__)
+   __atomic_store_n(pVar, NewVal, __ATOMIC_RELEASE);
+#endif
+}
+#endif // __TSOK__
+
+/**
+ * Atomic compare and exchange
+ *
+ * Assign NewVal to pVar only if pVar still contains ExpVal.
+ *
+ * @Param   pVar   : Pointer to data value to be updated
+ * @param   ExpVal : Expected current value of pVar
+ * @param   NewVal : New value to be assigned to pVar
+ *
+ * @Return  true - pVar was updated
+ */
+#if defined(__TSOK__) || defined(__ADSPBLACKFIN__)
+
+bool AtomicCompareExchange(sig_atomic_t *pVar, sig_atomic_t ExpVal, sig_atomic_t NewVal);
+
+#else
+
+static inline bool AtomicCompareExchange(sig_atomic_t *pVar, sig_atomic_t ExpVal, sig_atomic_t NewVal) {
+
+#if defined(_WIN32) || defined(WIN32)
+	return InterlockedCompareExchange((LONG *)pVar, (LONG)NewVal, (LONG)ExpVal) == (LONG)ExpVal;
+#elif defined(__TCS__)
+	#pragma TCS_atomic
+	if (*pVar != ExpVal)
+		return false;
+	*pVar = NewVal;
+	return true;
+#elif defined(__GNUC__)
+   return __atomic_compare_exchange_n(pVar, &ExpVal, NewVal, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+#endif
+}
+#endif // __TSOK__
+
 #if defined(_WIN32) || defined(WIN32)
 #else
 static inline uint32_t EnterCriticalSection(void) {
@@ -286,17 +377,21 @@ static inline void ExitCriticalSection(uint32_t State) {
 }
 #endif
 
-#ifdef __arm__
 static inline uint32_t DisableInterrupt() {
+#ifdef __arm__
 	uint32_t __primmask = __get_PRIMASK();
 	__disable_irq();
 	return __primmask;
+#else
+	return 0;
+#endif
 }
 
 static inline void EnableInterrupt(uint32_t __primmask) {
+#ifdef __arm__
 	__set_PRIMASK(__primmask);
-}
 #endif
+}
 
 #endif // __ATOMIC_H__
 
@@ -4,7 +4,35 @@
 @brief	Implementation of an overly simple circular FIFO buffer.
 
 There is no queuing implementation and non blocking to be able to be use in
-interrupt. User must ensure thread safety when used in a threaded environment.
+interrupt.
+
+In blocking mode the FIFO is lock-free single producer/single consumer.  The
+producer only writes PutIdx and the consumer only writes GetIdx.  Indices are
+published with release ordering and read with acquire ordering.  Put functions
+can be called from one context (interrupt or thread) and Get functions from
+another without extra locking.
+
+In drop mode (bBlocking = false) the producer also advances GetIdx when the
+FIFO is full.  This is done with compare and exchange so that it remains safe
+against the consumer.  Peeked blocks are not protected in this mode, CFifoRelease
+only removes the peeked blocks the producer has not already pushed out.
+
+The MPSC flavor, initialized with CFifoInitMpsc, allows multiple producers to
+share one FIFO.  Producers claim a block by compare and exchange on PutIdx and
+publish it by updating a per block sequence number.  The consumer only reads
+blocks that have been published, in order.  The sequence array is taken from
+the FIFO memory, so the same memory holds fewer blocks than the SPSC flavor.
+
+The C++ CFifo<BlkSize, NbBlk> template allocates a FIFO with power of 2 geometry
+known at compile time.  Its inline Get/Put use masks and shifts instead of
+compare and wrap.  The memory layout is the same as CFifoInit so the C functions
+can be used on it as well.
+
+Statistics (high-water mark, put/get counts, full & drop counts, dwell time
+histogram) are available when compiled with CFIFO_STATS defined.  Without it
+the statistics code and API are compiled out entirely.  The header keeps its
+statistics pointer either way so that the FIFO memory layout does not depend
+on the define.
 
 @author Hoang Nguyen Hoan
 @date 	Jan. 3, 2014
@@ -44,22 +72,89 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
   * @{
   */
 
+#ifndef CFIFO_CACHELINE_SIZE
+#ifdef __arm__
+#define CFIFO_CACHELINE_SIZE		32		//!< Cortex-M7 cache line size
+#else
+#define CFIFO_CACHELINE_SIZE		64		//!< Host cache line size
+#endif
+#endif
+
+typedef struct __CFIFO_Stats	CFIFOSTATS;
+
+#ifdef CFIFO_STATS
+
+#ifndef CFIFO_STATS_HIST_SIZE
+#define CFIFO_STATS_HIST_SIZE		16		//!< Number of dwell time histogram bins
+#endif
+
+/// @brief	Clock function used to timestamp blocks for dwell time statistics.
+///
+/// Tick unit is defined by the user (cycle counter, timer tick, etc...).  Only
+/// differences are used, the counter is allowed to wrap.
+///
+/// @return	Current tick count
+typedef uint32_t (*CFIFOCLOCK)(void);
+
+/// @brief	CFIFO statistics.
+///
+/// Counters updated from the put side are owned by the producer, the ones updated
+/// from the get side are owned by the consumer.  On MPSC FIFOs the put side
+/// counters are approximate when producers preempt each others.
+struct __CFIFO_Stats {
+	uint32_t PutCnt;			//!< Number of blocks published to consumer
+	uint32_t GetCnt;			//!< Number of blocks retrieved by consumer
+	uint32_t FullCnt;			//!< Number of blocks rejected, FIFO full in blocking mode
+	uint32_t DropCnt;			//!< Number of old blocks pushed out, FIFO full in drop mode
+	int32_t HighWater;			//!< Highest number of blocks used
+	uint32_t DwellHist[CFIFO_STATS_HIST_SIZE];	//!< Dwell time histogram. Bin 0 counts
+								//!< 0 tick, bin n counts [2^(n-1), 2^n) ticks,
+								//!< last bin counts all above
+	CFIFOCLOCK Clock;			//!< Clock function for timestamps. NULL for no dwell time
+	uint32_t *pTimeStamp;		//!< Per block enqueue time, MaxIdxCnt entries
+};
+
+#endif // CFIFO_STATS
+
 #pragma pack(push,4)
 
-/// Header defining a circular fifo memory block.
+/// @brief	Header defining a circular fifo memory block.
+///
+/// PutIdx & GetIdx are free running in the range [0, 2 * MaxIdxCnt).  Using
+/// twice the block count allows to distinguish between full and empty without
+/// a separate state.  Each index is on its own cache line to avoid false
+/// sharing between producer & consumer.
 typedef struct __CFIFO_Header {
-	volatile int32_t PutIdx;	//!< Index to start of empty data block
-	volatile int32_t GetIdx;	//!< Index to start of used data block
 	int32_t MaxIdxCnt;			//!< Max block count
 	bool    bBlocking;          //!< False to push out when FIFO is full (drop)
-	uint32_t DropCnt;           //!< Count dropped block
 	uint32_t BlkSize;			//!< Block size in bytes
 	uint32_t MemSize;			//!< Total FIFO memory size allocated
 	uint8_t *pMemStart;			//!< Start of FIFO data memory
+	int32_t *pSeq;				//!< Per block sequence numbers, MPSC flavor only. NULL otherwise
+	CFIFOSTATS *pStats;			//!< Statistics. NULL if not enabled
+	uint8_t Pad1[CFIFO_CACHELINE_SIZE];
+	volatile int32_t PutIdx;	//!< Index to start of empty data block. Owned by producer
+	uint32_t DropCnt;           //!< Count dropped block. Owned by producer
+	uint8_t Pad2[CFIFO_CACHELINE_SIZE - 8];
+	volatile int32_t GetIdx;	//!< Index to start of used data block. Owned by consumer
+	int32_t PeekIdx;			//!< Index of first peeked block not yet released. Owned by consumer
+	uint8_t Pad3[CFIFO_CACHELINE_SIZE - 8];
 } CFIFOHDR;
 
 #pragma pack(pop)
 
+/// Max number of spans returned by CFifoReserve & CFifoPeek. Data wraps at most once.
+#define CFIFO_SPAN_MAX			2
+
+/// @brief	Contiguous region of FIFO memory.
+///
+/// Used by the two phases functions CFifoReserve/CFifoCommit and CFifoPeek/CFifoRelease
+/// to give direct access to FIFO memory.
+typedef struct __CFIFO_Span {
+	uint8_t *pBlk;				//!< Pointer to first block of the span
+	int Cnt;					//!< Number of consecutive blocks in the span
+} CFIFOSPAN;
+
 /// @brief	CFIFO handle.
 ///
 /// This handle is used for all CFIFO function calls. It is the pointer to to CFIFO memory block.
@@ -72,6 +167,10 @@ typedef CFIFOHDR*	HCFIFO;
 /// This macro calculates total memory require in bytes including header for block based FIFO.
 #define CFIFO_TOTAL_MEMSIZE(NbBlk, BlkSize)		((NbBlk) * (BlkSize) + sizeof(CFIFOHDR))
 
+/// This macro calculates total memory require in bytes including header and sequence
+/// numbers for a MPSC FIFO holding NbBlk blocks.
+#define CFIFO_MPSC_TOTAL_MEMSIZE(NbBlk, BlkSize)	((NbBlk) * ((BlkSize) + sizeof(int32_t)) + sizeof(CFIFOHDR))
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -92,7 +191,29 @@ extern "C" {
  *
  * 	@return CFifo Handle
  */
-HCFIFO CFifoInit(uint8_t *pMemBlk, uint32_t TotalMemSize, uint32_t BlkSize, bool bDrop);
+HCFIFO CFifoInit(uint8_t *pMemBlk, uint32_t TotalMemSize, uint32_t BlkSize, bool bBlocking);
+
+/**
+ * @brief	Initialize multiple producers, single consumer FIFO.
+ *
+ * Producers from any context (interrupts, timer handlers, threads) write to the
+ * FIFO using CFifoClaim/CFifoPublish or CFifoWrite.  The consumer uses the
+ * regular Get, Peek/Release and Read functions.  The FIFO is always blocking,
+ * a claim fails when the FIFO is full.
+ *
+ * CFifoPut, CFifoPutMultiple, CFifoReserve and CFifoCommit are single producer
+ * functions and do nothing on a MPSC FIFO.
+ *
+ * Memory sized with CFIFO_TOTAL_MEMSIZE can be used as is, the FIFO will then
+ * hold fewer blocks.  Use CFIFO_MPSC_TOTAL_MEMSIZE to get the exact block count.
+ *
+ * @param	pMemBlk 		: Pointer to memory block to be used for FIFO
+ * @param	TotalMemSize	: Total memory size in byte
+ * @param	BlkSize 		: Block size in bytes
+ *
+ * 	@return CFifo Handle. NULL if memory is too small for 2 blocks
+ */
+HCFIFO CFifoInitMpsc(uint8_t *pMemBlk, uint32_t TotalMemSize, uint32_t BlkSize);
 
 /**
  * @brief	Retrieve FIFO data by returning pointer to FIFO memory block for reading.
@@ -143,31 +264,124 @@ uint8_t *CFifoPut(HCFIFO hFifo);
  */
 uint8_t *CFifoPutMultiple(HCFIFO hFifo, int *pCnt);
 
+/**
+ * @brief	Claim one block of a MPSC FIFO for writing.
+ *
+ * Safe to be called concurrently by multiple producers.  The block is not visible
+ * to the consumer until it is published with CFifoPublish.  Blocks are consumed
+ * in claim order, a claimed block that is not yet published holds back the
+ * blocks claimed after it.
+ *
+ * @param	hFifo : CFIFO handle
+ *
+ * @return	Pointer to the claimed block. NULL if FIFO is full
+ */
+uint8_t *CFifoClaim(HCFIFO hFifo);
+
+/**
+ * @brief	Publish a block claimed by CFifoClaim to the consumer.
+ *
+ * @param	hFifo : CFIFO handle
+ * @param	pBlk  : Pointer returned by CFifoClaim
+ */
+void CFifoPublish(HCFIFO hFifo, uint8_t *pBlk);
+
+/**
+ * @brief	Reserve FIFO blocks for writing without publishing them.
+ *
+ * First phase of a zero copy write.  The reserved blocks are not visible to the
+ * consumer until CFifoCommit is called.  This allows DMA or packet handler to fill
+ * the blocks in place.  Only one reservation can be pending at a time.
+ *
+ * In drop mode, old blocks are pushed out to make room for the requested count.
+ *
+ * @param	hFifo : CFIFO handle
+ * @param	Cnt   : Number of blocks to reserve
+ * @param	pSpan : Pointer to array of CFIFO_SPAN_MAX spans to receive the reserved
+ * 					memory regions. Second span has Cnt = 0 if data does not wrap
+ *
+ * @return	Total number of blocks reserved
+ */
+int CFifoReserve(HCFIFO hFifo, int Cnt, CFIFOSPAN *pSpan);
+
+/**
+ * @brief	Publish reserved blocks to the consumer.
+ *
+ * Second phase of a zero copy write.
+ *
+ * @param	hFifo : CFIFO handle
+ * @param	Cnt   : Number of blocks to publish.  Must not exceed the count
+ * 					returned by CFifoReserve
+ */
+void CFifoCommit(HCFIFO hFifo, int Cnt);
+
+/**
+ * @brief	Get direct access to FIFO blocks for reading without removing them.
+ *
+ * First phase of a zero copy read.  The blocks remain owned by the consumer and
+ * can not be overwritten by the producer in blocking mode until CFifoRelease is called.
+ *
+ * @param	hFifo : CFIFO handle
+ * @param	Cnt   : Number of blocks to get
+ * @param	pSpan : Pointer to array of CFIFO_SPAN_MAX spans to receive the memory
+ * 					regions. Second span has Cnt = 0 if data does not wrap
+ *
+ * @return	Total number of blocks available in the spans
+ */
+int CFifoPeek(HCFIFO hFifo, int Cnt, CFIFOSPAN *pSpan);
+
+/**
+ * @brief	Remove blocks from FIFO after reading.
+ *
+ * Second phase of a zero copy read.  Released blocks are returned to the producer.
+ *
+ * In drop mode the release is counted from the index of the last CFifoPeek.
+ * Blocks pushed out by the producer since then are not released a second time.
+ *
+ * @param	hFifo : CFIFO handle
+ * @param	Cnt   : Number of blocks to release.  Must not exceed the count
+ * 					returned by CFifoPeek
+ */
+void CFifoRelease(HCFIFO hFifo, int Cnt);
+
 /**
  * @brief	Retrieve FIFO data into provided buffer
  *
+ * Data is copied with at most 2 memcpy, one per contiguous region.  Only whole
+ * blocks are read, BuffLen is rounded down to a multiple of the block size.  No
+ * data is discarded.
+ *
  * @param	hFifo : CFIFO handle
  * @param	pBuff : Pointer to buffer container for returned data
  * @param	BuffLen : Size of container in bytes
  *
- * @return	Number of bytes copied into pBuff
+ * @return	Number of bytes copied into pBuff, a multiple of the block size
  */
-int CFifoPop(HCFIFO hFifo, uint8_t *pBuff, int BuffLen);
+int CFifoRead(HCFIFO hFifo, uint8_t *pBuff, int BuffLen);
 
 /**
  * @brief	Insert FIFO data with provided data
  *
+ * Data is copied with at most 2 memcpy, one per contiguous region.  When DataLen
+ * is not a multiple of the block size, the last block is partially filled.
+ *
+ * On a MPSC FIFO each block is claimed, copied and published separately.  Blocks
+ * from concurrent producers may interleave.
+ *
  * @param	hFifo : CFIFO handle
  * @param	pData : Pointer to data to be inserted
  * @param	DataLen : Size of data in bytes
  *
  * @return	Number of bytes inserted into FIFO
  */
-int CFifoPush(HCFIFO hFifo, uint8_t *pData, int DataLen);
+int CFifoWrite(HCFIFO hFifo, uint8_t *pData, int DataLen);
 
 /**
  * @brief	Reset FIFO
  *
+ * All blocks currently in the FIFO are discarded.  This must be called from
+ * the consumer side.
+ *
  * @param	hFifo : CFIFO handle
  */
 void CFifoFlush(HCFIFO hFifo);
@@ -190,9 +404,154 @@ int CFifoAvail(HCFIFO hFifo);
  */
 int CFifoUsed(HCFIFO hFifo);
 
+#ifdef CFIFO_STATS
+/**
+ * @brief	Enable statistics on a FIFO.
+ *
+ * Statistics are cleared.  Can be called again to reset them.  Must be called
+ * when the FIFO is not in use.
+ *
+ * @param	hFifo 		: CFIFO handle
+ * @param	pStats		: Pointer to statistics memory, must remain valid
+ * 						  while statistics are enabled.  NULL to disable
+ * @param	pTimeStamp	: Pointer to MaxIdxCnt timestamp entries for dwell time.
+ * 						  NULL for no dwell time
+ * @param	Clock		: Clock function for timestamps. NULL for no dwell time
+ */
+void CFifoStatsInit(HCFIFO hFifo, CFIFOSTATS *pStats, uint32_t *pTimeStamp, CFIFOCLOCK Clock);
+
+/**
+ * @brief	Get snapshot of FIFO statistics.
+ *
+ * @param	hFifo 	: CFIFO handle
+ * @param	pStats	: Pointer to statistics to be filled
+ *
+ * @return	false - Statistics are not enabled on this FIFO
+ */
+bool CFifoGetStats(HCFIFO hFifo, CFIFOSTATS *pStats);
+#endif // CFIFO_STATS
+
 #ifdef __cplusplus
 }
-#endif
+
+#include "atomic.h"
+
+/// @brief	Statically allocated CFIFO with compile time geometry.
+///
+/// Both BlkSize and NbBlk must be powers of 2.  Index and address computations
+/// are constant folded to masks and shifts.  The memory layout is the same as a
+/// FIFO created by CFifoInit, the handle can be passed to any C function or
+/// driver expecting a HCFIFO such as UARTDEV::hRxFifo.
+///
+/// Inline Get/Put/Used/Avail are single producer, single consumer.  Drop mode and
+/// statistics are handled by the C functions.
+///
+/// @tparam	BlkSize : Block size in bytes
+/// @tparam	NbBlk	: Number of blocks
+template <uint32_t BlkSize, int32_t NbBlk>
+class CFifo {
+	static_assert(BlkSize > 0 && (BlkSize & (BlkSize - 1)) == 0, "CFifo BlkSize must be a power of 2");
+	static_assert(NbBlk > 0 && (NbBlk & (NbBlk - 1)) == 0, "CFifo NbBlk must be a power of 2");
+
+	static const int32_t IdxMask = (NbBlk << 1) - 1;
+
+public:
+	/**
+	 * @brief	Construct and initialize FIFO
+	 *
+	 * @param   bBlocking	: false - Old data will be pushed out when full
+	 * 						  true  - New data will not be pushed in when full
+	 */
+	CFifo(bool bBlocking = true) { CFifoInit(vMem, sizeof(vMem), BlkSize, bBlocking); }
+
+	/**
+	 * @brief	Get C handle of the FIFO
+	 *
+	 * @return	CFIFO handle
+	 */
+	HCFIFO Handle() { return (HCFIFO)vMem; }
+	operator HCFIFO() { return Handle(); }
+
+	/**
+	 * @brief	Retrieve one block. See CFifoGet
+	 *
+	 * @return	Pointer to the block or NULL if empty
+	 */
+	uint8_t *Get() {
+		HCFIFO hfifo = Handle();
+
+		// Drop mode & statistics go through the generic path
+		if (hfifo->bBlocking == false || hfifo->pStats)
+			return CFifoGet(hfifo);
+
+		int32_t idx = hfifo->GetIdx;
+
+		if (idx == AtomicLoadAcquire((sig_atomic_t *)&hfifo->PutIdx))
+			return NULL;
+
+		AtomicStoreRelease((sig_atomic_t *)&hfifo->GetIdx, (idx + 1) & IdxMask);
+
+		return BlkAddr(idx);
+	}
+
+	/**
+	 * @brief	Insert one block. See CFifoPut
+	 *
+	 * @return	Pointer to the block or NULL if full
+	 */
+	uint8_t *Put() {
+		HCFIFO hfifo = Handle();
+
+		// Drop mode & statistics go through the generic path
+		if (hfifo->bBlocking == false || hfifo->pStats)
+			return CFifoPut(hfifo);
+
+		int32_t idx = hfifo->PutIdx;
+
+		if (((idx - AtomicLoadAcquire((sig_atomic_t *)&hfifo->GetIdx)) & IdxMask) >= NbBlk)
+			return NULL;
+
+		AtomicStoreRelease((sig_atomic_t *)&hfifo->PutIdx, (idx + 1) & IdxMask);
+
+		return BlkAddr(idx);
+	}
+
+	int Read(uint8_t *pBuff, int BuffLen) { return CFifoRead(Handle(), pBuff, BuffLen); }
+	int Write(uint8_t *pData, int DataLen) { return CFifoWrite(Handle(), pData, DataLen); }
+	int Reserve(int Cnt, CFIFOSPAN *pSpan) { return CFifoReserve(Handle(), Cnt, pSpan); }
+	void Commit(int Cnt) { CFifoCommit(Handle(), Cnt); }
+	int Peek(int Cnt, CFIFOSPAN *pSpan) { return CFifoPeek(Handle(), Cnt, pSpan); }
+	void Release(int Cnt) { CFifoRelease(Handle(), Cnt); }
+	void Flush() { CFifoFlush(Handle()); }
+
+	/**
+	 * @brief	Get number of used blocks
+	 *
+	 * @return	Number of FIFO block used
+	 */
+	int Used() {
+		HCFIFO hfifo = Handle();
+
+		return (AtomicLoadAcquire((sig_atomic_t *)&hfifo->PutIdx) -
+				AtomicLoadAcquire((sig_atomic_t *)&hfifo->GetIdx)) & IdxMask;
+	}
+
+	/**
+	 * @brief	Get number of blocks available for writing
+	 *
+	 * @return	Number of FIFO block available
+	 */
+	int Avail() { return NbBlk - Used(); }
+
+private:
+	uint8_t *BlkAddr(int32_t Idx) {
+		return vMem + sizeof(CFIFOHDR) + (Idx & (NbBlk - 1)) * BlkSize;
+	}
+
+	alignas(CFIFO_CACHELINE_SIZE) uint8_t vMem[CFIFO_TOTAL_MEMSIZE(NbBlk, BlkSize)];
+};
+
+#endif	// __cplusplus
 
 /** @} end group FIFO */
 
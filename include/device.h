@@ -40,14 +40,130 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdint.h>
 #include <string.h>
+#ifdef __cplusplus
+#include <type_traits>
+#endif
 
 #ifndef __cplusplus
 #include <stdbool.h>
 #endif
 
 #include "device_intrf.h"
+#include "device_intrf_async.h"
 #include "iopincfg.h"
 
+/** @name	Register cache attributes
+  * Registers not listed in the descriptor are volatile, always accessed on the bus.
+  * @{
+  */
+#define DEVREG_ATTR_VOLATILE	0			//!< Not cached (status, data...)
+#define DEVREG_ATTR_CACHED		(1<<0)		//!< Reads served from shadow once value is known
+#define DEVREG_ATTR_WRONLY		(1<<1)		//!< Write only, never read back.  Reads return shadow, 0 if unknown
+#define DEVREG_ATTR_TRIGGER		(1<<2)		//!< Write has side effect, never elided nor deferred
+#define DEVREG_ATTR_RSTVAL		(1<<3)		//!< Reset value known, shadow valid after RegCacheReset
+/** @} */
+
+/// Register cache descriptor entry.  Range of 8 bits registers sharing attributes
+typedef struct __Dev_Reg_Desc {
+	uint8_t Addr;			//!< First register address
+	uint8_t Count;			//!< Number of consecutive registers
+	uint8_t Attr;			//!< DEVREG_ATTR_xxx flags
+	uint8_t RstVal;			//!< Value after device reset, for DEVREG_ATTR_RSTVAL
+} DEVREG_DESC;
+
+/// Register cache statistics
+typedef struct __Dev_Reg_Cache_Stats {
+	uint32_t HitCnt;		//!< Reads served from shadow
+	uint32_t MissCnt;		//!< Reads of cached registers going to the bus
+	uint32_t ElideCnt;		//!< Writes dropped, register already holds the value
+	uint32_t FlushCnt;		//!< Burst writes issued by flush
+} DEVREGCACHE_STATS;
+
+/// Memory required for a cache spanning NbReg register addresses, value + state each
+#define DEVREGCACHE_MEMSIZE(NbReg)		((NbReg) * 2)
+
+/// Register cache, owned by the driver.  Setup with Device::RegCacheInit
+typedef struct __Dev_Reg_Cache {
+	const DEVREG_DESC *pDesc;	//!< Register descriptor table
+	int NbDesc;					//!< Number of descriptor entries
+	uint8_t Base;				//!< Lowest described register address
+	int Size;					//!< Number of register addresses covered from Base
+	uint8_t *pVal;				//!< Shadow values
+	uint8_t *pState;			//!< Attributes & state per register, private
+	bool bAutoIncr;				//!< Device increments register address on burst write
+	bool bDefer;				//!< Writes are kept dirty until flushed
+	DEVREGCACHE_STATS Stats;
+} DEVREGCACHE;
+
+#define DEVREG_READ_MAXREQ		16		//!< Max requests per Device::ReadRegs call
+#define DEVREG_READ_MAXBURST	64		//!< Max size of a merged burst read
+
+/// Default max gap in bytes read to merge 2 ranges.  A transaction costs
+/// about 4 bytes on I2C (start, dev address, register, restart, dev address)
+/// and a few byte times of CS setup & register address on SPI.
+#define DEVREG_READ_MAXGAP		4
+
+/// Register block read request for Device::ReadRegs
+typedef struct __Dev_Reg_Read {
+	uint8_t Addr;			//!< First register address
+	int Len;				//!< Number of registers to read
+	uint8_t *pBuff;			//!< Destination buffer, Len bytes
+	int Count;				//!< Bytes read, set by ReadRegs
+} DEVREG_READ;
+
+/// Register script opcodes
+typedef enum __Dev_Reg_Op {
+	DEVREG_OP_END,			//!< End of script
+	DEVREG_OP_WR,			//!< Write Val to Reg
+	DEVREG_OP_RMW,			//!< Read Reg, replace bits in Mask by Val & write back
+	DEVREG_OP_DELAY,		//!< Wait Time usec
+	DEVREG_OP_POLL,			//!< Read Reg until (Reg & Mask) == Val, fail after Time usec
+} DEVREG_OP;
+
+/// Register script step.  A script is an array of steps ending with DEVREG_OP_END
+typedef struct __Dev_Reg_Step {
+	uint8_t Op;				//!< DEVREG_OP_xxx
+	uint8_t Reg;			//!< Register address
+	uint8_t Mask;			//!< Bits modified by RMW, tested by POLL
+	uint8_t Val;			//!< Value written, expected by POLL
+	uint32_t Time;			//!< DELAY time, POLL timeout in usec
+} DEVREG_STEP;
+
+#define DEVREG_SCRIPT_MAXBURST		16		//!< Max registers written per burst
+#define DEVREG_SCRIPT_MAXXACT		4		//!< Max queued transactions in flight
+#define DEVREG_POLL_INTERVAL		100		//!< POLL read interval in usec
+#ifndef DEVREG_SCRIPT_TIMEOUT
+#define DEVREG_SCRIPT_TIMEOUT		20000	//!< Max wait before queued writes not started are cancelled, in usec
+#endif
+#define DEVREG_SCRIPT_WAIT_INTERVAL	10		//!< Queued writes check interval in usec
+
+#ifdef __cplusplus
+
+/// @name	Register script steps.  constexpr so static scripts are placed in flash.
+/// @{
+constexpr DEVREG_STEP DevRegWr(uint8_t Reg, uint8_t Val) {
+	return DEVREG_STEP{ DEVREG_OP_WR, Reg, 0xFF, Val, 0 };
+}
+
+constexpr DEVREG_STEP DevRegRmw(uint8_t Reg, uint8_t Mask, uint8_t Val) {
+	return DEVREG_STEP{ DEVREG_OP_RMW, Reg, Mask, Val, 0 };
+}
+
+constexpr DEVREG_STEP DevRegDelay(uint32_t uSec) {
+	return DEVREG_STEP{ DEVREG_OP_DELAY, 0, 0, 0, uSec };
+}
+
+constexpr DEVREG_STEP DevRegPoll(uint8_t Reg, uint8_t Mask, uint8_t Val, uint32_t TimeoutUs) {
+	return DEVREG_STEP{ DEVREG_OP_POLL, Reg, Mask, Val, TimeoutUs };
+}
+
+constexpr DEVREG_STEP DevRegEnd() {
+	return DEVREG_STEP{ DEVREG_OP_END, 0, 0, 0, 0 };
+}
+/// @}
+
+#endif // __cplusplus
+
 #ifdef __cplusplus
 
 /// @brief	Device base class
@@ -143,13 +259,56 @@ public:
 	 * @return	Actual number of bytes written
 	 */
 	virtual int Write(uint8_t *pCmdAddr, int CmdAddrLen, uint8_t *pData, int DataLen) {
-		if (vpIntrf) {
-			return vpIntrf->Write(vDevAddr, pCmdAddr, CmdAddrLen, pData, DataLen);
+		if (vpIntrf && pCmdAddr) {
+			// Command & data are sent as 2 segments of a single transaction, no staging copy
+			// unless the interface does not implement Transfer
+			DEVINTRF_SEG seg[2] = {
+				{ pCmdAddr, CmdAddrLen, false },
+				{ pData, DataLen, false }
+			};
+			int count = vpIntrf->Transfer(vDevAddr, seg, pData != NULL && DataLen > 0 ? 2 : 1);
+
+			return count > CmdAddrLen ? count - CmdAddrLen : 0;
 		}
 
 		return 0;
 	}
 
+	/**
+	 * @brief	Read a set of register blocks with the fewest transactions.
+	 *
+	 * Requests are sorted by address.  Ranges closer than MaxGap are merged
+	 * into a single burst read, the gap registers being read & discarded,
+	 * then data is scattered to each request buffer.  Requires a device
+	 * auto incrementing register address on burst read.  Registers with
+	 * read side effects (FIFO, clear on read...) must not sit in a gap.
+	 * Reads bypass the register cache.
+	 *
+	 * @param	pReq	: Array of requests, Count set on return
+	 * @param	NbReq	: Number of requests, max DEVREG_READ_MAXREQ
+	 * @param	MaxGap	: Max number of unused registers read to merge 2 ranges
+	 *
+	 * @return	Number of requests completely read
+	 */
+	int ReadRegs(DEVREG_READ *pReq, int NbReq, int MaxGap = DEVREG_READ_MAXGAP);
+
+	/**
+	 * @brief	Execute a register script.
+	 *
+	 * Consecutive writes to consecutive registers are sent as one burst on
+	 * auto increment devices.  When a transaction queue is set, writes are
+	 * submitted without waiting and the script only blocks on read, delay,
+	 * poll & end steps.  Queued writes go straight to the interface, not
+	 * through the Write override of the driver.
+	 *
+	 * @param	pScript		: Steps, terminated by DevRegEnd()
+	 * @param	bAutoIncr	: true - device auto increments register address on burst write
+	 *
+	 * @return	true - Success\n
+	 * 			false - write failure or poll timeout, script aborted
+	 */
+	bool RegScriptRun(const DEVREG_STEP *pScript, bool bAutoIncr);
+
 	/**
 	 * @brief	Read device's 8 bits register/memory
 	 *
@@ -160,6 +319,9 @@ public:
 	 */
 	virtual uint8_t Read8(uint8_t *pRegAddr, int RegAddrLen) {
 		uint8_t val = 0;
+		if (vpRegCache && RegAddrLen == 1) {
+			return RegCacheRead8(*pRegAddr);
+		}
 		Read(pRegAddr, RegAddrLen, &val, 1);
 		return val;
 	}
@@ -167,6 +329,9 @@ public:
 	/**
 	 * @brief	Read device's 16 bits register/memory
 	 *
+	 * Data is returned as transfered, in host byte order.  Use DevReg to read
+	 * registers in device byte order.
+	 *
 	 * @param 	pRegAddr	: Buffer containing address location to read
 	 * @param	RegAddrLen	: Address buffer size
 	 *
@@ -181,6 +346,9 @@ public:
 	/**
 	 * @brief	Read device's 32 bit register/memory
 	 *
+	 * Data is returned as transfered, in host byte order.  Use DevReg to read
+	 * registers in device byte order.
+	 *
 	 * @param 	pRegAddr	: Buffer containing address location to read
 	 * @param	RegAddrLen	: Address buffer size
 	 *
@@ -202,12 +370,18 @@ public:
 	 * @return	true - Success
 	 */
 	virtual bool Write8(uint8_t *pRegAddr, int RegAddrLen, uint8_t Data) {
+		if (vpRegCache && RegAddrLen == 1) {
+			return RegCacheWrite8(*pRegAddr, Data);
+		}
 		return Write(pRegAddr, RegAddrLen, &Data, 1) > 0;
 	}
 
 	/**
 	 * @brief	Write 16 bits data to device's register/memory
 	 *
+	 * Data is transfered in host byte order.  Use DevReg to write registers in
+	 * device byte order.
+	 *
 	 * @param 	pRegAddr	: Buffer containing address location to write
 	 * @param	RegAddrLen	: Address buffer size
 	 * @param	Data		: Data to be written to the device
@@ -221,6 +395,9 @@ public:
 	/**
 	 * @brief	Write 32 bits data to device's register/memory
 	 *
+	 * Data is transfered in host byte order.  Use DevReg to write registers in
+	 * device byte order.
+	 *
 	 * @param 	pRegAddr	: Buffer containing address location to write
 	 * @param	RegAddrLen	: Address buffer size
 	 * @param	Data		: Data to be written to the device
@@ -228,7 +405,7 @@ public:
 	 * @return	true - Success
 	 */
 	virtual bool Write32(uint8_t *pRegAddr, int RegAddrLen, uint32_t Data) {
-		return Write(pRegAddr, RegAddrLen, (uint8_t*)&Data, 1) > 3;
+		return Write(pRegAddr, RegAddrLen, (uint8_t*)&Data, 4) > 3;
 	}
 
 	/**
@@ -240,7 +417,113 @@ public:
 	 */
 	bool Valid() { return vbValid; }
 
+	/**
+	 * @brief	Get register cache
+	 *
+	 * @return	Register cache in use or NULL
+	 */
+	DEVREGCACHE *RegCache() { return vpRegCache; }
+
 protected:
+	/**
+	 * @brief	Enable register cache.
+	 *
+	 * Once enabled, Read8 & Write8 with 1 byte register address go through the
+	 * cache.  Cached registers are read from the device once then served from
+	 * the shadow, writes of unchanged values are dropped.  Read/Write of
+	 * register blocks bypass the cache, call RegCacheInvalidate if they modify
+	 * cached registers.
+	 *
+	 * @param	pCache		: Cache data, owned by the driver
+	 * @param	pDesc		: Register descriptor table
+	 * @param	NbDesc		: Number of descriptor entries
+	 * @param	pMem		: Cache memory
+	 * @param	MemSize		: Size of cache memory, DEVREGCACHE_MEMSIZE(address span of pDesc)
+	 * @param	bAutoIncr	: true - device auto increments register address on
+	 * 						  burst write.  Flush coalesces contiguous dirty registers
+	 *
+	 * @return	true - Success
+	 */
+	bool RegCacheInit(DEVREGCACHE *pCache, const DEVREG_DESC *pDesc, int NbDesc,
+					  uint8_t *pMem, int MemSize, bool bAutoIncr);
+
+	/**
+	 * @brief	Mark all cached values unknown.  Pending writes are dropped.
+	 */
+	void RegCacheInvalidate();
+
+	/**
+	 * @brief	Reload cache after device reset.
+	 *
+	 * Registers with known reset value become valid, others unknown.
+	 */
+	void RegCacheReset();
+
+	/**
+	 * @brief	Defer register writes.
+	 *
+	 * While deferred, Write8 only updates the shadow.  Rewriting a register
+	 * before flush costs nothing.  Trigger registers flush pending writes then
+	 * are written immediately to keep ordering.
+	 *
+	 * @param	bDefer	: true - defer writes\n
+	 * 					  false - flush & write through
+	 *
+	 * @return	false if flush failed
+	 */
+	bool RegCacheDefer(bool bDefer);
+
+	/**
+	 * @brief	Write dirty registers to the device.
+	 *
+	 * Each run of contiguous dirty registers is written in a single burst on
+	 * auto increment devices.  Gaps of known non volatile registers are
+	 * bridged with their shadow value.
+	 *
+	 * @return	true - Success
+	 */
+	bool RegCacheFlush();
+
+	/**
+	 * @brief	Cached 8 bits register read
+	 *
+	 * @param	RegAddr	: Register address
+	 *
+	 * @return	Register value
+	 */
+	uint8_t RegCacheRead8(uint8_t RegAddr);
+
+	/**
+	 * @brief	Cached 8 bits register write
+	 *
+	 * @param	RegAddr	: Register address
+	 * @param	Data	: Value to write
+	 *
+	 * @return	true - Success
+	 */
+	bool RegCacheWrite8(uint8_t RegAddr, uint8_t Data);
+
+	/**
+	 * @brief	Update shadow after registers were written outside of the cache
+	 *
+	 * @param	RegAddr	: First register address
+	 * @param	pData	: Values written
+	 * @param	Len		: Number of registers
+	 */
+	void RegCacheStore(uint8_t RegAddr, const uint8_t *pData, int Len);
+
+	/**
+	 * @brief	Wait for queued register script writes to complete.
+	 *
+	 * Writes not started within DEVREG_SCRIPT_TIMEOUT are cancelled.  Shadow
+	 * is updated for the writes that succeeded.
+	 *
+	 * @param	pQue	: Script writes in flight
+	 *
+	 * @return	true - all writes succeeded
+	 */
+	bool RegScriptWait(struct __Dev_Reg_Script_Que *pQue);
+
 	/**
 	 * @brief	Store device id.
 	 *
@@ -273,11 +556,196 @@ protected:
 	 */
 	DeviceIntrf *Interface() { return vpIntrf; }
 
+	/**
+	 * @brief	Set transaction queue of the interface, used by register scripts
+	 *
+	 * @param	pQue : Queue executing on the device interface, NULL for none
+	 */
+	void Queue(DEVINTRFQUE *pQue) { vpQue = pQue; }
+
+	/**
+	 * @brief	Get transaction queue
+	 *
+	 * @return	Queue in use or NULL
+	 */
+	DEVINTRFQUE *Queue() { return vpQue; }
+
 	bool			vbValid;			//!< Device is valid ready to use (passed detection)
 	uint32_t 	vDevAddr;		//!< Device address or chip select
 	DeviceIntrf *vpIntrf;		//!< Device's interface
 	uint64_t		vDevId;			//!< This is implementation specific data for device identifier
 	 	 	 	 	 	 	 	//!< could be value reg from hardware register or serial number
+	DEVREGCACHE *vpRegCache;	//!< Register cache, NULL if not used
+	DEVINTRFQUE *vpQue;			//!< Interface transaction queue, NULL if not used
+};
+
+/// Register byte order
+typedef enum __Dev_Reg_Endian {
+	DEVREG_ENDIAN_LITTLE,	//!< Least significant byte at lowest address
+	DEVREG_ENDIAN_BIG,		//!< Most significant byte at lowest address
+} DEVREG_ENDIAN;
+
+// Byte order codec, unrolled at compile time.  The compiler folds it into a
+// plain load or a byte swap instruction.
+template <DEVREG_ENDIAN Endian, int NbBytes, typename U>
+struct __DevRegCodec {
+	static inline U Get(const uint8_t *p) {
+		return Endian == DEVREG_ENDIAN_BIG ?
+			   (U)((__DevRegCodec<Endian, NbBytes - 1, U>::Get(p) << 8) | p[NbBytes - 1]) :
+			   (U)(((U)p[NbBytes - 1] << (8 * (NbBytes - 1))) | __DevRegCodec<Endian, NbBytes - 1, U>::Get(p));
+	}
+	static inline void Put(uint8_t *p, U Val) {
+		if (Endian == DEVREG_ENDIAN_BIG) {
+			p[NbBytes - 1] = (uint8_t)Val;
+			__DevRegCodec<Endian, NbBytes - 1, U>::Put(p, Val >> 8);
+		}
+		else {
+			p[NbBytes - 1] = (uint8_t)(Val >> (8 * (NbBytes - 1)));
+			__DevRegCodec<Endian, NbBytes - 1, U>::Put(p, Val);
+		}
+	}
+};
+
+template <DEVREG_ENDIAN Endian, typename U>
+struct __DevRegCodec<Endian, 0, U> {
+	static inline U Get(const uint8_t *) { return 0; }
+	static inline void Put(uint8_t *, U) {}
+};
+
+/**
+ * @brief	Decode a multi-byte register value from transfered bytes.
+ *
+ * Usage : DevRegGet<uint32_t, DEVREG_ENDIAN_BIG, 3>(d) for a 24 bits big endian ADC.
+ *
+ * @param	p : Register bytes as transfered
+ *
+ * @return	Value, NbBytes wide, not sign extended
+ */
+template <typename T, DEVREG_ENDIAN Endian, int NbBytes = sizeof(T)>
+inline T DevRegGet(const uint8_t *p) {
+	static_assert(NbBytes > 0 && NbBytes <= 8, "Register width must be 1 to 8 bytes");
+	return (T)__DevRegCodec<Endian, NbBytes, typename std::conditional<(NbBytes > 4), uint64_t, uint32_t>::type>::Get(p);
+}
+
+/**
+ * @brief	Encode a multi-byte register value to bytes to transfer.
+ *
+ * @param	p	: Destination, NbBytes long
+ * @param	Val	: Value to encode
+ */
+template <typename T, DEVREG_ENDIAN Endian, int NbBytes = sizeof(T)>
+inline void DevRegPut(uint8_t *p, T Val) {
+	static_assert(NbBytes > 0 && NbBytes <= 8, "Register width must be 1 to 8 bytes");
+	typedef typename std::conditional<(NbBytes > 4), uint64_t, uint32_t>::type U;
+	__DevRegCodec<Endian, NbBytes, U>::Put(p, (U)Val);
+}
+
+/// @brief	Multi-byte register of a device.
+///
+/// Describes at compile time register address, width & byte order.  Read and
+/// Write are a single burst of NbBytes, decoding is a load or byte swap
+/// instead of per driver shift & or.  Decode from a block is used on data
+/// read with ReadRegs or a larger burst.
+///
+/// Usage :
+/// @code
+/// typedef DevReg<int16_t, DEVREG_ENDIAN_BIG, MPU9250_AG_ACCEL_XOUT_H> AccelX;
+///
+/// int16_t x = AccelX::Read(*this);
+/// int16_t y = AccelY::Decode(d, MPU9250_AG_ACCEL_XOUT_H);
+/// @endcode
+template <typename T, DEVREG_ENDIAN Endian, uint8_t Addr, int NbBytes = sizeof(T)>
+struct DevReg {
+	typedef T Type;
+	static const uint8_t Address = Addr;	//!< First register address
+	static const int Size = NbBytes;		//!< Number of bytes
+
+	/// Decode from register bytes
+	static inline T Decode(const uint8_t *pData) {
+		return DevRegGet<T, Endian, NbBytes>(pData);
+	}
+
+	/// Decode from a block of registers starting at BlockAddr
+	static inline T Decode(const uint8_t *pBlock, uint8_t BlockAddr) {
+		return DevRegGet<T, Endian, NbBytes>(&pBlock[Addr - BlockAddr]);
+	}
+
+	/// Encode to register bytes
+	static inline void Encode(uint8_t *pData, T Val) {
+		DevRegPut<T, Endian, NbBytes>(pData, Val);
+	}
+
+	/// Read register from device, 0 on failure
+	static inline T Read(Device &Dev) {
+		uint8_t reg = Addr;
+		uint8_t d[NbBytes];
+
+		if (Dev.Read(&reg, 1, d, NbBytes) != NbBytes)
+			return 0;
+
+		return Decode(d);
+	}
+
+	/// Write register to device
+	static inline bool Write(Device &Dev, T Val) {
+		uint8_t reg = Addr;
+		uint8_t d[NbBytes];
+
+		Encode(d, Val);
+
+		return Dev.Write(&reg, 1, d, NbBytes) == NbBytes;
+	}
+};
+
+/// @brief	Bit field packed in a multi-byte register.
+///
+/// Width bits starting at bit Shift of the NbBytes wide register value.  The
+/// field is sign extended when T is signed.
+///
+/// Usage, 20 bits BME280 pressure ADC in bits 23..4 of PRESS_MSB/LSB/XLSB :
+/// @code
+/// typedef DevRegBits<uint32_t, DEVREG_ENDIAN_BIG, BME280_REG_PRESS_MSB, 3, 4, 20> AdcP;
+/// @endcode
+template <typename T, DEVREG_ENDIAN Endian, uint8_t Addr, int NbBytes, int Shift, int Width>
+struct DevRegBits {
+	static_assert(Shift + Width <= NbBytes * 8, "Bit field exceeds register");
+	static_assert(Width <= (int)sizeof(T) * 8, "Bit field exceeds type");
+
+	typedef T Type;
+	typedef typename std::conditional<(NbBytes > 4), uint64_t, uint32_t>::type Raw;
+	static const uint8_t Address = Addr;	//!< First register address
+	static const int Size = NbBytes;		//!< Number of bytes
+
+	/// Decode from register bytes
+	static inline T Decode(const uint8_t *pData) {
+		Raw v = DevRegGet<Raw, Endian, NbBytes>(pData) >> Shift;
+
+		if (Width < (int)sizeof(Raw) * 8) {
+			Raw m = ((Raw)1 << (Width % (sizeof(Raw) * 8))) - 1;
+			v &= m;
+			if (std::is_signed<T>::value && (v >> (Width - 1)) != 0) {
+				v |= ~m;
+			}
+		}
+
+		return (T)v;
+	}
+
+	/// Decode from a block of registers starting at BlockAddr
+	static inline T Decode(const uint8_t *pBlock, uint8_t BlockAddr) {
+		return Decode(&pBlock[Addr - BlockAddr]);
+	}
+
+	/// Read register from device & extract field, 0 on failure
+	static inline T Read(Device &Dev) {
+		uint8_t reg = Addr;
+		uint8_t d[NbBytes];
+
+		if (Dev.Read(&reg, 1, d, NbBytes) != NbBytes)
+			return 0;
+
+		return Decode(d);
+	}
 };
 
 extern "C" {
@@ -41,6 +41,9 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdint.h>
 #include <stdbool.h>
 #include "atomic.h"
+#ifdef DEVINTRF_TRACE
+#include "device_intrf_trace.h"
+#endif
 
 /** @addtogroup device_intrf	Device Interface
   * @{
@@ -90,6 +93,17 @@ typedef struct __device_intrf DEVINTRF;
  */
 typedef int (*DEVINTRF_EVTCB)(DEVINTRF *pDev, DEVINTRF_EVT EvtId, uint8_t *pBuffer, int BufferLen);
 
+/// @brief	Transfer segment for DeviceIntrfTransfer.
+///
+/// A transaction is a list of segments sent or received in order within a
+/// single start/stop.  Changing direction between segments is a restart
+/// condition.
+typedef struct __DevIntrf_Seg {
+	uint8_t *pData;			//!< Data to send or buffer to receive into
+	int Len;				//!< Length in bytes
+	bool bRx;				//!< true - receive into pData, false - send pData
+} DEVINTRF_SEG;
+
 #pragma pack(push, 4)
 
 /// @brief	Device interface data structure.
@@ -234,6 +248,29 @@ struct __device_intrf {
      * @return  None
 	 */
 	void (*Reset)(DEVINTRF *pDevIntrf);
+
+	/**
+	 * @brief	Optional scatter-gather transfer.
+	 *
+	 * Performs a full transaction from start to stop condition over a list of
+	 * segments without intermediate copy, for example using chained DMA
+	 * descriptors.  Busy flag is already set by caller and is released by caller.
+	 * Must be set to NULL if not implemented, DeviceIntrfTransfer then falls back
+	 * to StartTx/TxData/StartRx/RxData sequence.
+	 *
+	 * @param	pDevIntrf : Pointer to an instance of the Device Interface
+	 * @param	DevAddr   : The device selection id scheme
+	 * @param	pSeg	  : Array of segments
+	 * @param	NbSeg	  : Number of segments
+	 *
+	 * @return	Total number of bytes transfered.  Transfer stops at first short segment
+	 */
+	int (*Transfer)(DEVINTRF *pDevIntrf, int DevAddr, const DEVINTRF_SEG *pSeg, int NbSeg);
+
+#ifdef DEVINTRF_TRACE
+	DEVTRACE *pTrace;		//!< Transaction tracer, NULL if not traced. Must be
+							//!< initialized to NULL by implementation
+#endif
 };
 
 #pragma pack(pop)
@@ -242,6 +279,18 @@ struct __device_intrf {
 extern "C" {
 #endif
 
+#ifdef DEVINTRF_TRACE
+/**
+ * @brief	Attach a transaction tracer to the interface.
+ *
+ * @param	pDevIntrf : Pointer to an instance of the Device Interface
+ * @param	pTrace	  : Pointer to initialized tracer, NULL to stop tracing
+ */
+static inline void DeviceIntrfTrace(DEVINTRF *pDev, DEVTRACE *pTrace) {
+	pDev->pTrace = pTrace;
+}
+#endif
+
 /**
  * @brief	Turn off the interface.
  *
@@ -367,6 +416,23 @@ int DeviceIntrfRead(DEVINTRF *pDev, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
 int DeviceIntrfWrite(DEVINTRF *pDev, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
                      uint8_t *pData, int DataLen);
 
+/**
+ * @brief	Scatter-gather transfer.
+ *
+ * Sends and receives a list of segments within a single transaction.  Uses
+ * the interface Transfer function when available.  Otherwise consecutive
+ * segments in the same direction are combined into a single TxData or RxData
+ * call to keep DMA based interfaces from generating a stop condition in between.
+ *
+ * @param	pDevIntrf	: Pointer to an instance of the Device Interface
+ * @param	DevAddr   	: The device selection id scheme
+ * @param	pSeg		: Array of segments
+ * @param	NbSeg		: Number of segments
+ *
+ * @return	Total number of bytes transfered over all segments
+ */
+int DeviceIntrfTransfer(DEVINTRF *pDev, int DevAddr, const DEVINTRF_SEG *pSeg, int NbSeg);
+
 // Initiate receive
 // WARNING this function must be used in pair with StopRx
 // Re-entrance protection flag is used
@@ -387,8 +453,12 @@ int DeviceIntrfWrite(DEVINTRF *pDev, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
  * 			false - failed.
  */
 static inline bool DeviceIntrfStartRx(DEVINTRF *pDev, int DevAddr) {
-    if (AtomicTestAndSet(&pDev->Busy))
+    if (AtomicTestAndSet(&pDev->Busy)) {
+#ifdef DEVINTRF_TRACE
+    	DevTraceRecord(pDev->pTrace, DEVTRACE_EVT_BUSY, DevAddr, 0, 0, 0, DevTraceTime(pDev->pTrace));
+#endif
         return false;
+    }
 
     bool retval = pDev->StartRx(pDev, DevAddr);
 
@@ -448,8 +518,12 @@ static inline void DeviceIntrfStopRx(DEVINTRF *pDev) {
  * 			false - failed
  */
 static inline bool DeviceIntrfStartTx(DEVINTRF *pDev, int DevAddr) {
-    if (AtomicTestAndSet(&pDev->Busy))
+    if (AtomicTestAndSet(&pDev->Busy)) {
+#ifdef DEVINTRF_TRACE
+    	DevTraceRecord(pDev->pTrace, DEVTRACE_EVT_BUSY, DevAddr, 0, 0, 0, DevTraceTime(pDev->pTrace));
+#endif
         return false;
+    }
 
     bool retval =  pDev->StartTx(pDev, DevAddr);
 
@@ -628,6 +702,21 @@ public:
         return DeviceIntrfWrite(*this, DevAddr, pAdCmd, AdCmdLen, pData, DataLen);
     }
 
+    /**
+     * @brief	Scatter-gather transfer.
+     *
+     * Sends and receives a list of segments within a single transaction.
+     *
+     * @param	DevAddr   	: The device selection id scheme
+     * @param	pSeg		: Array of segments
+     * @param	NbSeg		: Number of segments
+     *
+     * @return	Total number of bytes transfered over all segments
+     */
+    virtual int Transfer(int DevAddr, const DEVINTRF_SEG *pSeg, int NbSeg) {
+        return DeviceIntrfTransfer(*this, DevAddr, pSeg, NbSeg);
+    }
+
 	// Initiate receive
     // WARNING this function must be used in pair with StopRx
     // Re-entrance protection flag is used
@@ -0,0 +1,237 @@
+/**-------------------------------------------------------------------------
+@file	device_intrf_arb.h
+
+@brief	Device interface bus arbiter.
+
+Arbitrates access to a DEVINTRF shared by several drivers.  Each driver owns
+a client with a priority and a max wait time.  A client acquires the bus
+before its transfers and releases it after, instead of racing on the busy
+flag and spinning through MaxRetry.
+
+When the bus is released, the waiting client with the best priority gets it.
+Clients of same priority are served in request order.  Optional aging raises
+the effective priority of a client by one level per Aging ticks waited, so
+low priority clients are not starved.  A client giving up after its max wait
+gets a timeout instead of blowing its deadline.
+
+Long operations made of several transfers (EEPROM page writes, multi sector
+writes...) should call DevIntrfArbSlice between transfers.  When the client
+held the bus longer than the time slice and another client is waiting, the
+bus is handed over before continuing.
+
+Per client statistics record wait & hold times for tuning priorities.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __DEVICE_INTRF_ARB_H__
+#define __DEVICE_INTRF_ARB_H__
+
+#include <stdint.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#include "device_intrf.h"
+
+/** @addtogroup device_intrf	Device Interface
+  * @{
+  */
+
+#define DEVINTRFARB_WAIT_FOREVER	0xFFFFFFFFUL	//!< Max wait value to never time out
+
+typedef struct __DevIntrf_Arb DEVINTRFARB;
+
+/// @brief	Arbiter clock function.
+///
+/// @return	Free running tick count, allowed to wrap
+typedef uint32_t (*DEVINTRFARB_CLOCK)(void);
+
+/// @brief	Wait hook, called while a client waits for the bus.
+///
+/// Typically yields to the RTOS or waits for event.  NULL to spin.
+///
+/// @param	pArb : Arbiter
+typedef void (*DEVINTRFARB_YIELD)(DEVINTRFARB *pArb);
+
+/// Per client statistics, times in clock ticks
+typedef struct __DevIntrf_Arb_Stats {
+	uint32_t AcqCnt;		//!< Successful acquisitions
+	uint32_t TimeoutCnt;	//!< Acquisitions given up after max wait
+	uint32_t SliceCnt;		//!< Bus handed over at end of time slice
+	uint32_t WaitMax;		//!< Longest wait
+	uint64_t WaitTotal;		//!< Total wait, timeouts included
+	uint32_t HoldMax;		//!< Longest hold
+	uint64_t HoldTotal;		//!< Total hold
+} DEVINTRFARB_STATS;
+
+/// Arbiter client, one per driver
+typedef struct __DevIntrf_Arb_Client {
+	int Prio;						//!< Priority, 0 is highest
+	uint32_t MaxWait;				//!< Max wait in ticks, 0 to try once
+	volatile bool bWaiting;			//!< Waiting for the bus, private
+	uint32_t WaitStart;				//!< Wait start time, private
+	DEVINTRFARB_STATS Stats;		//!< Statistics
+	struct __DevIntrf_Arb_Client *pNext;	//!< Client list link, private
+} DEVINTRFARB_CLIENT;
+
+/// Bus arbiter
+struct __DevIntrf_Arb {
+	DEVINTRF *pIntrf;				//!< Arbitrated interface
+	DEVINTRFARB_CLOCK Clock;		//!< Clock function
+	DEVINTRFARB_YIELD Yield;		//!< Wait hook, NULL to spin
+	uint32_t Slice;					//!< Time slice in ticks, 0 for none
+	uint32_t Aging;					//!< Ticks waited per priority level gained, 0 for none
+	DEVINTRFARB_CLIENT *pClients;	//!< Registered clients
+	DEVINTRFARB_CLIENT *volatile pOwner;	//!< Client holding the bus
+	uint32_t OwnStart;				//!< Time bus was acquired by owner
+	uint32_t SliceStart;			//!< Start of current time slice
+	bool Lock;						//!< Arbiter data lock, private
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief	Initialize arbiter.
+ *
+ * @param	pArb	: Arbiter to initialize
+ * @param	pIntrf	: Interface to arbitrate
+ * @param	Clock	: Clock function for wait, hold & slice times
+ * @param	Yield	: Wait hook, NULL to spin
+ * @param	Slice	: Time slice in ticks, 0 for none
+ * @param	Aging	: Ticks waited per priority level gained, 0 for none
+ *
+ * @return	true - Success
+ */
+bool DevIntrfArbInit(DEVINTRFARB *pArb, DEVINTRF *pIntrf, DEVINTRFARB_CLOCK Clock,
+					 DEVINTRFARB_YIELD Yield, uint32_t Slice, uint32_t Aging);
+
+/**
+ * @brief	Register a client.
+ *
+ * @param	pArb	: Arbiter
+ * @param	pClient	: Client to register
+ * @param	Prio	: Priority, 0 is highest
+ * @param	MaxWait	: Max wait in ticks. 0 to try once, DEVINTRFARB_WAIT_FOREVER for no limit
+ */
+void DevIntrfArbAddClient(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int Prio, uint32_t MaxWait);
+
+/**
+ * @brief	Queue client for the bus without waiting.
+ *
+ * Wait time counts from now and a following DevIntrfArbAcquire keeps the
+ * position.  Useful to get in line as soon as a transfer is known to be
+ * needed, for example on data ready interrupt.
+ *
+ * The request expires after the client max wait if no DevIntrfArbAcquire
+ * follows.  Call DevIntrfArbCancel when the transfer is no longer needed,
+ * a client with DEVINTRFARB_WAIT_FOREVER otherwise stays in line.
+ *
+ * @param	pArb	: Arbiter
+ * @param	pClient	: Client
+ */
+void DevIntrfArbRequest(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient);
+
+/**
+ * @brief	Withdraw a pending DevIntrfArbRequest.
+ *
+ * @param	pArb	: Arbiter
+ * @param	pClient	: Client
+ */
+void DevIntrfArbCancel(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient);
+
+/**
+ * @brief	Acquire the bus, waiting up to client max wait.
+ *
+ * Not reentrant, a client must release the bus before acquiring it again.
+ * Must not be called from interrupt.
+ *
+ * @param	pArb	: Arbiter
+ * @param	pClient	: Client
+ *
+ * @return	true - bus acquired\n
+ * 			false - timeout
+ */
+bool DevIntrfArbAcquire(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient);
+
+/**
+ * @brief	Release the bus.
+ *
+ * @param	pArb	: Arbiter
+ * @param	pClient	: Client holding the bus
+ */
+void DevIntrfArbRelease(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient);
+
+/**
+ * @brief	Time slice point, call between transfers of a long operation.
+ *
+ * Hands the bus over if the slice has expired and another client waits,
+ * then acquires it back.
+ *
+ * @param	pArb	: Arbiter
+ * @param	pClient	: Client holding the bus
+ *
+ * @return	true - client holds the bus\n
+ * 			false - bus could not be acquired back, client does not hold it
+ */
+bool DevIntrfArbSlice(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient);
+
+/**
+ * @brief	Arbitrated DeviceIntrfRead.
+ *
+ * @return	Number of bytes read, 0 on timeout
+ */
+int DevIntrfArbRead(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int DevAddr,
+					uint8_t *pAdCmd, int AdCmdLen, uint8_t *pBuff, int BuffLen);
+
+/**
+ * @brief	Arbitrated DeviceIntrfWrite.
+ *
+ * @return	Number of data bytes written, 0 on timeout
+ */
+int DevIntrfArbWrite(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int DevAddr,
+					 uint8_t *pAdCmd, int AdCmdLen, uint8_t *pData, int DataLen);
+
+/**
+ * @brief	Arbitrated DeviceIntrfTransfer.
+ *
+ * @return	Total number of bytes transfered, 0 on timeout
+ */
+int DevIntrfArbTransfer(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int DevAddr,
+						const DEVINTRF_SEG *pSeg, int NbSeg);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} end group device_intrf */
+
+#endif // __DEVICE_INTRF_ARB_H__
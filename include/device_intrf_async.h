@@ -0,0 +1,232 @@
+/**-------------------------------------------------------------------------
+@file	device_intrf_async.h
+
+@brief	Asynchronous device interface transaction queue.
+
+Drivers sharing an interface submit transaction descriptors instead of
+calling the blocking DeviceIntrfRead/Write.  Transactions are queued per
+interface and executed back to back in submission order, each one
+completing through its callback.  A submitter never fails on the busy flag,
+the transaction is simply queued behind the one in progress.
+
+Two execution modes are supported :
+- Blocking, no start function.  The submitter finding the queue idle runs
+it until empty using DeviceIntrfTransfer.  Transactions submitted meanwhile
+from callbacks, interrupts or other threads are picked up by that loop.
+- Completion driven.  The start function programs the transfer (DMA chain,
+interrupt state machine...) and returns.  The interface completion interrupt
+calls DevIntrfQueComplete, which invokes the callback and starts the next
+transaction.
+
+Descriptors are owned by the caller and must stay valid until completion.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __DEVICE_INTRF_ASYNC_H__
+#define __DEVICE_INTRF_ASYNC_H__
+
+#include <stdint.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#include "device_intrf.h"
+
+/** @addtogroup device_intrf	Device Interface
+  * @{
+  */
+
+/// Max segments per transaction, command + 2 data buffers
+#define DEVINTRF_XACT_MAXSEG		3
+
+typedef struct __DevIntrf_Xact DEVINTRF_XACT;
+typedef struct __DevIntrf_Que DEVINTRFQUE;
+
+/**
+ * @brief	Transaction completion callback.
+ *
+ * Called in the context completing the transaction, interrupt in completion
+ * driven mode.  New transactions can be submitted from the callback.
+ *
+ * @param	pXact : Completed transaction, Count holds the result
+ */
+typedef void (*DEVINTRF_XACTCB)(DEVINTRF_XACT *pXact);
+
+/**
+ * @brief	Start function of completion driven interface.
+ *
+ * Starts the transfer and returns without waiting.  Completion must be
+ * reported later by calling DevIntrfQueComplete, never from within this
+ * function.
+ *
+ * @param	pQue	: Queue
+ * @param	pXact	: Transaction to start
+ *
+ * @return	true - started\n
+ * 			false - failed, transaction completes with Count 0
+ */
+typedef bool (*DEVINTRFQUE_START)(DEVINTRFQUE *pQue, DEVINTRF_XACT *pXact);
+
+/// Transaction descriptor
+struct __DevIntrf_Xact {
+	int DevAddr;							//!< Device address or chip select
+	DEVINTRF_SEG Seg[DEVINTRF_XACT_MAXSEG];	//!< Segments
+	int NbSeg;								//!< Number of segments used
+	int CmdLen;								//!< Command bytes not counted in result
+	DEVINTRF_XACTCB CompleteCB;				//!< Completion callback, can be NULL
+	void *pCtx;								//!< Caller context
+	int Count;								//!< Data bytes transfered, set on completion
+	DEVINTRF_XACT *pNext;					//!< Queue link, private
+};
+
+/// Queue statistics
+typedef struct __DevIntrf_Que_Stats {
+	uint32_t SubmitCnt;		//!< Transactions submitted
+	uint32_t DoneCnt;		//!< Transactions completed
+	uint32_t FailCnt;		//!< Transactions completed without data
+	uint32_t Depth;			//!< Transactions queued or in progress
+	uint32_t MaxDepth;		//!< Highest Depth seen
+} DEVINTRFQUE_STATS;
+
+/// Per interface transaction queue
+struct __DevIntrf_Que {
+	DEVINTRF *pIntrf;			//!< Interface executing the transactions
+	DEVINTRFQUE_START Start;	//!< Start function, NULL for blocking execution
+	void *pStartData;			//!< Private data of start function
+	DEVINTRF_XACT *pHead;		//!< Next transaction to execute
+	DEVINTRF_XACT *pTail;		//!< Last transaction queued
+	DEVINTRF_XACT *pCur;		//!< Transaction in progress
+	volatile bool bRunning;		//!< Queue is being executed
+	DEVINTRFQUE_STATS Stats;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief	Initialize transaction queue.
+ *
+ * @param	pQue		: Queue to initialize
+ * @param	pIntrf		: Interface executing the transactions
+ * @param	Start		: Start function for completion driven interface.
+ * 						  NULL to execute with blocking DeviceIntrfTransfer
+ * @param	pStartData	: Private data for start function
+ *
+ * @return	true - Success
+ */
+bool DevIntrfQueInit(DEVINTRFQUE *pQue, DEVINTRF *pIntrf, DEVINTRFQUE_START Start, void *pStartData);
+
+/**
+ * @brief	Submit a transaction.  Safe to call from any context.
+ *
+ * In blocking mode, the call returns after the queue is emptied if it was
+ * idle, otherwise immediately.
+ *
+ * @param	pQue	: Queue
+ * @param	pXact	: Initialized transaction descriptor
+ *
+ * @return	true - queued
+ */
+bool DevIntrfQueSubmit(DEVINTRFQUE *pQue, DEVINTRF_XACT *pXact);
+
+/**
+ * @brief	Report completion of transaction in progress.
+ *
+ * To be called by completion driven interface, usually from its interrupt.
+ * Invokes the callback and starts the next transaction.
+ *
+ * @param	pQue	: Queue
+ * @param	Count	: Total bytes transfered over all segments
+ */
+void DevIntrfQueComplete(DEVINTRFQUE *pQue, int Count);
+
+/**
+ * @brief	Cancel a transaction not started yet.
+ *
+ * The transaction is removed from the queue and completes with Count 0.  A
+ * transaction in progress can not be cancelled, it completes normally.
+ *
+ * @param	pQue	: Queue
+ * @param	pXact	: Transaction to cancel
+ *
+ * @return	true - cancelled\n
+ * 			false - in progress or already completed
+ */
+bool DevIntrfQueCancel(DEVINTRFQUE *pQue, DEVINTRF_XACT *pXact);
+
+/**
+ * @brief	Check if queue has nothing queued or in progress.
+ *
+ * @param	pQue	: Queue
+ *
+ * @return	true - idle
+ */
+static inline bool DevIntrfQueIdle(DEVINTRFQUE *pQue) {
+	return pQue->bRunning == false;
+}
+
+/**
+ * @brief	Setup a read transaction, command followed by data read.
+ *
+ * @param	pXact		: Transaction to setup
+ * @param	DevAddr		: Device address or chip select
+ * @param	pAdCmd		: Address or command to send, NULL if none
+ * @param	AdCmdLen	: Size of addr/Cmd in bytes
+ * @param	pBuff		: Buffer to receive data
+ * @param	BuffLen		: Number of bytes to read
+ * @param	CompleteCB	: Completion callback
+ * @param	pCtx		: Caller context
+ */
+void DevIntrfXactRead(DEVINTRF_XACT *pXact, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
+					  uint8_t *pBuff, int BuffLen, DEVINTRF_XACTCB CompleteCB, void *pCtx);
+
+/**
+ * @brief	Setup a write transaction, command followed by data.
+ *
+ * @param	pXact		: Transaction to setup
+ * @param	DevAddr		: Device address or chip select
+ * @param	pAdCmd		: Address or command to send
+ * @param	AdCmdLen	: Size of addr/Cmd in bytes
+ * @param	pData		: Data to send, NULL if none
+ * @param	DataLen		: Data length in bytes
+ * @param	CompleteCB	: Completion callback
+ * @param	pCtx		: Caller context
+ */
+void DevIntrfXactWrite(DEVINTRF_XACT *pXact, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
+					   uint8_t *pData, int DataLen, DEVINTRF_XACTCB CompleteCB, void *pCtx);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} end group device_intrf */
+
+#endif // __DEVICE_INTRF_ASYNC_H__
@@ -0,0 +1,185 @@
+/**-------------------------------------------------------------------------
+@file	device_intrf_trace.h
+
+@brief	Device interface transaction tracer.
+
+Opt-in tracing of DEVINTRF traffic, compiled in when DEVINTRF_TRACE is
+defined.  A DEVTRACE attached to an interface with DeviceIntrfTrace records
+one entry per DeviceIntrfRx/Tx/Read/Write/Transfer call (device address, requested &
+transferred bytes, retries used, start time & duration) and one entry per
+busy flag contention failure in DeviceIntrfStartRx/StartTx.  Drivers calling
+StartRx/RxData/StopRx directly are only traced for contention.
+
+Records are written to an MPSC CFIFO so that interfaces used from interrupt
+and thread context can share a tracer without locking.  When the FIFO is full
+new records are dropped and counted.  DevTraceDump drains the FIFO into a
+compact binary trace (DEVTRACE_HDR followed by DEVTRACE_REC entries, native
+little endian) to be summarized on host by the devtrace tool.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __DEVICE_INTRF_TRACE_H__
+#define __DEVICE_INTRF_TRACE_H__
+
+#include <stdint.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#include "atomic.h"
+#include "cfifo.h"
+
+/** @addtogroup device_intrf	Device Interface
+  * @{
+  */
+
+#define DEVTRACE_MAGIC			0x52545644	//!< "DVTR"
+#define DEVTRACE_VERSION		1
+
+/// Trace event types
+typedef enum __DevTrace_Evt {
+	DEVTRACE_EVT_RX,		//!< DeviceIntrfRx
+	DEVTRACE_EVT_TX,		//!< DeviceIntrfTx
+	DEVTRACE_EVT_READ,		//!< DeviceIntrfRead
+	DEVTRACE_EVT_WRITE,		//!< DeviceIntrfWrite
+	DEVTRACE_EVT_BUSY,		//!< StartRx/StartTx/Transfer failed on busy flag
+	DEVTRACE_EVT_XFER,		//!< DeviceIntrfTransfer
+	DEVTRACE_EVT_MAX
+} DEVTRACE_EVT;
+
+/// @brief	Trace clock function.
+///
+/// Returns a free running tick count used for start time & duration.  The
+/// counter is allowed to wrap.
+///
+/// @return	Current tick count
+typedef uint32_t (*DEVTRACECLOCK)(void);
+
+#pragma pack(push, 1)
+
+/// Binary trace record
+typedef struct __DevTrace_Rec {
+	uint32_t Time;			//!< Start time in clock ticks
+	uint32_t Dur;			//!< Duration in clock ticks, including retries
+	uint16_t DevAddr;		//!< Device address or chip select
+	uint16_t ReqLen;		//!< Requested data length, saturated at 0xFFFF
+	uint16_t Len;			//!< Transferred data length, 0 on failure
+	uint8_t Evt;			//!< Event type DEVTRACE_EVT
+	uint8_t Retry;			//!< Number of retries used
+} DEVTRACE_REC;
+
+/// Binary trace chunk header, followed by NbRec records
+typedef struct __DevTrace_Hdr {
+	uint32_t Magic;			//!< DEVTRACE_MAGIC
+	uint16_t Version;		//!< DEVTRACE_VERSION
+	uint16_t RecSize;		//!< sizeof(DEVTRACE_REC)
+	uint32_t ClockRate;		//!< Clock ticks per second, 0 if unknown
+	uint32_t NbRec;			//!< Number of records following
+	uint32_t DropCnt;		//!< Records dropped since previous chunk
+} DEVTRACE_HDR;
+
+#pragma pack(pop)
+
+/// Tracer instance
+typedef struct __DevIntrf_Trace {
+	HCFIFO hFifo;			//!< Record FIFO, MPSC flavor
+	DEVTRACECLOCK Clock;	//!< Clock function, NULL for no timing
+	uint32_t ClockRate;		//!< Clock ticks per second
+	sig_atomic_t DropCnt;	//!< Records dropped since last dump
+} DEVTRACE;
+
+/// Memory size required to hold NbRec records
+#define DEVTRACE_MEMSIZE(NbRec)		CFIFO_MPSC_TOTAL_MEMSIZE(NbRec, sizeof(DEVTRACE_REC))
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief	Initialize tracer.
+ *
+ * @param	pTrace		: Pointer to tracer to initialize
+ * @param	pMem		: Record memory, use DEVTRACE_MEMSIZE to size it
+ * @param	MemSize		: Memory size in bytes
+ * @param	Clock		: Clock function. NULL for no timing
+ * @param	ClockRate	: Clock ticks per second, stored in dump for the summary tool
+ *
+ * @return	true - Success
+ */
+bool DevTraceInit(DEVTRACE *pTrace, uint8_t *pMem, uint32_t MemSize, DEVTRACECLOCK Clock,
+				  uint32_t ClockRate);
+
+/**
+ * @brief	Get trace clock tick count.
+ *
+ * @param	pTrace	: Pointer to tracer, can be NULL
+ *
+ * @return	Tick count, 0 if no tracer or no clock
+ */
+static inline uint32_t DevTraceTime(DEVTRACE *pTrace) {
+	return pTrace && pTrace->Clock ? pTrace->Clock() : 0;
+}
+
+/**
+ * @brief	Add a record.  Safe to call from any context.
+ *
+ * @param	pTrace		: Pointer to tracer, NULL does nothing
+ * @param	Evt			: Event type
+ * @param	DevAddr		: Device address
+ * @param	ReqLen		: Requested data length
+ * @param	Len			: Transferred data length
+ * @param	Retry		: Number of retries used
+ * @param	StartTime	: Start time from DevTraceTime
+ */
+void DevTraceRecord(DEVTRACE *pTrace, DEVTRACE_EVT Evt, int DevAddr, int ReqLen, int Len,
+					int Retry, uint32_t StartTime);
+
+/**
+ * @brief	Drain trace records into a binary chunk.
+ *
+ * Writes a DEVTRACE_HDR followed by as many records as fit in the buffer.
+ * Records not fitting are left in the tracer for the next dump.  Consumer
+ * side, must not be called concurrently.
+ *
+ * @param	pTrace	: Pointer to tracer
+ * @param	pBuff	: Buffer to receive the chunk
+ * @param	BuffLen	: Buffer length in bytes
+ *
+ * @return	Number of bytes written, 0 if buffer can't hold the header
+ */
+int DevTraceDump(DEVTRACE *pTrace, uint8_t *pBuff, int BuffLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** @} end group device_intrf */
+
+#endif // __DEVICE_INTRF_TRACE_H__
@@ -35,15 +35,27 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __DISKIO_H__
 
 #include <stdint.h>
+#include <string.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
 
 /** @addtogroup Storage
   * @{
   */
 
-#define DISKIO_SECT_SIZE		    512     //!< Disk sector size in bytes
-#define DISKIO_CACHE_SECT_MAX	    1       //!< Max number of cache sector
+#define DISKIO_SECT_SIZE		    512     //!< Default disk sector size in bytes
+#define DISKIO_CACHE_SECT_MAX	    16      //!< Max number of cache sector with caller
+                                            //!< allocated descriptors, see SetCache
 #define DISKIO_CACHE_DIRTY_BIT      (1<<31) //!< This bit is set in the UseCnt if there was
                                             //!< write to the cache
+#define DISKIO_CACHE_HASH_EMPTY     -1      //!< Unused cache hash slot
+#define DISKIO_WRITE_RUN_MAX        16      //!< Max sectors per coalesced write back
+#define DISKIO_MULTI_SECT_MAX       32      //!< Max sectors per multi sector transfer bypassing cache
+#define DISKIO_BYPASS_SECT_DEF      8       //!< Default min sectors of a transfer bypassing cache
+#define DISKIO_STREAM_MAX           4       //!< Max interleaved sequential read streams
+#define DISKIO_PREFETCH_WIN_MIN     2       //!< Initial read ahead window in sectors
 
 #pragma pack(push, 1)
 typedef struct __DiskPartition {
@@ -71,10 +83,50 @@ typedef struct __DiskIO_Cache_Desc {
 	volatile int UseCnt;	//!< semaphore
 	uint32_t    SectNo;		//!< sector number of this cache
 	uint8_t		*pSectData;	//!< Pointer to sector cache memory. Must be at least 1 sector size
+	bool		bRef;		//!< Referenced since last pass of the eviction clock
+	bool		bPrefetch;	//!< Read ahead, not used yet
+	bool		bDemand;	//!< Read with read ahead for the pending access, counted as miss
 } DISKIO_CACHE_DESC;
 
+/// DiskIO cache statistics
+typedef struct __DiskIO_Cache_Stats {
+	uint32_t HitCnt;		//!< Sector found in cache
+	uint32_t MissCnt;		//!< Sector read from device into cache
+	uint32_t EvictCnt;		//!< Valid sector replaced
+	uint32_t WriteBackCnt;	//!< Dirty sector written to device
+	uint32_t WriteRunCnt;	//!< Write back device writes, each of 1 or more consecutive sectors
+	uint32_t FullCnt;		//!< No cache available, all pinned
+	uint32_t BypassCnt;		//!< Sectors transfered directly, bypassing cache
+	uint32_t PrefetchCnt;	//!< Sectors read ahead
+	uint32_t PrefetchHitCnt;	//!< Read ahead sectors used
+} DISKIO_CACHE_STATS;
+
+/// Sequential read stream
+typedef struct __DiskIO_Stream {
+	uint32_t LastSect;		//!< Last sector read
+	uint32_t NextSect;		//!< First sector past read ahead
+	int Window;				//!< Read ahead window in sectors, 0 until sequential
+	uint32_t PendSect;		//!< Deferred read ahead start
+	int PendCnt;			//!< Deferred read ahead sectors, 0 for none
+	uint32_t Stamp;			//!< Last use, 0 for unused stream
+} DISKIO_STREAM;
+
 #pragma pack(pop)
 
+/// @brief	Cache arena size in bytes for NbSect sectors of SectSize bytes.
+///
+/// Holds descriptors, hash table of 2 to 4 slots per sector, dirty list &
+/// sector data.
+#define DISKIO_CACHE_MEMSIZE_SECT(NbSect, SectSize)	((NbSect) * (sizeof(DISKIO_CACHE_DESC) + (SectSize) + 10) + 4)
+
+/// @brief	Cache arena size in bytes for NbSect sectors of DISKIO_SECT_SIZE.
+#define DISKIO_CACHE_MEMSIZE(NbSect)	DISKIO_CACHE_MEMSIZE_SECT(NbSect, DISKIO_SECT_SIZE)
+
+/// @brief	Clock function for write back age limit.
+///
+/// @return	Free running tick count, allowed to wrap
+typedef uint32_t (*DISKIO_CLOCK)(void);
+
 #ifdef __cplusplus
 
 /// DiskIO base class
@@ -85,6 +137,10 @@ public:
 	/**
 	 * @brief	Get the size of one sector.
 	 *
+	 * Native sector size of the device, power of 2.  It is read once, when
+	 * the cache is set or on first access.  Partial sector access to devices
+	 * with sectors larger than DISKIO_SECT_SIZE requires a cache.
+	 *
 	 * @return	Sector size in bytes.
 	 */
 	virtual int GetSectSize(void) { return DISKIO_SECT_SIZE; }
@@ -129,6 +185,54 @@ public:
 	 */
 	virtual bool SectWrite(uint32_t SectNo, uint8_t *pData) = 0;
 
+	/**
+	 * @brief	Read consecutive sectors from physical device.
+	 *
+	 * Used for large reads bypassing the cache.  Default implementation calls
+	 * SectRead for each sector.  Devices with multi sector read should
+	 * overload it.
+	 *
+	 * @param	SectNo	: First sector number
+	 * @param	ppBuff	: Buffer of each sector, not necessarily contiguous
+	 * @param	NbSect	: Number of sectors
+	 *
+	 * @return
+	 * 			- true  : Success
+	 * 			- false : Failed
+	 */
+	virtual bool SectReadMulti(uint32_t SectNo, uint8_t * const *ppBuff, int NbSect) {
+		for (int i = 0; i < NbSect; i++)
+		{
+			if (SectRead(SectNo + i, ppBuff[i]) == false)
+				return false;
+		}
+		return true;
+	}
+
+	/**
+	 * @brief	Write consecutive sectors to physical device.
+	 *
+	 * Used by the cache to write back runs of dirty sectors and for large
+	 * writes bypassing the cache.  Default implementation calls SectWrite for
+	 * each sector.  Devices with multi sector write should overload it.
+	 *
+	 * @param	SectNo	: First sector number
+	 * @param	ppData	: Data of each sector, not contiguous
+	 * @param	NbSect	: Number of sectors
+	 *
+	 * @return
+	 * 			- true  : Success
+	 * 			- false : Failed
+	 */
+	virtual bool SectWriteMulti(uint32_t SectNo, uint8_t * const *ppData, int NbSect) {
+		for (int i = 0; i < NbSect; i++)
+		{
+			if (SectWrite(SectNo + i, ppData[i]) == false)
+				return false;
+		}
+		return true;
+	}
+
 	/**
 	 * @brief	Reset DiskIO to its default state
 	 */
@@ -139,6 +243,8 @@ public:
 	 * implemented in with sector caching. Physical SectRead/SectWrite are
 	 * called internally to flush cache as needed.
 	 *
+	 * Offset versions transfer runs of whole sectors of at least the bypass
+	 * size directly with SectReadMulti/SectWriteMulti, see SetCacheBypass.
 	 */
 	virtual int Read(uint32_t SetNo, uint32_t SectOffset, uint8_t *pBuff, uint32_t Len);
 	virtual int Read(uint64_t Offset, uint8_t *pBuff, uint32_t Len);
@@ -150,16 +256,180 @@ public:
 	 */
 	virtual void Erase() {}
 
+	/**
+	 * @brief	Get sector in cache, reading it from device if not cached.
+	 *
+	 * The cache entry is pinned until released with ReleaseCacheSect.
+	 *
+	 * @param	SectNo	: Sector number
+	 * @param	bLock	: Not used
+	 *
+	 * @return	Cache index, -1 if no cache available
+	 */
 	int	GetCacheSect(uint32_t SectNo, bool bLock = false);
+
+	/**
+	 * @brief	Release cache entry pinned by GetCacheSect.
+	 *
+	 * @param	Idx		: Cache index
+	 * @param	bDirty	: true - sector data was modified
+	 */
+	void ReleaseCacheSect(int Idx, bool bDirty = false);
+
+	/**
+	 * @brief	Get cached sector data.
+	 *
+	 * @param	Idx	: Cache index returned by GetCacheSect
+	 *
+	 * @return	Pointer to sector data
+	 */
+	uint8_t *CacheSectData(int Idx) { return vpCacheSect[Idx].pSectData; }
+
+	/**
+	 * @brief	Set cache with caller allocated descriptors.
+	 *
+	 * Descriptors must have pSectData set to buffers of one sector.  Limited
+	 * to DISKIO_CACHE_SECT_MAX entries, use SetCacheMem for larger cache.
+	 *
+	 * @param	pCacheBlk	: Cache descriptors
+	 * @param	NbCacheBlk	: Number of descriptors
+	 */
 	void SetCache(DISKIO_CACHE_DESC *pCacheBlk, int NbCacheBlk);
-	void Flush();
+
+	/**
+	 * @brief	Set cache from a memory arena.
+	 *
+	 * Descriptors, hash table & sector data are all allocated in the arena.
+	 * Use DISKIO_CACHE_MEMSIZE_SECT to size it.  Device must be initialized,
+	 * its sector size is used.
+	 *
+	 * @param	pMem	: Arena memory
+	 * @param	MemSize	: Arena size in bytes
+	 *
+	 * @return	Number of cache sectors
+	 */
+	int SetCacheMem(uint8_t *pMem, uint32_t MemSize);
+
+	/**
+	 * @brief	Set write back limits.
+	 *
+	 * Writes stay in cache until the sector is evicted or Flush is called.
+	 * These limits flush all dirty sectors earlier.
+	 *
+	 * @param	DirtyMax	: Flush when this many sectors are dirty, 0 for no limit
+	 * @param	AgeMax		: Flush when oldest dirty sector is older in Clock ticks, 0 for no limit
+	 * @param	Clock		: Clock function, NULL for no age limit
+	 */
+	void SetWriteBack(int DirtyMax, uint32_t AgeMax = 0, DISKIO_CLOCK Clock = NULL);
+
+	/**
+	 * @brief	Set min size of transfers bypassing the cache.
+	 *
+	 * Runs of whole sectors at least this long are transfered directly
+	 * between device & caller buffer.  Cached copies are kept coherent.
+	 *
+	 * @param	NbSect	: Min number of sectors, 0 to always use cache
+	 */
+	void SetCacheBypass(int NbSect) { vBypassMin = NbSect; }
+
+	/**
+	 * @brief	Set sequential read ahead.
+	 *
+	 * Sequential sector reads are tracked per stream, up to DISKIO_STREAM_MAX
+	 * interleaved streams such as file data & FAT.  Read ahead starts at
+	 * DISKIO_PREFETCH_WIN_MIN sectors on the second sequential sector and
+	 * doubles each time a stream has used half of it.  A non sequential read
+	 * starts a new stream with no read ahead.  Missing sectors are read in
+	 * the cache with SectReadMulti.  Must be set after the cache.
+	 *
+	 * @param	WindowMax	: Max read ahead in sectors, 0 to disable.  Limited to
+	 * 						  half the cache & DISKIO_MULTI_SECT_MAX
+	 * @param	bDeferred	: true - read ahead is only queued and issued by
+	 * 						  PrefetchRun, from idle loop or background task
+	 */
+	void SetPrefetch(int WindowMax, bool bDeferred = false);
+
+	/**
+	 * @brief	Issue deferred read ahead.
+	 *
+	 * @return	Number of sectors read
+	 */
+	int PrefetchRun();
+
+	/**
+	 * @brief	Flush if age limit is reached.
+	 *
+	 * Age is checked on each write.  Call periodically to bound the age of
+	 * dirty data when there are no writes.
+	 *
+	 * @return	false - write back failed, see Flush
+	 */
+	bool FlushAged();
+
+	/**
+	 * @brief	Get number of dirty cache sectors.
+	 */
+	int DirtyCount() { return vNbDirty; }
+
+	/**
+	 * @brief	Get cache statistics.
+	 */
+	const DISKIO_CACHE_STATS &CacheStats() { return vCacheStats; }
+	void ResetCacheStats() { memset(&vCacheStats, 0, sizeof(vCacheStats)); }
+
+	/**
+	 * @brief	Write back all dirty sectors.
+	 *
+	 * Sectors are written in ascending order, consecutive sectors in a single
+	 * SectWriteMulti.  Stops at the first failed write, sectors not written
+	 * stay dirty.
+	 *
+	 * @return	true - all dirty sectors written
+	 */
+	bool Flush();
 
 protected:
 
 private:
-	int vLastIdx;	    //!< Last cache sector accessed
+	int CacheHashSlot(uint32_t SectNo) { return (uint32_t)(SectNo * 2654435761U) >> vHashShift; }
+	int CacheFind(uint32_t SectNo);
+	void CacheInsert(int Idx);
+	void CacheRemove(int Idx);
+	void SectSizeInit();
+	void CacheInit(DISKIO_CACHE_DESC *pCacheBlk, int NbCacheBlk, int16_t *pHash, int HashBits, int16_t *pDirty);
+	int CacheGet(uint32_t SectNo, bool bFill);
+	int CacheAlloc(uint32_t SectNo);
+	void CacheFree(int Idx);
+	int DirtyFind(uint32_t SectNo);
+	void DirtyAdd(int Idx);
+	int CacheWriteRun(int Pos);
+	int BypassRead(uint32_t SectNo, uint8_t *pBuff, int NbSect);
+	int BypassWrite(uint32_t SectNo, uint8_t *pData, int NbSect);
+	void Prefetch(uint32_t SectNo);
+	int PrefetchRange(uint32_t SectNo, int NbSect, uint32_t DemandSect);
+
+	uint32_t vSectSize;	//!< Device sector size, 0 until read
+	int vSectShift;		//!< Log2 of sector size
+	int vLastIdx;	    //!< Eviction clock hand
 	int vNbCache;       //!< Number of cache sector
 	DISKIO_CACHE_DESC *vpCacheSect;	//!< pointer to static disk cache
+	int16_t *vpHash;	//!< Open addressing hash of cached sector numbers to cache index
+	int vHashMask;		//!< Hash table size - 1, power of 2
+	int vHashShift;		//!< 32 - hash bits
+	int16_t vHashMem[DISKIO_CACHE_SECT_MAX * 2];	//!< Hash table for SetCache
+	int16_t *vpDirty;	//!< Dirty cache indices in ascending sector order
+	int vNbDirty;		//!< Number of dirty sectors
+	int16_t vDirtyMem[DISKIO_CACHE_SECT_MAX];		//!< Dirty list for SetCache
+	int vDirtyMax;		//!< Dirty sector count flush threshold
+	uint32_t vAgeMax;	//!< Dirty age flush threshold
+	uint32_t vDirtyTime;	//!< Time oldest dirty sector was written
+	DISKIO_CLOCK vClock;
+	int vBypassMin;		//!< Min sectors of a transfer bypassing cache, 0 for none
+	int vPrefetchMax;	//!< Max read ahead window, 0 for none
+	bool vbPrefetchDefer;	//!< Read ahead issued by PrefetchRun
+	uint32_t vStreamStamp;	//!< Stream use counter
+	DISKIO_STREAM vStream[DISKIO_STREAM_MAX];
+	DISKIO_CACHE_STATS vCacheStats;
 };
 
 extern "C" {
@@ -83,6 +83,7 @@ typedef struct {
     FLASHDISKIOCB pWaitCB;		//!< If provided, this is called when there are
     							//!< long delays, such as mass erase, to allow application
     							//!< to perform other tasks while waiting
+    uint32_t    SectSize;       //!< Disk sector size in bytes, power of 2.  0 for DISKIO_SECT_SIZE
 } FLASHDISKIO_CFG;
 
 
@@ -118,6 +119,13 @@ public:
      */
     virtual uint64_t GetSize(void) { return vTotalSize; }
 
+    /**
+     * @brief	Get disk sector size.
+     *
+     * @return	Sector size in bytes
+     */
+    virtual int GetSectSize(void) { return vSectSize; }
+
     /**
 	 * @brief	Device specific minimum erasable block size in bytes.
 	 *
@@ -161,6 +169,19 @@ public:
      */
     virtual bool SectRead(uint32_t SectNo, uint8_t *pBuff);
 
+    /**
+     * @brief	Read consecutive sectors with a single READ command.
+     *
+     * @param	SectNo	: First sector number
+     * @param	ppBuff	: Buffer of each sector
+     * @param	NbSect	: Number of sectors
+     *
+     * @return
+     * 			- true	: Success
+     * 			- false	: Failed
+     */
+    virtual bool SectReadMulti(uint32_t SectNo, uint8_t * const *ppBuff, int NbSect);
+
     /**
      * @brief	Write one sector to physical device
      *
@@ -221,6 +242,7 @@ protected:
 private:
     uint32_t    vEraseSize;		//!< Min erasable block size in byte
     uint32_t    vWriteSize;		//!< Min writable size in bytes
+    uint32_t    vSectSize;		//!< Disk sector size in bytes
     uint64_t    vTotalSize;		//!< Total Flash size in bytes
     int         vAddrSize;		//!< Address size in bytes
     int         vDevNo;			//!< Device No
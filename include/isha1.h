@@ -72,12 +72,12 @@ extern "C" {
  * set bLast parameter to true for last data packet to process.
  *
  * Make sure to have enough memory for returning results.  pRes must have at
- * least 33 bytes.
+ * least 41 bytes.
  *
  * @param 	pSrc 	: Pointer to source data
  * @param	SrcLen	: Source data length in bytes
  * @param	bLast	: set true to indicate last data packet
- * @param	pRes	: Pointer to buffer to store results of 32 characters
+ * @param	pRes	: Pointer to buffer to store results of 40 characters
  * 					  if NULL is passed, internal buffer will be used
  *
  * 	@return	Pointer to digest string. If pRes is NULL, internal buffer is returned
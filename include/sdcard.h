@@ -40,7 +40,9 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "device_intrf.h"
 #include "diskio.h"
 
-#define SDCARD_CACHE_MAX		2
+#define SDCARD_TOKEN_START			0xFE	//!< Start block token, single block write & read
+#define SDCARD_TOKEN_MULTI_WRITE	0xFC	//!< Start block token, multiple block write
+#define SDCARD_TOKEN_STOP_TRAN		0xFD	//!< Stop transmission token, multiple block write
 
 #pragma pack(push, 4)
 
@@ -81,33 +83,71 @@ public:
 	SDCard();
 	virtual ~SDCard();
 
+	/**
+	 * @brief	Initialize card.
+	 *
+	 * @param	pDevInterf		: SPI interface
+	 * @param	pCacheMem		: Cache arena, see DISKIO_CACHE_MEMSIZE.  NULL for no cache
+	 * @param	CacheMemSize	: Arena size in bytes
+	 *
+	 * @return	true - Success
+	 */
 	virtual bool Init(DeviceIntrf *pDevInterf, uint8_t *pCacheMem = NULL, int CacheMemSize = 0);
 	virtual bool Init(DeviceIntrf *pDevInterf, DISKIO_CACHE_DESC *pCacheBlk = NULL, int NbCacheBlk = 0);
 	int Cmd(uint8_t Cmd, uint32_t param);
 	int GetResponse(uint8_t *pBuff, int BuffLen);
 	int ReadData(uint8_t *pBuff, int BuffLen);
-	int WriteData(uint8_t *pData, int Len);
+	int WriteData(uint8_t *pData, int Len, uint8_t Token = SDCARD_TOKEN_START);
 	int GetSectSize(void);
 	uint32_t GetNbSect(void);
 	// @return size in KB
 	uint64_t GetSize(void);
 	int ReadSingleBlock(uint32_t Addr, uint8_t *pData, int Len);
 	int WriteSingleBlock(uint32_t Addr, uint8_t *pData, int Len);
+
+	/**
+	 * @brief	Read consecutive blocks with CMD18.
+	 *
+	 * @param	Addr	: First block number
+	 * @param	ppData	: Buffer of each block
+	 * @param	NbBlk	: Number of blocks
+	 *
+	 * @return	Number of blocks read
+	 */
+	int ReadMultiBlock(uint32_t Addr, uint8_t * const *ppData, int NbBlk);
+
+	/**
+	 * @brief	Write consecutive blocks with CMD25.
+	 *
+	 * @param	Addr	: First block number
+	 * @param	ppData	: Data of each block
+	 * @param	NbBlk	: Number of blocks
+	 *
+	 * @return	Number of blocks written
+	 */
+	int WriteMultiBlock(uint32_t Addr, uint8_t * const *ppData, int NbBlk);
 	bool SectRead(uint32_t SectNo, uint8_t *pData) {
 		return ReadSingleBlock(SectNo, pData, vDev.SectSize) == vDev.SectSize;
 	}
 	bool SectWrite(uint32_t SectNo, uint8_t *pData) {
 		return WriteSingleBlock(SectNo, pData, vDev.SectSize) == vDev.SectSize;
 	}
+	bool SectReadMulti(uint32_t SectNo, uint8_t * const *ppBuff, int NbSect) {
+		return ReadMultiBlock(SectNo, ppBuff, NbSect) == NbSect;
+	}
+	bool SectWriteMulti(uint32_t SectNo, uint8_t * const *ppData, int NbSect) {
+		return WriteMultiBlock(SectNo, ppData, NbSect) == NbSect;
+	}
 	//operator SDDEV *() { return &vDev; };
 
 protected:
 private:
+	bool WaitReady();
+	int SendData(uint8_t *pData, int Len, uint8_t Token);
+
 	//std::shared_ptr<SerialIntrf> vpInterf;
 	DeviceIntrf *vpInterf;
 	SDDEV vDev;
-	int NbCacheBlk;
-	DISKIO_CACHE_DESC vCacheDesc[SDCARD_CACHE_MAX];
 };
 
 extern "C" {
@@ -42,6 +42,8 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdbool.h>
 #endif
 
+#include "atomic.h"
+#include "cfifo.h"
 #include "iopincfg.h"
 #include "device.h"
 #include "timer.h"
@@ -75,8 +77,201 @@ typedef enum __Sensor_State {
 	SENSOR_STATE_SAMPLING			//!< Sampling in progress
 } SENSOR_STATE;
 
+#define SENSOR_DRDY_MAXINT		8		//!< Max pin interrupt number + 1 usable for data ready
+
+/// @brief	Hardware FIFO sample clock.
+///
+/// Timestamps samples drained from a hardware FIFO.  A reference sample of
+/// each batch, typically the watermark sample stamped by the watermark
+/// interrupt, gets its measured time.  Others are interpolated at the sample
+/// period measured between reference samples.
+typedef struct __Sensor_Fifo_Clock {
+	uint32_t RefTime;		//!< Time of last reference sample in usec
+	uint32_t RefIdx;		//!< Index of last reference sample, counted from init
+	uint32_t NextIdx;		//!< Index of next sample drained
+	uint32_t PeriodNs;		//!< Sample period in nsec
+	bool bRef;				//!< Reference time is valid
+} SENSOR_FIFOCLK;
+
+/**
+ * @brief	Initialize FIFO sample clock.
+ *
+ * @param	pClk		: FIFO clock
+ * @param	PeriodNs	: Nominal sample period in nsec, used until measured
+ */
+static inline void SensorFifoClkInit(SENSOR_FIFOCLK *pClk, uint32_t PeriodNs) {
+	memset(pClk, 0, sizeof(SENSOR_FIFOCLK));
+	pClk->PeriodNs = PeriodNs;
+}
+
+/**
+ * @brief	Start timestamping a batch of samples.
+ *
+ * @param	pClk	: FIFO clock
+ * @param	bTime	: true - RefTime is valid, false - extrapolate from last reference
+ * @param	RefTime	: Time of sample RefIdx of the batch in usec
+ * @param	RefIdx	: Index in the batch of the sample stamped with RefTime
+ * @param	Count	: Number of samples in the batch
+ *
+ * @return	Timestamp of first sample of the batch in usec
+ */
+static inline uint32_t SensorFifoClkBatch(SENSOR_FIFOCLK *pClk, bool bTime, uint32_t RefTime,
+										  int RefIdx, int Count) {
+	uint32_t first = pClk->NextIdx;
+
+	if (bTime)
+	{
+		uint32_t ref = first + RefIdx;
+
+		if (pClk->bRef && ref != pClk->RefIdx)
+		{
+			pClk->PeriodNs = (uint32_t)(((uint64_t)(RefTime - pClk->RefTime) * 1000ULL) / (ref - pClk->RefIdx));
+		}
+		pClk->RefTime = RefTime;
+		pClk->RefIdx = ref;
+		pClk->bRef = true;
+	}
+	pClk->NextIdx += Count;
+
+	return pClk->RefTime + (uint32_t)(((int64_t)(int32_t)(first - pClk->RefIdx) * pClk->PeriodNs) / 1000LL);
+}
+
+/**
+ * @brief	Timestamp of a sample of the batch.
+ *
+ * @param	pClk	: FIFO clock
+ * @param	First	: Timestamp of first sample, returned by SensorFifoClkBatch
+ * @param	Idx		: Sample index in the batch
+ *
+ * @return	Timestamp in usec
+ */
+static inline uint32_t SensorFifoClkTime(SENSOR_FIFOCLK *pClk, uint32_t First, int Idx) {
+	return First + (uint32_t)(((uint64_t)Idx * pClk->PeriodNs) / 1000ULL);
+}
+
+/// @brief	Sensor sample queue.
+///
+/// Blocking CFIFO holding one sample per block.  The driver queues each new
+/// sample, consumers read batches in place with peek & release.  Samples
+/// arriving while the queue is full are dropped & counted.  Single producer,
+/// single consumer.
+typedef struct __Sensor_Sample_Queue {
+	HCFIFO hFifo;			//!< Sample FIFO, NULL if not used
+	uint32_t PutCnt;		//!< Samples queued
+	uint32_t OvrCnt;		//!< Samples dropped, queue full
+} SENSOR_SAMPLEQUE;
+
+/// Memory size in bytes for a queue of NbSample samples
+#define SENSOR_SAMPLEQUE_MEMSIZE(NbSample, SampleSize)	CFIFO_TOTAL_MEMSIZE(NbSample, SampleSize)
+
+/**
+ * @brief	Initialize sample queue.
+ *
+ * @param	pQue		: Sample queue
+ * @param	pMem		: Queue memory, SENSOR_SAMPLEQUE_MEMSIZE bytes.  NULL to disable
+ * @param	MemSize		: Memory size in bytes
+ * @param	SampleSize	: Sample size in bytes
+ *
+ * @return	true - queue is enabled
+ */
+static inline bool SensorQueInit(SENSOR_SAMPLEQUE *pQue, uint8_t *pMem, int MemSize, int SampleSize) {
+	memset(pQue, 0, sizeof(SENSOR_SAMPLEQUE));
+
+	if (pMem == NULL || MemSize <= (int)sizeof(CFIFOHDR))
+		return false;
+
+	pQue->hFifo = CFifoInit(pMem, MemSize, SampleSize, true);
+
+	return pQue->hFifo != NULL;
+}
+
+/**
+ * @brief	Queue samples.  Called by driver when new data is read.
+ *
+ * @param	pQue		: Sample queue
+ * @param	pData		: Samples
+ * @param	Cnt			: Number of samples
+ * @param	SampleSize	: Sample size in bytes
+ *
+ * @return	Number of samples queued, others are dropped
+ */
+static inline int SensorQuePut(SENSOR_SAMPLEQUE *pQue, const void *pData, int Cnt, int SampleSize) {
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
+
+	if (pQue->hFifo == NULL)
+		return 0;
+
+	int n = CFifoReserve(pQue->hFifo, Cnt, span);
+	const uint8_t *p = (const uint8_t *)pData;
+
+	for (int i = 0; i < CFIFO_SPAN_MAX && span[i].Cnt > 0; i++)
+	{
+		memcpy(span[i].pBlk, p, span[i].Cnt * SampleSize);
+		p += span[i].Cnt * SampleSize;
+	}
+	CFifoCommit(pQue->hFifo, n);
+
+	pQue->PutCnt += n;
+	pQue->OvrCnt += Cnt - n;
+
+	return n;
+}
+
+/**
+ * @brief	Get oldest queued samples in place.
+ *
+ * Samples stay in the queue until released.  Only contiguous samples are
+ * returned, call again after release to get the samples after wrap around.
+ *
+ * @param	pQue	: Sample queue
+ * @param	ppData	: Receives pointer to first sample
+ * @param	MaxCnt	: Max number of samples
+ *
+ * @return	Number of samples at *ppData
+ */
+static inline int SensorQuePeek(SENSOR_SAMPLEQUE *pQue, void **ppData, int MaxCnt) {
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
+
+	if (pQue->hFifo == NULL || CFifoPeek(pQue->hFifo, MaxCnt, span) <= 0)
+		return 0;
+
+	*ppData = span[0].pBlk;
+
+	return span[0].Cnt;
+}
+
+/**
+ * @brief	Remove samples returned by SensorQuePeek.
+ *
+ * @param	pQue	: Sample queue
+ * @param	Cnt		: Number of samples consumed
+ */
+static inline void SensorQueRelease(SENSOR_SAMPLEQUE *pQue, int Cnt) {
+	if (pQue->hFifo)
+	{
+		CFifoRelease(pQue->hFifo, Cnt);
+	}
+}
+
+/**
+ * @brief	Number of samples in queue.
+ */
+static inline int SensorQueUsed(SENSOR_SAMPLEQUE *pQue) {
+	return pQue->hFifo ? CFifoUsed(pQue->hFifo) : 0;
+}
+
 #ifdef __cplusplus
 
+class Sensor;
+
+/// @brief	Data ready notification.
+///
+/// Called from the pin interrupt when the sensor signals new data.  Typically
+/// wakes the task or posts the event calling Sensor::Process.
+///
+/// @param	pSensor : Sensor with new data
+typedef void (*SENSOR_DRDYCB)(Sensor *pSensor);
+
 /// @brief	Sensor generic base class.
 ///
 /// Require implementations :
@@ -89,6 +284,11 @@ typedef enum __Sensor_State {
 ///
 class Sensor : virtual public Device {
 public:
+	Sensor() : vState(SENSOR_STATE_SLEEP), vOpMode(SENSOR_OPMODE_SINGLE), vSampFreq(0),
+			   vSampPeriod(0), vpTimer(NULL), vbSampling(false), vSampleCnt(0),
+			   vSampleTime(0), vTimerTrigId(-1), vDrdyIntNo(-1), vDrdyPending(0),
+			   vDrdyOvrCnt(0), vDrdyCB(NULL), vDrdyDiv(1), vDrdyCnt(0), vDrdyTime(0) {}
+
 	/**
 	 * @brief	Start sampling data
 	 *
@@ -119,7 +319,8 @@ public:
 		vSampFreq = Freq;
         vSampPeriod = 1000000000LL / vSampFreq;
 
-		if (vpTimer && OpMode == SENSOR_OPMODE_CONTINUOUS)
+		// Data ready interrupt paces sampling, no timer polling
+		if (vpTimer && OpMode == SENSOR_OPMODE_CONTINUOUS && vDrdyIntNo < 0)
 		{
 		    vTimerTrigId = vpTimer->EnableTimerTrigger(vSampPeriod, TIMER_TRIG_TYPE_CONTINUOUS,
 		                                               TimerTrigHandler, (void*)this);
@@ -202,6 +403,51 @@ public:
 	 */
 	virtual bool UpdateData() = 0;
 
+	/**
+	 * @brief	Use data ready interrupt instead of timer polling.
+	 *
+	 * The pin interrupt only flags new data and calls the notify callback.
+	 * Data is read by Process, from a task or main loop, only when the device
+	 * signaled it.  Continuous mode timer trigger is stopped.
+	 *
+	 * Without pin, PortNo < 0, data ready interrupt is disabled and continuous
+	 * mode falls back to timer polling.
+	 *
+	 * @param	Pin		: Data ready pin, PortNo < 0 for none
+	 * @param	IntNo	: Pin interrupt number, less than SENSOR_DRDY_MAXINT
+	 * @param	IntPrio	: Pin interrupt priority
+	 * @param	Sense	: Active edge of data ready signal
+	 * @param	NotifyCB: Called from interrupt on new data, NULL if not used
+	 *
+	 * @return	true - data ready interrupt is used\n
+	 * 			false - timer polling is used
+	 */
+	bool DataReadyInt(const IOPINCFG &Pin, int IntNo, int IntPrio, IOPINSENSE Sense,
+					  SENSOR_DRDYCB NotifyCB = NULL);
+
+	/**
+	 * @brief	Data ready worker.
+	 *
+	 * Reads the sensor if data ready was signaled since last call.  Events
+	 * coalesced because the worker ran late are counted in DataReadyOverrun.
+	 * Must not be called from interrupt.
+	 *
+	 * @return	true - new data was read
+	 */
+	bool Process();
+
+	/**
+	 * @brief	Data ready pending.
+	 *
+	 * @return	true - data ready signaled, not yet processed
+	 */
+	bool DataReady() { return AtomicLoadAcquire((sig_atomic_t*)&vDrdyPending) != 0; }
+
+	/**
+	 * @brief	Number of data ready events lost because Process ran late.
+	 */
+	uint32_t DataReadyOverrun() { return vDrdyOvrCnt; }
+
 	static void TimerTrigHandler(Timer *pTimer, int TrigNo, void *pContext) {
 	    Sensor *sensor = (Sensor*)pContext;
 
@@ -211,6 +457,18 @@ public:
 
 protected:
 
+	/**
+	 * @brief	Configure device data ready output.
+	 *
+	 * Sensor implementation must overload this function if the device has a
+	 * data ready interrupt output.
+	 *
+	 * @param	bEnable : true - enable data ready output
+	 *
+	 * @return	true - success, false if not supported
+	 */
+	virtual bool DataReadyEnable(bool bEnable) { return false; }
+
 	SENSOR_STATE vState;		//!< Current sensor state
 	SENSOR_OPMODE vOpMode;		//!< Current operating mode
 	uint32_t vSampFreq;			//!< Sampling frequency in milliHerz, relevant to CONTINUOUS mode
@@ -220,6 +478,16 @@ protected:
 	uint64_t vSampleCnt;		//!< Keeping sample count
 	uint64_t vSampleTime;		//!< Time stamp when sampling is started
 	int vTimerTrigId;
+	int vDrdyIntNo;				//!< Data ready pin interrupt number, -1 for timer polling
+	volatile sig_atomic_t vDrdyPending;	//!< Data ready events not yet processed
+	uint32_t vDrdyOvrCnt;		//!< Data ready events coalesced
+	SENSOR_DRDYCB vDrdyCB;		//!< Data ready notification
+	int vDrdyDiv;				//!< Data ready interrupts per event, FIFO watermark emulation
+	int vDrdyCnt;				//!< Data ready interrupts counted toward vDrdyDiv
+	volatile uint32_t vDrdyTime;	//!< Time of last data ready event in usec, set if timer is available
+
+private:
+	static void DrdyIntHandler(int IntNo);
 };
 
 extern "C" {
@@ -63,18 +63,99 @@ typedef struct __AccelSensor_Config {
 
 #pragma pack(pop)
 
+class AccelSensor;
+
+/// @brief	Accel sample batch callback, for hardware FIFO mode.
+///
+/// @param	pSensor	: Sensor
+/// @param	pData	: Samples in time order
+/// @param	Count	: Number of samples
+typedef void (*ACCELBATCHCB)(AccelSensor *pSensor, const ACCELSENSOR_DATA *pData, int Count);
 
 class AccelSensor : virtual public Sensor {
 public:
+	AccelSensor() : vAccelBatchCB(NULL), vAccelQue(), vIntHandler(NULL), vScale(0) {}
+
 	virtual bool Init(const ACCELSENSOR_CFG &Cfg, DeviceIntrf *pIntrf, Timer *pTimer) = 0;
 	virtual bool Read(ACCELSENSOR_DATA *pData) = 0;
 	virtual uint8_t Scale() { return vScale; }
 	virtual uint8_t Scale(uint8_t Value) { vScale = Value; return vScale; }
 
+	/**
+	 * @brief	Set hardware FIFO watermark.
+	 *
+	 * In FIFO mode the sensor signals data ready once Watermark samples are
+	 * queued.  Samples are drained in bursts and delivered to the batch
+	 * callback with timestamps interpolated between watermark events.
+	 * Sensor implementation must overload this function if the device has a
+	 * FIFO.
+	 *
+	 * @param	Watermark	: Samples per batch, 0 to disable FIFO mode
+	 * @param	BatchCB		: Batch callback
+	 *
+	 * @return	Watermark set, 0 if FIFO mode is disabled or not supported
+	 */
+	virtual int FifoWatermark(int Watermark, ACCELBATCHCB BatchCB) { return 0; }
+
+	/**
+	 * @brief	Enable sample queue.
+	 *
+	 * Each new sample is queued with its timestamp in addition to updating the
+	 * last measured data.  The consumer reads batches in place with AccelPeek and
+	 * AccelRelease instead of polling Read for each sample.
+	 *
+	 * @param	pMem	: Queue memory, SENSOR_SAMPLEQUE_MEMSIZE(NbSample, sizeof(ACCELSENSOR_DATA)) bytes.
+	 * 					  NULL to disable
+	 * @param	MemSize	: Memory size in bytes
+	 *
+	 * @return	true - queue is enabled
+	 */
+	bool AccelQueue(uint8_t *pMem, int MemSize) {
+		return SensorQueInit(&vAccelQue, pMem, MemSize, sizeof(ACCELSENSOR_DATA));
+	}
+
+	/**
+	 * @brief	Get oldest queued samples in place.
+	 *
+	 * @param	ppData	: Receives pointer to first sample
+	 * @param	MaxCnt	: Max number of samples
+	 *
+	 * @return	Number of contiguous samples at *ppData
+	 */
+	int AccelPeek(ACCELSENSOR_DATA **ppData, int MaxCnt) {
+		return SensorQuePeek(&vAccelQue, (void **)ppData, MaxCnt);
+	}
+
+	/**
+	 * @brief	Remove samples returned by AccelPeek.
+	 *
+	 * @param	Cnt	: Number of samples consumed
+	 */
+	void AccelRelease(int Cnt) { SensorQueRelease(&vAccelQue, Cnt); }
+
+	/**
+	 * @brief	Get sample queue counters.
+	 *
+	 * @return	Queue state, OvrCnt is the number of samples dropped
+	 */
+	const SENSOR_SAMPLEQUE &AccelQueStat() { return vAccelQue; }
+
 protected:
 	virtual bool UpdateData() = 0;
 
+	/**
+	 * @brief	Queue samples.  Called by implementation on new samples.
+	 *
+	 * @param	pData	: Samples in time order
+	 * @param	Count	: Number of samples
+	 */
+	void AccelQuePut(const ACCELSENSOR_DATA *pData, int Count) {
+		SensorQuePut(&vAccelQue, pData, Count, sizeof(ACCELSENSOR_DATA));
+	}
+
 	ACCELSENSOR_DATA vData;
+	ACCELBATCHCB vAccelBatchCB;		//!< FIFO mode batch callback
+	SENSOR_SAMPLEQUE vAccelQue;		//!< Sample queue
 
 private:
 	ACCELINTCB vIntHandler;
@@ -0,0 +1,234 @@
+/**-------------------------------------------------------------------------
+@file	agm_fusion.h
+
+@brief	Accel, gyro, mag sensor fusion.
+
+Orientation estimation from AGM sensor samples, output as unit quaternion.
+Two filters are available :
+- Madgwick : gradient descent correction, single gain Beta
+- Mahony : proportional integral correction, gains Kp & Ki, also estimates
+  gyro bias
+
+Each filter has a float kernel and a fixed point kernel for cores without
+FPU.  The fixed point kernel computes in Q8.24 using 32x32->64 bit multiplies
+and a single 64 bit division per normalization.  Inputs are raw sensor
+counts, outputs are available in Q15 for streaming and Q31.
+
+Magnetometer is optional, without it heading drifts with gyro bias.  Mag
+axes must be aligned to the accel frame by the caller.
+
+Streaming a Q15 quaternion with timestamp is 12 bytes per sample instead of
+22 bytes for raw accel, gyro & mag axes.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __AGM_FUSION_H__
+#define __AGM_FUSION_H__
+
+#include <stdint.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#include "sensors/accel_sensor.h"
+#include "sensors/gyro_sensor.h"
+#include "sensors/mag_sensor.h"
+
+/** @addtogroup Sensors
+  * @{
+  */
+
+#define AGMFUSION_Q24_ONE		(1L << 24)		//!< 1.0 in Q8.24
+
+typedef enum __AgmFusion_Algo {
+	AGMFUSION_ALGO_MADGWICK,	//!< Madgwick gradient descent
+	AGMFUSION_ALGO_MAHONY,		//!< Mahony complementary PI
+} AGMFUSION_ALGO;
+
+#pragma pack(push, 4)
+
+/// Fusion configuration
+typedef struct __AgmFusion_Config {
+	AGMFUSION_ALGO Algo;	//!< Filter algorithm
+	float SampFreq;			//!< Sampling frequency in Hz
+	float GyroSens;			//!< Gyro sensitivity in rad/s per count
+	float Gain;				//!< Madgwick Beta or Mahony Kp
+	float Ki;				//!< Mahony integral gain, 0 for none. Unused by Madgwick
+} AGMFUSION_CFG;
+
+/// Float kernel state
+typedef struct __AgmFusion_Float {
+	AGMFUSION_ALGO Algo;
+	float q[4];				//!< Orientation quaternion w, x, y, z
+	float eInt[3];			//!< Mahony integral error
+	float Gain;
+	float Ki;
+	float Dt;				//!< Sampling period in sec
+	float GyroSens;
+} AGMFUSIONF;
+
+/// Fixed point kernel state, all Q8.24
+typedef struct __AgmFusion_Fixed {
+	AGMFUSION_ALGO Algo;
+	int32_t q[4];			//!< Orientation quaternion w, x, y, z
+	int32_t eInt[3];		//!< Mahony integral error
+	int32_t Gain;
+	int32_t Ki;
+	int32_t Dt;				//!< Sampling period in sec
+	int32_t GyroSens;
+} AGMFUSIONQ;
+
+#pragma pack(pop)
+
+#pragma pack(push, 1)
+
+/// Fused orientation sample
+typedef struct __AgmFusion_Quat {
+	uint32_t Timestamp;		//!< Timestamp of gyro sample
+	int16_t w;				//!< Quaternion in Q15
+	int16_t x;
+	int16_t y;
+	int16_t z;
+} AGMFUSION_QUAT;
+
+#pragma pack(pop)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief	Initialize float kernel, orientation is reset to identity.
+ *
+ * @param	pFus	: Kernel state
+ * @param	pCfg	: Configuration
+ */
+void AgmFusionInitF(AGMFUSIONF *pFus, const AGMFUSION_CFG *pCfg);
+
+/**
+ * @brief	Float kernel update with one sample set.
+ *
+ * @param	pFus	: Kernel state
+ * @param	pAccel	: Accel x, y, z in counts.  All 0 to skip correction
+ * @param	pGyro	: Gyro x, y, z in counts
+ * @param	pMag	: Mag x, y, z in counts, aligned to accel axes.  NULL if none
+ */
+void AgmFusionUpdateF(AGMFUSIONF *pFus, const int16_t *pAccel, const int16_t *pGyro, const int16_t *pMag);
+
+/**
+ * @brief	Initialize fixed point kernel, orientation is reset to identity.
+ *
+ * Configuration is converted to Q8.24 once here.
+ *
+ * @param	pFus	: Kernel state
+ * @param	pCfg	: Configuration
+ */
+void AgmFusionInitQ(AGMFUSIONQ *pFus, const AGMFUSION_CFG *pCfg);
+
+/**
+ * @brief	Fixed point kernel update with one sample set.
+ *
+ * Same as AgmFusionUpdateF without floating point operations.
+ */
+void AgmFusionUpdateQ(AGMFUSIONQ *pFus, const int16_t *pAccel, const int16_t *pGyro, const int16_t *pMag);
+
+/**
+ * @brief	Get fixed point kernel orientation in Q31.
+ *
+ * @param	pFus	: Kernel state
+ * @param	pQ		: Receives w, x, y, z
+ */
+void AgmFusionQ31(const AGMFUSIONQ *pFus, int32_t *pQ);
+
+#ifdef __cplusplus
+}
+
+/// @brief	Sensor fusion pipeline stage.
+///
+/// Consumes sample batches as delivered by AGM sensors in FIFO mode and
+/// produces timestamped quaternions.
+class AgmFusion {
+public:
+	AgmFusion() : vbFixed(false) {}
+
+	/**
+	 * @brief	Initialize fusion.
+	 *
+	 * @param	Cfg		: Configuration
+	 * @param	bFixed	: true - use fixed point kernel
+	 *
+	 * @return	true - Success
+	 */
+	bool Init(const AGMFUSION_CFG &Cfg, bool bFixed = false);
+
+	/**
+	 * @brief	Update with a batch of samples.
+	 *
+	 * Samples at same index are from the same sampling instant.
+	 *
+	 * @param	pAccel	: Accel samples
+	 * @param	pGyro	: Gyro samples
+	 * @param	pMag	: Mag samples, NULL if none
+	 * @param	Count	: Number of samples
+	 * @param	pQuat	: Receives one quaternion per sample, NULL for last only
+	 *
+	 * @return	Number of samples processed
+	 */
+	int Update(const ACCELSENSOR_DATA *pAccel, const GYROSENSOR_DATA *pGyro,
+			   const MAGSENSOR_DATA *pMag, int Count, AGMFUSION_QUAT *pQuat = NULL);
+
+	/**
+	 * @brief	Get last orientation.
+	 *
+	 * @param	Quat : Receives quaternion in Q15 with timestamp
+	 */
+	void Read(AGMFUSION_QUAT &Quat) { Quat = vQuat; }
+
+	/**
+	 * @brief	Get last orientation in float.
+	 *
+	 * @param	pQ : Receives w, x, y, z
+	 */
+	void Read(float *pQ);
+
+	bool Fixed() { return vbFixed; }
+
+private:
+	bool vbFixed;
+	AGMFUSIONF vFusF;
+	AGMFUSIONQ vFusQ;
+	AGMFUSION_QUAT vQuat;		//!< Last output
+};
+
+#endif // __cplusplus
+
+/** @} End of group Sensors */
+
+#endif // __AGM_FUSION_H__
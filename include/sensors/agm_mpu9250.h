@@ -361,13 +361,25 @@ Modified by          Date              Description
 #define MPU9250_MAG_ASAY				0x11
 #define MPU9250_MAG_ASAZ				0x12
 
+#define MPU9250_FIFO_SIZE				512
+#define MPU9250_FIFO_FRAME_SIZE			12			// Accel & gyro, 6 bytes each
+#define MPU9250_FIFO_MAX_FRAME			(MPU9250_FIFO_SIZE / MPU9250_FIFO_FRAME_SIZE)
+#define MPU9250_FIFO_DRAIN_FRAME		16			// Frames per drain burst, sets stack use
+
 
 #pragma pack(push, 1)
 
 #pragma pack(pop)
 
+/// @brief	MPU9250 accel, gyro & mag.
+///
+/// FIFO mode : the device has no watermark interrupt.  Data ready interrupts
+/// are counted down to the watermark before the drain is signaled, so there is
+/// one wakeup & one drain per watermark.
 class AgmMpu9250 : public AccelSensor, public GyroSensor, public MagSensor {
 public:
+	AgmMpu9250() : vbSpi(false), vbInitialized(false), vFifoWm(0) {}
+
 	virtual bool Init(const ACCELSENSOR_CFG &Cfg, DeviceIntrf *pIntrf, Timer *pTimer = NULL);
 	virtual bool Init(const GYROSENSOR_CFG&, DeviceIntrf*, Timer *pTimer = NULL);
 	virtual bool Init(const MAGSENSOR_CFG&, DeviceIntrf*, Timer *pTimer = NULL);
@@ -380,6 +392,8 @@ public:
 	virtual bool Read(ACCELSENSOR_DATA *pData);
 	virtual bool Read(GYROSENSOR_DATA*);
 	virtual bool Read(MAGSENSOR_DATA*);
+	virtual int FifoWatermark(int Watermark, ACCELBATCHCB BatchCB);
+	virtual int FifoWatermark(int Watermark, GYROBATCHCB BatchCB);
 	/**
 	 * @brief	Set sampling frequency.
 	 * 		The sampling frequency is relevant only in continuous mode.
@@ -388,14 +402,21 @@ public:
 	 */
 	 uint32_t SamplingFrequency(uint32_t FreqHz);
 
+protected:
+	virtual bool DataReadyEnable(bool bEnable);
+
 private:
 	bool InitDefault(uint32_t DevAddr, DeviceIntrf *pIntrf, Timer *pTimer);
+	int FifoConfig(int Watermark);
+	int FifoDrain();
 	bool UpdateData();
 	int Read(uint8_t *pCmdAddr, int CmdAddrLen, uint8_t *pBuff, int BuffLen);
 	int Write(uint8_t *pCmdAddr, int CmdAddrLen, uint8_t *pData, int DataLen);
 
 	bool vbSpi;
 	bool vbInitialized;
+	int vFifoWm;				//!< FIFO watermark in frames, 0 FIFO not used
+	SENSOR_FIFOCLK vFifoClk;	//!< FIFO sample timestamps
 };
 
 #endif // __AGM_MPU9250_H__
@@ -86,6 +86,7 @@ typedef struct __GasSensor_Config {
 /// Gas sensor base class, implementation must derive this class
 class GasSensor : virtual public Sensor {
 public:
+	GasSensor() : vGasQue() {}
 
 	/**
 	 * @brief	Initialize sensor (require implementation).
@@ -129,9 +130,58 @@ public:
 	 */
 	virtual bool SetHeatingProfile(int Count, const GASSENSOR_HEAT *pProfile) = 0;
 
+	/**
+	 * @brief	Enable sample queue.
+	 *
+	 * Each new sample is queued with its timestamp in addition to updating the
+	 * last measured data.  The consumer reads batches in place with GasPeek and
+	 * GasRelease instead of polling Read for each sample.
+	 *
+	 * @param	pMem	: Queue memory, SENSOR_SAMPLEQUE_MEMSIZE(NbSample, sizeof(GASSENSOR_DATA)) bytes.
+	 * 					  NULL to disable
+	 * @param	MemSize	: Memory size in bytes
+	 *
+	 * @return	true - queue is enabled
+	 */
+	bool GasQueue(uint8_t *pMem, int MemSize) {
+		return SensorQueInit(&vGasQue, pMem, MemSize, sizeof(GASSENSOR_DATA));
+	}
+
+	/**
+	 * @brief	Get oldest queued samples in place.
+	 *
+	 * @param	ppData	: Receives pointer to first sample
+	 * @param	MaxCnt	: Max number of samples
+	 *
+	 * @return	Number of contiguous samples at *ppData
+	 */
+	int GasPeek(GASSENSOR_DATA **ppData, int MaxCnt) {
+		return SensorQuePeek(&vGasQue, (void **)ppData, MaxCnt);
+	}
+
+	/**
+	 * @brief	Remove samples returned by GasPeek.
+	 *
+	 * @param	Cnt	: Number of samples consumed
+	 */
+	void GasRelease(int Cnt) { SensorQueRelease(&vGasQue, Cnt); }
+
+	/**
+	 * @brief	Get sample queue counters.
+	 *
+	 * @return	Queue state, OvrCnt is the number of samples dropped
+	 */
+	const SENSOR_SAMPLEQUE &GasQueStat() { return vGasQue; }
+
 protected:
 
+	/**
+	 * @brief	Queue last measured data.  Called by implementation on new sample.
+	 */
+	void GasQuePut() { SensorQuePut(&vGasQue, &vGasData, 1, sizeof(GASSENSOR_DATA)); }
+
 	GASSENSOR_DATA vGasData;	//!< Last measured data
+	SENSOR_SAMPLEQUE vGasQue;	//!< Sample queue
 };
 
 extern "C" {
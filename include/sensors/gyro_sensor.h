@@ -58,11 +58,39 @@ typedef struct __GyroSensor_Config {
 
 #pragma pack(pop)
 
+class GyroSensor;
+
+/// @brief	Gyro sample batch callback, for hardware FIFO mode.
+///
+/// @param	pSensor	: Sensor
+/// @param	pData	: Samples in time order
+/// @param	Count	: Number of samples
+typedef void (*GYROBATCHCB)(GyroSensor *pSensor, const GYROSENSOR_DATA *pData, int Count);
+
 class GyroSensor : virtual public Sensor {
 public:
+	GyroSensor() : vGyroBatchCB(NULL) {}
+
 	virtual bool Init(const GYROSENSOR_CFG &Cfg, DeviceIntrf *pIntrf, Timer *pTimer) = 0;
 	virtual bool Read(GYROSENSOR_DATA *pData) = 0;
 
+	/**
+	 * @brief	Set hardware FIFO watermark.
+	 *
+	 * See AccelSensor::FifoWatermark.  On combined devices accel & gyro share
+	 * the FIFO and the watermark.
+	 *
+	 * @param	Watermark	: Samples per batch, 0 to disable FIFO mode
+	 * @param	BatchCB		: Batch callback
+	 *
+	 * @return	Watermark set, 0 if FIFO mode is disabled or not supported
+	 */
+	virtual int FifoWatermark(int Watermark, GYROBATCHCB BatchCB) { return 0; }
+
+protected:
+	GYROSENSOR_DATA vGyroData;		//!< Last sample
+	GYROBATCHCB vGyroBatchCB;		//!< FIFO mode batch callback
+
 private:
 };
 
@@ -281,6 +281,8 @@ private:
 	BME280_CALIB_DATA vCalibData;
 	uint8_t vCtrlReg;
 	bool vbSpi;
+	DEVREGCACHE vRegCache;	// Control register cache
+	uint8_t vRegCacheMem[DEVREGCACHE_MEMSIZE(BME280_REG_CONFIG - BME280_REG_CTRL_HUM + 1)];
 };
 
 extern "C" {
@@ -89,6 +89,7 @@ typedef struct __TPHSensor_Config {
 /// TPH sensor base class.  Sensor implementation must derive form this class
 class TphSensor : virtual public Sensor {
 public:
+	TphSensor() : vTphQue() {}
 
 	/**
 	 * @brief	Initialize sensor (require implementation).
@@ -143,10 +144,59 @@ public:
 	 */
 	virtual float ReadHumidity() = 0;
 
+	/**
+	 * @brief	Enable sample queue.
+	 *
+	 * Each new sample is queued with its timestamp in addition to updating the
+	 * last measured data.  The consumer reads batches in place with TphPeek and
+	 * TphRelease instead of polling Read for each sample.
+	 *
+	 * @param	pMem	: Queue memory, SENSOR_SAMPLEQUE_MEMSIZE(NbSample, sizeof(TPHSENSOR_DATA)) bytes.
+	 * 					  NULL to disable
+	 * @param	MemSize	: Memory size in bytes
+	 *
+	 * @return	true - queue is enabled
+	 */
+	bool TphQueue(uint8_t *pMem, int MemSize) {
+		return SensorQueInit(&vTphQue, pMem, MemSize, sizeof(TPHSENSOR_DATA));
+	}
+
+	/**
+	 * @brief	Get oldest queued samples in place.
+	 *
+	 * @param	ppData	: Receives pointer to first sample
+	 * @param	MaxCnt	: Max number of samples
+	 *
+	 * @return	Number of contiguous samples at *ppData
+	 */
+	int TphPeek(TPHSENSOR_DATA **ppData, int MaxCnt) {
+		return SensorQuePeek(&vTphQue, (void **)ppData, MaxCnt);
+	}
+
+	/**
+	 * @brief	Remove samples returned by TphPeek.
+	 *
+	 * @param	Cnt	: Number of samples consumed
+	 */
+	void TphRelease(int Cnt) { SensorQueRelease(&vTphQue, Cnt); }
+
+	/**
+	 * @brief	Get sample queue counters.
+	 *
+	 * @return	Queue state, OvrCnt is the number of samples dropped
+	 */
+	const SENSOR_SAMPLEQUE &TphQueStat() { return vTphQue; }
+
 protected:
 
+	/**
+	 * @brief	Queue last measured data.  Called by implementation on new sample.
+	 */
+	void TphQuePut() { SensorQuePut(&vTphQue, &vTphData, 1, sizeof(TPHSENSOR_DATA)); }
+
 	TPHSENSOR_DATA 	vTphData;			//!< Last measured data
 	TPHDataRdyCB	vDataRdyHandler;	//!< Callback data ready handler
+	SENSOR_SAMPLEQUE vTphQue;			//!< Sample queue
 };
 
 extern "C" {
@@ -461,6 +461,8 @@ private:
 	bool vbGasData;
 	int vNbHeatPoint;		// Number of heating points
 	GASSENSOR_HEAT vHeatPoints[BME680_GAS_HEAT_PROFILE_MAX];
+	DEVREGCACHE vRegCache;	// Heater & control register cache
+	uint8_t vRegCacheMem[DEVREGCACHE_MEMSIZE(BME680_REG_CONFIG - BME680_REG_RES_HEAT_X_START + 1)];
 };
 
 extern "C" {
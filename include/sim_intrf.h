@@ -0,0 +1,513 @@
+/**-------------------------------------------------------------------------
+@file	sim_intrf.h
+
+@brief	Simulated device interface.
+
+Software implementation of DEVINTRF for running device drivers on host.  Bus
+traffic is routed to device models attached to the interface by device
+address (I2C address or SPI chip select).  Memory & register models are
+provided for SPI NOR flash, SD card in SPI mode, I2C EEPROM and register
+file devices such as the BME280 and MPU9250.
+
+Each transfer is charged to a simulated clock using a simple cost model :
+	- XferNs per transaction (start to stop), covering start/stop condition,
+	  chip select and driver setup
+	- Bit time derived from Rate, 8 bits per byte on SPI, 9 on I2C (ack bit).
+	  I2C start & restart conditions also send the address byte
+	- ByteNs per byte, extra per byte overhead such as polled CPU handling
+	- Device busy time reported by models (flash program/erase, EEPROM write
+	  cycle)
+
+Bus transaction counts, byte counts and simulated time are accumulated in
+SIMINTRF_STATS to benchmark the effective throughput of drivers.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __SIM_INTRF_H__
+#define __SIM_INTRF_H__
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#include "device_intrf.h"
+#include "device_intrf_async.h"
+
+/** @addtogroup device_intrf	Device Interface
+  * @{
+  */
+
+#define SIMINTRF_MAX_DEV		4		//!< Max number of device models per interface
+
+/// Simulated bus type
+typedef enum __SimIntrf_Bus {
+	SIMINTRF_BUS_SPI,			//!< 8 bits per byte, full duplex
+	SIMINTRF_BUS_I2C,			//!< 9 bits per byte, address byte on each (re)start
+} SIMINTRF_BUS;
+
+/// @brief	Device model forward data structure type definition.
+typedef struct __SimIntrf_Model SIMINTRF_MODEL;
+
+/// @brief	Device model interface.
+///
+/// Implemented by each device model.  All functions are mandatory.
+struct __SimIntrf_Model {
+	void *pModelData;		//!< Private model data
+
+	/**
+	 * @brief	Start or restart condition addressing this device.
+	 *
+	 * @param	pModel	: Pointer to model
+	 * @param	bRx		: true - start of read phase (StartRx)
+	 *
+	 * @return	true - device responded (ACK)\n
+	 * 			false - no response (NACK)
+	 */
+	bool (*Start)(SIMINTRF_MODEL *pModel, bool bRx);
+
+	/**
+	 * @brief	Data from host to device.
+	 *
+	 * @param	pModel	: Pointer to model
+	 * @param	pData	: Data received by the device
+	 * @param	DataLen	: Length of data in bytes
+	 *
+	 * @return	Number of bytes accepted
+	 */
+	int (*Write)(SIMINTRF_MODEL *pModel, const uint8_t *pData, int DataLen);
+
+	/**
+	 * @brief	Data from device to host.
+	 *
+	 * @param	pModel	: Pointer to model
+	 * @param	pBuff	: Buffer to fill with device data
+	 * @param	BuffLen	: Number of bytes requested
+	 *
+	 * @return	Number of bytes returned
+	 */
+	int (*Read)(SIMINTRF_MODEL *pModel, uint8_t *pBuff, int BuffLen);
+
+	/**
+	 * @brief	Stop condition, end of transaction.
+	 *
+	 * @param	pModel	: Pointer to model
+	 *
+	 * @return	Device internal busy time in nsec started by this transaction
+	 * 			(program, erase, write cycle).  It is added to the simulated time.
+	 */
+	uint32_t (*Stop)(SIMINTRF_MODEL *pModel);
+};
+
+#pragma pack(push, 4)
+
+/// Configuration data used to initialize the simulated interface
+typedef struct __SimIntrf_Config {
+	SIMINTRF_BUS Bus;		//!< Bus type
+	int Rate;				//!< Bus clock in Hz
+	uint32_t XferNs;		//!< Cost per transaction in nsec
+	uint32_t ByteNs;		//!< Extra cost per byte in nsec, added to bit time
+	int MaxRetry;			//!< Max number of retry
+	int RxMax;				//!< Max bytes returned per RxData call, 0 - no limit
+} SIMINTRF_CFG;
+
+/// Bus activity statistics
+typedef struct __SimIntrf_Stats {
+	uint32_t XferCnt;		//!< Number of transactions (start to stop)
+	uint32_t StartCnt;		//!< Number of start & restart conditions
+	uint32_t NackCnt;		//!< Number of unanswered start conditions
+	uint64_t TxBytes;		//!< Data bytes sent to devices
+	uint64_t RxBytes;		//!< Data bytes received from devices
+	uint64_t BusNs;			//!< Simulated bus time in nsec
+	uint64_t DevNs;			//!< Simulated device busy time in nsec
+	uint64_t WallNs;		//!< Simulated elapsed time in nsec, advanced by SimIntrfRun only
+} SIMINTRF_STATS;
+
+/// Device model attached to an address
+typedef struct __SimIntrf_Slot {
+	int DevAddr;			//!< Device address or chip select
+	SIMINTRF_MODEL *pModel;	//!< Device model
+} SIMINTRF_SLOT;
+
+/// Device driver data
+typedef struct __SimIntrf_Device {
+	SIMINTRF_BUS Bus;		//!< Bus type
+	int Rate;				//!< Bus clock in Hz
+	uint32_t XferNs;		//!< Cost per transaction in nsec
+	uint32_t ByteNs;		//!< Extra cost per byte in nsec
+	uint32_t BytePs;		//!< Total cost per byte in psec, bit time included
+	int RxMax;				//!< Max bytes returned per RxData call, 0 - no limit
+	int NbDev;				//!< Number of attached device models
+	SIMINTRF_SLOT Dev[SIMINTRF_MAX_DEV];	//!< Attached device models
+	SIMINTRF_MODEL *pActive;//!< Model addressed by current transaction
+	SIMINTRF_STATS Stats;	//!< Bus activity statistics
+	DEVINTRFQUE *pQue;		//!< Transaction queue in completion driven mode
+	bool bPending;			//!< Queue transaction in progress
+	int PendCount;			//!< Result of transaction in progress
+	uint64_t PendNs;		//!< Bus time left for transaction in progress
+	DEVINTRF DevIntrf;		//!< Device interface implementation
+} SIMINTRFDEV;
+
+#pragma pack(pop)
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+/**
+ * @brief	Initialize simulated interface.
+ *
+ * @param	pDev 		: Pointer to device data to initialize
+ * @param	pCfgData 	: Pointer to configuration
+ *
+ * @return	true - Success
+ */
+bool SimIntrfInit(SIMINTRFDEV *pDev, const SIMINTRF_CFG *pCfgData);
+
+/**
+ * @brief	Attach a device model to the interface.
+ *
+ * @param	pDev 	: Pointer to simulated interface
+ * @param	DevAddr	: Device address or chip select the model responds to
+ * @param	pModel	: Pointer to initialized device model
+ *
+ * @return	true - Success\n
+ * 			false - Device table full
+ */
+bool SimIntrfAttach(SIMINTRFDEV *pDev, int DevAddr, SIMINTRF_MODEL *pModel);
+
+/**
+ * @brief	Clear bus activity statistics.
+ *
+ * @param	pDev 	: Pointer to simulated interface
+ */
+static inline void SimIntrfResetStats(SIMINTRFDEV *pDev) {
+	memset(&pDev->Stats, 0, sizeof(SIMINTRF_STATS));
+}
+
+/**
+ * @brief	Get total simulated time, bus & device busy time.
+ *
+ * @param	pDev 	: Pointer to simulated interface
+ *
+ * @return	Simulated time in nsec
+ */
+static inline uint64_t SimIntrfTime(SIMINTRFDEV *pDev) {
+	return pDev->Stats.BusNs + pDev->Stats.DevNs;
+}
+
+/**
+ * @brief	Initialize a transaction queue driven by simulated completion.
+ *
+ * Queued transactions are executed on the device models when started and
+ * complete once SimIntrfRun has advanced the simulated elapsed time by their
+ * bus time, as a DMA completion interrupt would.  Bus utilization is then
+ * Stats.BusNs / Stats.WallNs.
+ *
+ * @param	pDev 	: Pointer to simulated interface
+ * @param	pQue	: Queue to initialize
+ *
+ * @return	true - Success
+ */
+bool SimIntrfQueInit(SIMINTRFDEV *pDev, DEVINTRFQUE *pQue);
+
+/**
+ * @brief	Advance simulated elapsed time.
+ *
+ * Stands for time the application spends on other work.  Queue transactions
+ * ending within that time are completed in order.
+ *
+ * @param	pDev 	: Pointer to simulated interface
+ * @param	Ns		: Time to advance in nsec
+ */
+void SimIntrfRun(SIMINTRFDEV *pDev, uint64_t Ns);
+
+/**
+ * @brief	Advance simulated elapsed time until the queue is empty.
+ *
+ * @param	pDev 	: Pointer to simulated interface
+ */
+void SimIntrfRunIdle(SIMINTRFDEV *pDev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#pragma pack(push, 4)
+
+/// Register file model, 256 x 8 bits registers with auto increment.
+///
+/// First byte written after a start condition is the register address.
+/// Register index is (byte & AddrMask) | AddrSet.  For I2C use 0xFF, 0.  On SPI
+/// devices using bit 7 as read flag use 0x7F, 0 (MPU9250) or 0x7F, 0x80 (BME280).
+typedef struct __Sim_RegFile {
+	uint8_t Reg[256];		//!< Register values
+	uint8_t AddrMask;		//!< Register address mask
+	uint8_t AddrSet;		//!< Register address bits forced set
+	uint8_t Ptr;			//!< Current register
+	bool bAddrPhase;		//!< Next byte written is register address
+	/**
+	 * @brief	Optional register write hook.
+	 *
+	 * @return	true - store value in register
+	 */
+	bool (*WrHook)(struct __Sim_RegFile *pRegFile, uint8_t RegAddr, uint8_t Val);
+	SIMINTRF_MODEL Model;	//!< Model interface
+} SIMREGFILE;
+
+/// MPU9250 accel & gyro model, register file with FIFO.
+///
+/// Samples are produced by SimMpu9250Sample.  Reading FIFO_R_W pops FIFO data
+/// and FIFO_COUNT follows the FIFO level.  Accel, temperature & gyro are
+/// queued according to FIFO_EN.  A full FIFO drops new samples.
+typedef struct __Sim_Mpu9250 {
+	SIMREGFILE RegFile;		//!< Registers, must be first
+	uint8_t Fifo[512];		//!< FIFO data
+	int FifoRd;				//!< FIFO read index
+	int FifoCnt;			//!< FIFO level in bytes
+	uint32_t OvrCnt;		//!< Samples dropped, FIFO full
+} SIMMPU9250;
+
+/// I2C EEPROM model.  MSB first address, page wrap on write.
+typedef struct __Sim_Eeprom {
+	uint8_t *pMem;			//!< EEPROM memory
+	uint32_t Size;			//!< Memory size in bytes
+	uint16_t PageSize;		//!< Write page size in bytes
+	uint8_t AddrLen;		//!< Address length in bytes
+	uint32_t WrNs;			//!< Write cycle time in nsec
+	uint32_t Addr;			//!< Current address
+	int AddrCnt;			//!< Address bytes received
+	bool bWrite;			//!< Data written in current transaction
+	SIMINTRF_MODEL Model;	//!< Model interface
+} SIMEEPROM;
+
+/// SPI NOR flash model
+///
+/// Supports READ (0x03), PP (0x02), RDSR (0x05), WREN (0x06), WRDI (0x04),
+/// JEDEC ID (0x9F), SE 4KB (0x20), BE (0xD8) and CE (0xC7/0x60).  Status never
+/// reports WIP, program & erase times are returned as device busy time.
+typedef struct __Sim_Flash {
+	uint8_t *pMem;			//!< Flash memory
+	uint32_t Size;			//!< Memory size in bytes
+	uint32_t PageSize;		//!< Program page size in bytes
+	uint32_t BlkSize;		//!< Block erase (0xD8) size in bytes
+	uint32_t Id;			//!< JEDEC Id, manufacturer in LSB, sent LSB first
+	int AddrLen;			//!< Address length in bytes
+	uint32_t ProgNs;		//!< Page program time in nsec
+	uint32_t EraseNs;		//!< Sector/block erase time in nsec
+	uint8_t Status;			//!< Status register
+	int Cmd;				//!< Current command, -1 waiting for command byte
+	uint32_t Addr;			//!< Current address
+	int AddrCnt;			//!< Address bytes received
+	int IdIdx;				//!< JEDEC Id byte index
+	uint32_t BusyNs;		//!< Busy time started by current command
+	SIMINTRF_MODEL Model;	//!< Model interface
+} SIMFLASH;
+
+#define SIMSDCARD_RESP_MAX		(3 + 512 + 2)	//!< Max queued response, R1, gap, token, block, CRC
+
+/// SD card in SPI mode model, SDHC block addressing.
+///
+/// Driver toggles chip select per byte so command state is kept across
+/// transactions.  Supports CMD0, 1, 8, 9, 12, 13, 17, 18, 24, 25, 55, 58 and
+/// ACMD41.
+typedef struct __Sim_SDCard {
+	uint8_t *pMem;			//!< Card memory
+	uint32_t NbSect;		//!< Number of 512 bytes sectors, multiple of 1024
+	uint32_t RdNs;			//!< Block read access time in nsec
+	uint32_t RdNextNs;		//!< Next block access time of multiple block read in nsec
+	uint32_t WrNs;			//!< Block write busy time in nsec
+	uint8_t Cmd[6];			//!< Command frame being received
+	int CmdIdx;				//!< Command bytes received
+	bool bAppCmd;			//!< CMD55 received
+	bool bIdle;				//!< Card in idle state
+	int WrState;			//!< Write data phase, 0 - none, 1 - wait token, 2 - data
+	bool bWrMulti;			//!< CMD25 write in progress, until stop token
+	bool bRdMulti;			//!< CMD18 read in progress, until CMD12
+	uint32_t RdSect;		//!< Next sector of multiple block read
+	uint32_t CmdCnt;		//!< Number of commands received
+	uint32_t WrSect;		//!< Sector being written
+	uint32_t WrErrSect;		//!< Sector rejecting writes, -1 for none
+	int WrIdx;				//!< Write data bytes received
+	uint8_t WrData[514];	//!< Write data block with CRC
+	uint8_t Resp[SIMSDCARD_RESP_MAX];	//!< Queued response
+	int RespLen;			//!< Queued response length
+	int RespIdx;			//!< Next response byte
+	uint32_t BusyNs;		//!< Busy time pending
+	SIMINTRF_MODEL Model;	//!< Model interface
+} SIMSDCARD;
+
+#pragma pack(pop)
+
+#ifdef __cplusplus
+extern "C" {
+#endif	// __cplusplus
+
+/**
+ * @brief	Initialize register file model.
+ *
+ * @param	pRegFile : Pointer to model data, register file cleared
+ * @param	AddrMask : Register address mask
+ * @param	AddrSet	 : Register address bits forced set
+ *
+ * @return	Pointer to model interface
+ */
+SIMINTRF_MODEL *SimRegFileInit(SIMREGFILE *pRegFile, uint8_t AddrMask, uint8_t AddrSet);
+
+/**
+ * @brief	Initialize register file as BME280.
+ *
+ * ID, datasheet calibration data and a fixed measurement are loaded.  Soft
+ * reset & read only registers are handled.
+ *
+ * @param	pRegFile : Pointer to model data
+ * @param	bSpi	 : true - SPI addressing, false - I2C
+ *
+ * @return	Pointer to model interface
+ */
+SIMINTRF_MODEL *SimBme280Init(SIMREGFILE *pRegFile, bool bSpi);
+
+/**
+ * @brief	Initialize MPU9250 model.
+ *
+ * @param	pMpu	: Pointer to model data
+ * @param	bSpi	: true - SPI addressing, false - I2C
+ *
+ * @return	Pointer to model interface
+ */
+SIMINTRF_MODEL *SimMpu9250Init(SIMMPU9250 *pMpu, bool bSpi);
+
+/**
+ * @brief	Produce a MPU9250 sample.
+ *
+ * Updates data registers & queues the sample in the FIFO if enabled.
+ *
+ * @param	pMpu	: Pointer to model data
+ * @param	pAccel	: Accel x, y, z
+ * @param	pGyro	: Gyro x, y, z
+ */
+void SimMpu9250Sample(SIMMPU9250 *pMpu, const int16_t *pAccel, const int16_t *pGyro);
+
+/**
+ * @brief	Initialize I2C EEPROM model.
+ *
+ * @param	pEeprom	 : Pointer to model data
+ * @param	pMem	 : EEPROM memory
+ * @param	Size	 : Memory size in bytes
+ * @param	PageSize : Write page size in bytes
+ * @param	AddrLen	 : Address length in bytes
+ * @param	WrNs	 : Write cycle time in nsec
+ *
+ * @return	Pointer to model interface
+ */
+SIMINTRF_MODEL *SimEepromInit(SIMEEPROM *pEeprom, uint8_t *pMem, uint32_t Size,
+							  uint16_t PageSize, uint8_t AddrLen, uint32_t WrNs);
+
+/**
+ * @brief	Initialize SPI NOR flash model.  Memory is set to erased state.
+ *
+ * Timing & Id fields can be changed after init.  Defaults are 256 bytes page,
+ * 64KB block, 700us page program, 50ms erase.
+ *
+ * @param	pFlash	: Pointer to model data
+ * @param	pMem	: Flash memory
+ * @param	Size	: Memory size in bytes
+ * @param	AddrLen	: Address length in bytes
+ *
+ * @return	Pointer to model interface
+ */
+SIMINTRF_MODEL *SimFlashInit(SIMFLASH *pFlash, uint8_t *pMem, uint32_t Size, int AddrLen);
+
+/**
+ * @brief	Initialize SD card model.
+ *
+ * Timing fields can be changed after init.  Defaults are 100us read access,
+ * 10us next block of multiple block read & 250us write busy.
+ *
+ * @param	pCard	: Pointer to model data
+ * @param	pMem	: Card memory
+ * @param	NbSect	: Number of 512 bytes sectors, multiple of 1024
+ *
+ * @return	Pointer to model interface
+ */
+SIMINTRF_MODEL *SimSDCardInit(SIMSDCARD *pCard, uint8_t *pMem, uint32_t NbSect);
+
+#ifdef __cplusplus
+}
+
+/// Simulated device interface class
+class SimDevIntrf : public DeviceIntrf {
+public:
+	SimDevIntrf() {
+		memset((void*)&vDevData, 0, (int)sizeof(vDevData));
+	}
+
+	virtual ~SimDevIntrf() {}
+
+	SimDevIntrf(SimDevIntrf&);	// Copy ctor not allowed
+
+	bool Init(const SIMINTRF_CFG &CfgData) { return SimIntrfInit(&vDevData, &CfgData); }
+	bool Attach(int DevAddr, SIMINTRF_MODEL *pModel) { return SimIntrfAttach(&vDevData, DevAddr, pModel); }
+	operator DEVINTRF*() { return &vDevData.DevIntrf; }
+	operator SIMINTRFDEV& () { return vDevData; };	// Get device data
+	int Rate(int RateHz) { return DeviceIntrfSetRate(&vDevData.DevIntrf, RateHz); }
+	int Rate(void) { return vDevData.Rate; };	// Get rate in Hz
+	virtual bool StartRx(int DevAddr) {
+		return DeviceIntrfStartRx(&vDevData.DevIntrf, DevAddr);
+	}
+	virtual int RxData(uint8_t *pBuff, int BuffLen) {
+		return DeviceIntrfRxData(&vDevData.DevIntrf, pBuff, BuffLen);
+	}
+	virtual void StopRx(void) { DeviceIntrfStopRx(&vDevData.DevIntrf); }
+	virtual bool StartTx(int DevAddr) {
+		return DeviceIntrfStartTx(&vDevData.DevIntrf, DevAddr);
+	}
+	virtual int TxData(uint8_t *pData, int DataLen) {
+		return DeviceIntrfTxData(&vDevData.DevIntrf, pData, DataLen);
+	}
+	virtual void StopTx(void) { DeviceIntrfStopTx(&vDevData.DevIntrf); }
+
+	const SIMINTRF_STATS &Stats() { return vDevData.Stats; }
+	void ResetStats() { SimIntrfResetStats(&vDevData); }
+	uint64_t Time() { return SimIntrfTime(&vDevData); }
+	bool QueInit(DEVINTRFQUE &Que) { return SimIntrfQueInit(&vDevData, &Que); }
+	void Run(uint64_t Ns) { SimIntrfRun(&vDevData, Ns); }
+	void RunIdle() { SimIntrfRunIdle(&vDevData); }
+
+private:
+	SIMINTRFDEV vDevData;
+};
+
+#endif	// __cplusplus
+
+/** @} end group device_intrf */
+
+#endif	// __SIM_INTRF_H__
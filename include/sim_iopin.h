@@ -0,0 +1,94 @@
+/**-------------------------------------------------------------------------
+@file	sim_iopin.h
+
+@brief	Simulated I/O pins.
+
+Host implementation of the iopincfg.h API for running drivers using pin
+interrupts, such as sensor data ready, on host.  Pin levels are driven by the
+test with SimIOPinSet.  Sense events call the registered callback right away,
+as the pin interrupt would.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#ifndef __SIM_IOPIN_H__
+#define __SIM_IOPIN_H__
+
+#include <stdint.h>
+
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
+#include "iopincfg.h"
+
+#define SIMIOPIN_MAX_PORT		4		//!< Number of simulated ports, 32 pins each
+#define SIMIOPIN_MAX_INT		8		//!< Number of pin interrupts
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief	Reset all pins low & disable all pin interrupts.
+ */
+void SimIOPinReset(void);
+
+/**
+ * @brief	Drive a simulated pin.
+ *
+ * Calls the callback of enabled interrupts sensing the transition.
+ *
+ * @param	PortNo	: Port number
+ * @param	PinNo	: Pin number
+ * @param	bHigh	: New pin level
+ */
+void SimIOPinSet(int PortNo, int PinNo, bool bHigh);
+
+/**
+ * @brief	Read a simulated pin.
+ *
+ * @param	PortNo	: Port number
+ * @param	PinNo	: Pin number
+ *
+ * @return	true - pin is high
+ */
+bool SimIOPinRead(int PortNo, int PinNo);
+
+/**
+ * @brief	Number of events generated on an interrupt since reset.
+ *
+ * @param	IntNo : Interrupt number
+ */
+uint32_t SimIOPinIntCount(int IntNo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SIM_IOPIN_H__
@@ -36,6 +36,7 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __UTF8_H__
 
 #include <stdio.h>
+#include <stddef.h>
 
 /** @addtogroup Utilities
   * @{
@@ -34,45 +34,337 @@ Modified by          Date              Description
 ----------------------------------------------------------------------------*/
 #include <stdint.h>
 #include <string.h>
+#include "istddef.h"
 #include "atomic.h"
 #include "cfifo.h"
 
+// Indices are free running in the range [0, 2 * MaxIdxCnt)
+
+static inline int32_t CFifoIdxAdd(HCFIFO pFifo, int32_t Idx, int32_t Cnt)
+{
+	Idx += Cnt;
+	if (Idx >= (pFifo->MaxIdxCnt << 1))
+		Idx -= pFifo->MaxIdxCnt << 1;
+
+	return Idx;
+}
+
+static inline int32_t CFifoIdxDist(HCFIFO pFifo, int32_t PutIdx, int32_t GetIdx)
+{
+	int32_t d = PutIdx - GetIdx;
+
+	if (d < 0)
+		d += pFifo->MaxIdxCnt << 1;
+
+	return d;
+}
+
+static inline int32_t CFifoIdxSlot(HCFIFO pFifo, int32_t Idx)
+{
+	if (Idx >= pFifo->MaxIdxCnt)
+		Idx -= pFifo->MaxIdxCnt;
+
+	return Idx;
+}
+
+static inline uint8_t *CFifoBlkAddr(HCFIFO pFifo, int32_t Idx)
+{
+	return pFifo->pMemStart + CFifoIdxSlot(pFifo, Idx) * pFifo->BlkSize;
+}
+
+// Number of consecutive blocks from Idx to the end of FIFO memory
+static inline int32_t CFifoIdxToEnd(HCFIFO pFifo, int32_t Idx)
+{
+	return pFifo->MaxIdxCnt - CFifoIdxSlot(pFifo, Idx);
+}
+
+// Split Cnt blocks starting at Idx into at most 2 contiguous spans
+static inline int CFifoSpans(HCFIFO pFifo, int32_t Idx, int32_t Cnt, CFIFOSPAN *pSpan)
+{
+	int32_t l = CFifoIdxToEnd(pFifo, Idx);
+
+	if (l > Cnt)
+		l = Cnt;
+
+	pSpan[0].pBlk = CFifoBlkAddr(pFifo, Idx);
+	pSpan[0].Cnt = l;
+	pSpan[1].pBlk = pFifo->pMemStart;
+	pSpan[1].Cnt = Cnt - l;
+
+	return Cnt;
+}
+
+#ifdef CFIFO_STATS
+
+// Producer side, Cnt blocks starting at Idx are about to be published
+static void CFifoStatsPut(HCFIFO pFifo, int32_t Idx, int32_t Cnt)
+{
+	CFIFOSTATS *stats = pFifo->pStats;
+
+	if (stats == NULL)
+		return;
+
+	stats->PutCnt += Cnt;
+
+	int32_t used = CFifoIdxDist(pFifo, CFifoIdxAdd(pFifo, Idx, Cnt), AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx));
+
+	if (used > stats->HighWater)
+		stats->HighWater = used;
+
+	if (stats->Clock && stats->pTimeStamp)
+	{
+		uint32_t t = stats->Clock();
+
+		for (int32_t i = 0; i < Cnt; i++)
+		{
+			stats->pTimeStamp[CFifoIdxSlot(pFifo, CFifoIdxAdd(pFifo, Idx, i))] = t;
+		}
+	}
+}
+
+// Consumer side, Cnt blocks starting at Idx have been retrieved
+static void CFifoStatsGet(HCFIFO pFifo, int32_t Idx, int32_t Cnt)
+{
+	CFIFOSTATS *stats = pFifo->pStats;
+
+	if (stats == NULL)
+		return;
+
+	stats->GetCnt += Cnt;
+
+	if (stats->Clock && stats->pTimeStamp)
+	{
+		uint32_t t = stats->Clock();
+
+		for (int32_t i = 0; i < Cnt; i++)
+		{
+			uint32_t d = t - stats->pTimeStamp[CFifoIdxSlot(pFifo, CFifoIdxAdd(pFifo, Idx, i))];
+			int bin = 0;
+
+			while (d && bin < CFIFO_STATS_HIST_SIZE - 1)
+			{
+				d >>= 1;
+				bin++;
+			}
+			stats->DwellHist[bin]++;
+		}
+	}
+}
+
+#define CFIFO_STATS_PUT(pFifo, Idx, Cnt)	CFifoStatsPut(pFifo, Idx, Cnt)
+#define CFIFO_STATS_GET(pFifo, Idx, Cnt)	CFifoStatsGet(pFifo, Idx, Cnt)
+#define CFIFO_STATS_FULL(pFifo, Cnt)		do { if (pFifo->pStats) pFifo->pStats->FullCnt += Cnt; } while (0)
+#else
+#define CFIFO_STATS_PUT(pFifo, Idx, Cnt)
+#define CFIFO_STATS_GET(pFifo, Idx, Cnt)
+#define CFIFO_STATS_FULL(pFifo, Cnt)
+#endif // CFIFO_STATS
+
+// Producer side, push out up to Cnt oldest blocks to make room in drop mode
+static int32_t CFifoDrop(HCFIFO pFifo, int32_t Cnt)
+{
+	int32_t getidx, cnt;
+
+	do {
+		getidx = AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx);
+		cnt = CFifoIdxDist(pFifo, pFifo->PutIdx, getidx);
+		if (cnt > Cnt)
+			cnt = Cnt;
+		if (cnt <= 0)
+			return 0;
+	} while (AtomicCompareExchange((sig_atomic_t *)&pFifo->GetIdx, getidx,
+								   CFifoIdxAdd(pFifo, getidx, cnt)) == false);
+
+	pFifo->DropCnt += cnt;
+
+	return cnt;
+}
+
+// MPSC sequence number of a block slot for index Idx :
+//	Idx 				- free, can be claimed by producer at Idx
+//	Idx + 1				- published, can be read by consumer at Idx
+//	Idx + MaxIdxCnt		- released, free for producer at next lap
+// All values are modulo 2 * MaxIdxCnt.  They are distinct when MaxIdxCnt >= 2
+
+// MPSC consumer side, count published consecutive blocks from Idx, up to Cnt
+static int32_t CFifoMpscReady(HCFIFO pFifo, int32_t Idx, int32_t Cnt)
+{
+	int32_t n = 0;
+
+	while (n < Cnt)
+	{
+		int32_t idx = CFifoIdxAdd(pFifo, Idx, n);
+
+		if (AtomicLoadAcquire((sig_atomic_t *)&pFifo->pSeq[CFifoIdxSlot(pFifo, idx)]) != CFifoIdxAdd(pFifo, idx, 1))
+			break;
+		n++;
+	}
+
+	return n;
+}
+
+// MPSC consumer side, return Cnt blocks starting at Idx to producers
+static void CFifoMpscFree(HCFIFO pFifo, int32_t Idx, int32_t Cnt)
+{
+	for (int32_t n = 0; n < Cnt; n++)
+	{
+		int32_t idx = CFifoIdxAdd(pFifo, Idx, n);
+
+		AtomicStoreRelease((sig_atomic_t *)&pFifo->pSeq[CFifoIdxSlot(pFifo, idx)],
+						   CFifoIdxAdd(pFifo, idx, pFifo->MaxIdxCnt));
+	}
+
+	AtomicStoreRelease((sig_atomic_t *)&pFifo->GetIdx, CFifoIdxAdd(pFifo, Idx, Cnt));
+}
+
+// Consumer side, release Cnt blocks starting at GetIdx
+static inline bool CFifoAdvanceGet(HCFIFO pFifo, int32_t GetIdx, int32_t Cnt)
+{
+	int32_t getidx = CFifoIdxAdd(pFifo, GetIdx, Cnt);
+
+	if (pFifo->bBlocking == true)
+	{
+		// Consumer is the only writer of GetIdx
+		AtomicStoreRelease((sig_atomic_t *)&pFifo->GetIdx, getidx);
+
+		return true;
+	}
+
+	// Producer may have pushed out blocks in the mean time
+	return AtomicCompareExchange((sig_atomic_t *)&pFifo->GetIdx, GetIdx, getidx);
+}
+
 HCFIFO CFifoInit(uint8_t *pMemBlk, uint32_t TotalMemSize, uint32_t BlkSize, bool bBlocking)
 {
-	if (pMemBlk == NULL)
+	if (pMemBlk == NULL || BlkSize == 0 || TotalMemSize <= sizeof(CFIFOHDR))
 		return NULL;
 
 	CFIFOHDR *hdr = (CFIFOHDR *)pMemBlk;
 	hdr->bBlocking = bBlocking;
 	hdr->DropCnt = 0;
 	hdr->PutIdx = 0;
-	hdr->GetIdx = -1;
+	hdr->GetIdx = 0;
+	hdr->PeekIdx = 0;
 	hdr->BlkSize = BlkSize;
 	hdr->MemSize = TotalMemSize;
 	hdr->MaxIdxCnt = (TotalMemSize - sizeof(CFIFOHDR)) / BlkSize;
 	hdr->pMemStart = (uint8_t*)(pMemBlk + sizeof(CFIFOHDR));
+	hdr->pSeq = NULL;
+	hdr->pStats = NULL;
 
 	return hdr;
 }
 
+HCFIFO CFifoInitMpsc(uint8_t *pMemBlk, uint32_t TotalMemSize, uint32_t BlkSize)
+{
+	if (pMemBlk == NULL || BlkSize == 0 || TotalMemSize <= sizeof(CFIFOHDR))
+		return NULL;
+
+	int32_t cnt = (TotalMemSize - sizeof(CFIFOHDR)) / (BlkSize + sizeof(int32_t));
+
+	if (cnt < 2)
+		return NULL;
+
+	CFIFOHDR *hdr = (CFIFOHDR *)pMemBlk;
+	hdr->bBlocking = true;
+	hdr->DropCnt = 0;
+	hdr->PutIdx = 0;
+	hdr->GetIdx = 0;
+	hdr->PeekIdx = 0;
+	hdr->BlkSize = BlkSize;
+	hdr->MemSize = TotalMemSize;
+	hdr->MaxIdxCnt = cnt;
+	hdr->pSeq = (int32_t*)(pMemBlk + sizeof(CFIFOHDR));
+	hdr->pMemStart = (uint8_t*)&hdr->pSeq[cnt];
+	hdr->pStats = NULL;
+
+	for (int32_t i = 0; i < cnt; i++)
+	{
+		hdr->pSeq[i] = i;
+	}
+
+	return hdr;
+}
+
+uint8_t *CFifoClaim(HCFIFO pFifo)
+{
+	if (pFifo == NULL || pFifo->pSeq == NULL)
+		return NULL;
+
+	int32_t idx;
+
+	// NOTE : a producer stalled for 2 * MaxIdxCnt claims between loading PutIdx
+	// and the compare exchange could claim a stale index.  Keep the FIFO deep
+	// enough relative to producer preemption.
+	while (true)
+	{
+		idx = AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx);
+
+		if (AtomicLoadAcquire((sig_atomic_t *)&pFifo->pSeq[CFifoIdxSlot(pFifo, idx)]) == idx)
+		{
+			// Slot is free, take the ticket
+			if (AtomicCompareExchange((sig_atomic_t *)&pFifo->PutIdx, idx, CFifoIdxAdd(pFifo, idx, 1)))
+				break;
+		}
+		else if (idx == AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx))
+		{
+			// Slot not yet released by consumer or previous lap producer
+			CFIFO_STATS_FULL(pFifo, 1);
+
+			return NULL;
+		}
+	}
+
+	return CFifoBlkAddr(pFifo, idx);
+}
+
+void CFifoPublish(HCFIFO pFifo, uint8_t *pBlk)
+{
+	if (pFifo == NULL || pFifo->pSeq == NULL || pBlk == NULL)
+		return;
+
+	int32_t slot = (pBlk - pFifo->pMemStart) / pFifo->BlkSize;
+
+	// Claimed slot still holds its free running index as sequence number
+	int32_t idx = pFifo->pSeq[slot];
+
+	CFIFO_STATS_PUT(pFifo, idx, 1);
+
+	// Only the claiming producer updates the sequence number at this stage
+	AtomicStoreRelease((sig_atomic_t *)&pFifo->pSeq[slot], CFifoIdxAdd(pFifo, idx, 1));
+}
+
 uint8_t *CFifoGet(HCFIFO pFifo)
 {
-	if (pFifo == NULL || pFifo->GetIdx < 0)
+	if (pFifo == NULL)
 		return NULL;
 
-	int32_t idx = pFifo->GetIdx;
-	int32_t getidx = idx + 1;
+	int32_t idx;
 
-	if (getidx >= pFifo->MaxIdxCnt)
-		getidx = 0;
-	if (getidx == pFifo->PutIdx)
-		getidx = -1;
+	if (pFifo->pSeq)
+	{
+		idx = pFifo->GetIdx;
 
-	AtomicAssign((sig_atomic_t *)&pFifo->GetIdx, getidx);
+		if (CFifoMpscReady(pFifo, idx, 1) == 0)
+			return NULL;
 
-	uint8_t *p = pFifo->pMemStart + idx * pFifo->BlkSize;
+		CFIFO_STATS_GET(pFifo, idx, 1);
+		CFifoMpscFree(pFifo, idx, 1);
 
-	return p;
+		return CFifoBlkAddr(pFifo, idx);
+	}
+
+	do {
+		idx = pFifo->bBlocking ? pFifo->GetIdx : AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx);
+
+		if (idx == AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx))
+			return NULL;
+
+	} while (CFifoAdvanceGet(pFifo, idx, 1) == false);
+
+	CFIFO_STATS_GET(pFifo, idx, 1);
+
+	return CFifoBlkAddr(pFifo, idx);
 }
 
 uint8_t *CFifoGetMultiple(HCFIFO pFifo, int *pCnt)
@@ -80,69 +372,80 @@ uint8_t *CFifoGetMultiple(HCFIFO pFifo, int *pCnt)
 	if (pCnt == NULL)
 		return CFifoGet(pFifo);
 
-	if (pFifo == NULL || pFifo->GetIdx < 0 || *pCnt == 0)
+	if (pFifo == NULL || *pCnt <= 0)
 	{
 		*pCnt = 0;
 		return NULL;
 	}
 
-	int32_t cnt = *pCnt;
-	int32_t putidx = pFifo->PutIdx;
-	int32_t idx = pFifo->GetIdx;
-	int32_t getidx = idx + cnt;
+	int32_t idx, cnt;
 
-	if (idx < putidx)
+	if (pFifo->pSeq)
 	{
-		if (getidx >= putidx)
+		idx = pFifo->GetIdx;
+		cnt = CFifoMpscReady(pFifo, idx, min(*pCnt, CFifoIdxToEnd(pFifo, idx)));
+
+		if (cnt > 0)
 		{
-			getidx = -1;
-			cnt = putidx- idx;
+			CFIFO_STATS_GET(pFifo, idx, cnt);
+			CFifoMpscFree(pFifo, idx, cnt);
 		}
+
+		*pCnt = cnt;
+
+		return cnt > 0 ? CFifoBlkAddr(pFifo, idx) : NULL;
 	}
-	else
-	{
-		if (getidx >= pFifo->MaxIdxCnt)
+
+	do {
+		idx = pFifo->bBlocking ? pFifo->GetIdx : AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx);
+		cnt = CFifoIdxDist(pFifo, AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx), idx);
+
+		if (cnt <= 0)
 		{
-			getidx = putidx == 0 ? -1 : 0;
-			cnt = pFifo->MaxIdxCnt - idx;
+			*pCnt = 0;
+			return NULL;
 		}
-	}
 
-	AtomicAssign((sig_atomic_t *)&pFifo->GetIdx, getidx);
+		// Limit to requested & consecutive blocks
+		if (cnt > *pCnt)
+			cnt = *pCnt;
+		if (cnt > CFifoIdxToEnd(pFifo, idx))
+			cnt = CFifoIdxToEnd(pFifo, idx);
+
+	} while (CFifoAdvanceGet(pFifo, idx, cnt) == false);
+
+	CFIFO_STATS_GET(pFifo, idx, cnt);
 
-	uint8_t *p = pFifo->pMemStart + idx * pFifo->BlkSize;
 	*pCnt = cnt;
 
-	return p;
+	return CFifoBlkAddr(pFifo, idx);
 }
 
 uint8_t *CFifoPut(HCFIFO pFifo)
 {
-	if (pFifo == NULL)
+	if (pFifo == NULL || pFifo->pSeq)
 		return NULL;
 
-    if (pFifo->PutIdx == pFifo->GetIdx)
-    {
-        if (pFifo->bBlocking == true)
-            return NULL;
-        // drop data
-        int32_t gidx = pFifo->GetIdx + 1;
-        if (gidx >= pFifo->MaxIdxCnt)
-            gidx = 0;
-        AtomicAssign((sig_atomic_t *)&pFifo->GetIdx, gidx);
-        pFifo->DropCnt++;
-    }
 	int32_t idx = pFifo->PutIdx;
-	int32_t putidx = idx + 1;
-	if (putidx >= pFifo->MaxIdxCnt)
-		putidx = 0;
-	AtomicAssign((sig_atomic_t *)&pFifo->PutIdx, putidx);
-	if (pFifo->GetIdx < 0)
-		AtomicAssign((sig_atomic_t *)&pFifo->GetIdx, idx);
 
-	uint8_t *p = pFifo->pMemStart + idx * pFifo->BlkSize;
+	if (CFifoIdxDist(pFifo, idx, AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx)) >= pFifo->MaxIdxCnt)
+	{
+		if (pFifo->bBlocking == true)
+		{
+			CFIFO_STATS_FULL(pFifo, 1);
+
+			return NULL;
+		}
+
+		// drop data
+		CFifoDrop(pFifo, 1);
+	}
+
+	CFIFO_STATS_PUT(pFifo, idx, 1);
+
+	AtomicStoreRelease((sig_atomic_t *)&pFifo->PutIdx, CFifoIdxAdd(pFifo, idx, 1));
 
-	return p;
+	return CFifoBlkAddr(pFifo, idx);
 }
 
 uint8_t *CFifoPutMultiple(HCFIFO pFifo, int *pCnt)
@@ -150,185 +453,294 @@ uint8_t *CFifoPutMultiple(HCFIFO pFifo, int *pCnt)
 	if (pCnt == NULL)
 		return CFifoPut(pFifo);
 
-	if (pFifo == NULL || *pCnt == 0)
+	if (pFifo == NULL || pFifo->pSeq || *pCnt <= 0)
 	{
 		*pCnt = 0;
 		return NULL;
 	}
 
-	if (pFifo->PutIdx == pFifo->GetIdx)
-    {
-	    if (pFifo->bBlocking == true)
-	        return NULL;
-	    // Drop
-	    int l = *pCnt;
-	    CFifoGetMultiple(pFifo, &l);
-        pFifo->DropCnt += l;
-    }
-	int32_t cnt = *pCnt;
 	int32_t idx = pFifo->PutIdx;
-	int32_t getidx = pFifo->GetIdx;
-	int32_t putidx = idx + cnt;
+	int32_t cnt = *pCnt;
+	int32_t avail = pFifo->MaxIdxCnt - CFifoIdxDist(pFifo, idx, AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx));
 
-	if (idx > getidx)
+	// Limit to consecutive blocks
+	if (cnt > CFifoIdxToEnd(pFifo, idx))
+		cnt = CFifoIdxToEnd(pFifo, idx);
+
+	if (cnt > avail)
 	{
-		if (putidx >= pFifo->MaxIdxCnt)
+		if (pFifo->bBlocking == true)
+		{
+			CFIFO_STATS_FULL(pFifo, cnt - avail);
+			cnt = avail;
+		}
+		else
 		{
-			cnt = pFifo->MaxIdxCnt - idx;
-			putidx = 0;
+			// Drop
+			CFifoDrop(pFifo, cnt - avail);
 		}
 	}
-	else
+
+	if (cnt <= 0)
 	{
-		if (putidx >= getidx)
+		*pCnt = 0;
+		return NULL;
+	}
+
+	CFIFO_STATS_PUT(pFifo, idx, cnt);
+
+	AtomicStoreRelease((sig_atomic_t *)&pFifo->PutIdx, CFifoIdxAdd(pFifo, idx, cnt));
+
+	*pCnt = cnt;
+
+	return CFifoBlkAddr(pFifo, idx);
+}
+
+int CFifoReserve(HCFIFO pFifo, int Cnt, CFIFOSPAN *pSpan)
+{
+	if (pFifo == NULL || pFifo->pSeq || pSpan == NULL)
+		return 0;
+
+	if (Cnt > pFifo->MaxIdxCnt)
+		Cnt = pFifo->MaxIdxCnt;
+
+	int32_t idx = pFifo->PutIdx;
+	int32_t avail = pFifo->MaxIdxCnt - CFifoIdxDist(pFifo, idx, AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx));
+
+	if (Cnt > avail)
+	{
+		if (pFifo->bBlocking == true)
 		{
-			cnt = getidx - idx;
-			putidx = getidx;
+			CFIFO_STATS_FULL(pFifo, Cnt - avail);
+			Cnt = avail;
+		}
+		else
+		{
+			CFifoDrop(pFifo, Cnt - avail);
 		}
 	}
 
-	AtomicAssign((sig_atomic_t *)&pFifo->PutIdx, putidx);
+	if (Cnt < 0)
+		Cnt = 0;
 
-	if (getidx < 0)
-		AtomicAssign((sig_atomic_t *)&pFifo->GetIdx, idx);
+	return CFifoSpans(pFifo, idx, Cnt, pSpan);
+}
 
-	uint8_t *p = pFifo->pMemStart + idx * pFifo->BlkSize;
+void CFifoCommit(HCFIFO pFifo, int Cnt)
+{
+	if (pFifo == NULL || pFifo->pSeq || Cnt <= 0)
+		return;
 
-	*pCnt = cnt;
+	CFIFO_STATS_PUT(pFifo, pFifo->PutIdx, Cnt);
 
-	return p;
+	AtomicStoreRelease((sig_atomic_t *)&pFifo->PutIdx, CFifoIdxAdd(pFifo, pFifo->PutIdx, Cnt));
 }
 
-void CFifoFlush(HCFIFO pFifo)
+int CFifoPeek(HCFIFO pFifo, int Cnt, CFIFOSPAN *pSpan)
 {
-	AtomicAssign((sig_atomic_t *)&pFifo->GetIdx, -1);
-	AtomicAssign((sig_atomic_t *)&pFifo->PutIdx, 0);
+	if (pFifo == NULL || pSpan == NULL)
+		return 0;
+
+	int32_t idx = AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx);
+	int32_t used = CFifoIdxDist(pFifo, AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx), idx);
+
+	if (Cnt > used)
+		Cnt = used;
+
+	if (Cnt < 0)
+		Cnt = 0;
+
+	if (pFifo->pSeq)
+		Cnt = CFifoMpscReady(pFifo, idx, Cnt);
+
+	pFifo->PeekIdx = idx;
+
+	return CFifoSpans(pFifo, idx, Cnt, pSpan);
 }
 
-int CFifoAvail(HCFIFO pFifo)
+void CFifoRelease(HCFIFO pFifo, int Cnt)
 {
-	int len = 0;
+	if (pFifo == NULL || Cnt <= 0)
+		return;
 
-	if (pFifo->GetIdx < 0)
-		return pFifo->MaxIdxCnt;
+	int32_t idx, used;
 
-	if (pFifo->PutIdx > pFifo->GetIdx)
+	if (pFifo->pSeq)
 	{
-		len = pFifo->MaxIdxCnt - pFifo->PutIdx + pFifo->GetIdx;
+		idx = pFifo->GetIdx;
+		Cnt = CFifoMpscReady(pFifo, idx, Cnt);
+		CFIFO_STATS_GET(pFifo, idx, Cnt);
+		CFifoMpscFree(pFifo, idx, Cnt);
+
+		return;
 	}
-	else if (pFifo->PutIdx < pFifo->GetIdx)
+
+	if (pFifo->bBlocking)
 	{
-		len = pFifo->GetIdx - pFifo->PutIdx;
+		idx = pFifo->GetIdx;
+		used = CFifoIdxDist(pFifo, AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx), idx);
+
+		if (Cnt > used)
+			Cnt = used;
+
+		CFifoAdvanceGet(pFifo, idx, Cnt);
+		pFifo->PeekIdx = CFifoIdxAdd(pFifo, idx, Cnt);
+		CFIFO_STATS_GET(pFifo, idx, Cnt);
+
+		return;
 	}
 
-	return len;
+	// Drop mode : the producer may already have pushed out some of the peeked
+	// blocks.  Only release what is left of the peeked range [PeekIdx, PeekIdx + Cnt)
+	int32_t peekidx = pFifo->PeekIdx;
+	int32_t cnt;
+
+	do {
+		idx = AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx);
+		cnt = Cnt - CFifoIdxDist(pFifo, idx, peekidx);
+
+		if (cnt <= 0)
+		{
+			// Whole peeked range already dropped
+			cnt = 0;
+			break;
+		}
+	} while (CFifoAdvanceGet(pFifo, idx, cnt) == false);
+
+	pFifo->PeekIdx = CFifoIdxAdd(pFifo, peekidx, Cnt);
+
+	CFIFO_STATS_GET(pFifo, idx, cnt);
 }
 
-int CFifoUsed(HCFIFO pFifo)
+void CFifoFlush(HCFIFO pFifo)
 {
-	int len = 0;
-
-	if (pFifo->GetIdx < 0)
-		return 0;
+	int32_t getidx;
 
-	if (pFifo->GetIdx < pFifo->PutIdx)
+	if (pFifo->pSeq)
 	{
-		len = pFifo->PutIdx - pFifo->GetIdx;
+		// Claimed blocks not yet published are kept
+		getidx = pFifo->GetIdx;
+		CFifoMpscFree(pFifo, getidx, CFifoMpscReady(pFifo, getidx, pFifo->MaxIdxCnt));
+
+		return;
 	}
-	else
+
+	do {
+		getidx = AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx);
+	} while (AtomicCompareExchange((sig_atomic_t *)&pFifo->GetIdx, getidx,
+								   AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx)) == false);
+}
+
+int CFifoAvail(HCFIFO pFifo)
+{
+	return pFifo->MaxIdxCnt - CFifoUsed(pFifo);
+}
+
+int CFifoUsed(HCFIFO pFifo)
+{
+	return CFifoIdxDist(pFifo, AtomicLoadAcquire((sig_atomic_t *)&pFifo->PutIdx),
+						AtomicLoadAcquire((sig_atomic_t *)&pFifo->GetIdx));
+}
+
+#ifdef CFIFO_STATS
+void CFifoStatsInit(HCFIFO pFifo, CFIFOSTATS *pStats, uint32_t *pTimeStamp, CFIFOCLOCK Clock)
+{
+	if (pFifo == NULL)
+		return;
+
+	if (pStats)
 	{
-		len = pFifo->MaxIdxCnt - pFifo->GetIdx + pFifo->PutIdx;
+		memset(pStats, 0, sizeof(CFIFOSTATS));
+		pStats->Clock = Clock;
+		pStats->pTimeStamp = pTimeStamp;
 	}
 
-	return len;
+	pFifo->DropCnt = 0;
+	pFifo->pStats = pStats;
+}
+
+bool CFifoGetStats(HCFIFO pFifo, CFIFOSTATS *pStats)
+{
+	if (pFifo == NULL || pFifo->pStats == NULL || pStats == NULL)
+		return false;
+
+	memcpy(pStats, pFifo->pStats, sizeof(CFIFOSTATS));
+
+	// Overwrite drops are counted by the FIFO itself
+	pStats->DropCnt = pFifo->DropCnt;
+
+	return true;
 }
+#endif // CFIFO_STATS
 
 int CFifoRead(HCFIFO pFifo, uint8_t *pBuff, int BuffLen)
 {
-	if (pFifo == NULL || pFifo->GetIdx < 0 || pBuff == NULL)
+	if (pFifo == NULL || pBuff == NULL || BuffLen <= 0)
 		return 0;
 
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
+	int nblk = pFifo->BlkSize == 1 ? BuffLen : BuffLen / (int)pFifo->BlkSize;
 	int cnt = 0;
 
-	if (BuffLen <= pFifo->BlkSize)
-	{
-		// Single block
-		uint8_t *p = CFifoGet(pFifo);
-		if (p)
-		{
-			memcpy(pBuff, p, BuffLen);
+	if (nblk <= 0)
+		return 0;
 
-			return BuffLen;
-		}
-	}
-	else
+	nblk = CFifoPeek(pFifo, nblk, span);
+
+	// At most 2 copies, whole blocks only
+	for (int i = 0; i < CFIFO_SPAN_MAX && cnt < nblk * (int)pFifo->BlkSize; i++)
 	{
-		// Span multiple blocks
-		while (BuffLen > 0)
-		{
-			int l = BuffLen / pFifo->BlkSize;
-			if ((BuffLen % pFifo->BlkSize) > 0)
-				l++;
-			uint8_t *p = CFifoGetMultiple(pFifo, &l);
-			if (p == NULL)
-				break;
-			l *= pFifo->BlkSize;
-			memcpy(pBuff, p, l);
-			pBuff += l;
-			BuffLen -= l;
-			cnt += l;
-		}
+		int l = span[i].Cnt * (int)pFifo->BlkSize;
+
+		memcpy(pBuff + cnt, span[i].pBlk, l);
+		cnt += l;
 	}
 
+	CFifoRelease(pFifo, nblk);
+
 	return cnt;
 }
 
 int CFifoWrite(HCFIFO pFifo, uint8_t *pData, int DataLen)
 {
-	if (pFifo == NULL || pData == NULL)
+	if (pFifo == NULL || pData == NULL || DataLen <= 0)
 		return 0;
 
-    if (pFifo->PutIdx == pFifo->GetIdx)
-    {
-        if (pFifo->bBlocking == true)
-            return 0;
-        int l = DataLen;
-        CFifoGetMultiple(pFifo, &l);
-        pFifo->DropCnt += l;
-    }
-
+	CFIFOSPAN span[CFIFO_SPAN_MAX];
+	int nblk = pFifo->BlkSize == 1 ? DataLen : (DataLen + (int)pFifo->BlkSize - 1) / (int)pFifo->BlkSize;
 	int cnt = 0;
 
-	if (DataLen <= pFifo->BlkSize)
+	if (pFifo->pSeq)
 	{
-		// Single block
-		uint8_t *p = CFifoPut(pFifo);
-		if (p)
+		while (cnt < DataLen)
 		{
-			memcpy(p, pData, DataLen);
+			uint8_t *p = CFifoClaim(pFifo);
 
-			return DataLen;
-		}
-	}
-	else
-	{
-		// Span multiple blocks
-		while (DataLen > 0)
-		{
-			int l = DataLen / pFifo->BlkSize;
-			if ((DataLen % pFifo->BlkSize) > 0)
-				l++;
-			uint8_t *p = CFifoPutMultiple(pFifo, &l);
 			if (p == NULL)
 				break;
-			l *= pFifo->BlkSize;
-			memcpy(p, pData, l);
-			pData += l;
-			DataLen -= l;
+
+			int l = min(pFifo->BlkSize, DataLen - cnt);
+
+			memcpy(p, pData + cnt, l);
+			CFifoPublish(pFifo, p);
 			cnt += l;
 		}
+
+		return cnt;
 	}
 
+	nblk = CFifoReserve(pFifo, nblk, span);
+
+	// At most 2 copies, last block may be partially filled
+	for (int i = 0; i < CFIFO_SPAN_MAX && cnt < DataLen; i++)
+	{
+		int l = min(span[i].Cnt * pFifo->BlkSize, DataLen - cnt);
+
+		memcpy(span[i].pBlk, pData + cnt, l);
+		cnt += l;
+	}
+
+	CFifoCommit(pFifo, nblk);
+
 	return cnt;
 }
-
@@ -47,7 +47,8 @@ Modified by          Date              Description
  */
 uint8_t crc8_ccitt(uint8_t *pData, int Len, uint8_t SeedVal)
 {
-	uint8_t i, e, f, crc;
+	uint8_t e, f, crc;
+	int i;
 
 	crc = SeedVal;
 	for (i = 0; i < Len; i++)
@@ -36,6 +36,8 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 ----------------------------------------------------------------------------*/
 
+#include "idelay.h"
+#include "atomic.h"
 #include "device.h"
 
 Device::Device()
@@ -44,5 +46,532 @@ Device::Device()
 	vpIntrf = NULL;
 	vbValid = false;
 	vDevId = -1;
+	vpRegCache = NULL;
+	vpQue = NULL;
+}
+
+// Register cache state flags, attributes are kept in the low bits
+#define DEVREG_STATE_ATTR_MASK		0xF
+#define DEVREG_STATE_VALID			(1<<6)
+#define DEVREG_STATE_DIRTY			(1<<7)
+
+int Device::ReadRegs(DEVREG_READ *pReq, int NbReq, int MaxGap)
+{
+	uint8_t order[DEVREG_READ_MAXREQ];
+	uint8_t buff[DEVREG_READ_MAXBURST];
+	int done = 0;
+	int i = 0;
+
+	if (pReq == NULL || NbReq <= 0 || NbReq > DEVREG_READ_MAXREQ)
+		return 0;
+
+	// Sort by address
+	for (int k = 0; k < NbReq; k++)
+	{
+		int j = k;
+
+		pReq[k].Count = 0;
+		while (j > 0 && pReq[order[j - 1]].Addr > pReq[k].Addr)
+		{
+			order[j] = order[j - 1];
+			j--;
+		}
+		order[j] = k;
+	}
+
+	while (i < NbReq)
+	{
+		DEVREG_READ *r = &pReq[order[i]];
+		int start = r->Addr;
+		int end = start + r->Len;
+		int n = 1;
+
+		// Extend burst while gap is cheaper than a new transaction
+		while (i + n < NbReq)
+		{
+			DEVREG_READ *next = &pReq[order[i + n]];
+			int nend = next->Addr + next->Len > end ? next->Addr + next->Len : end;
+
+			if (next->Addr - end > MaxGap || nend - start > DEVREG_READ_MAXBURST)
+				break;
+
+			end = nend;
+			n++;
+		}
+
+		// Read may modify address (SPI read flag, page select)
+		uint8_t addr = start;
+
+		if (n == 1)
+		{
+			r->Count = r->Len > 0 ? Read(&addr, 1, r->pBuff, r->Len) : 0;
+			if (r->Count >= r->Len)
+			{
+				done++;
+			}
+		}
+		else
+		{
+			int cnt = Read(&addr, 1, buff, end - start);
+
+			for (int k = i; k < i + n; k++)
+			{
+				r = &pReq[order[k]];
+
+				int avail = cnt - (r->Addr - start);
+
+				r->Count = avail < 0 ? 0 : avail > r->Len ? r->Len : avail;
+				memcpy(r->pBuff, &buff[r->Addr - start], r->Count);
+				if (r->Count >= r->Len)
+				{
+					done++;
+				}
+			}
+		}
+
+		i += n;
+	}
+
+	return done;
+}
+
+// Queued register script writes in flight
+typedef struct __Dev_Reg_Script_Que {
+	sig_atomic_t Pending;
+	volatile bool bFail;
+	struct {
+		DEVINTRF_XACT Xact;
+		uint8_t Data[1 + DEVREG_SCRIPT_MAXBURST];	// Register address + values
+	} Slot[DEVREG_SCRIPT_MAXXACT];
+	int NbSlot;
+} DEVREG_SCRIPTQUE;
+
+static void DevRegScriptDone(DEVINTRF_XACT *pXact)
+{
+	DEVREG_SCRIPTQUE *q = (DEVREG_SCRIPTQUE *)pXact->pCtx;
+
+	if (pXact->Count < pXact->Seg[1].Len)
+	{
+		q->bFail = true;
+	}
+	AtomicDec(&q->Pending);
+}
+
+// Wait for queued writes & update shadow of the ones that succeeded.  Returns
+// false if any failed or did not start within DEVREG_SCRIPT_TIMEOUT
+bool Device::RegScriptWait(DEVREG_SCRIPTQUE *pQue)
+{
+	uint32_t t = 0;
+
+	while (AtomicLoadAcquire(&pQue->Pending) > 0)
+	{
+		if (t >= DEVREG_SCRIPT_TIMEOUT)
+		{
+			// Interface stalled.  Withdraw the writes not started yet, they
+			// complete as failed.  The one in progress owns the slot buffers
+			// until the interface reports its completion
+			for (int i = 0; i < pQue->NbSlot; i++)
+			{
+				DevIntrfQueCancel(vpQue, &pQue->Slot[i].Xact);
+			}
+			pQue->bFail = true;
+		}
+		usDelay(DEVREG_SCRIPT_WAIT_INTERVAL);
+		t += DEVREG_SCRIPT_WAIT_INTERVAL;
+	}
+
+	for (int i = 0; i < pQue->NbSlot; i++)
+	{
+		DEVINTRF_XACT *xact = &pQue->Slot[i].Xact;
+
+		if (xact->Count == xact->Seg[1].Len)
+		{
+			RegCacheStore(pQue->Slot[i].Data[0], &pQue->Slot[i].Data[1], xact->Count);
+		}
+	}
+	pQue->NbSlot = 0;
+
+	return pQue->bFail == false;
+}
+
+bool Device::RegScriptRun(const DEVREG_STEP *pScript, bool bAutoIncr)
+{
+	DEVREG_SCRIPTQUE que;
+	uint8_t d[DEVREG_SCRIPT_MAXBURST];
+	const DEVREG_STEP *s = pScript;
+	bool res = true;
+
+	if (pScript == NULL)
+		return false;
+
+	que.Pending = 0;
+	que.bFail = false;
+	que.NbSlot = 0;
+
+	while (res && s->Op != DEVREG_OP_END)
+	{
+		uint8_t addr = s->Reg;
+		int n = 1;
+
+		switch (s->Op)
+		{
+			case DEVREG_OP_WR:
+				d[0] = s->Val;
+				if (bAutoIncr)
+				{
+					while (n < DEVREG_SCRIPT_MAXBURST && s[n].Op == DEVREG_OP_WR &&
+						   s[n].Reg == (uint8_t)(s->Reg + n))
+					{
+						d[n] = s[n].Val;
+						n++;
+					}
+				}
+
+				if (vpQue)
+				{
+					if (que.NbSlot >= DEVREG_SCRIPT_MAXXACT && RegScriptWait(&que) == false)
+					{
+						res = false;
+						break;
+					}
+
+					uint8_t *p = que.Slot[que.NbSlot].Data;
+					DEVINTRF_XACT *xact = &que.Slot[que.NbSlot].Xact;
+
+					p[0] = addr;
+					memcpy(&p[1], d, n);
+					DevIntrfXactWrite(xact, vDevAddr, p, 1, &p[1], n, DevRegScriptDone, &que);
+					que.NbSlot++;
+					AtomicInc(&que.Pending);
+					if (DevIntrfQueSubmit(vpQue, xact) == false)
+					{
+						AtomicDec(&que.Pending);
+						res = false;
+						break;
+					}
+				}
+				else if (n == 1)
+				{
+					res = Write8(&addr, 1, d[0]);
+				}
+				else
+				{
+					res = Write(&addr, 1, d, n) == n;
+					if (res)
+					{
+						RegCacheStore(s->Reg, d, n);
+					}
+				}
+				break;
+
+			case DEVREG_OP_RMW:
+				res = RegScriptWait(&que);
+				if (res)
+				{
+					d[0] = (Read8(&addr, 1) & ~s->Mask) | (s->Val & s->Mask);
+					addr = s->Reg;
+					res = Write8(&addr, 1, d[0]);
+				}
+				break;
+
+			case DEVREG_OP_DELAY:
+				res = RegScriptWait(&que);
+				usDelay(s->Time);
+				break;
+
+			case DEVREG_OP_POLL:
+				{
+					uint32_t t = 0;
+
+					res = RegScriptWait(&que);
+
+					// Polled registers are volatile, read failure is not ready
+					while (res)
+					{
+						addr = s->Reg;
+						if (Read(&addr, 1, d, 1) == 1 && (d[0] & s->Mask) == s->Val)
+							break;
+
+						if (t >= s->Time)
+						{
+							res = false;
+							break;
+						}
+						usDelay(DEVREG_POLL_INTERVAL);
+						t += DEVREG_POLL_INTERVAL;
+					}
+				}
+				break;
+
+			default:
+				res = false;
+		}
+
+		s += n;
+	}
+
+	if (RegScriptWait(&que) == false)
+	{
+		res = false;
+	}
+
+	return res;
+}
+
+void Device::RegCacheStore(uint8_t RegAddr, const uint8_t *pData, int Len)
+{
+	DEVREGCACHE *c = vpRegCache;
+
+	if (c == NULL)
+		return;
+
+	for (int i = 0; i < Len; i++)
+	{
+		int idx = RegAddr + i - c->Base;
+
+		if (idx >= 0 && idx < c->Size && (c->pState[idx] & (DEVREG_ATTR_CACHED | DEVREG_ATTR_WRONLY)))
+		{
+			c->pVal[idx] = pData[i];
+			c->pState[idx] = (c->pState[idx] & ~DEVREG_STATE_DIRTY) | DEVREG_STATE_VALID;
+		}
+	}
+}
+
+bool Device::RegCacheInit(DEVREGCACHE *pCache, const DEVREG_DESC *pDesc, int NbDesc,
+						  uint8_t *pMem, int MemSize, bool bAutoIncr)
+{
+	int first = 0xFF, last = 0;
+
+	vpRegCache = NULL;
+
+	if (pCache == NULL || pDesc == NULL || NbDesc <= 0 || pMem == NULL)
+		return false;
+
+	for (int i = 0; i < NbDesc; i++)
+	{
+		if (pDesc[i].Count <= 0 || pDesc[i].Addr + pDesc[i].Count > 0x100)
+			return false;
+
+		if (pDesc[i].Addr < first)
+		{
+			first = pDesc[i].Addr;
+		}
+		if (pDesc[i].Addr + pDesc[i].Count - 1 > last)
+		{
+			last = pDesc[i].Addr + pDesc[i].Count - 1;
+		}
+	}
+
+	memset(pCache, 0, sizeof(DEVREGCACHE));
+
+	pCache->pDesc = pDesc;
+	pCache->NbDesc = NbDesc;
+	pCache->Base = first;
+	pCache->Size = last - first + 1;
+	pCache->bAutoIncr = bAutoIncr;
+
+	if (MemSize < DEVREGCACHE_MEMSIZE(pCache->Size))
+		return false;
+
+	pCache->pVal = pMem;
+	pCache->pState = pMem + pCache->Size;
+
+	vpRegCache = pCache;
+	RegCacheInvalidate();
+
+	return true;
+}
+
+void Device::RegCacheInvalidate()
+{
+	DEVREGCACHE *c = vpRegCache;
+
+	if (c == NULL)
+		return;
+
+	memset(c->pState, 0, c->Size);
+
+	for (int i = 0; i < c->NbDesc; i++)
+	{
+		memset(&c->pState[c->pDesc[i].Addr - c->Base], c->pDesc[i].Attr & DEVREG_STATE_ATTR_MASK,
+			   c->pDesc[i].Count);
+	}
+}
+
+void Device::RegCacheReset()
+{
+	DEVREGCACHE *c = vpRegCache;
+
+	if (c == NULL)
+		return;
+
+	RegCacheInvalidate();
+
+	for (int i = 0; i < c->NbDesc; i++)
+	{
+		if (c->pDesc[i].Attr & DEVREG_ATTR_RSTVAL)
+		{
+			int idx = c->pDesc[i].Addr - c->Base;
+
+			memset(&c->pVal[idx], c->pDesc[i].RstVal, c->pDesc[i].Count);
+			for (int j = 0; j < c->pDesc[i].Count; j++)
+			{
+				c->pState[idx + j] |= DEVREG_STATE_VALID;
+			}
+		}
+	}
+}
+
+bool Device::RegCacheDefer(bool bDefer)
+{
+	if (vpRegCache == NULL)
+		return bDefer == false;
+
+	vpRegCache->bDefer = bDefer;
+
+	return bDefer ? true : RegCacheFlush();
+}
+
+bool Device::RegCacheFlush()
+{
+	DEVREGCACHE *c = vpRegCache;
+	bool res = true;
+	int i = 0;
+
+	if (c == NULL)
+		return true;
+
+	while (i < c->Size)
+	{
+		if ((c->pState[i] & DEVREG_STATE_DIRTY) == 0)
+		{
+			i++;
+			continue;
+		}
+
+		int n = 1;
+
+		if (c->bAutoIncr)
+		{
+			// Extend run up to the last dirty register reachable through known
+			// non volatile ones
+			for (int j = i + 1; j < c->Size; j++)
+			{
+				uint8_t st = c->pState[j];
+
+				if (st & DEVREG_STATE_DIRTY)
+				{
+					n = j - i + 1;
+				}
+				else if ((st & DEVREG_STATE_VALID) == 0 || (st & DEVREG_ATTR_TRIGGER) ||
+						 (st & (DEVREG_ATTR_CACHED | DEVREG_ATTR_WRONLY)) == 0)
+				{
+					break;
+				}
+			}
+		}
+
+		// Write may modify address (SPI read/write flag)
+		uint8_t addr = c->Base + i;
+
+		c->Stats.FlushCnt++;
+		if (Write(&addr, 1, &c->pVal[i], n) == n)
+		{
+			for (int j = i; j < i + n; j++)
+			{
+				c->pState[j] &= ~DEVREG_STATE_DIRTY;
+			}
+		}
+		else
+		{
+			for (int j = i; j < i + n; j++)
+			{
+				c->pState[j] &= ~(DEVREG_STATE_DIRTY | DEVREG_STATE_VALID);
+			}
+			res = false;
+		}
+		i += n;
+	}
+
+	return res;
+}
+
+uint8_t Device::RegCacheRead8(uint8_t RegAddr)
+{
+	DEVREGCACHE *c = vpRegCache;
+	int idx = RegAddr - c->Base;
+	uint8_t st = idx >= 0 && idx < c->Size ? c->pState[idx] : 0;
+	uint8_t val = 0;
+
+	if (st & (DEVREG_ATTR_CACHED | DEVREG_ATTR_WRONLY))
+	{
+		if (st & DEVREG_STATE_VALID)
+		{
+			c->Stats.HitCnt++;
+
+			return c->pVal[idx];
+		}
+
+		// Write only register not written since reset, it can not be read back
+		if (st & DEVREG_ATTR_WRONLY)
+			return 0;
+
+		c->Stats.MissCnt++;
+	}
+
+	if (Read(&RegAddr, 1, &val, 1) == 1 && (st & DEVREG_ATTR_CACHED))
+	{
+		c->pVal[idx] = val;
+		c->pState[idx] |= DEVREG_STATE_VALID;
+	}
+
+	return val;
+}
+
+bool Device::RegCacheWrite8(uint8_t RegAddr, uint8_t Data)
+{
+	DEVREGCACHE *c = vpRegCache;
+	int idx = RegAddr - c->Base;
+	uint8_t st = idx >= 0 && idx < c->Size ? c->pState[idx] : 0;
+
+	if ((st & (DEVREG_ATTR_CACHED | DEVREG_ATTR_WRONLY)) == 0)
+	{
+		return Write(&RegAddr, 1, &Data, 1) > 0;
+	}
+
+	if ((st & DEVREG_ATTR_TRIGGER) == 0)
+	{
+		if ((st & DEVREG_STATE_VALID) && c->pVal[idx] == Data)
+		{
+			c->Stats.ElideCnt++;
+
+			return true;
+		}
+
+		c->pVal[idx] = Data;
+		c->pState[idx] |= DEVREG_STATE_VALID;
+
+		if (c->bDefer)
+		{
+			c->pState[idx] |= DEVREG_STATE_DIRTY;
+
+			return true;
+		}
+	}
+	else if (c->bDefer)
+	{
+		// Keep write order
+		RegCacheFlush();
+	}
+
+	c->pVal[idx] = Data;
+	c->pState[idx] |= DEVREG_STATE_VALID;
+
+	if (Write(&RegAddr, 1, &Data, 1) > 0)
+		return true;
+
+	c->pState[idx] &= ~DEVREG_STATE_VALID;
+
+	return false;
 }
 
@@ -39,6 +39,17 @@ THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "device_intrf.h"
 
+#ifdef DEVINTRF_TRACE
+// Retries used, nrtry ends at -1 when all retries were exhausted
+#define DEVINTRF_TRACE_START(pDev)		uint32_t tstart = DevTraceTime(pDev->pTrace)
+#define DEVINTRF_TRACE_XFER(pDev, Evt, DevAddr, ReqLen, Len, nrtry)	\
+		DevTraceRecord(pDev->pTrace, Evt, DevAddr, ReqLen, Len, \
+					   nrtry < 0 ? pDev->MaxRetry : pDev->MaxRetry - nrtry, tstart)
+#else
+#define DEVINTRF_TRACE_START(pDev)
+#define DEVINTRF_TRACE_XFER(pDev, Evt, DevAddr, ReqLen, Len, nrtry)
+#endif
+
 // NOTE : For thread safe use
 //
 // DeviceIntrfStartRx
@@ -53,6 +64,7 @@ int DeviceIntrfRx(DEVINTRF *pDev, int DevAddr, uint8_t *pBuff, int BuffLen)
 
 	int count = 0;
 	int nrtry = pDev->MaxRetry;
+	DEVINTRF_TRACE_START(pDev);
 
 	do {
 		if (DeviceIntrfStartRx(pDev, DevAddr)) {
@@ -61,6 +73,8 @@ int DeviceIntrfRx(DEVINTRF *pDev, int DevAddr, uint8_t *pBuff, int BuffLen)
 		}
 	} while(count <= 0 && nrtry-- > 0);
 
+	DEVINTRF_TRACE_XFER(pDev, DEVTRACE_EVT_RX, DevAddr, BuffLen, count, nrtry);
+
 	return count;
 }
 
@@ -71,6 +85,7 @@ int DeviceIntrfTx(DEVINTRF *pDev, int DevAddr, uint8_t *pBuff, int BuffLen)
 
 	int count = 0;
 	int nrtry = pDev->MaxRetry;
+	DEVINTRF_TRACE_START(pDev);
 
 	do {
 		if (DeviceIntrfStartTx(pDev, DevAddr)) {
@@ -79,6 +94,8 @@ int DeviceIntrfTx(DEVINTRF *pDev, int DevAddr, uint8_t *pBuff, int BuffLen)
 		}
 	} while (count <= 0 && nrtry-- > 0);
 
+	DEVINTRF_TRACE_XFER(pDev, DEVTRACE_EVT_TX, DevAddr, BuffLen, count, nrtry);
+
 	return count;
 }
 
@@ -91,6 +108,8 @@ int DeviceIntrfRead(DEVINTRF *pDev, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
     if (pRxBuff == NULL || RxLen <= 0)
         return 0;
 
+    DEVINTRF_TRACE_START(pDev);
+
     do {
         if (DeviceIntrfStartTx(pDev, DevAddr))
         {
@@ -108,35 +127,142 @@ int DeviceIntrfRead(DEVINTRF *pDev, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
         }
     } while (count <= 0 && nrtry-- > 0);
 
+    DEVINTRF_TRACE_XFER(pDev, DEVTRACE_EVT_READ, DevAddr, RxLen, count, nrtry);
+
     return count;
 }
 
+// Fallback for interfaces without Transfer.  Runs of segments in the same
+// direction are combined so that DMA based interfaces see a single TxData or
+// RxData, as DeviceIntrfWrite used to do.  Busy flag is held by caller
+static int DeviceIntrfLegacyTransfer(DEVINTRF *pDev, int DevAddr, const DEVINTRF_SEG *pSeg, int NbSeg)
+{
+	int count = 0;
+	bool bStarted = false;
+	bool bRx = false;
+	int i = 0;
+
+	while (i < NbSeg)
+	{
+		int j = i, runlen = 0, cnt;
+
+		bRx = pSeg[i].bRx;
+		while (j < NbSeg && pSeg[j].bRx == bRx)
+		{
+			runlen += pSeg[j].Len > 0 ? pSeg[j].Len : 0;
+			j++;
+		}
+
+		// Note : when already started, this is a restart condition,
+		// must not generate any stop condition here
+		if ((bRx ? pDev->StartRx(pDev, DevAddr) : pDev->StartTx(pDev, DevAddr)) == false)
+			break;
+
+		bStarted = true;
+
+		if (j - i == 1)
+		{
+			cnt = bRx ? pDev->RxData(pDev, pSeg[i].pData, runlen) :
+						pDev->TxData(pDev, pSeg[i].pData, runlen);
+		}
+		else
+		{
+			uint8_t d[runlen > 0 ? runlen : 1];
+			int k, off = 0;
+
+			if (bRx)
+			{
+				cnt = pDev->RxData(pDev, d, runlen);
+				for (k = i; k < j && off < cnt; k++)
+				{
+					if (pSeg[k].Len > 0)
+					{
+						int l = cnt - off < pSeg[k].Len ? cnt - off : pSeg[k].Len;
+
+						memcpy(pSeg[k].pData, &d[off], l);
+						off += l;
+					}
+				}
+			}
+			else
+			{
+				for (k = i; k < j; k++)
+				{
+					if (pSeg[k].Len > 0)
+					{
+						memcpy(&d[off], pSeg[k].pData, pSeg[k].Len);
+						off += pSeg[k].Len;
+					}
+				}
+				cnt = pDev->TxData(pDev, d, runlen);
+			}
+		}
+
+		count += cnt;
+		if (cnt < runlen)
+			break;
+
+		i = j;
+	}
+
+	if (bStarted)
+	{
+		if (bRx)
+			pDev->StopRx(pDev);
+		else
+			pDev->StopTx(pDev);
+	}
+
+	return count;
+}
+
+// Single attempt with busy flag handling
+static int DeviceIntrfXfer(DEVINTRF *pDev, int DevAddr, const DEVINTRF_SEG *pSeg, int NbSeg)
+{
+	int count;
+
+	if (AtomicTestAndSet(&pDev->Busy))
+	{
+#ifdef DEVINTRF_TRACE
+		DevTraceRecord(pDev->pTrace, DEVTRACE_EVT_BUSY, DevAddr, 0, 0, 0, DevTraceTime(pDev->pTrace));
+#endif
+		return 0;
+	}
+
+	if (pDev->Transfer)
+	{
+		count = pDev->Transfer(pDev, DevAddr, pSeg, NbSeg);
+	}
+	else
+	{
+		count = DeviceIntrfLegacyTransfer(pDev, DevAddr, pSeg, NbSeg);
+	}
+
+	AtomicClear(&pDev->Busy);
+
+	return count;
+}
+
 int DeviceIntrfWrite(DEVINTRF *pDev, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
                   uint8_t *pData, int DataLen)
 {
-    int count = 0, txlen = AdCmdLen;
+    int count = 0;
     int nrtry = pDev->MaxRetry;
-    uint8_t d[AdCmdLen + DataLen > 0 ? DataLen : 0];
+    DEVINTRF_SEG seg[2] = {
+    	{ pAdCmd, AdCmdLen, false },
+		{ pData, DataLen, false }
+    };
 
     if (pAdCmd == NULL)
         return 0;
 
     // NOTE : Some I2C devices that uses DMA transfer may require that the tx to be combined
-    // into single tx. Because it may generate a end condition at the end of the DMA
-    memcpy(d, pAdCmd, AdCmdLen);
-
-    if (pData != NULL && DataLen > 0)
-    {
-    	memcpy(&d[AdCmdLen], pData, DataLen);
-    	txlen += DataLen;
-    }
+    // into single tx. Because it may generate a end condition at the end of the DMA.
+    // Interfaces without Transfer get it combined by the legacy fallback
+    DEVINTRF_TRACE_START(pDev);
 
     do {
-        if (DeviceIntrfStartTx(pDev, DevAddr))
-        {
-            count = pDev->TxData(pDev, d, txlen);
-			DeviceIntrfStopTx(pDev);
-        }
+    	count = DeviceIntrfXfer(pDev, DevAddr, seg, pData != NULL && DataLen > 0 ? 2 : 1);
     } while (count <= 0 && nrtry-- > 0);
 
     if (count >= AdCmdLen)
@@ -144,6 +270,34 @@ int DeviceIntrfWrite(DEVINTRF *pDev, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
     else
         count = 0;
 
+    DEVINTRF_TRACE_XFER(pDev, DEVTRACE_EVT_WRITE, DevAddr, DataLen, count, nrtry);
+
     return count;
 }
 
+int DeviceIntrfTransfer(DEVINTRF *pDev, int DevAddr, const DEVINTRF_SEG *pSeg, int NbSeg)
+{
+	int count = 0;
+	int nrtry = pDev->MaxRetry;
+
+	if (pSeg == NULL || NbSeg <= 0)
+		return 0;
+
+	DEVINTRF_TRACE_START(pDev);
+
+	do {
+		count = DeviceIntrfXfer(pDev, DevAddr, pSeg, NbSeg);
+	} while (count <= 0 && nrtry-- > 0);
+
+#ifdef DEVINTRF_TRACE
+	int reqlen = 0;
+
+	for (int i = 0; i < NbSeg; i++)
+	{
+		reqlen += pSeg[i].Len;
+	}
+	DEVINTRF_TRACE_XFER(pDev, DEVTRACE_EVT_XFER, DevAddr, reqlen, count, nrtry);
+#endif
+
+	return count;
+}
@@ -0,0 +1,300 @@
+/**-------------------------------------------------------------------------
+@file	device_intrf_arb.c
+
+@brief	Device interface bus arbiter.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "atomic.h"
+#include "device_intrf_arb.h"
+
+static inline uint32_t DevIntrfArbLock(DEVINTRFARB *pArb)
+{
+	uint32_t state = DisableInterrupt();
+
+	while (AtomicTestAndSet(&pArb->Lock));
+
+	return state;
+}
+
+static inline void DevIntrfArbUnlock(DEVINTRFARB *pArb, uint32_t State)
+{
+	AtomicClear(&pArb->Lock);
+	EnableInterrupt(State);
+}
+
+// Lower is better
+static inline int DevIntrfArbEffPrio(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, uint32_t Now)
+{
+	if (pArb->Aging == 0)
+		return pClient->Prio;
+
+	return pClient->Prio - (int)((Now - pClient->WaitStart) / pArb->Aging);
+}
+
+// Client is in line.  A request not followed by an acquire expires after the
+// client max wait so that it can not hold up the others.
+static inline bool DevIntrfArbQueued(DEVINTRFARB_CLIENT *pClient, uint32_t Now)
+{
+	return pClient->bWaiting && Now - pClient->WaitStart <= pClient->MaxWait;
+}
+
+// Waiting client to get the bus next.  Ties go to the longest waiting.
+// Called with lock held
+static DEVINTRFARB_CLIENT *DevIntrfArbNext(DEVINTRFARB *pArb, uint32_t Now)
+{
+	DEVINTRFARB_CLIENT *best = NULL;
+	int bestprio = 0;
+
+	for (DEVINTRFARB_CLIENT *c = pArb->pClients; c != NULL; c = c->pNext)
+	{
+		if (DevIntrfArbQueued(c, Now) == false)
+			continue;
+
+		int prio = DevIntrfArbEffPrio(pArb, c, Now);
+
+		if (best == NULL || prio < bestprio ||
+			(prio == bestprio && Now - c->WaitStart > Now - best->WaitStart))
+		{
+			best = c;
+			bestprio = prio;
+		}
+	}
+
+	return best;
+}
+
+static inline void DevIntrfArbWaitStats(DEVINTRFARB_CLIENT *pClient, uint32_t Wait)
+{
+	pClient->Stats.WaitTotal += Wait;
+	if (Wait > pClient->Stats.WaitMax)
+	{
+		pClient->Stats.WaitMax = Wait;
+	}
+}
+
+bool DevIntrfArbInit(DEVINTRFARB *pArb, DEVINTRF *pIntrf, DEVINTRFARB_CLOCK Clock,
+					 DEVINTRFARB_YIELD Yield, uint32_t Slice, uint32_t Aging)
+{
+	if (pArb == NULL || pIntrf == NULL || Clock == NULL)
+		return false;
+
+	memset(pArb, 0, sizeof(DEVINTRFARB));
+
+	pArb->pIntrf = pIntrf;
+	pArb->Clock = Clock;
+	pArb->Yield = Yield;
+	pArb->Slice = Slice;
+	pArb->Aging = Aging;
+
+	return true;
+}
+
+void DevIntrfArbAddClient(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int Prio, uint32_t MaxWait)
+{
+	memset(pClient, 0, sizeof(DEVINTRFARB_CLIENT));
+
+	pClient->Prio = Prio;
+	pClient->MaxWait = MaxWait;
+
+	uint32_t state = DevIntrfArbLock(pArb);
+
+	pClient->pNext = pArb->pClients;
+	pArb->pClients = pClient;
+
+	DevIntrfArbUnlock(pArb, state);
+}
+
+void DevIntrfArbRequest(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient)
+{
+	uint32_t state = DevIntrfArbLock(pArb);
+	uint32_t now = pArb->Clock();
+
+	if (DevIntrfArbQueued(pClient, now) == false)
+	{
+		pClient->WaitStart = now;
+		pClient->bWaiting = true;
+	}
+
+	DevIntrfArbUnlock(pArb, state);
+}
+
+void DevIntrfArbCancel(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient)
+{
+	uint32_t state = DevIntrfArbLock(pArb);
+
+	pClient->bWaiting = false;
+
+	DevIntrfArbUnlock(pArb, state);
+}
+
+bool DevIntrfArbAcquire(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient)
+{
+	uint32_t state = DevIntrfArbLock(pArb);
+	uint32_t now = pArb->Clock();
+
+	// Keep position of an earlier request still in line
+	if (DevIntrfArbQueued(pClient, now) == false)
+	{
+		pClient->WaitStart = now;
+		pClient->bWaiting = true;
+	}
+
+	while (true)
+	{
+		uint32_t wait = now - pClient->WaitStart;
+
+		if (pArb->pOwner == NULL && DevIntrfArbNext(pArb, now) == pClient)
+		{
+			pClient->bWaiting = false;
+			pArb->pOwner = pClient;
+			pArb->OwnStart = now;
+			pArb->SliceStart = now;
+			pClient->Stats.AcqCnt++;
+			DevIntrfArbWaitStats(pClient, wait);
+			DevIntrfArbUnlock(pArb, state);
+
+			return true;
+		}
+
+		if (wait >= pClient->MaxWait)
+		{
+			pClient->bWaiting = false;
+			pClient->Stats.TimeoutCnt++;
+			DevIntrfArbWaitStats(pClient, wait);
+			DevIntrfArbUnlock(pArb, state);
+
+			return false;
+		}
+
+		DevIntrfArbUnlock(pArb, state);
+
+		if (pArb->Yield)
+		{
+			pArb->Yield(pArb);
+		}
+
+		state = DevIntrfArbLock(pArb);
+		now = pArb->Clock();
+	}
+}
+
+void DevIntrfArbRelease(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient)
+{
+	uint32_t state = DevIntrfArbLock(pArb);
+
+	if (pArb->pOwner == pClient)
+	{
+		uint32_t hold = pArb->Clock() - pArb->OwnStart;
+
+		pClient->Stats.HoldTotal += hold;
+		if (hold > pClient->Stats.HoldMax)
+		{
+			pClient->Stats.HoldMax = hold;
+		}
+		pArb->pOwner = NULL;
+	}
+
+	DevIntrfArbUnlock(pArb, state);
+}
+
+bool DevIntrfArbSlice(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient)
+{
+	bool handover = false;
+
+	if (pArb->Slice == 0)
+		return true;
+
+	uint32_t state = DevIntrfArbLock(pArb);
+	uint32_t now = pArb->Clock();
+
+	if (now - pArb->SliceStart >= pArb->Slice)
+	{
+		if (DevIntrfArbNext(pArb, now) != NULL)
+		{
+			handover = true;
+		}
+		else
+		{
+			pArb->SliceStart = now;
+		}
+	}
+
+	DevIntrfArbUnlock(pArb, state);
+
+	if (handover == false)
+		return true;
+
+	pClient->Stats.SliceCnt++;
+	DevIntrfArbRelease(pArb, pClient);
+
+	return DevIntrfArbAcquire(pArb, pClient);
+}
+
+int DevIntrfArbRead(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int DevAddr,
+					uint8_t *pAdCmd, int AdCmdLen, uint8_t *pBuff, int BuffLen)
+{
+	if (DevIntrfArbAcquire(pArb, pClient) == false)
+		return 0;
+
+	int count = DeviceIntrfRead(pArb->pIntrf, DevAddr, pAdCmd, AdCmdLen, pBuff, BuffLen);
+
+	DevIntrfArbRelease(pArb, pClient);
+
+	return count;
+}
+
+int DevIntrfArbWrite(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int DevAddr,
+					 uint8_t *pAdCmd, int AdCmdLen, uint8_t *pData, int DataLen)
+{
+	if (DevIntrfArbAcquire(pArb, pClient) == false)
+		return 0;
+
+	int count = DeviceIntrfWrite(pArb->pIntrf, DevAddr, pAdCmd, AdCmdLen, pData, DataLen);
+
+	DevIntrfArbRelease(pArb, pClient);
+
+	return count;
+}
+
+int DevIntrfArbTransfer(DEVINTRFARB *pArb, DEVINTRFARB_CLIENT *pClient, int DevAddr,
+						const DEVINTRF_SEG *pSeg, int NbSeg)
+{
+	if (DevIntrfArbAcquire(pArb, pClient) == false)
+		return 0;
+
+	int count = DeviceIntrfTransfer(pArb->pIntrf, DevAddr, pSeg, NbSeg);
+
+	DevIntrfArbRelease(pArb, pClient);
+
+	return count;
+}
@@ -0,0 +1,266 @@
+/**-------------------------------------------------------------------------
+@file	device_intrf_async.c
+
+@brief	Asynchronous device interface transaction queue.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "atomic.h"
+#include "device_intrf_async.h"
+
+bool DevIntrfQueInit(DEVINTRFQUE *pQue, DEVINTRF *pIntrf, DEVINTRFQUE_START Start, void *pStartData)
+{
+	if (pQue == NULL || pIntrf == NULL)
+		return false;
+
+	memset(pQue, 0, sizeof(DEVINTRFQUE));
+
+	pQue->pIntrf = pIntrf;
+	pQue->Start = Start;
+	pQue->pStartData = pStartData;
+
+	return true;
+}
+
+// Pop next transaction, clear running state when empty
+static DEVINTRF_XACT *DevIntrfQuePop(DEVINTRFQUE *pQue)
+{
+	uint32_t state = DisableInterrupt();
+	DEVINTRF_XACT *xact = pQue->pHead;
+
+	if (xact)
+	{
+		pQue->pHead = xact->pNext;
+		if (pQue->pHead == NULL)
+		{
+			pQue->pTail = NULL;
+		}
+	}
+	else
+	{
+		pQue->bRunning = false;
+	}
+	pQue->pCur = xact;
+
+	EnableInterrupt(state);
+
+	return xact;
+}
+
+static void DevIntrfQueFinish(DEVINTRFQUE *pQue, DEVINTRF_XACT *pXact, int Count)
+{
+	uint32_t state;
+
+	pXact->Count = Count > pXact->CmdLen ? Count - pXact->CmdLen : 0;
+
+	state = DisableInterrupt();
+	pQue->Stats.DoneCnt++;
+	if (pXact->Count == 0)
+	{
+		pQue->Stats.FailCnt++;
+	}
+	pQue->Stats.Depth--;
+	EnableInterrupt(state);
+
+	if (pXact->CompleteCB)
+	{
+		pXact->CompleteCB(pXact);
+	}
+}
+
+// Execute queued transactions.  Returns when queue is empty or, in completion
+// driven mode, when a transfer has been started
+static void DevIntrfQueRun(DEVINTRFQUE *pQue)
+{
+	DEVINTRF_XACT *xact;
+
+	while ((xact = DevIntrfQuePop(pQue)) != NULL)
+	{
+		if (pQue->Start)
+		{
+			if (pQue->Start(pQue, xact))
+				return;
+
+			DevIntrfQueFinish(pQue, xact, 0);
+		}
+		else
+		{
+			DevIntrfQueFinish(pQue, xact, DeviceIntrfTransfer(pQue->pIntrf, xact->DevAddr,
+															  xact->Seg, xact->NbSeg));
+		}
+	}
+}
+
+bool DevIntrfQueSubmit(DEVINTRFQUE *pQue, DEVINTRF_XACT *pXact)
+{
+	bool run = false;
+
+	if (pQue == NULL || pXact == NULL || pXact->NbSeg <= 0 || pXact->NbSeg > DEVINTRF_XACT_MAXSEG)
+		return false;
+
+	pXact->pNext = NULL;
+	pXact->Count = 0;
+
+	uint32_t state = DisableInterrupt();
+
+	if (pQue->pTail)
+	{
+		pQue->pTail->pNext = pXact;
+	}
+	else
+	{
+		pQue->pHead = pXact;
+	}
+	pQue->pTail = pXact;
+
+	pQue->Stats.SubmitCnt++;
+	pQue->Stats.Depth++;
+	if (pQue->Stats.Depth > pQue->Stats.MaxDepth)
+	{
+		pQue->Stats.MaxDepth = pQue->Stats.Depth;
+	}
+
+	if (pQue->bRunning == false)
+	{
+		pQue->bRunning = true;
+		run = true;
+	}
+
+	EnableInterrupt(state);
+
+	if (run)
+	{
+		DevIntrfQueRun(pQue);
+	}
+
+	return true;
+}
+
+void DevIntrfQueComplete(DEVINTRFQUE *pQue, int Count)
+{
+	DEVINTRF_XACT *xact = pQue->pCur;
+
+	if (xact == NULL)
+		return;
+
+	DevIntrfQueFinish(pQue, xact, Count);
+	DevIntrfQueRun(pQue);
+}
+
+bool DevIntrfQueCancel(DEVINTRFQUE *pQue, DEVINTRF_XACT *pXact)
+{
+	bool found = false;
+
+	if (pQue == NULL || pXact == NULL)
+		return false;
+
+	uint32_t state = DisableInterrupt();
+	DEVINTRF_XACT *prev = NULL;
+
+	// Only transactions not started yet, the one in progress owns the bus
+	for (DEVINTRF_XACT *x = pQue->pHead; x != NULL; prev = x, x = x->pNext)
+	{
+		if (x == pXact)
+		{
+			if (prev)
+			{
+				prev->pNext = x->pNext;
+			}
+			else
+			{
+				pQue->pHead = x->pNext;
+			}
+			if (pQue->pTail == x)
+			{
+				pQue->pTail = prev;
+			}
+			found = true;
+			break;
+		}
+	}
+
+	EnableInterrupt(state);
+
+	if (found)
+	{
+		DevIntrfQueFinish(pQue, pXact, 0);
+	}
+
+	return found;
+}
+
+void DevIntrfXactRead(DEVINTRF_XACT *pXact, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
+					  uint8_t *pBuff, int BuffLen, DEVINTRF_XACTCB CompleteCB, void *pCtx)
+{
+	int n = 0;
+
+	pXact->DevAddr = DevAddr;
+	pXact->CmdLen = 0;
+
+	if (pAdCmd != NULL && AdCmdLen > 0)
+	{
+		pXact->Seg[n].pData = pAdCmd;
+		pXact->Seg[n].Len = AdCmdLen;
+		pXact->Seg[n].bRx = false;
+		pXact->CmdLen = AdCmdLen;
+		n++;
+	}
+
+	pXact->Seg[n].pData = pBuff;
+	pXact->Seg[n].Len = BuffLen;
+	pXact->Seg[n].bRx = true;
+	pXact->NbSeg = n + 1;
+	pXact->CompleteCB = CompleteCB;
+	pXact->pCtx = pCtx;
+}
+
+void DevIntrfXactWrite(DEVINTRF_XACT *pXact, int DevAddr, uint8_t *pAdCmd, int AdCmdLen,
+					   uint8_t *pData, int DataLen, DEVINTRF_XACTCB CompleteCB, void *pCtx)
+{
+	pXact->DevAddr = DevAddr;
+	pXact->Seg[0].pData = pAdCmd;
+	pXact->Seg[0].Len = AdCmdLen;
+	pXact->Seg[0].bRx = false;
+	pXact->CmdLen = AdCmdLen;
+	pXact->NbSeg = 1;
+
+	if (pData != NULL && DataLen > 0)
+	{
+		pXact->Seg[1].pData = pData;
+		pXact->Seg[1].Len = DataLen;
+		pXact->Seg[1].bRx = false;
+		pXact->NbSeg = 2;
+	}
+
+	pXact->CompleteCB = CompleteCB;
+	pXact->pCtx = pCtx;
+}
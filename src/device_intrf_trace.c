@@ -0,0 +1,106 @@
+/**-------------------------------------------------------------------------
+@file	device_intrf_trace.c
+
+@brief	Device interface transaction tracer.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "device_intrf_trace.h"
+
+static inline uint16_t DevTraceSat16(int Val)
+{
+	return Val < 0 ? 0 : Val > 0xFFFF ? 0xFFFF : Val;
+}
+
+bool DevTraceInit(DEVTRACE *pTrace, uint8_t *pMem, uint32_t MemSize, DEVTRACECLOCK Clock,
+				  uint32_t ClockRate)
+{
+	if (pTrace == NULL)
+		return false;
+
+	pTrace->hFifo = CFifoInitMpsc(pMem, MemSize, sizeof(DEVTRACE_REC));
+	if (pTrace->hFifo == NULL)
+		return false;
+
+	pTrace->Clock = Clock;
+	pTrace->ClockRate = ClockRate;
+	pTrace->DropCnt = 0;
+
+	return true;
+}
+
+void DevTraceRecord(DEVTRACE *pTrace, DEVTRACE_EVT Evt, int DevAddr, int ReqLen, int Len,
+					int Retry, uint32_t StartTime)
+{
+	if (pTrace == NULL)
+		return;
+
+	DEVTRACE_REC *rec = (DEVTRACE_REC *)CFifoClaim(pTrace->hFifo);
+
+	if (rec == NULL)
+	{
+		AtomicInc(&pTrace->DropCnt);
+
+		return;
+	}
+
+	rec->Time = StartTime;
+	rec->Dur = DevTraceTime(pTrace) - StartTime;
+	rec->DevAddr = DevAddr;
+	rec->ReqLen = DevTraceSat16(ReqLen);
+	rec->Len = DevTraceSat16(Len);
+	rec->Evt = Evt;
+	rec->Retry = Retry > 0xFF ? 0xFF : Retry;
+
+	CFifoPublish(pTrace->hFifo, (uint8_t *)rec);
+}
+
+int DevTraceDump(DEVTRACE *pTrace, uint8_t *pBuff, int BuffLen)
+{
+	DEVTRACE_HDR hdr;
+
+	if (pTrace == NULL || pBuff == NULL || BuffLen < (int)sizeof(DEVTRACE_HDR))
+		return 0;
+
+	int cnt = CFifoRead(pTrace->hFifo, pBuff + sizeof(DEVTRACE_HDR),
+						(BuffLen - sizeof(DEVTRACE_HDR)) / sizeof(DEVTRACE_REC) * sizeof(DEVTRACE_REC));
+
+	hdr.Magic = DEVTRACE_MAGIC;
+	hdr.Version = DEVTRACE_VERSION;
+	hdr.RecSize = sizeof(DEVTRACE_REC);
+	hdr.ClockRate = pTrace->ClockRate;
+	hdr.NbRec = cnt / sizeof(DEVTRACE_REC);
+	hdr.DropCnt = AtomicExchange(&pTrace->DropCnt, 0);
+	memcpy(pBuff, &hdr, sizeof(DEVTRACE_HDR));
+
+	return sizeof(DEVTRACE_HDR) + cnt;
+}
@@ -40,6 +40,7 @@ FlashDiskIO::FlashDiskIO() : DiskIO()
 {
 	vpWaitCB = NULL;
 	vpInterf = NULL;
+	vSectSize = DISKIO_SECT_SIZE;
 }
 
 bool FlashDiskIO::Init(FLASHDISKIO_CFG &Cfg, DeviceIntrf *pInterf,
@@ -59,6 +60,7 @@ bool FlashDiskIO::Init(FLASHDISKIO_CFG &Cfg, DeviceIntrf *pInterf,
 
     vDevNo          = Cfg.DevNo;
     vEraseSize      = Cfg.EraseSize;
+    vSectSize       = Cfg.SectSize > 0 ? Cfg.SectSize : DISKIO_SECT_SIZE;
     if (Cfg.WriteSize == 0)
         vWriteSize = DISKIO_SECT_SIZE;
     else
@@ -205,9 +207,9 @@ void FlashDiskIO::EraseBlock(uint32_t BlkNo, int NbBlk)
 bool FlashDiskIO::SectRead(uint32_t SectNo, uint8_t *pBuff)
 {
     uint8_t d[9];
-    uint32_t addr = SectNo * DISKIO_SECT_SIZE;
+    uint32_t addr = SectNo * vSectSize;
     uint8_t *p = (uint8_t*)&addr;
-    int cnt = DISKIO_SECT_SIZE;
+    int cnt = vSectSize;
 
     // Makesure there is no write access pending
     WaitReady(100000);
@@ -221,7 +223,7 @@ bool FlashDiskIO::SectRead(uint32_t SectNo, uint8_t *pBuff)
 
         vpInterf->StartRx(vDevNo);
         vpInterf->TxData((uint8_t*)d, vAddrSize + 1);
-        int l = vpInterf->RxData(pBuff, DISKIO_SECT_SIZE);
+        int l = vpInterf->RxData(pBuff, cnt);
         vpInterf->StopRx();
         if (l <= 0)
             return false;
@@ -233,13 +235,52 @@ bool FlashDiskIO::SectRead(uint32_t SectNo, uint8_t *pBuff)
     return true;
 }
 
+bool FlashDiskIO::SectReadMulti(uint32_t SectNo, uint8_t * const *ppBuff, int NbSect)
+{
+    uint8_t d[9];
+    uint32_t addr = SectNo * vSectSize;
+    uint8_t *p = (uint8_t*)&addr;
+    bool res = true;
+
+    WaitReady(100000);
+
+    d[0] = FLASH_CMD_READ;
+    for (int i = 1; i <= vAddrSize; i++)
+        d[i] = p[vAddrSize - i];
+
+    // Flash address auto increments, sectors are clocked out back to back
+    vpInterf->StartRx(vDevNo);
+    vpInterf->TxData((uint8_t*)d, vAddrSize + 1);
+    for (int i = 0; i < NbSect && res; i++)
+    {
+        uint8_t *pBuff = ppBuff[i];
+        int cnt = vSectSize;
+
+        // Interface may return partial chunks
+        while (cnt > 0)
+        {
+            int l = vpInterf->RxData(pBuff, cnt);
+            if (l <= 0)
+            {
+                res = false;
+                break;
+            }
+            cnt -= l;
+            pBuff += l;
+        }
+    }
+    vpInterf->StopRx();
+
+    return res;
+}
+
 /**
  * Write one sector to physical device
  */
 bool FlashDiskIO::SectWrite(uint32_t SectNo, uint8_t *pData)
 {
     uint8_t d[9];
-    uint32_t addr = SectNo * DISKIO_SECT_SIZE;
+    uint32_t addr = SectNo * vSectSize;
     uint8_t *p = (uint8_t*)&addr;
 
     int cnt = 0;
@@ -247,7 +288,7 @@ bool FlashDiskIO::SectWrite(uint32_t SectNo, uint8_t *pData)
    // printf("Sect : %d 0x%02x 0x%02x 0x%02x 0x%02x\r\n", SectNo, pData[0], pData[1], pData[2], pData[3]);
     d[0] = FLASH_CMD_WRITE;
 
-    cnt = DISKIO_SECT_SIZE;
+    cnt = vSectSize;
     while (cnt > 0)
     {
         for (int i = 1; i <= vAddrSize; i++)
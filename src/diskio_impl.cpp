@@ -42,8 +42,35 @@ Modified by          Date              Description
 
 using namespace std;
 
-DiskIO::DiskIO() : vLastIdx(1), vNbCache(0), vpCacheSect(NULL)
+DiskIO::DiskIO() : vSectSize(0), vSectShift(0), vLastIdx(0), vNbCache(0), vpCacheSect(NULL), vpHash(NULL), vHashMask(0), vHashShift(32),
+				   vpDirty(NULL), vNbDirty(0), vDirtyMax(0), vAgeMax(0), vDirtyTime(0), vClock(NULL),
+				   vBypassMin(DISKIO_BYPASS_SECT_DEF), vPrefetchMax(0), vbPrefetchDefer(false), vStreamStamp(0)
 {
+	memset(&vCacheStats, 0, sizeof(vCacheStats));
+	memset(vStream, 0, sizeof(vStream));
+}
+
+// Device sector size is read once, device must be initialized
+void DiskIO::SectSizeInit()
+{
+	vSectSize = GetSectSize();
+	vSectShift = 0;
+
+	while ((1U << vSectShift) < vSectSize)
+		vSectShift++;
+}
+
+void DiskIO::CacheInit(DISKIO_CACHE_DESC *pCacheBlk, int NbCacheBlk, int16_t *pHash, int HashBits, int16_t *pDirty)
+{
+	vNbCache = NbCacheBlk;
+	vpCacheSect = pCacheBlk;
+	vpHash = pHash;
+	vpDirty = pDirty;
+	vHashMask = (1 << HashBits) - 1;
+	vHashShift = 32 - HashBits;
+	vLastIdx = 0;
+
+	Reset();
 }
 
 void DiskIO::SetCache(DISKIO_CACHE_DESC *pCacheBlk, int NbCacheBlk)
@@ -51,15 +78,54 @@ void DiskIO::SetCache(DISKIO_CACHE_DESC *pCacheBlk, int NbCacheBlk)
 	if (pCacheBlk == NULL || NbCacheBlk <= 0)
 		return;
 
-	vNbCache = NbCacheBlk;
+	if (NbCacheBlk > DISKIO_CACHE_SECT_MAX)
+		NbCacheBlk = DISKIO_CACHE_SECT_MAX;
 
-	vpCacheSect = pCacheBlk;
+	SectSizeInit();
 
-	for (int i = 0; i < vNbCache; i++)
+	// At least 2 slots per entry
+	int bits = 1;
+
+	while ((1 << bits) < NbCacheBlk * 2)
+		bits++;
+
+	CacheInit(pCacheBlk, NbCacheBlk, vHashMem, bits, vDirtyMem);
+}
+
+int DiskIO::SetCacheMem(uint8_t *pMem, uint32_t MemSize)
+{
+	uint32_t pad = (4 - ((uintptr_t)pMem & 3)) & 3;
+
+	SectSizeInit();
+
+	if (pMem == NULL || MemSize < pad + DISKIO_CACHE_MEMSIZE_SECT(1, vSectSize))
+		return 0;
+
+	int n = (MemSize - 4) / (sizeof(DISKIO_CACHE_DESC) + vSectSize + 10);
+
+	if (n > 0x4000)
+		n = 0x4000;
+
+	int bits = 1;
+
+	while ((1 << bits) < n * 2)
+		bits++;
+
+	// Descriptors, hash table, dirty list then sector data, all 4 bytes aligned
+	DISKIO_CACHE_DESC *desc = (DISKIO_CACHE_DESC *)(pMem + pad);
+	int16_t *hash = (int16_t *)&desc[n];
+	int16_t *dirty = &hash[1 << bits];
+	uint8_t *p = (uint8_t *)&dirty[(n + 1) & ~1];
+
+	for (int i = 0; i < n; i++)
 	{
-		vpCacheSect[i].UseCnt = 0;
-		vpCacheSect[i].SectNo = -1;
+		desc[i].pSectData = p;
+		p += vSectSize;
 	}
+
+	CacheInit(desc, n, hash, bits, dirty);
+
+	return n;
 }
 
 void DiskIO::Reset()
@@ -68,69 +134,523 @@ void DiskIO::Reset()
 	{
 		vpCacheSect[i].UseCnt = 0;
 		vpCacheSect[i].SectNo = -1;
+		vpCacheSect[i].bRef = false;
+		vpCacheSect[i].bPrefetch = false;
+		vpCacheSect[i].bDemand = false;
 	}
+
+	for (int i = 0; i <= vHashMask && vpHash; i++)
+	{
+		vpHash[i] = DISKIO_CACHE_HASH_EMPTY;
+	}
+
+	vNbDirty = 0;
+
+	memset(vStream, 0, sizeof(vStream));
 }
 
-int	DiskIO::GetCacheSect(uint32_t SectNo, bool bLock)
+int DiskIO::CacheFind(uint32_t SectNo)
 {
-    // Try to find sector in cache
-	for (int i = 0; i < vNbCache; i++)
+	for (int i = CacheHashSlot(SectNo); vpHash[i] != DISKIO_CACHE_HASH_EMPTY; i = (i + 1) & vHashMask)
 	{
-		// Grab first cache
-		vpCacheSect[i].UseCnt++;
-		if (vpCacheSect[0].SectNo == SectNo)
-			return i;
-		// Not requested sector release it
-		vpCacheSect[i].UseCnt--;
+		if (vpCacheSect[vpHash[i]].SectNo == SectNo)
+			return vpHash[i];
 	}
 
-	// Not in cache, try to pick unused cache
-	int i = vNbCache;
+	return -1;
+}
+
+void DiskIO::CacheInsert(int Idx)
+{
+	int i = CacheHashSlot(vpCacheSect[Idx].SectNo);
 
-	while (i > 0)
+	while (vpHash[i] != DISKIO_CACHE_HASH_EMPTY)
 	{
-		vLastIdx++;
+		i = (i + 1) & vHashMask;
+	}
 
-		if (vLastIdx >= vNbCache)
-			vLastIdx = 0;
+	vpHash[i] = Idx;
+}
+
+// Linear probing delete, entries after the hole are shifted back if their
+// home slot allows it so that no tombstone is needed
+void DiskIO::CacheRemove(int Idx)
+{
+	int i = CacheHashSlot(vpCacheSect[Idx].SectNo);
 
-		if ((vpCacheSect[vLastIdx].UseCnt & ~DISKIO_CACHE_DIRTY_BIT) == 0)
+	while (vpHash[i] != Idx)
+	{
+		if (vpHash[i] == DISKIO_CACHE_HASH_EMPTY)
+			return;
+		i = (i + 1) & vHashMask;
+	}
+
+	vpHash[i] = DISKIO_CACHE_HASH_EMPTY;
+
+	for (int j = (i + 1) & vHashMask; vpHash[j] != DISKIO_CACHE_HASH_EMPTY; j = (j + 1) & vHashMask)
+	{
+		int k = CacheHashSlot(vpCacheSect[vpHash[j]].SectNo);
+
+		// Stays if its home slot is cyclically in (i, j]
+		if (i <= j ? (i < k && k <= j) : (i < k || k <= j))
+			continue;
+
+		vpHash[i] = vpHash[j];
+		vpHash[j] = DISKIO_CACHE_HASH_EMPTY;
+		i = j;
+	}
+}
+
+// Position of sector in dirty list, or insertion position if not dirty
+int DiskIO::DirtyFind(uint32_t SectNo)
+{
+	int lo = 0, hi = vNbDirty;
+
+	while (lo < hi)
+	{
+		int mid = (lo + hi) >> 1;
+
+		if (vpCacheSect[vpDirty[mid]].SectNo < SectNo)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+void DiskIO::DirtyAdd(int Idx)
+{
+	int pos = DirtyFind(vpCacheSect[Idx].SectNo);
+
+	memmove(&vpDirty[pos + 1], &vpDirty[pos], (vNbDirty - pos) * sizeof(int16_t));
+	vpDirty[pos] = Idx;
+
+	if (vNbDirty++ == 0 && vClock)
+	{
+		vDirtyTime = vClock();
+	}
+}
+
+// Write back the run of consecutive dirty sectors around dirty list position
+// Pos with a single SectWriteMulti.  Returns number of sectors written, -1 on
+// failure with the run left dirty
+int DiskIO::CacheWriteRun(int Pos)
+{
+	uint8_t *data[DISKIO_WRITE_RUN_MAX];
+	uint32_t sectno = vpCacheSect[vpDirty[Pos]].SectNo;
+	int first = Pos, last = Pos;
+
+	while (first > 0 && last - first + 1 < DISKIO_WRITE_RUN_MAX &&
+		   vpCacheSect[vpDirty[first - 1]].SectNo == sectno - (Pos - first) - 1)
+	{
+		first--;
+	}
+	while (last + 1 < vNbDirty && last - first + 1 < DISKIO_WRITE_RUN_MAX &&
+		   vpCacheSect[vpDirty[last + 1]].SectNo == sectno + (last - Pos) + 1)
+	{
+		last++;
+	}
+
+	int n = last - first + 1;
+
+	for (int i = 0; i < n; i++)
+	{
+		data[i] = vpCacheSect[vpDirty[first + i]].pSectData;
+	}
+
+	if (SectWriteMulti(sectno - (Pos - first), data, n) == false)
+		return -1;
+
+	for (int i = 0; i < n; i++)
+	{
+		vpCacheSect[vpDirty[first + i]].UseCnt &= ~DISKIO_CACHE_DIRTY_BIT;
+	}
+
+	vNbDirty -= n;
+	memmove(&vpDirty[first], &vpDirty[last + 1], (vNbDirty - first) * sizeof(int16_t));
+
+	vCacheStats.WriteBackCnt += n;
+	vCacheStats.WriteRunCnt++;
+
+	return n;
+}
+
+int	DiskIO::GetCacheSect(uint32_t SectNo, bool bLock)
+{
+	return CacheGet(SectNo, true);
+}
+
+// Find or allocate cache entry, bFill false if sector will be overwritten
+int DiskIO::CacheGet(uint32_t SectNo, bool bFill)
+{
+	if (vNbCache <= 0)
+		return -1;
+
+	int idx = CacheFind(SectNo);
+
+	if (idx >= 0)
+	{
+		vpCacheSect[idx].UseCnt++;
+		vpCacheSect[idx].bRef = true;
+
+		if (vpCacheSect[idx].bDemand)
+		{
+			// Just read by PrefetchRange for this access, not a hit
+			vpCacheSect[idx].bDemand = false;
+		}
+		else
 		{
-			// Got unused cache
+			vCacheStats.HitCnt++;
+		}
+
+		if (vpCacheSect[idx].bPrefetch)
+		{
+			vpCacheSect[idx].bPrefetch = false;
+			vCacheStats.PrefetchHitCnt++;
+		}
+
+		return idx;
+	}
+
+	idx = CacheAlloc(SectNo);
+	if (idx < 0)
+		return -1;
 
-		    // Flush cache is dirty
-		    if (vpCacheSect[vLastIdx].UseCnt & DISKIO_CACHE_DIRTY_BIT)
-		        SectWrite(vpCacheSect[vLastIdx].SectNo, vpCacheSect[vLastIdx].pSectData);
+	// Fill cache
+	if (bFill && SectRead(SectNo, vpCacheSect[idx].pSectData) == false)
+	{
+		CacheFree(idx);
+
+		return -1;
+	}
+
+	vCacheStats.MissCnt++;
 
-	        vpCacheSect[vLastIdx].UseCnt = 1;
+	return idx;
+}
+
+// Allocate pinned cache entry for a sector not in cache, data not filled
+int DiskIO::CacheAlloc(uint32_t SectNo)
+{
+	int idx;
+
+	// CLOCK eviction.  Pinned entries are skipped, referenced
+	// ones get a second chance.  Two turns find a victim if any is unpinned
+	for (int n = vNbCache * 2; n > 0; n--)
+	{
+		DISKIO_CACHE_DESC *desc = &vpCacheSect[vLastIdx];
 
-	        // Fill cache
-			SectRead(SectNo, vpCacheSect[vLastIdx].pSectData);
+		idx = vLastIdx;
 
-			vpCacheSect[vLastIdx].SectNo = SectNo;
-			return vLastIdx;
+		if (++vLastIdx >= vNbCache)
+			vLastIdx = 0;
+
+		if ((desc->UseCnt & ~DISKIO_CACHE_DIRTY_BIT) != 0)
+			continue;
+
+		if (desc->bRef)
+		{
+			desc->bRef = false;
+			continue;
 		}
-		i--;
+
+		if (desc->SectNo != (uint32_t)-1)
+		{
+			// Flush cache is dirty, with its dirty neighbours.  Keep it if
+			// it could not be written
+			if ((desc->UseCnt & DISKIO_CACHE_DIRTY_BIT) &&
+				CacheWriteRun(DirtyFind(desc->SectNo)) < 0)
+			{
+				continue;
+			}
+			CacheRemove(idx);
+			vCacheStats.EvictCnt++;
+		}
+
+		desc->UseCnt = 1;
+		desc->SectNo = SectNo;
+		desc->bRef = true;
+		desc->bPrefetch = false;
+		desc->bDemand = false;
+		CacheInsert(idx);
+
+		return idx;
 	}
 
 	// No Cache avail
+	vCacheStats.FullCnt++;
+
 	return -1;
 }
 
+// Drop entry from CacheAlloc whose data could not be read
+void DiskIO::CacheFree(int Idx)
+{
+	CacheRemove(Idx);
+	vpCacheSect[Idx].UseCnt = 0;
+	vpCacheSect[Idx].SectNo = -1;
+	vpCacheSect[Idx].bRef = false;
+}
+
+void DiskIO::ReleaseCacheSect(int Idx, bool bDirty)
+{
+	if (Idx < 0 || Idx >= vNbCache)
+		return;
+
+	if (bDirty && (vpCacheSect[Idx].UseCnt & DISKIO_CACHE_DIRTY_BIT) == 0)
+	{
+		vpCacheSect[Idx].UseCnt |= DISKIO_CACHE_DIRTY_BIT;
+		DirtyAdd(Idx);
+	}
+	vpCacheSect[Idx].UseCnt--;
+
+	if (bDirty)
+	{
+		if (vDirtyMax > 0 && vNbDirty >= vDirtyMax)
+		{
+			Flush();
+		}
+		else
+		{
+			FlushAged();
+		}
+	}
+}
+
+void DiskIO::SetWriteBack(int DirtyMax, uint32_t AgeMax, DISKIO_CLOCK Clock)
+{
+	vDirtyMax = DirtyMax;
+	vAgeMax = AgeMax;
+	vClock = Clock;
+
+	if (vClock && vNbDirty > 0)
+	{
+		vDirtyTime = vClock();
+	}
+}
+
+bool DiskIO::FlushAged()
+{
+	if (vNbDirty > 0 && vClock && vAgeMax > 0 && vClock() - vDirtyTime >= vAgeMax)
+	{
+		return Flush();
+	}
+
+	return true;
+}
+
+void DiskIO::SetPrefetch(int WindowMax, bool bDeferred)
+{
+	vPrefetchMax = min(WindowMax, min(vNbCache / 2, DISKIO_MULTI_SECT_MAX));
+	vbPrefetchDefer = bDeferred;
+
+	memset(vStream, 0, sizeof(vStream));
+}
+
+// Read missing sectors of range in cache, consecutive missing sectors with one
+// SectReadMulti.  DemandSect is being read by caller, not counted as read ahead.
+// Returns number of sectors read
+int DiskIO::PrefetchRange(uint32_t SectNo, int NbSect, uint32_t DemandSect)
+{
+	uint8_t *buff[DISKIO_MULTI_SECT_MAX];
+	int16_t idx[DISKIO_MULTI_SECT_MAX];
+	int cnt = 0;
+	int i = 0;
+
+	while (i < NbSect)
+	{
+		if (CacheFind(SectNo + i) >= 0)
+		{
+			i++;
+			continue;
+		}
+
+		uint32_t first = SectNo + i;
+		int n = 0;
+
+		while (i < NbSect && n < DISKIO_MULTI_SECT_MAX && CacheFind(SectNo + i) < 0)
+		{
+			int k = CacheAlloc(SectNo + i);
+
+			if (k < 0)
+				break;
+
+			idx[n] = k;
+			buff[n++] = vpCacheSect[k].pSectData;
+			i++;
+		}
+
+		// Cache full
+		if (n == 0)
+			break;
+
+		bool res = SectReadMulti(first, buff, n);
+
+		for (int j = 0; j < n; j++)
+		{
+			if (res == false)
+			{
+				CacheFree(idx[j]);
+				continue;
+			}
+
+			vpCacheSect[idx[j]].UseCnt--;
+
+			if (first + j == DemandSect)
+			{
+				vpCacheSect[idx[j]].bDemand = true;
+				vCacheStats.MissCnt++;
+			}
+			else
+			{
+				vpCacheSect[idx[j]].bPrefetch = true;
+				vCacheStats.PrefetchCnt++;
+			}
+		}
+
+		if (res == false)
+			break;
+
+		cnt += n;
+	}
+
+	return cnt;
+}
+
+// Track read streams & read ahead before sector is read
+void DiskIO::Prefetch(uint32_t SectNo)
+{
+	DISKIO_STREAM *s = NULL;
+	DISKIO_STREAM *lru = &vStream[0];
+
+	for (int i = 0; i < DISKIO_STREAM_MAX; i++)
+	{
+		DISKIO_STREAM *p = &vStream[i];
+
+		if (p->Stamp != 0 && (p->LastSect == SectNo || p->LastSect + 1 == SectNo))
+		{
+			s = p;
+			break;
+		}
+		if (p->Stamp < lru->Stamp)
+		{
+			lru = p;
+		}
+	}
+
+	if (s == NULL)
+	{
+		// Random access, new stream without read ahead
+		s = lru;
+		s->LastSect = SectNo;
+		s->NextSect = SectNo + 1;
+		s->Window = 0;
+		s->PendCnt = 0;
+		s->Stamp = ++vStreamStamp;
+
+		return;
+	}
+
+	s->Stamp = ++vStreamStamp;
+
+	if (s->LastSect == SectNo)
+		return;
+
+	s->LastSect = SectNo;
+
+	if (s->NextSect < SectNo)
+	{
+		s->NextSect = SectNo;
+	}
+
+	// Less than half window ahead, grow & read ahead
+	if ((int)(s->NextSect - SectNo - 1) > s->Window / 2)
+		return;
+
+	s->Window = s->Window > 0 ? min(s->Window * 2, vPrefetchMax) : min(DISKIO_PREFETCH_WIN_MIN, vPrefetchMax);
+
+	uint32_t start = s->NextSect;
+	uint32_t end = SectNo + 1 + s->Window;
+
+	if (end > GetNbSect())
+	{
+		end = GetNbSect();
+	}
+	if (end <= start)
+		return;
+
+	s->NextSect = end;
+
+	if (vbPrefetchDefer)
+	{
+		// Demand sector is read by caller
+		if (start == SectNo)
+		{
+			start++;
+		}
+		// Extends read ahead not issued yet
+		if (s->PendCnt == 0)
+		{
+			s->PendSect = start;
+		}
+		s->PendCnt = end - s->PendSect;
+	}
+	else
+	{
+		PrefetchRange(start, end - start, SectNo);
+	}
+}
+
+int DiskIO::PrefetchRun()
+{
+	int cnt = 0;
+
+	for (int i = 0; i < DISKIO_STREAM_MAX; i++)
+	{
+		if (vStream[i].PendCnt > 0)
+		{
+			cnt += PrefetchRange(vStream[i].PendSect, vStream[i].PendCnt, -1);
+			vStream[i].PendCnt = 0;
+		}
+	}
+
+	return cnt;
+}
+
 int DiskIO::Read(uint32_t SectNo, uint32_t SectOffset, uint8_t *pBuff, uint32_t Len)
 {
 	if (pBuff == NULL)
 		return -1;
 
-	int l = min(Len, DISKIO_SECT_SIZE - SectOffset);
+	if (vSectSize == 0)
+		SectSizeInit();
+
+	uint32_t l = min(Len, vSectSize - SectOffset);
+
+	if (vPrefetchMax > 0)
+	{
+		Prefetch(SectNo);
+	}
 
 	int idx = GetCacheSect(SectNo);
 	if (idx < 0)
 	{
-	    // No cache, do physical read
-	    uint8_t d[DISKIO_SECT_SIZE];
-	    SectRead(SectNo, d);
-	    memcpy(pBuff, d + SectOffset, l);
+	    // No cache, do physical read, whole sector straight to caller
+	    if (l == vSectSize)
+	    {
+	    	SectRead(SectNo, pBuff);
+	    }
+	    else if (vSectSize <= DISKIO_SECT_SIZE)
+	    {
+	    	uint8_t d[DISKIO_SECT_SIZE];
+	    	SectRead(SectNo, d);
+	    	memcpy(pBuff, d + SectOffset, l);
+	    }
+	    else
+	    {
+	    	return -1;
+	    }
 	}
 	else
 	{
@@ -138,28 +658,114 @@ int DiskIO::Read(uint32_t SectNo, uint32_t SectOffset, uint8_t *pBuff, uint32_t
 	    memcpy(pBuff, vpCacheSect[idx].pSectData + SectOffset, l);
 
 	    // Done with cache sector, release it
-	    vpCacheSect[idx].UseCnt--;
+	    ReleaseCacheSect(idx);
 	}
 
 	return l;
 }
 
+// Read whole sectors straight into caller buffer.  Dirty cached sectors are
+// newer than the device, they are copied over.  Returns number of bytes read
+int DiskIO::BypassRead(uint32_t SectNo, uint8_t *pBuff, int NbSect)
+{
+	uint8_t *buff[DISKIO_MULTI_SECT_MAX];
+
+	for (int i = 0; i < NbSect; i++)
+	{
+		buff[i] = pBuff + i * vSectSize;
+	}
+
+	if (SectReadMulti(SectNo, buff, NbSect) == false)
+		return -1;
+
+	for (int i = DirtyFind(SectNo); i < vNbDirty; i++)
+	{
+		DISKIO_CACHE_DESC *desc = &vpCacheSect[vpDirty[i]];
+
+		if (desc->SectNo >= SectNo + NbSect)
+			break;
+
+		memcpy(buff[desc->SectNo - SectNo], desc->pSectData, vSectSize);
+	}
+
+	vCacheStats.BypassCnt += NbSect;
+
+	return NbSect * vSectSize;
+}
+
+// Write whole sectors straight from caller buffer.  Once written, cached
+// copies are updated and no longer dirty.  Returns number of bytes written
+int DiskIO::BypassWrite(uint32_t SectNo, uint8_t *pData, int NbSect)
+{
+	uint8_t *data[DISKIO_MULTI_SECT_MAX];
+
+	for (int i = 0; i < NbSect; i++)
+	{
+		data[i] = pData + i * vSectSize;
+	}
+
+	// Cache is left untouched on failure, dirty copies are still to be written
+	if (SectWriteMulti(SectNo, data, NbSect) == false)
+		return -1;
+
+	for (int i = 0; i < NbSect; i++)
+	{
+		int idx = vNbCache > 0 ? CacheFind(SectNo + i) : -1;
+
+		if (idx >= 0)
+		{
+			DISKIO_CACHE_DESC *desc = &vpCacheSect[idx];
+
+			memcpy(desc->pSectData, data[i], vSectSize);
+
+			if (desc->UseCnt & DISKIO_CACHE_DIRTY_BIT)
+			{
+				int pos = DirtyFind(desc->SectNo);
+
+				desc->UseCnt &= ~DISKIO_CACHE_DIRTY_BIT;
+				vNbDirty--;
+				memmove(&vpDirty[pos], &vpDirty[pos + 1], (vNbDirty - pos) * sizeof(int16_t));
+			}
+		}
+	}
+
+	vCacheStats.BypassCnt += NbSect;
+
+	return NbSect * vSectSize;
+}
+
 int DiskIO::Read(uint64_t Offset, uint8_t *pBuff, uint32_t Len)
 {
-	uint64_t sectno = Offset / DISKIO_SECT_SIZE;
-	uint32_t sectoff = Offset % DISKIO_SECT_SIZE;
+	if (vSectSize == 0)
+		SectSizeInit();
+
+	uint32_t sectno = Offset >> vSectShift;
+	uint32_t sectoff = Offset & (vSectSize - 1);
 
 	uint32_t retval = 0;
+	bool bypass = false;
 
 	while (Len > 0)
 	{
-		int l = Read(sectno, sectoff, pBuff, Len);
+		int l;
+		uint32_t n = Len >> vSectShift;
+
+		// Once started, remaining whole sectors bypass the cache too
+		if (sectoff == 0 && vBypassMin > 0 && n > 0 && (bypass || n >= (uint32_t)vBypassMin))
+		{
+			bypass = true;
+			l = BypassRead(sectno, pBuff, min(n, (uint32_t)DISKIO_MULTI_SECT_MAX));
+		}
+		else
+		{
+			l = Read(sectno, sectoff, pBuff, Len);
+		}
 		if (l <= 0)
 			break;
 		pBuff += l;
 		Len -= l;
 		retval += l;
-		sectno++;
+		sectno += (sectoff + l) >> vSectShift;
 		sectoff = 0;
 	}
 
@@ -171,16 +777,33 @@ int DiskIO::Write(uint32_t SectNo, uint32_t SectOffset, uint8_t *pData, uint32_t
 	if (pData == NULL)
 		return -1;
 
-	uint32_t l = min(Len, DISKIO_SECT_SIZE - SectOffset);
+	if (vSectSize == 0)
+		SectSizeInit();
+
+	uint32_t l = min(Len, vSectSize - SectOffset);
+
+	// Whole sector is overwritten, no need to read it first
+	bool fill = l < vSectSize;
 
-	int idx = GetCacheSect(SectNo, true);
+	int idx = CacheGet(SectNo, fill);
 	if (idx < 0)
 	{
-	    // No cache, do physical write
-	    uint8_t d[DISKIO_SECT_SIZE];
-	    SectRead(SectNo, d);
-	    memcpy(d + SectOffset, pData, l);
-	    SectWrite(SectNo, d);
+	    // No cache, do physical write, whole sector straight from caller
+	    if (fill == false)
+	    {
+	    	SectWrite(SectNo, pData);
+	    }
+	    else if (vSectSize <= DISKIO_SECT_SIZE)
+	    {
+	    	uint8_t d[DISKIO_SECT_SIZE];
+	    	SectRead(SectNo, d);
+	    	memcpy(d + SectOffset, pData, l);
+	    	SectWrite(SectNo, d);
+	    }
+	    else
+	    {
+	    	return -1;
+	    }
 	}
 	else
 	{
@@ -188,8 +811,7 @@ int DiskIO::Write(uint32_t SectNo, uint32_t SectOffset, uint8_t *pData, uint32_t
         memcpy(vpCacheSect[idx].pSectData + SectOffset, pData, l);
 
         // Done with cache sector, release it
-        vpCacheSect[idx].UseCnt |= DISKIO_CACHE_DIRTY_BIT;
-        vpCacheSect[idx].UseCnt--;
+        ReleaseCacheSect(idx, true);
 	}
 
 	return l;
@@ -197,34 +819,50 @@ int DiskIO::Write(uint32_t SectNo, uint32_t SectOffset, uint8_t *pData, uint32_t
 
 int DiskIO::Write(uint64_t Offset, uint8_t *pData, uint32_t Len)
 {
-	uint64_t sectno = Offset / DISKIO_SECT_SIZE;
-	uint32_t sectoff = Offset % DISKIO_SECT_SIZE;
+	if (vSectSize == 0)
+		SectSizeInit();
+
+	uint32_t sectno = Offset >> vSectShift;
+	uint32_t sectoff = Offset & (vSectSize - 1);
 
 	uint32_t retval = 0;
+	bool bypass = false;
 
 	while (Len > 0)
 	{
-		int l = Write(sectno, sectoff, pData, Len);
+		int l;
+		uint32_t n = Len >> vSectShift;
+
+		// Once started, remaining whole sectors bypass the cache too
+		if (sectoff == 0 && vBypassMin > 0 && n > 0 && (bypass || n >= (uint32_t)vBypassMin))
+		{
+			bypass = true;
+			l = BypassWrite(sectno, pData, min(n, (uint32_t)DISKIO_MULTI_SECT_MAX));
+		}
+		else
+		{
+			l = Write(sectno, sectoff, pData, Len);
+		}
 		if (l < 0)
 			break;
 		pData += l;
 		Len -= l;
 		retval += l;
-		sectno++;
+		sectno += (sectoff + l) >> vSectShift;
 		sectoff = 0;
 	}
 
 	return retval;
 }
 
-void DiskIO::Flush()
+bool DiskIO::Flush()
 {
-    for (int i = 0; i < vNbCache; i++)
-    {
-        if (vpCacheSect[i].UseCnt & DISKIO_CACHE_DIRTY_BIT)
-        {
-            SectWrite(vpCacheSect[i].SectNo, vpCacheSect[i].pSectData);
-            vpCacheSect[i].UseCnt &= ~DISKIO_CACHE_DIRTY_BIT;
-        }
-    }
+	// Dirty list is in sector order, each run starts at the head
+	while (vNbDirty > 0)
+	{
+		if (CacheWriteRun(0) < 0)
+			return false;
+	}
+
+	return true;
 }
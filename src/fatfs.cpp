@@ -36,11 +36,8 @@ Modified by          Date              Description
 #include <stdint.h>
 #include <string.h>
 #include <stdlib.h>
-#include <reent.h>
-#include <errno.h>
-#include <sys/unistd.h>
-#include <reent.h>
 #include <errno.h>
+#include <unistd.h>
 #include <stdint.h>
 #include <sys/types.h>
 #include <memory>
@@ -68,27 +68,27 @@ Modified by          Date              Description
 #define H3	0x10325476
 #define H4	0xc3d2e1f0
 
-inline uint32_t ROTR(uint32_t x, uint32_t n)
+static inline uint32_t ROTR(uint32_t x, uint32_t n)
 {
     return (x >> n) | (x << (32-n));
 }
 
-inline uint32_t ROTL(uint32_t x, uint32_t n)
+static inline uint32_t ROTL(uint32_t x, uint32_t n)
 {
 	return (x << n) | (x >> (32 - n));
 }
 
-inline uint32_t CH(uint32_t x, uint32_t y, uint32_t z)
+static inline uint32_t CH(uint32_t x, uint32_t y, uint32_t z)
 {
 	return (x & y) ^ (~x & z);
 }
 
-inline uint32_t MAJ(uint32_t x, uint32_t y, uint32_t z)
+static inline uint32_t MAJ(uint32_t x, uint32_t y, uint32_t z)
 {
 	return (x & y) ^ (x & z) ^ (y & z);
 }
 
-inline uint32_t PAR(uint32_t x, uint32_t y, uint32_t z)
+static inline uint32_t PAR(uint32_t x, uint32_t y, uint32_t z)
 {
 	return (x ^ y) ^ z;
 }
@@ -146,7 +146,7 @@ static void Sha1Compute(uint32_t *W, uint32_t *H)
 static int g_LastWIdx = 0;
 static int g_LastOctet = 0;
 static uint64_t g_TotalBitLen = 0;
-static char g_Sha1Digest[34] = { 0,};
+static char g_Sha1Digest[42] = { 0,};
 static uint32_t W[80];
 static uint32_t H[5] = { H0, H1, H2, H3, H4 };
 
@@ -155,12 +155,12 @@ static uint32_t H[5] = { H0, H1, H2, H3, H4 };
  * set bLast parameter to true for last data packet to process.
  *
  * Make sure to have enough memory for returning results.  pRes must have at
- * least 33 bytes.
+ * least 41 bytes.
  *
  * @param 	pSrc 	: Pointer to source data
  * 			SrcLen	: Source data length in bytes
  *			bLast	: set true to indicate last data packet
- * 			pRes	: Pointer to buffer to store results of 32 characters
+ * 			pRes	: Pointer to buffer to store results of 40 characters
  * 					  if NULL is passed, internal buffer will be used
  *
  * 	@return	Pointer to digest string. If pRes is NULL, internal buffer is returned
@@ -170,74 +170,45 @@ char *Sha1(uint8_t *pData, int DataLen, bool bLast, char *pRes)
 {
 	uint8_t *p = pData;
 	int t = 0, j = 0;
+	int blkcnt = (g_LastWIdx << 2) + g_LastOctet;	// Bytes already in current 512 bits message
 	char *digest = g_Sha1Digest;
 
-	g_TotalBitLen += DataLen << 3;
+	g_TotalBitLen += (uint64_t)DataLen << 3;
 
-	if (g_LastOctet || g_LastWIdx)
+	while (DataLen > 0)
 	{
-		// We have incomplete buffer from previous call
-		t = g_LastWIdx;
-
-		// Fill up left over from previous 32bits
-		for (int j = g_LastOctet; j < 4; j++)
-		{
-			W[t] |= *p << (24 - (j << 3));
-			DataLen--;
-			p++;
-		}
-		t++;
-		// Fill up th rest of the 512 bits message
-		for (; t < 16 && DataLen > 3; t++)
-		{
-			W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | (p[0] << 24);
-			p += 4;
-			DataLen -= 4;
-		}
-		if (t >= 16)
-		{
-			// We have complete 512
-			Sha1Compute(W, H);
-			memset(W, 0, sizeof(W));
-			t = 0; j = 0;
-		}
-	}
-
-	if (DataLen > 64)
-	{
-		// Process N complete 512 bits message
-		int n = DataLen / 64;
-		for (int i = 0; i < n; i++)
+		if (blkcnt == 0 && DataLen >= 64)
 		{
+			// Process complete 512 bits message
 			for (t = 0; t < 16; t++)
 			{
-				W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | (p[0] << 24);
+				W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | ((uint32_t)p[0] << 24);
 				p += 4;
-				DataLen -= 4;
 			}
+			DataLen -= 64;
 			Sha1Compute(W, H);
+			continue;
 		}
-		t = 0;
-		j = 0;
-		memset(W, 0, sizeof(W));
-	}
-	g_LastWIdx = 0;
-	g_LastOctet = 0;
-	if (DataLen)
-	{
-		// Still have incompleted data
-		for (t = 0; t < 16 && DataLen > 3; t++)
-		{
-			W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | (p[0] << 24);
-			p += 4;
-			DataLen -= 4;
-		}
-		for (j = 0; j < DataLen; j++)
+
+		// Incomplete message, fill byte by byte
+		t = blkcnt >> 2;
+		j = blkcnt & 3;
+		if (j == 0)
+			W[t] = 0;
+		W[t] |= (uint32_t)*p << (24 - (j << 3));
+		p++;
+		DataLen--;
+		blkcnt++;
+		if (blkcnt >= 64)
 		{
-			W[t] |= *p << (24 - (j << 3));
-			p++;
+			Sha1Compute(W, H);
+			blkcnt = 0;
 		}
 	}
+
+	t = blkcnt >> 2;
+	j = blkcnt & 3;
+
 	if (bLast == false)
 	{
 		// More data to come, remember where we are
@@ -250,20 +221,26 @@ char *Sha1(uint8_t *pData, int DataLen, bool bLast, char *pRes)
 	if (bLast)
 	{
 		// All data processed.  add the 1 bit & data len
-		W[t] |= 0x80 << (24 - (j << 3));
-		t++;
-		if (t > 14)
-			Sha1Compute(W, H);
+		if (j == 0)
+			W[t] = 0;
+		W[t] |= 0x80UL << (24 - (j << 3));
+		for (int i = t + 1; i < 16; i++)
+			W[i] = 0;
+		if (t > 13)
 		{
-			W[14] = g_TotalBitLen >> 32;
-			W[15] = g_TotalBitLen & 0xffffffff;
+			// No room for length, needs an extra message
+			Sha1Compute(W, H);
+			memset(W, 0, sizeof(W));
 		}
+		W[14] = g_TotalBitLen >> 32;
+		W[15] = g_TotalBitLen & 0xffffffff;
 		Sha1Compute(W, H);
 
 		if (pRes)
 			digest = pRes;
 
-		sprintf(digest, "%08lX%08lX%08lX%08lX%08lX", H[0], H[1], H[2], H[3], H[4]);
+		sprintf(digest, "%08lX%08lX%08lX%08lX%08lX", (unsigned long)H[0], (unsigned long)H[1],
+				(unsigned long)H[2], (unsigned long)H[3], (unsigned long)H[4]);
 
 		// Reset memory, ready for new processing
 
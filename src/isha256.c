@@ -80,42 +80,42 @@ static uint32_t g_Sha256KValue[] = {
 	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
-inline uint32_t ROTR(uint32_t x, uint32_t n) 
+static inline uint32_t ROTR(uint32_t x, uint32_t n) 
 {
     return (x >> n) | (x << (32-n));
 }
 
-inline uint32_t ROTL(uint32_t x, uint32_t n) 
+static inline uint32_t ROTL(uint32_t x, uint32_t n) 
 {
 	return (x << n) | (x >> (32 - n));
 }
 		
-inline uint32_t SUM0(uint32_t x)
+static inline uint32_t SUM0(uint32_t x)
 { 
 	return ROTR(x, 2) ^ ROTR(x, 13) ^ ROTR(x, 22);
 }
 
-inline uint32_t SUM1(uint32_t x)
+static inline uint32_t SUM1(uint32_t x)
 { 
 	return ROTR(x, 6) ^ ROTR(x, 11) ^ ROTR(x, 25);
 }
 
-inline uint32_t SIGMA0(uint32_t x)
+static inline uint32_t SIGMA0(uint32_t x)
 { 
 	return ROTR(x, 7) ^ ROTR(x, 18) ^ (x >> 3);
 }
 
-inline uint32_t SIGMA1(uint32_t x)
+static inline uint32_t SIGMA1(uint32_t x)
 { 
 	return ROTR(x, 17) ^ ROTR(x, 19) ^ (x >> 10);
 }
 
-inline uint32_t CH(uint32_t x, uint32_t y, uint32_t z)
+static inline uint32_t CH(uint32_t x, uint32_t y, uint32_t z)
 { 
 	return (x & y) ^ (~x & z); 
 }
 
-inline uint32_t MAJ(uint32_t x, uint32_t y, uint32_t z)
+static inline uint32_t MAJ(uint32_t x, uint32_t y, uint32_t z)
 { 
 	return (x & y) ^ (x & z) ^ (y & z); 
 }
@@ -193,74 +193,45 @@ char *Sha256(uint8_t *pData, int DataLen, bool bLast, char *pRes)
 {
 	uint8_t *p = pData;
 	int t = 0, j = 0;
+	int blkcnt = (g_LastWIdx << 2) + g_LastOctet;	// Bytes already in current 512 bits message
 	char *digest = g_Sha256Digest;
 
-	g_TotalBitLen += DataLen << 3;
+	g_TotalBitLen += (uint64_t)DataLen << 3;
 
-	if (g_LastOctet || g_LastWIdx)
+	while (DataLen > 0)
 	{
-		// We have incomplete buffer from previous call
-		t = g_LastWIdx;
-
-		// Fill up left over from previous 32bits
-		for (int j = g_LastOctet; j < 4; j++)
-		{
-			W[t] |= *p << (24 - (j << 3));
-			DataLen--;
-			p++;
-		}
-		t++;
-		// Fill up th rest of the 512 bits message
-		for (; t < 16 && DataLen > 3; t++)
-		{
-			W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | (p[0] << 24);
-			p += 4;
-			DataLen -= 4;
-		}
-		if (t >= 16)
-		{
-			// We have complete 512
-			Sha256Compute(W, H);
-			memset(W, 0, sizeof(W));
-			t = 0; j = 0;
-		}
-	}
-
-	if (DataLen > 64)
-	{
-		// Process N complete 512 bits message
-		int n = DataLen / 64;
-		for (int i = 0; i < n; i++)
+		if (blkcnt == 0 && DataLen >= 64)
 		{
+			// Process complete 512 bits message
 			for (t = 0; t < 16; t++)
 			{
-				W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | (p[0] << 24);
+				W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | ((uint32_t)p[0] << 24);
 				p += 4;
-				DataLen -= 4;
 			}
+			DataLen -= 64;
 			Sha256Compute(W, H);
+			continue;
 		}
-		t = 0;
-		j = 0;
-		memset(W, 0, sizeof(W));
-	}
-	g_LastWIdx = 0;
-	g_LastOctet = 0;
-	if (DataLen)
-	{
-		// Still have incompleted data
-		for (t = 0; t < 16 && DataLen > 3; t++)
-		{
-			W[t] = p[3] | (p[2] << 8) | (p[1] << 16) | (p[0] << 24);
-			p += 4;
-			DataLen -= 4;
-		}
-		for (j = 0; j < DataLen; j++)
+
+		// Incomplete message, fill byte by byte
+		t = blkcnt >> 2;
+		j = blkcnt & 3;
+		if (j == 0)
+			W[t] = 0;
+		W[t] |= (uint32_t)*p << (24 - (j << 3));
+		p++;
+		DataLen--;
+		blkcnt++;
+		if (blkcnt >= 64)
 		{
-			W[t] |= *p << (24 - (j << 3));
-			p++;
+			Sha256Compute(W, H);
+			blkcnt = 0;
 		}
 	}
+
+	t = blkcnt >> 2;
+	j = blkcnt & 3;
+
 	if (bLast == false)
 	{
 		// More data to come, remember where we are
@@ -273,20 +244,27 @@ char *Sha256(uint8_t *pData, int DataLen, bool bLast, char *pRes)
 	if (bLast)
 	{
 		// All data processed.  add the 1 bit & data len
-		W[t] |= 0x80 << (24 - (j << 3));
-		t++;
-		if (t > 14)
-			Sha256Compute(W, H);
+		if (j == 0)
+			W[t] = 0;
+		W[t] |= 0x80UL << (24 - (j << 3));
+		for (int i = t + 1; i < 16; i++)
+			W[i] = 0;
+		if (t > 13)
 		{
-			W[14] = g_TotalBitLen >> 32;
-			W[15] = g_TotalBitLen & 0xffffffff;
+			// No room for length, needs an extra message
+			Sha256Compute(W, H);
+			memset(W, 0, sizeof(W));
 		}
+		W[14] = g_TotalBitLen >> 32;
+		W[15] = g_TotalBitLen & 0xffffffff;
 		Sha256Compute(W, H);
 
 		if (pRes)
 			digest = pRes;
 
-		//sprintf(digest, "%08lX%08lX%08lX%08lX%08lX%08lX%08lX%08lX", H[0], H[1], H[2], H[3], H[4], H[5], H[6], H[7]);
+		sprintf(digest, "%08lX%08lX%08lX%08lX%08lX%08lX%08lX%08lX", (unsigned long)H[0], (unsigned long)H[1],
+				(unsigned long)H[2], (unsigned long)H[3], (unsigned long)H[4], (unsigned long)H[5],
+				(unsigned long)H[6], (unsigned long)H[7]);
 
 		// Reset memory, ready for new processing
 
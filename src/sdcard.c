@@ -336,7 +336,7 @@ uint32_t SDGetSize(SDDEV *pDev)
 	{
 		// Vers 2.0
 		// Bits 48-69
-		size = (uint64_t)(((data[7] & 0x3f) << 16u) | (data[8] << 8u) | data[9]) * 512;
+		size = (uint64_t)((((data[7] & 0x3f) << 16u) | (data[8] << 8u) | data[9]) + 1) * 512;
 	}
 
 	return size;
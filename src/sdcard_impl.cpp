@@ -41,7 +41,6 @@ Modified by          Date              Description
 
 SDCard::SDCard()
 {
-	memset(vCacheDesc, 0, sizeof(vCacheDesc));
 }
 
 SDCard::~SDCard()
@@ -50,34 +49,20 @@ SDCard::~SDCard()
 
 bool SDCard::Init(DeviceIntrf *pDevInterf, uint8_t *pCacheMem, int CacheMemSize)
 {
-	int nbcache = CacheMemSize / DISKIO_SECT_SIZE;
-	DISKIO_CACHE_DESC *cachedesc = NULL;
+	if (Init(pDevInterf, (DISKIO_CACHE_DESC *)NULL, 0) == false)
+		return false;
 
-	if (pCacheMem)
+	if (pCacheMem && CacheMemSize > 0)
 	{
-		if (nbcache > SDCARD_CACHE_MAX)
-			nbcache = SDCARD_CACHE_MAX;
-
-		NbCacheBlk = nbcache;
-
-		if (nbcache > 0)
-		{
-			for (int i = 0; i < nbcache; i++)
-			{
-				vCacheDesc[i].pSectData = pCacheMem;
-				pCacheMem += DISKIO_SECT_SIZE;
-			}
-
-			cachedesc = vCacheDesc;
-		}
+		SetCacheMem(pCacheMem, CacheMemSize);
 	}
 
-	return Init(pDevInterf, cachedesc, nbcache);
+	return true;
 }
 
 bool SDCard::Init(DeviceIntrf *pDevInterf, DISKIO_CACHE_DESC *pCacheBlk, int NbCacheBlk)
 {
-	uint8_t data[4];
+	uint8_t data[5];
 	uint16_t r = 0xffff;
 	//vpInterf = std::shared_ptr<SerialIntrf>(pSerInterf);
 	vpInterf = pDevInterf;
@@ -180,6 +165,12 @@ int SDCard::Cmd(uint8_t Cmd, uint32_t param)
 	// Send command
 	vpInterf->Tx(0, data, 6);
 
+	if (Cmd == 12)
+	{
+		// Stuff byte precedes the response of stop transmission
+		vpInterf->Rx(0, &r, 1);
+	}
+
 	// wait for response
 	t = 100000;
 	do {
@@ -245,15 +236,28 @@ int SDCard::ReadData(uint8_t *pBuff, int BuffLen)
 	return cnt;
 }
 
-int SDCard::WriteData(uint8_t *pData, int Len)
+int SDCard::WriteData(uint8_t *pData, int Len, uint8_t Token)
 {
-	int cnt;
-	uint16_t crc;
-	uint8_t d[2] = { 0xff, 0xfe };
-
 	if (pData == NULL)
 		return -1;
 
+	int cnt = SendData(pData, Len, Token);
+	if (cnt == 0)
+	{
+		// Failed write, read status
+		Cmd(13, 0);
+	}
+
+	return cnt;
+}
+
+// Send data block, returns 0 if rejected by the card
+int SDCard::SendData(uint8_t *pData, int Len, uint8_t Token)
+{
+	int cnt;
+	uint16_t crc;
+	uint8_t d[2] = { 0xff, Token };
+
 	crc = crc16_ccitt(pData, Len, 0);
 
 	vpInterf->Tx(0, d, 2);
@@ -276,9 +280,7 @@ int SDCard::WriteData(uint8_t *pData, int Len)
 	{
 		if ((d[0] & 0x1f) != 0x5)
 		{
-			// Failed write, read status
-			int r = Cmd(13, 0);
-			//printf("SDCard Write resp error: %x %d, r = %x\n\r", d[0], t, r);
+			//printf("SDCard Write resp error: %x %d\n\r", d[0], t);
 			return 0;
 		}
 	}
@@ -324,7 +326,7 @@ uint64_t SDCard::GetSize(void)
 	{
 		// Vers 2.0
 		// Bits 48-69
-		size = (uint64_t)(((data[7] & 0x3f) << 16u) | (data[8] << 8u) | data[9]) * 512;
+		size = (uint64_t)((((data[7] & 0x3f) << 16u) | (data[8] << 8u) | data[9]) + 1) * 512;
 	}
 
 	return size;
@@ -360,3 +362,110 @@ int SDCard::WriteSingleBlock(uint32_t Addr, uint8_t *pData, int Len)
 
 	return retval;
 }
+
+// Wait while card holds data out low
+bool SDCard::WaitReady()
+{
+	uint8_t r;
+	int t = 1000000;
+
+	do {
+		vpInterf->Rx(0, &r, 1);
+	} while (r != 0xff && --t > 0);
+
+	return t > 0;
+}
+
+int SDCard::ReadMultiBlock(uint32_t Addr, uint8_t * const *ppData, int NbBlk)
+{
+	int cnt = 0;
+
+	if (ppData == NULL || NbBlk <= 0)
+		return 0;
+
+	// Not worth the stop command
+	if (NbBlk == 1)
+		return ReadSingleBlock(Addr, ppData[0], vDev.SectSize) == vDev.SectSize ? 1 : 0;
+
+	uint32_t state = DisableInterrupt();
+	int r = Cmd(18, Addr);
+	EnableInterrupt(state);
+
+	if (r != 0)
+		return 0;
+
+	// Interrupts held off per block only, a long run takes many ms
+	while (cnt < NbBlk)
+	{
+		state = DisableInterrupt();
+		int l = ReadData(ppData[cnt], vDev.SectSize);
+		EnableInterrupt(state);
+
+		if (l != vDev.SectSize)
+			break;
+
+		cnt++;
+	}
+
+	// Card holds busy after the response
+	state = DisableInterrupt();
+	r = Cmd(12, 0);
+	if (r == 0 && WaitReady() == false)
+	{
+		r = -1;
+	}
+	EnableInterrupt(state);
+
+	return r == 0 ? cnt : 0;
+}
+
+int SDCard::WriteMultiBlock(uint32_t Addr, uint8_t * const *ppData, int NbBlk)
+{
+	int cnt = 0;
+
+	if (ppData == NULL || NbBlk <= 0)
+		return 0;
+
+	if (NbBlk == 1)
+		return WriteSingleBlock(Addr, ppData[0], vDev.SectSize) == vDev.SectSize ? 1 : 0;
+
+	uint32_t state = DisableInterrupt();
+	int r = Cmd(25, Addr);
+	EnableInterrupt(state);
+
+	if (r != 0)
+		return 0;
+
+	// Interrupts held off per block only, a long run takes many ms
+	while (cnt < NbBlk)
+	{
+		state = DisableInterrupt();
+		int l = SendData(ppData[cnt], vDev.SectSize, SDCARD_TOKEN_MULTI_WRITE);
+		if (l == vDev.SectSize)
+		{
+			// Programming block
+			WaitReady();
+		}
+		EnableInterrupt(state);
+
+		if (l != vDev.SectSize)
+			break;
+
+		cnt++;
+	}
+
+	// Stop token ends the write before any other command
+	uint8_t d = SDCARD_TOKEN_STOP_TRAN;
+
+	state = DisableInterrupt();
+	vpInterf->Tx(0, &d, 1);
+	WaitReady();
+	if (cnt < NbBlk)
+	{
+		// Failed write, read status
+		Cmd(13, 0);
+	}
+	EnableInterrupt(state);
+
+	return cnt;
+}
@@ -0,0 +1,131 @@
+/**-------------------------------------------------------------------------
+@file	sensor.cpp
+
+@brief	Sensor base class data ready interrupt.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "sensor.h"
+
+// Sensors by data ready pin interrupt number
+static Sensor *s_pDrdySensor[SENSOR_DRDY_MAXINT] = { NULL, };
+
+void Sensor::DrdyIntHandler(int IntNo)
+{
+	if (IntNo < 0 || IntNo >= SENSOR_DRDY_MAXINT)
+		return;
+
+	Sensor *sensor = s_pDrdySensor[IntNo];
+
+	if (sensor == NULL)
+		return;
+
+	// Devices without watermark interrupt signal every sample
+	if (sensor->vDrdyDiv > 1 && ++sensor->vDrdyCnt < sensor->vDrdyDiv)
+		return;
+
+	sensor->vDrdyCnt = 0;
+
+	if (sensor->vpTimer)
+	{
+		sensor->vDrdyTime = sensor->vpTimer->uSecond();
+	}
+
+	if (AtomicInc((sig_atomic_t*)&sensor->vDrdyPending) > 1)
+	{
+		sensor->vDrdyOvrCnt++;
+	}
+
+	if (sensor->vDrdyCB)
+	{
+		sensor->vDrdyCB(sensor);
+	}
+}
+
+bool Sensor::DataReadyInt(const IOPINCFG &Pin, int IntNo, int IntPrio, IOPINSENSE Sense,
+						  SENSOR_DRDYCB NotifyCB)
+{
+	// Release previous interrupt
+	if (vDrdyIntNo >= 0)
+	{
+		IOPinDisbleInterrupt(vDrdyIntNo);
+		s_pDrdySensor[vDrdyIntNo] = NULL;
+		vDrdyIntNo = -1;
+		DataReadyEnable(false);
+	}
+
+	AtomicAssign((sig_atomic_t*)&vDrdyPending, 0);
+	vDrdyCB = NotifyCB;
+
+	if (Pin.PortNo >= 0 && IntNo >= 0 && IntNo < SENSOR_DRDY_MAXINT &&
+		s_pDrdySensor[IntNo] == NULL && DataReadyEnable(true))
+	{
+		IOPinCfg(&Pin, 1);
+		s_pDrdySensor[IntNo] = this;
+
+		if (IOPinEnableInterrupt(IntNo, IntPrio, Pin.PortNo, Pin.PinNo, Sense, DrdyIntHandler))
+		{
+			vDrdyIntNo = IntNo;
+
+			if (vpTimer && vTimerTrigId >= 0)
+			{
+				vpTimer->DisableTimerTrigger(vTimerTrigId);
+				vTimerTrigId = -1;
+			}
+
+			return true;
+		}
+
+		s_pDrdySensor[IntNo] = NULL;
+		DataReadyEnable(false);
+	}
+
+	// Fall back to timer polling
+	if (vOpMode == SENSOR_OPMODE_CONTINUOUS && vTimerTrigId < 0 && vSampFreq > 0)
+	{
+		Mode(vOpMode, vSampFreq);
+	}
+
+	return false;
+}
+
+bool Sensor::Process()
+{
+	if (AtomicExchange((sig_atomic_t*)&vDrdyPending, 0) == 0)
+		return false;
+
+	bool res = UpdateData();
+
+	StartSampling();
+
+	return res;
+}
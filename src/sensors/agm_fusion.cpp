@@ -0,0 +1,535 @@
+/**-------------------------------------------------------------------------
+@file	agm_fusion.cpp
+
+@brief	Accel, gyro, mag sensor fusion.
+
+Madgwick & Mahony filters in float and Q8.24 fixed point.  Both filters
+compare gravity & magnetic field predicted from the current orientation with
+the measured ones.  Madgwick steps along the gradient of the error, Mahony
+feeds the cross product error back to the gyro rates.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#include "sensors/agm_fusion.h"
+
+#define Q24_SHIFT		24
+
+/*
+ * Float kernel
+ */
+
+static inline bool FusNormF(float *pV, int Cnt)
+{
+	float n = 0;
+
+	for (int i = 0; i < Cnt; i++)
+	{
+		n += pV[i] * pV[i];
+	}
+
+	if (n <= 0)
+		return false;
+
+	n = 1.0f / sqrtf(n);
+
+	for (int i = 0; i < Cnt; i++)
+	{
+		pV[i] *= n;
+	}
+
+	return true;
+}
+
+// Earth field reference from measured mag, horizontal component on x
+static inline void FusMagRefF(const float *q, const float *m, float &bx, float &bz)
+{
+	float hx = m[0] * (1 - 2 * (q[2] * q[2] + q[3] * q[3])) + 2 * m[1] * (q[1] * q[2] - q[0] * q[3]) +
+			   2 * m[2] * (q[1] * q[3] + q[0] * q[2]);
+	float hy = 2 * m[0] * (q[1] * q[2] + q[0] * q[3]) + m[1] * (1 - 2 * (q[1] * q[1] + q[3] * q[3])) +
+			   2 * m[2] * (q[2] * q[3] - q[0] * q[1]);
+
+	bx = sqrtf(hx * hx + hy * hy);
+	bz = 2 * m[0] * (q[1] * q[3] - q[0] * q[2]) + 2 * m[1] * (q[2] * q[3] + q[0] * q[1]) +
+		 m[2] * (1 - 2 * (q[1] * q[1] + q[2] * q[2]));
+}
+
+// Gravity & earth field predicted in sensor frame
+static inline void FusPredictF(const float *q, float *v, float bx, float bz, float *w)
+{
+	v[0] = 2 * (q[1] * q[3] - q[0] * q[2]);
+	v[1] = 2 * (q[0] * q[1] + q[2] * q[3]);
+	v[2] = 1 - 2 * (q[1] * q[1] + q[2] * q[2]);
+
+	if (w)
+	{
+		w[0] = bx * (1 - 2 * (q[2] * q[2] + q[3] * q[3])) + bz * v[0];
+		w[1] = 2 * bx * (q[1] * q[2] - q[0] * q[3]) + bz * v[1];
+		w[2] = 2 * bx * (q[0] * q[2] + q[1] * q[3]) + bz * v[2];
+	}
+}
+
+void AgmFusionInitF(AGMFUSIONF *pFus, const AGMFUSION_CFG *pCfg)
+{
+	memset(pFus, 0, sizeof(AGMFUSIONF));
+
+	pFus->Algo = pCfg->Algo;
+	pFus->q[0] = 1.0f;
+	pFus->Gain = pCfg->Gain;
+	pFus->Ki = pCfg->Ki;
+	pFus->Dt = 1.0f / pCfg->SampFreq;
+	pFus->GyroSens = pCfg->GyroSens;
+}
+
+void AgmFusionUpdateF(AGMFUSIONF *pFus, const int16_t *pAccel, const int16_t *pGyro, const int16_t *pMag)
+{
+	float *q = pFus->q;
+	float g[3] = { pGyro[0] * pFus->GyroSens, pGyro[1] * pFus->GyroSens, pGyro[2] * pFus->GyroSens };
+	float a[3] = { (float)pAccel[0], (float)pAccel[1], (float)pAccel[2] };
+	float m[3] = { 0, 0, 0 }, v[3], w[3];
+	float s[4] = { 0, 0, 0, 0 };
+	float bx = 0, bz = 0;
+	bool acc = FusNormF(a, 3);
+	bool mag = false;
+
+	if (acc && pMag)
+	{
+		m[0] = pMag[0];
+		m[1] = pMag[1];
+		m[2] = pMag[2];
+		mag = FusNormF(m, 3);
+	}
+
+	if (acc)
+	{
+		if (mag)
+		{
+			FusMagRefF(q, m, bx, bz);
+		}
+		FusPredictF(q, v, bx, bz, mag ? w : NULL);
+
+		if (pFus->Algo == AGMFUSION_ALGO_MAHONY)
+		{
+			// Error is the rotation from measured to predicted directions
+			float e[3] = {
+				a[1] * v[2] - a[2] * v[1],
+				a[2] * v[0] - a[0] * v[2],
+				a[0] * v[1] - a[1] * v[0]
+			};
+
+			if (mag)
+			{
+				e[0] += m[1] * w[2] - m[2] * w[1];
+				e[1] += m[2] * w[0] - m[0] * w[2];
+				e[2] += m[0] * w[1] - m[1] * w[0];
+			}
+
+			for (int i = 0; i < 3; i++)
+			{
+				if (pFus->Ki > 0)
+				{
+					pFus->eInt[i] += pFus->Ki * e[i] * pFus->Dt;
+					g[i] += pFus->eInt[i];
+				}
+				g[i] += pFus->Gain * e[i];
+			}
+		}
+		else
+		{
+			// Gradient J'f of the objective function f = predicted - measured
+			float f0 = v[0] - a[0], f1 = v[1] - a[1], f2 = v[2] - a[2];
+
+			s[0] = -2 * q[2] * f0 + 2 * q[1] * f1;
+			s[1] = 2 * q[3] * f0 + 2 * q[0] * f1 - 4 * q[1] * f2;
+			s[2] = -2 * q[0] * f0 + 2 * q[3] * f1 - 4 * q[2] * f2;
+			s[3] = 2 * q[1] * f0 + 2 * q[2] * f1;
+
+			if (mag)
+			{
+				float f3 = w[0] - m[0], f4 = w[1] - m[1], f5 = w[2] - m[2];
+
+				s[0] += -2 * bz * q[2] * f3 + (-2 * bx * q[3] + 2 * bz * q[1]) * f4 + 2 * bx * q[2] * f5;
+				s[1] += 2 * bz * q[3] * f3 + (2 * bx * q[2] + 2 * bz * q[0]) * f4 +
+						(2 * bx * q[3] - 4 * bz * q[1]) * f5;
+				s[2] += (-4 * bx * q[2] - 2 * bz * q[0]) * f3 + (2 * bx * q[1] + 2 * bz * q[3]) * f4 +
+						(2 * bx * q[0] - 4 * bz * q[2]) * f5;
+				s[3] += (-4 * bx * q[3] + 2 * bz * q[1]) * f3 + (-2 * bx * q[0] + 2 * bz * q[2]) * f4 +
+						2 * bx * q[1] * f5;
+			}
+
+			if (FusNormF(s, 4))
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					s[i] *= pFus->Gain;
+				}
+			}
+		}
+	}
+
+	// Rate of change from gyro, q x (0, g) / 2
+	float qd[4] = {
+		0.5f * (-q[1] * g[0] - q[2] * g[1] - q[3] * g[2]) - s[0],
+		0.5f * (q[0] * g[0] + q[2] * g[2] - q[3] * g[1]) - s[1],
+		0.5f * (q[0] * g[1] - q[1] * g[2] + q[3] * g[0]) - s[2],
+		0.5f * (q[0] * g[2] + q[1] * g[1] - q[2] * g[0]) - s[3]
+	};
+
+	for (int i = 0; i < 4; i++)
+	{
+		q[i] += qd[i] * pFus->Dt;
+	}
+
+	FusNormF(q, 4);
+}
+
+/*
+ * Fixed point kernel, Q8.24
+ */
+
+static inline int32_t QMul(int32_t A, int32_t B)
+{
+	return (int32_t)(((int64_t)A * B) >> Q24_SHIFT);
+}
+
+static inline int32_t QFromFloat(float X)
+{
+	return (int32_t)lrintf(X * (float)AGMFUSION_Q24_ONE);
+}
+
+// Reciprocal square root by Newton iterations, no division.
+// S is reduced to X = S / 4^E in [0.25, 1) Q30, returns 1/sqrt(X) in Q30
+static uint64_t QRsqrt(uint64_t S, uint64_t &X, int &E)
+{
+	E = (63 - __builtin_clzll(S) - 28) >> 1;
+	X = E >= 0 ? S >> (2 * E) : S << (-2 * E);
+
+	// Linear first guess on [0.25, 1), within 13%.  Error squares on each
+	// iteration, 4 gets below Q30 resolution
+	uint64_t y = 0x8CCCCCCCULL - ((0x4CCCCCCCULL * X) >> 30);
+
+	for (int i = 0; i < 4; i++)
+	{
+		uint64_t xyy = (((X * y) >> 30) * y) >> 30;
+
+		y = (y * ((3ULL << 30) - xyy)) >> 31;
+	}
+
+	return y;
+}
+
+static uint32_t QSqrt(uint64_t S)
+{
+	uint64_t x;
+	int e;
+
+	if (S == 0)
+		return 0;
+
+	uint64_t y = QRsqrt(S, x, e);
+
+	// sqrt(X) = X / sqrt(X), in Q15
+	uint64_t r = (x * y) >> 30;
+
+	return (uint32_t)(e >= 15 ? r << (e - 15) : r >> (15 - e));
+}
+
+// Normalize to unit length in Q8.24.  Only the direction is used so input
+// can be in any scale, raw counts included
+static bool QNorm(int32_t *pV, int Cnt)
+{
+	uint32_t mx = 0;
+	int32_t v[4];
+	int64_t sum = 0;
+
+	for (int i = 0; i < Cnt; i++)
+	{
+		mx |= (uint32_t)(pV[i] < 0 ? -pV[i] : pV[i]);
+	}
+
+	if (mx == 0)
+		return false;
+
+	// Scale largest component to 24 bits, sum of squares fits in 50
+	int sh = 8 - __builtin_clz(mx);
+
+	for (int i = 0; i < Cnt; i++)
+	{
+		v[i] = sh > 0 ? pV[i] >> sh : pV[i] * (1 << -sh);
+		sum += (int64_t)v[i] * v[i];
+	}
+
+	// 2^48 / sqrt(sum), sum is in [2^46, 2^50) so E is 9 or 10
+	uint64_t x;
+	int e;
+	uint64_t y = QRsqrt(sum, x, e);
+	int64_t r = (int64_t)(y >> (e - 3));
+
+	for (int i = 0; i < Cnt; i++)
+	{
+		pV[i] = (int32_t)((v[i] * r) >> Q24_SHIFT);
+	}
+
+	return true;
+}
+
+static inline void FusMagRefQ(const int32_t *q, const int32_t *m, int32_t &bx, int32_t &bz)
+{
+	int32_t q1q1 = QMul(q[1], q[1]), q2q2 = QMul(q[2], q[2]), q3q3 = QMul(q[3], q[3]);
+	int32_t hx = QMul(m[0], AGMFUSION_Q24_ONE - 2 * (q2q2 + q3q3)) +
+				 2 * QMul(m[1], QMul(q[1], q[2]) - QMul(q[0], q[3])) +
+				 2 * QMul(m[2], QMul(q[1], q[3]) + QMul(q[0], q[2]));
+	int32_t hy = 2 * QMul(m[0], QMul(q[1], q[2]) + QMul(q[0], q[3])) +
+				 QMul(m[1], AGMFUSION_Q24_ONE - 2 * (q1q1 + q3q3)) +
+				 2 * QMul(m[2], QMul(q[2], q[3]) - QMul(q[0], q[1]));
+
+	bx = (int32_t)QSqrt((int64_t)hx * hx + (int64_t)hy * hy);
+	bz = 2 * QMul(m[0], QMul(q[1], q[3]) - QMul(q[0], q[2])) +
+		 2 * QMul(m[1], QMul(q[2], q[3]) + QMul(q[0], q[1])) +
+		 QMul(m[2], AGMFUSION_Q24_ONE - 2 * (q1q1 + q2q2));
+}
+
+static inline void FusPredictQ(const int32_t *q, int32_t *v, int32_t bx, int32_t bz, int32_t *w)
+{
+	v[0] = 2 * (QMul(q[1], q[3]) - QMul(q[0], q[2]));
+	v[1] = 2 * (QMul(q[0], q[1]) + QMul(q[2], q[3]));
+	v[2] = AGMFUSION_Q24_ONE - 2 * (QMul(q[1], q[1]) + QMul(q[2], q[2]));
+
+	if (w)
+	{
+		w[0] = QMul(bx, AGMFUSION_Q24_ONE - 2 * (QMul(q[2], q[2]) + QMul(q[3], q[3]))) + QMul(bz, v[0]);
+		w[1] = 2 * QMul(bx, QMul(q[1], q[2]) - QMul(q[0], q[3])) + QMul(bz, v[1]);
+		w[2] = 2 * QMul(bx, QMul(q[0], q[2]) + QMul(q[1], q[3])) + QMul(bz, v[2]);
+	}
+}
+
+void AgmFusionInitQ(AGMFUSIONQ *pFus, const AGMFUSION_CFG *pCfg)
+{
+	memset(pFus, 0, sizeof(AGMFUSIONQ));
+
+	pFus->Algo = pCfg->Algo;
+	pFus->q[0] = AGMFUSION_Q24_ONE;
+	pFus->Gain = QFromFloat(pCfg->Gain);
+	pFus->Ki = QFromFloat(pCfg->Ki);
+	pFus->Dt = QFromFloat(1.0f / pCfg->SampFreq);
+	pFus->GyroSens = QFromFloat(pCfg->GyroSens);
+}
+
+void AgmFusionUpdateQ(AGMFUSIONQ *pFus, const int16_t *pAccel, const int16_t *pGyro, const int16_t *pMag)
+{
+	int32_t *q = pFus->q;
+	int32_t g[3] = { pGyro[0] * pFus->GyroSens, pGyro[1] * pFus->GyroSens, pGyro[2] * pFus->GyroSens };
+	int32_t a[3] = { pAccel[0], pAccel[1], pAccel[2] };
+	int32_t m[3], v[3], w[3];
+	int32_t s[4] = { 0, 0, 0, 0 };
+	int32_t bx = 0, bz = 0;
+	bool acc = QNorm(a, 3);
+	bool mag = false;
+
+	if (acc && pMag)
+	{
+		m[0] = pMag[0];
+		m[1] = pMag[1];
+		m[2] = pMag[2];
+		mag = QNorm(m, 3);
+	}
+
+	if (acc)
+	{
+		if (mag)
+		{
+			FusMagRefQ(q, m, bx, bz);
+		}
+		FusPredictQ(q, v, bx, bz, mag ? w : NULL);
+
+		if (pFus->Algo == AGMFUSION_ALGO_MAHONY)
+		{
+			int32_t e[3] = {
+				QMul(a[1], v[2]) - QMul(a[2], v[1]),
+				QMul(a[2], v[0]) - QMul(a[0], v[2]),
+				QMul(a[0], v[1]) - QMul(a[1], v[0])
+			};
+
+			if (mag)
+			{
+				e[0] += QMul(m[1], w[2]) - QMul(m[2], w[1]);
+				e[1] += QMul(m[2], w[0]) - QMul(m[0], w[2]);
+				e[2] += QMul(m[0], w[1]) - QMul(m[1], w[0]);
+			}
+
+			for (int i = 0; i < 3; i++)
+			{
+				if (pFus->Ki > 0)
+				{
+					pFus->eInt[i] += QMul(QMul(pFus->Ki, e[i]), pFus->Dt);
+					g[i] += pFus->eInt[i];
+				}
+				g[i] += QMul(pFus->Gain, e[i]);
+			}
+		}
+		else
+		{
+			int32_t f0 = v[0] - a[0], f1 = v[1] - a[1], f2 = v[2] - a[2];
+
+			s[0] = 2 * (QMul(q[1], f1) - QMul(q[2], f0));
+			s[1] = 2 * (QMul(q[3], f0) + QMul(q[0], f1)) - 4 * QMul(q[1], f2);
+			s[2] = 2 * (QMul(q[3], f1) - QMul(q[0], f0)) - 4 * QMul(q[2], f2);
+			s[3] = 2 * (QMul(q[1], f0) + QMul(q[2], f1));
+
+			if (mag)
+			{
+				int32_t f3 = w[0] - m[0], f4 = w[1] - m[1], f5 = w[2] - m[2];
+				int32_t bxq[4] = { QMul(bx, q[0]), QMul(bx, q[1]), QMul(bx, q[2]), QMul(bx, q[3]) };
+				int32_t bzq[4] = { QMul(bz, q[0]), QMul(bz, q[1]), QMul(bz, q[2]), QMul(bz, q[3]) };
+
+				s[0] += 2 * (QMul(bxq[2], f5) - QMul(bzq[2], f3) + QMul(bzq[1] - bxq[3], f4));
+				s[1] += 2 * (QMul(bzq[3], f3) + QMul(bxq[2] + bzq[0], f4) + QMul(bxq[3] - 2 * bzq[1], f5));
+				s[2] += 2 * (QMul(bxq[1] + bzq[3], f4) + QMul(bxq[0] - 2 * bzq[2], f5) -
+							 QMul(2 * bxq[2] + bzq[0], f3));
+				s[3] += 2 * (QMul(bzq[1] - 2 * bxq[3], f3) + QMul(bzq[2] - bxq[0], f4) + QMul(bxq[1], f5));
+			}
+
+			if (QNorm(s, 4))
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					s[i] = QMul(s[i], pFus->Gain);
+				}
+			}
+		}
+	}
+
+	int32_t qd[4] = {
+		((-QMul(q[1], g[0]) - QMul(q[2], g[1]) - QMul(q[3], g[2])) >> 1) - s[0],
+		((QMul(q[0], g[0]) + QMul(q[2], g[2]) - QMul(q[3], g[1])) >> 1) - s[1],
+		((QMul(q[0], g[1]) - QMul(q[1], g[2]) + QMul(q[3], g[0])) >> 1) - s[2],
+		((QMul(q[0], g[2]) + QMul(q[1], g[1]) - QMul(q[2], g[0])) >> 1) - s[3]
+	};
+
+	for (int i = 0; i < 4; i++)
+	{
+		q[i] += QMul(qd[i], pFus->Dt);
+	}
+
+	QNorm(q, 4);
+}
+
+static inline int32_t QSat(int32_t X, int Shift, int32_t Max)
+{
+	int64_t r = Shift >= 0 ? (int64_t)X * (1LL << Shift) : ((int64_t)X + (1LL << (-Shift - 1))) >> -Shift;
+
+	return r > Max ? Max : (r < -Max ? -Max : (int32_t)r);
+}
+
+void AgmFusionQ31(const AGMFUSIONQ *pFus, int32_t *pQ)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		pQ[i] = QSat(pFus->q[i], 31 - Q24_SHIFT, INT32_MAX);
+	}
+}
+
+/*
+ * Pipeline stage
+ */
+
+bool AgmFusion::Init(const AGMFUSION_CFG &Cfg, bool bFixed)
+{
+	if (Cfg.SampFreq <= 0)
+		return false;
+
+	vbFixed = bFixed;
+	AgmFusionInitF(&vFusF, &Cfg);
+	AgmFusionInitQ(&vFusQ, &Cfg);
+	memset(&vQuat, 0, sizeof(AGMFUSION_QUAT));
+	vQuat.w = INT16_MAX;
+
+	return true;
+}
+
+int AgmFusion::Update(const ACCELSENSOR_DATA *pAccel, const GYROSENSOR_DATA *pGyro,
+					  const MAGSENSOR_DATA *pMag, int Count, AGMFUSION_QUAT *pQuat)
+{
+	int16_t q[4];
+
+	for (int i = 0; i < Count; i++)
+	{
+		int16_t a[3] = { pAccel[i].x, pAccel[i].y, pAccel[i].z };
+		int16_t g[3] = { pGyro[i].x, pGyro[i].y, pGyro[i].z };
+		int16_t m[3];
+
+		if (pMag)
+		{
+			m[0] = pMag[i].x;
+			m[1] = pMag[i].y;
+			m[2] = pMag[i].z;
+		}
+
+		if (vbFixed)
+		{
+			AgmFusionUpdateQ(&vFusQ, a, g, pMag ? m : NULL);
+			for (int j = 0; j < 4; j++)
+			{
+				q[j] = (int16_t)QSat(vFusQ.q[j], 15 - Q24_SHIFT, INT16_MAX);
+			}
+		}
+		else
+		{
+			AgmFusionUpdateF(&vFusF, a, g, pMag ? m : NULL);
+			for (int j = 0; j < 4; j++)
+			{
+				q[j] = (int16_t)QSat(QFromFloat(vFusF.q[j]), 15 - Q24_SHIFT, INT16_MAX);
+			}
+		}
+
+		vQuat.Timestamp = pGyro[i].Timestamp;
+		vQuat.w = q[0];
+		vQuat.x = q[1];
+		vQuat.y = q[2];
+		vQuat.z = q[3];
+
+		if (pQuat)
+		{
+			pQuat[i] = vQuat;
+		}
+	}
+
+	return Count;
+}
+
+void AgmFusion::Read(float *pQ)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		pQ[i] = vbFixed ? (float)vFusQ.q[i] / AGMFUSION_Q24_ONE : vFusF.q[i];
+	}
+}
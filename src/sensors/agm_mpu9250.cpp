@@ -38,6 +38,17 @@ Modified by          Date              Description
 #include "spi.h"
 #include "sensors/agm_mpu9250.h"
 
+// FIFO frame : accel x, y, z then gyro x, y, z, big endian
+typedef DevReg<uint16_t, DEVREG_ENDIAN_BIG, MPU9250_AG_FIFO_COUNT_H> Mpu9250FifoCount;
+
+template <typename D>
+static inline void Mpu9250Axes(const uint8_t *p, D &Data)
+{
+	Data.x = DevRegGet<int16_t, DEVREG_ENDIAN_BIG>(&p[0]);
+	Data.y = DevRegGet<int16_t, DEVREG_ENDIAN_BIG>(&p[2]);
+	Data.z = DevRegGet<int16_t, DEVREG_ENDIAN_BIG>(&p[4]);
+}
+
 bool AgmMpu9250::InitDefault(uint32_t DevAddr, DeviceIntrf *pIntrf, Timer *pTimer)
 {
 	if (vbInitialized)
@@ -215,41 +226,46 @@ bool AgmMpu9250::StartSampling()
 
 bool AgmMpu9250::WakeOnMotion(bool bEnable, uint8_t Threshold)
 {
-    uint8_t regaddr;
-
 	if (bEnable == true)
 	{
-	    regaddr = MPU9250_AG_PWR_MGMT_1;
-	    Write8(&regaddr, 1, 0);
-
-	    regaddr = MPU9250_AG_PWR_MGMT_2;
-		Write8(&regaddr, 1, MPU9250_AG_PWR_MGMT_2_DIS_XA | MPU9250_AG_PWR_MGMT_2_DIS_YA |
-				MPU9250_AG_PWR_MGMT_2_DIS_XG | MPU9250_AG_PWR_MGMT_2_DIS_YG);// | MPU9250_AG_PWR_MGMT_2_DIS_ZG);
-
-		regaddr = MPU9250_AG_ACCEL_CONFIG2;
-	    Write8(&regaddr, 1, (3<<MPU9250_AG_ACCEL_CONFIG2_ACCEL_FCHOICE_B_BITPOS) | (1<<MPU9250_AG_ACCEL_CONFIG2_A_DLPF_CFG_BITPOS));
-
-	    regaddr = MPU9250_AG_INT_ENABLE;
-	    Write8(&regaddr, 1, MPU9250_AG_INT_ENABLE_WOM_EN);
-
-	    regaddr = MPU9250_AG_MOT_DETECT_CTRL;
-	    Write8(&regaddr, 1, MPU9250_AG_MOT_DETECT_CTRL_ACCEL_INTEL_MODE | MPU9250_AG_MOT_DETECT_CTRL_ACCEL_INTEL_EN);
-
-	    regaddr = MPU9250_AG_WOM_THR;
-	    Write8(&regaddr, 1, Threshold);
+		// pwr_mgmt_1 & 2 are adjacent, sent as one burst
+		const DEVREG_STEP script[] = {
+			DevRegWr(MPU9250_AG_PWR_MGMT_1, 0),
+			DevRegWr(MPU9250_AG_PWR_MGMT_2, MPU9250_AG_PWR_MGMT_2_DIS_XA | MPU9250_AG_PWR_MGMT_2_DIS_YA |
+					 MPU9250_AG_PWR_MGMT_2_DIS_XG | MPU9250_AG_PWR_MGMT_2_DIS_YG),// | MPU9250_AG_PWR_MGMT_2_DIS_ZG);
+			DevRegWr(MPU9250_AG_ACCEL_CONFIG2, (3<<MPU9250_AG_ACCEL_CONFIG2_ACCEL_FCHOICE_B_BITPOS) |
+					 (1<<MPU9250_AG_ACCEL_CONFIG2_A_DLPF_CFG_BITPOS)),
+			DevRegWr(MPU9250_AG_INT_ENABLE, MPU9250_AG_INT_ENABLE_WOM_EN),
+			DevRegWr(MPU9250_AG_MOT_DETECT_CTRL, MPU9250_AG_MOT_DETECT_CTRL_ACCEL_INTEL_MODE |
+					 MPU9250_AG_MOT_DETECT_CTRL_ACCEL_INTEL_EN),
+			DevRegWr(MPU9250_AG_WOM_THR, Threshold),
+			DevRegWr(MPU9250_AG_PWR_MGMT_1, MPU9250_AG_PWR_MGMT_1_CYCLE),
+			DevRegEnd()
+		};
+
+		return RegScriptRun(script, true);
+	}
 
-		regaddr = MPU9250_AG_PWR_MGMT_1;
-		Write8(&regaddr, 1, MPU9250_AG_PWR_MGMT_1_CYCLE);
+	static const DEVREG_STEP s_Disable[] = {
+		DevRegWr(MPU9250_AG_INT_ENABLE, 0),
+		DevRegWr(MPU9250_AG_PWR_MGMT_1, 0),
+		DevRegEnd()
+	};
 
-	}
-	else
-	{
-	    regaddr = MPU9250_AG_INT_ENABLE;
-	    Write8(&regaddr, 1, 0);
+	return RegScriptRun(s_Disable, true);
+}
 
-	    regaddr = MPU9250_AG_PWR_MGMT_1;
-		Write8(&regaddr, 1, 0);
-	}
+bool AgmMpu9250::DataReadyEnable(bool bEnable)
+{
+	// Other interrupt sources such as wake on motion are kept.  Pin left at
+	// its reset configuration, active high push-pull 50 us pulse
+	const DEVREG_STEP script[] = {
+		DevRegRmw(MPU9250_AG_INT_ENABLE, MPU9250_AG_INT_ENABLE_RAW_RDY_EN,
+				  bEnable ? MPU9250_AG_INT_ENABLE_RAW_RDY_EN : 0),
+		DevRegEnd()
+	};
+
+	return RegScriptRun(script, true);
 }
 
 uint8_t AgmMpu9250::Scale(uint8_t Value)
@@ -279,32 +295,173 @@ uint8_t AgmMpu9250::Scale(uint8_t Value)
 	return AccelSensor::Scale();
 }
 
-bool AgmMpu9250::UpdateData()
+int AgmMpu9250::FifoWatermark(int Watermark, ACCELBATCHCB BatchCB)
 {
+	vAccelBatchCB = BatchCB;
 
+	return FifoConfig(Watermark);
 }
 
-bool AgmMpu9250::Read(ACCELSENSOR_DATA *pData)
+int AgmMpu9250::FifoWatermark(int Watermark, GYROBATCHCB BatchCB)
 {
-	uint8_t regaddr = MPU9250_AG_ACCEL_XOUT_H;
-	int8_t d[6];
+	vGyroBatchCB = BatchCB;
 
-	Read(&regaddr, 1, (uint8_t*)d, 6);
+	return FifoConfig(Watermark);
+}
+
+int AgmMpu9250::FifoConfig(int Watermark)
+{
+	static const DEVREG_STEP s_FifoOff[] = {
+		DevRegWr(MPU9250_AG_FIFO_EN, 0),
+		DevRegRmw(MPU9250_AG_USER_CTRL, MPU9250_AG_USER_CTRL_FIFO_EN, 0),
+		DevRegEnd()
+	};
+	static const DEVREG_STEP s_FifoOn[] = {
+		DevRegWr(MPU9250_AG_FIFO_EN, 0),
+		DevRegRmw(MPU9250_AG_USER_CTRL, MPU9250_AG_USER_CTRL_FIFO_EN | MPU9250_AG_USER_CTRL_FIFO_RST,
+				  MPU9250_AG_USER_CTRL_FIFO_RST),
+		DevRegWr(MPU9250_AG_FIFO_EN, MPU9250_AG_FIFO_EN_ACCEL | MPU9250_AG_FIFO_EN_GYRO_XOUT |
+				 MPU9250_AG_FIFO_EN_GYRO_YOUT | MPU9250_AG_FIFO_EN_GYRO_ZOUT),
+		DevRegRmw(MPU9250_AG_USER_CTRL, MPU9250_AG_USER_CTRL_FIFO_EN, MPU9250_AG_USER_CTRL_FIFO_EN),
+		DevRegEnd()
+	};
+
+	if (Watermark > MPU9250_FIFO_MAX_FRAME)
+	{
+		Watermark = MPU9250_FIFO_MAX_FRAME;
+	}
 
-	pData->x = (((int16_t)d[0] & 0xFF) << 8) | d[1];
-	pData->y = (((int16_t)d[2] & 0xFF) << 8) | d[3];
-	pData->x = (((int16_t)d[4] & 0xFF) << 8) | d[5];
+	vFifoWm = 0;
+	vDrdyDiv = 1;
+	vDrdyCnt = 0;
 
-	if (vpTimer)
+	if (Watermark <= 0)
 	{
-		pData->Timestamp = vpTimer->uSecond();
+		RegScriptRun(s_FifoOff, true);
+
+		return 0;
 	}
 
+	if (RegScriptRun(s_FifoOn, true) == false)
+		return 0;
+
+	SensorFifoClkInit(&vFifoClk, vSampFreq > 0 ? 1000000000UL / vSampFreq : 1000000UL);
+	vFifoWm = Watermark;
+	vDrdyDiv = Watermark;
+
+	return vFifoWm;
+}
+
+int AgmMpu9250::FifoDrain()
+{
+	uint8_t d[MPU9250_FIFO_DRAIN_FRAME * MPU9250_FIFO_FRAME_SIZE];
+	ACCELSENSOR_DATA accel[MPU9250_FIFO_DRAIN_FRAME];
+	GYROSENSOR_DATA gyro[MPU9250_FIFO_DRAIN_FRAME];
+	int cnt = (Mpu9250FifoCount::Read(*this) & 0x1FFF) / MPU9250_FIFO_FRAME_SIZE;
+	uint32_t first;
+	int idx = 0;
+
+	if (cnt <= 0)
+		return 0;
+
+	// Every watermark frame since FIFO reset is stamped by the data ready
+	// interrupt, the latest drained is the reference.  A late drain goes past
+	// it, the next reference is then less than a watermark into the batch.
+	// Polled, the last frame is the most recent.
+	if (vDrdyIntNo >= 0)
+	{
+		uint32_t end = vFifoClk.NextIdx + cnt;
+		int ref = (int)(end - end % vFifoWm - vFifoClk.NextIdx) - 1;
+
+		first = SensorFifoClkBatch(&vFifoClk, vpTimer != NULL && ref >= 0, vDrdyTime, ref, cnt);
+	}
+	else
+	{
+		first = SensorFifoClkBatch(&vFifoClk, vpTimer != NULL, vpTimer ? vpTimer->uSecond() : 0,
+								   cnt - 1, cnt);
+	}
+
+	while (idx < cnt)
+	{
+		uint8_t regaddr = MPU9250_AG_FIFO_R_W;
+		int n = cnt - idx;
+
+		if (n > MPU9250_FIFO_DRAIN_FRAME)
+		{
+			n = MPU9250_FIFO_DRAIN_FRAME;
+		}
+
+		if (Read(&regaddr, 1, d, n * MPU9250_FIFO_FRAME_SIZE) != n * MPU9250_FIFO_FRAME_SIZE)
+			break;
+
+		for (int i = 0; i < n; i++)
+		{
+			uint8_t *p = &d[i * MPU9250_FIFO_FRAME_SIZE];
+
+			accel[i].Timestamp = gyro[i].Timestamp = SensorFifoClkTime(&vFifoClk, first, idx + i);
+			Mpu9250Axes(p, accel[i]);
+			Mpu9250Axes(&p[6], gyro[i]);
+		}
+
+		AccelQuePut(accel, n);
+
+		if (vAccelBatchCB)
+		{
+			vAccelBatchCB(this, accel, n);
+		}
+		if (vGyroBatchCB)
+		{
+			vGyroBatchCB(this, gyro, n);
+		}
+
+		vData = accel[n - 1];
+		vGyroData = gyro[n - 1];
+		idx += n;
+	}
+
+	vSampleCnt += idx;
+
+	return idx;
+}
+
+bool AgmMpu9250::UpdateData()
+{
+	if (vFifoWm > 0)
+		return FifoDrain() > 0;
+
+	uint8_t regaddr = MPU9250_AG_ACCEL_XOUT_H;
+	uint8_t d[6];
+
+	if (Read(&regaddr, 1, d, 6) != 6)
+		return false;
+
+	Mpu9250Axes(d, vData);
+	vData.Timestamp = vpTimer ? vpTimer->uSecond() : 0;
+	AccelQuePut(&vData, 1);
+	vSampleCnt++;
+
 	return true;
 }
 
-bool AgmMpu9250::Read(GYROSENSOR_DATA*)
+bool AgmMpu9250::Read(ACCELSENSOR_DATA *pData)
 {
+	// In FIFO mode, last sample drained
+	if (vFifoWm == 0 && UpdateData() == false)
+		return false;
+
+	*pData = vData;
+
+	return true;
+}
+
+bool AgmMpu9250::Read(GYROSENSOR_DATA *pData)
+{
+	// In FIFO mode, last sample drained
+	if (vFifoWm > 0)
+	{
+		*pData = vGyroData;
+	}
+
 	return true;
 }
 bool AgmMpu9250::Read(MAGSENSOR_DATA*)
@@ -109,6 +109,26 @@ uint32_t TphBme280::CompenHum(int32_t adc_H)
 
 }
 
+// Control registers, reads served from cache after reset.  Driver only uses
+// sleep & normal mode so ctrl_meas keeps the value written.
+static const DEVREG_DESC s_Bme280RegDesc[] = {
+	{ BME280_REG_CTRL_HUM, 1, DEVREG_ATTR_CACHED | DEVREG_ATTR_RSTVAL, 0 },
+	{ BME280_REG_CTRL_MEAS, 2, DEVREG_ATTR_CACHED | DEVREG_ATTR_RSTVAL, 0 },	// ctrl_meas, config
+};
+
+// Raw ADC values, 20 bits pressure & temperature, 16 bits humidity
+typedef DevRegBits<uint32_t, DEVREG_ENDIAN_BIG, BME280_REG_PRESS_MSB, 3, 4, 20> Bme280AdcP;
+typedef DevRegBits<uint32_t, DEVREG_ENDIAN_BIG, BME280_REG_TEMP_MSB, 3, 4, 20> Bme280AdcT;
+typedef DevReg<uint16_t, DEVREG_ENDIAN_BIG, BME280_REG_HUM_MSB> Bme280AdcH;
+
+// After soft reset, wait for start up then for the NVM copy to complete
+// instead of a fixed 30 ms
+static const DEVREG_STEP s_Bme280StartScript[] = {
+	DevRegDelay(2000),
+	DevRegPoll(BME280_REG_STATUS, BME280_REG_STATUS_IM_UPDATE, 0, 28000),
+	DevRegEnd()
+};
+
 bool TphBme280::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *pTimer)
 {
 	uint8_t regaddr = BME280_REG_ID;
@@ -128,6 +148,10 @@ bool TphBme280::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *p
 		vpTimer = pTimer;
 	}
 
+	// Device does not auto increment on burst write, address/data pairs only
+	RegCacheInit(&vRegCache, s_Bme280RegDesc, sizeof(s_Bme280RegDesc) / sizeof(DEVREG_DESC),
+				 vRegCacheMem, sizeof(vRegCacheMem), false);
+
 	if (CfgData.DevAddr == BME280_I2C_DEV_ADDR0 || CfgData.DevAddr == BME280_I2C_DEV_ADDR1)
 	{
 		// I2C mode
@@ -151,8 +175,13 @@ bool TphBme280::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *p
 
 		Reset();
 
-		usDelay(30000);
+		// NVM copy not done, calibration data can not be trusted
+		if (RegScriptRun(s_Bme280StartScript, false) == false)
+		{
+			Valid(false);
 
+			return false;
+		}
 
 		// Load calibration data
 
@@ -176,7 +205,11 @@ bool TphBme280::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *p
 		vCalibData.dig_H5 = ((int16_t)cd[5] << 4) | (cd[4] >> 4);
 		vCalibData.dig_H6 = cd[6];
 
-		// Setup oversampling & filters.
+		// Setup oversampling & filters.  Device is in sleep mode after reset,
+		// settings are accumulated in the cache & written once at the end.
+		// ctrl_hum is written before ctrl_meas which latches it.
+		RegCacheDefer(true);
+
 		d = 0;
 		if (CfgData.HumOvrs > 0)
 		{
@@ -184,23 +217,25 @@ bool TphBme280::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *p
 		}
 
 		regaddr = BME280_REG_CTRL_HUM;
-		Write((uint8_t*)&regaddr, 1, &d, 1);
+		Write8(&regaddr, 1, d);
 
 		regaddr = BME280_REG_CONFIG;
-		Read((uint8_t*)&regaddr, 1, &d, 1);
+		d = Read8(&regaddr, 1);
 
 		d |= (CfgData.FilterCoeff << BME280_REG_CONFIG_FILTER_BITPOS) & BME280_REG_CONFIG_FILTER_MASK;
-		Write((uint8_t*)&regaddr, 1, &d, 1);
+		Write8(&regaddr, 1, d);
 
 		regaddr = BME280_REG_CTRL_MEAS;
-		Read(&regaddr, 1, &vCtrlReg, 1);
+		vCtrlReg = Read8(&regaddr, 1);
 
 		vCtrlReg |= (CfgData.PresOvrs << BME280_REG_CTRL_MEAS_OSRS_P_BITPOS) & BME280_REG_CTRL_MEAS_OSRS_P_MASK;
 		vCtrlReg |= (CfgData.TempOvrs << BME280_REG_CTRL_MEAS_OSRS_T_BITPOS) & BME280_REG_CTRL_MEAS_OSRS_T_MASK;
-		Write((uint8_t*)&regaddr, 1, &vCtrlReg, 1);
+		Write8(&regaddr, 1, vCtrlReg);
 
 		Mode(CfgData.OpMode, CfgData.Freq);
 
+		RegCacheDefer(false);
+
 		//State(SENSOR_STATE_SLEEP);
 
 		usDelay(10000);
@@ -226,7 +261,7 @@ SENSOR_STATE TphBme280::State(SENSOR_STATE State) {
 	{
 		uint8_t regaddr = BME280_REG_CTRL_MEAS;
 		vCtrlReg &= ~BME280_REG_CTRL_MEAS_MODE_MASK;
-		Write(&regaddr, 1, &vCtrlReg, 1);
+		Write8(&regaddr, 1, vCtrlReg);
 	}
 
 	return Sensor::State(State);
@@ -253,7 +288,7 @@ bool TphBme280::Mode(SENSOR_OPMODE OpMode, uint32_t Freq)
 
 	// read current ctrl_meas register
 	regaddr = BME280_REG_CTRL_MEAS;
-	Read(&regaddr, 1, &vCtrlReg, 1);
+	vCtrlReg = Read8(&regaddr, 1);
 
 	vCtrlReg &= ~BME280_REG_CTRL_MEAS_MODE_MASK;
 
@@ -294,7 +329,7 @@ bool TphBme280::Mode(SENSOR_OPMODE OpMode, uint32_t Freq)
 		}
 
 		regaddr = BME280_REG_CONFIG;
-		Write(&regaddr, 1, &d, 1);
+		Write8(&regaddr, 1, d);
 	}
 
 	//StartSampling();
@@ -327,7 +362,8 @@ bool TphBme280::StartSampling()
 	regaddr = BME280_REG_CTRL_MEAS;
 	d = vCtrlReg | BME280_REG_CTRL_MEAS_MODE_NORMAL;
 
-	Write(&regaddr, 1, &d, 1);
+	// Not written again while already running
+	Write8(&regaddr, 1, d);
 
 	vbSampling = true;
 
@@ -361,31 +397,36 @@ void TphBme280::Reset()
 	uint8_t d = BME280_REG_RESET_VAL;
 
 	Write(&addr, 1, &d, 1);
+	RegCacheReset();
 }
 
 bool TphBme280::UpdateData()
 {
-	uint8_t addr = BME280_REG_STATUS;
 	uint8_t status = 0;
+	uint8_t d[8];
 	bool retval = false;
+	DEVREG_READ req[2] = {
+		{ BME280_REG_STATUS, 1, &status, 0 },
+		{ BME280_REG_PRESS_MSB, 8, d, 0 },
+	};
 
-	Read(&addr, 1, &status, 1);
+	// Status & data in a single burst.  Data is discarded if a conversion
+	// is in progress
+	ReadRegs(req, 2);
 
 	if ((status & (BME280_REG_STATUS_MEASURING | BME280_REG_STATUS_IM_UPDATE))== 0)
 	{
-		uint8_t d[8];
-		addr = BME280_REG_PRESS_MSB;
-
-		if (Read(&addr, 1, d, 8) == 8)
+		if (req[1].Count == 8)
 		{
-			int32_t p = (((uint32_t)d[0] << 12) | ((uint32_t)d[1] << 4) | ((uint32_t)d[2] >> 4));
-			int32_t t = (((uint32_t)d[3] << 12) | ((uint32_t)d[4] << 4) | ((uint32_t)d[5] >> 4));
-			int32_t h = (((uint32_t)d[6] << 8) | d[7]);
+			int32_t p = Bme280AdcP::Decode(d, BME280_REG_PRESS_MSB);
+			int32_t t = Bme280AdcT::Decode(d, BME280_REG_PRESS_MSB);
+			int32_t h = Bme280AdcH::Decode(d, BME280_REG_PRESS_MSB);
 
 			vTphData.Temperature = CompenTemp(t);
 			vTphData.Pressure = CompenPress(p);
 			vTphData.Humidity = CompenHum(h);
 			vTphData.Timestamp = vSampleTime;
+			TphQuePut();
 
 			vSampleCnt++;
 
@@ -102,7 +102,7 @@ void TphMS8607::ReadPtProm()
 		uint8_t d[2];
 		vpIntrf->Tx(MS8607_PTDEV_ADDR, &cmd, 1);
 		vpIntrf->Rx(MS8607_PTDEV_ADDR, d, 2);
-		vPTProm[i] = ((uint16_t)d[0] << 8) | d[1];
+		vPTProm[i] = DevRegGet<uint16_t, DEVREG_ENDIAN_BIG>(d);
 		cmd += 2;
 	}
 
@@ -189,8 +189,9 @@ bool TphMS8607::Read(TPHSENSOR_DATA &TphData)
 
 	if (vpTimer)
 	{
-		vTphData.Timestamp = vpTimer->mSecond();
+		vTphData.Timestamp = vpTimer->uSecond();
 	}
+	TphQuePut();
 
 	memcpy(&TphData, &vTphData, sizeof(TPHSENSOR_DATA));
 
@@ -211,11 +212,11 @@ float TphMS8607::ReadTemperature()
 	cmd = MS8607_CMD_ADC_READ;
 	vpIntrf->Tx(MS8607_PTDEV_ADDR, &cmd, 1);
 	int c = vpIntrf->Rx(MS8607_PTDEV_ADDR, d, 3);
-	if ( c > 0)
+	if (c == 3)
 	{
 		uint64_t t2;
 
-		raw = ((uint32_t)d[0] << 16) + ((uint32_t)d[1] << 8) + d[3];
+		raw = DevRegGet<uint32_t, DEVREG_ENDIAN_BIG, 3>(d);
 		vCurDT = raw - ((int32_t)vPTProm[5] << 8L);
 		vTphData.Temperature = 2000L + (((uint64_t)vCurDT * (int64_t)vPTProm[6]) >> 23LL);
 
@@ -248,9 +249,9 @@ float TphMS8607::ReadPressure()
 	cmd = MS8607_CMD_ADC_READ;
 	vpIntrf->Tx(MS8607_PTDEV_ADDR, &cmd, 1);
 	int c = vpIntrf->Rx(MS8607_PTDEV_ADDR, d, 3);
-	if (c > 0)
+	if (c == 3)
 	{
-		raw = ((uint32_t)d[0] << 16) + ((uint32_t)d[1] << 8) + d[3];
+		raw = DevRegGet<uint32_t, DEVREG_ENDIAN_BIG, 3>(d);
 
 		int64_t off  = ((int64_t)vPTProm[2] << 17LL) + (((int64_t)vPTProm[4] * vCurDT) >> 6LL);
 		int64_t sens = ((int64_t)vPTProm[1] << 16LL) + (((int64_t)vPTProm[3] * vCurDT) >> 7LL);
@@ -299,7 +300,8 @@ float TphMS8607::ReadHumidity()
 	vpIntrf->Tx(MS8607_RHDEV_ADDR, &cmd, 1);
 	int count = vpIntrf->Rx(MS8607_RHDEV_ADDR, (uint8_t*)d, 3);
 
-	raw = ((uint32_t)d[0] << 8) + (d[1] & 0xFC);
+	// 14 bits, 2 lsb are status
+	raw = DevRegGet<uint16_t, DEVREG_ENDIAN_BIG>(d) & 0xFFFC;
 
 	if ((d[1] & 0x3) == 2)
 	{
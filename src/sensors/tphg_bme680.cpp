@@ -115,6 +115,22 @@ const float s_fBme860GasCalib2[16] = {
 };
 #endif
 
+// Heater & control registers keep their value across samples.  ctrl_meas is
+// not cached, forced mode returns to sleep by itself.
+static const DEVREG_DESC s_Bme680RegDesc[] = {
+	{ BME680_REG_RES_HEAT_X_START, BME680_REG_GAS_WAIT_X_END - BME680_REG_RES_HEAT_X_START + 1,
+	  DEVREG_ATTR_CACHED | DEVREG_ATTR_RSTVAL, 0 },
+	{ BME680_REG_CTRL_GAS0, 3, DEVREG_ATTR_CACHED | DEVREG_ATTR_RSTVAL, 0 },	// ctrl_gas_0, ctrl_gas_1, ctrl_hum
+	{ BME680_REG_CONFIG, 1, DEVREG_ATTR_CACHED | DEVREG_ATTR_RSTVAL, 0 },
+};
+
+// Raw ADC values, 20 bits pressure & temperature, 16 bits humidity and
+// 10 bits gas resistance in bits 15..6 of GAS_R_MSB/LSB
+typedef DevRegBits<uint32_t, DEVREG_ENDIAN_BIG, BME680_REG_PRESS_MSB, 3, 4, 20> Bme680AdcP;
+typedef DevRegBits<uint32_t, DEVREG_ENDIAN_BIG, BME680_REG_TEMP_MSB, 3, 4, 20> Bme680AdcT;
+typedef DevReg<uint16_t, DEVREG_ENDIAN_BIG, BME680_REG_HUM_MSB> Bme680AdcH;
+typedef DevRegBits<uint32_t, DEVREG_ENDIAN_BIG, BME680_REG_GAS_R_MSB, 2, 6, 10> Bme680AdcGas;
+
 TphgBme680::TphgBme680()
 {
 	vbMeasGas = false;
@@ -265,6 +281,10 @@ bool TphgBme680::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *
 		vpTimer = pTimer;
 	}
 
+	// Device does not auto increment on burst write, address/data pairs only
+	RegCacheInit(&vRegCache, s_Bme680RegDesc, sizeof(s_Bme680RegDesc) / sizeof(DEVREG_DESC),
+				 vRegCacheMem, sizeof(vRegCacheMem), false);
+
 	if (CfgData.DevAddr == BME680_I2C_DEV_ADDR0 || CfgData.DevAddr == BME680_I2C_DEV_ADDR1)
 	{
 		// I2C mode
@@ -275,10 +295,11 @@ bool TphgBme680::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *
 		vbSpi = true;
 
 		// Set SPI register page to 0
-		// for reading chip id later
+		// for reading chip id later.  Status register is in both pages, no
+		// page select needed
 		regaddr = BME680_REG_STATUS;
 		d = 0;
-		Write((uint8_t*)&regaddr, 1, &d, 1);
+		Device::Write((uint8_t*)&regaddr, 1, &d, 1);
 		vRegPage = 0;
 	}
 
@@ -337,7 +358,7 @@ bool TphgBme680::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *
 	}
 
 	regaddr = BME680_REG_CTRL_HUM;
-	Write((uint8_t*)&regaddr, 1, &d, 1);
+	Write8(&regaddr, 1, d);
 
 	// Need to keep temperature & pressure oversampling
 	// because of shared register with operating mode settings
@@ -359,10 +380,10 @@ bool TphgBme680::Init(const TPHSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *
 
 
 	regaddr = BME680_REG_CONFIG;
-	Read((uint8_t*)&regaddr, 1, &d, 1);
+	d = Read8(&regaddr, 1);
 
 	d |= (CfgData.FilterCoeff << BME680_REG_CONFIG_FILTER_BITPOS) & BME680_REG_CONFIG_FILTER_MASK;
-	Write((uint8_t*)&regaddr, 1, &d, 1);
+	Write8(&regaddr, 1, d);
 
 	State(SENSOR_STATE_SLEEP);
 
@@ -428,7 +449,7 @@ bool TphgBme680::Init(const GASSENSOR_CFG &CfgData, DeviceIntrf *pIntrf, Timer *
 	uint8_t reg = BME680_REG_CTRL_GAS1;
 	vCtrlGas1Reg = BME680_REG_CTRL_GAS1_RUN_GAS | ((vNbHeatPoint - 1) & BME680_REG_CTRL_GAS1_NB_CONV_MASK);
 
-	Write(&reg, 1, &vCtrlGas1Reg, 1);
+	Write8(&reg, 1, vCtrlGas1Reg);
 
 	return true;
 }
@@ -475,8 +496,9 @@ bool TphgBme680::SetHeatingProfile(int Count, const GASSENSOR_HEAT *pProfile)
 			dur |= (mul << 6);
 		}
 
-		Write(&regt, 1, &ht, 1);
-		Write(&regd, 1, (uint8_t*)&dur, 1);
+		// Unchanged heater settings are not rewritten
+		Write8(&regt, 1, ht);
+		Write8(&regd, 1, (uint8_t)dur);
 
 		regt++;
 		regd++;
@@ -608,37 +630,45 @@ void TphgBme680::Reset()
 
 	addr = BME680_REG_RESET;
 	Write(&addr, 1, &d, 1);
+
+	// Reset returns to SPI page 0 & default register values
+	vRegPage = 0;
+	RegCacheReset();
 }
 
 bool TphgBme680::UpdateData()
 {
-	uint8_t addr = BME680_REG_MEAS_STATUS_0;
 	uint8_t status = 0;
 	uint8_t	gasidx;
+	uint8_t d[8], g[2];
+	DEVREG_READ req[3] = {
+		{ BME680_REG_MEAS_STATUS_0, 1, &status, 0 },
+		{ BME680_REG_PRESS_MSB, 8, d, 0 },
+		{ BME680_REG_GAS_R_MSB, 2, g, 0 },
+	};
 	bsec_input_t inputs[BSEC_MAX_PHYSICAL_SENSOR];
 	uint8_t icnt = 0;
     bsec_output_t outputs[BSEC_NUMBER_OUTPUTS];
     uint8_t ocnt = BSEC_NUMBER_OUTPUTS;
 
-	Read(&addr, 1, &status, 1);
+	// Status, data & gas ADC in a single burst, all in SPI page 1
+	ReadRegs(req, 3);
 
 	gasidx = status & BME680_REG_MEAS_STATUS_0_GAS_MEAS_IDX_0;
 
 	if (status & BME680_REG_MEAS_STATUS_0_NEW_DATA)
 	{
-		uint8_t d[8];
-		addr = BME680_REG_PRESS_MSB;
-
-		if (Read(&addr, 1, d, 8) == 8)
+		if (req[1].Count == 8)
 		{
-			int32_t p = (((uint32_t)d[0] << 12) | ((uint32_t)d[1] << 4) | ((uint32_t)d[2] >> 4));
-			int32_t t = (((uint32_t)d[3] << 12) | ((uint32_t)d[4] << 4) | ((uint32_t)d[5] >> 4));
-			int32_t h = (((uint32_t)d[6] << 8) | d[7]);
+			int32_t p = Bme680AdcP::Decode(d, BME680_REG_PRESS_MSB);
+			int32_t t = Bme680AdcT::Decode(d, BME680_REG_PRESS_MSB);
+			int32_t h = Bme680AdcH::Decode(d, BME680_REG_PRESS_MSB);
 
 			vTphData.Temperature = CalcTemperature(t);
 			vTphData.Pressure = CalcPressure(p);
 			vTphData.Humidity = CalcHumidity(h);
 			vTphData.Timestamp = vSampleTime;
+			TphQuePut();
 
 			inputs[0].sensor_id = BSEC_INPUT_TEMPERATURE;
 			inputs[0].signal = vTphData.Temperature / 100.0;
@@ -652,19 +682,18 @@ bool TphgBme680::UpdateData()
 			icnt = 3;
 		}
 
-		addr = BME680_REG_GAS_R_MSB;
-
-		if (Read(&addr, 1, d, 2) == 2)
+		if (req[2].Count == 2)
 		{
-			int32_t grange = d[1] & BME680_REG_GAS_R_LSB_GAS_RANGE_R;
-			int32_t gadc = (d[1] >> 5) | (d[0] << 2);
-			if (d[1] & BME680_REG_GAS_R_LSB_GAS_VALID_R)// | BME680_REG_GAS_R_LSB_HEAT_STAB_R)) ==
+			int32_t grange = g[1] & BME680_REG_GAS_R_LSB_GAS_RANGE_R;
+			int32_t gadc = Bme680AdcGas::Decode(g);
+			if (g[1] & BME680_REG_GAS_R_LSB_GAS_VALID_R)// | BME680_REG_GAS_R_LSB_HEAT_STAB_R)) ==
 //					(BME680_REG_GAS_R_LSB_GAS_VALID_R | BME680_REG_GAS_R_LSB_HEAT_STAB_R))
 			{
 				vGasData.GasRes[gasidx] = CalcGas(gadc, grange);
 				vGasData.MeasIdx = gasidx;
 				vbGasData = true;
 				vGasData.Timestamp = vSampleTime;
+				GasQuePut();
 				//vGasResInt = iCalcGas(gadc, grange);
 				inputs[icnt].sensor_id = BSEC_INPUT_GASRESISTOR;
 				inputs[icnt].signal = vGasData.GasRes[gasidx];
@@ -705,7 +734,7 @@ bool TphgBme680::Read(TPHSENSOR_DATA &TphData)
 	uint8_t reg = BME680_REG_CTRL_GAS1;
 	uint8_t d = vCtrlGas1Reg & ~BME680_REG_CTRL_GAS1_RUN_GAS;
 
-	Write(&reg, 1, &d, 1);
+	Write8(&reg, 1, d);
 
 	memcpy(&TphData, &vTphData, sizeof(TPHSENSOR_DATA));
 
@@ -724,7 +753,7 @@ bool TphgBme680::Read(GASSENSOR_DATA &GasData)
 	uint8_t reg = BME680_REG_CTRL_GAS1;
 
 	//if (retval == true)
-		Write(&reg, 1, &vCtrlGas1Reg, 1);
+		Write8(&reg, 1, vCtrlGas1Reg);
 
 	vbGasData = false;
 
@@ -0,0 +1,322 @@
+/**-------------------------------------------------------------------------
+@file	sim_intrf.c
+
+@brief	Simulated device interface.
+
+DEVINTRF implementation routing bus traffic to attached device models and
+charging each transfer to a simulated clock.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "sim_intrf.h"
+
+// Per byte cost in psec.  Keeps bit time exact for usual bus clocks
+static void SimIntrfUpdateCost(SIMINTRFDEV *pDev)
+{
+	uint64_t bits = pDev->Bus == SIMINTRF_BUS_I2C ? 9 : 8;
+
+	pDev->BytePs = pDev->ByteNs * 1000;
+
+	if (pDev->Rate > 0)
+	{
+		pDev->BytePs += (uint32_t)(bits * 1000000000000ULL / pDev->Rate);
+	}
+}
+
+static inline void SimIntrfCharge(SIMINTRFDEV *pDev, int NbBytes)
+{
+	pDev->Stats.BusNs += ((uint64_t)NbBytes * pDev->BytePs + 500) / 1000;
+}
+
+static SIMINTRF_MODEL *SimIntrfFind(SIMINTRFDEV *pDev, int DevAddr)
+{
+	for (int i = 0; i < pDev->NbDev; i++)
+	{
+		if (pDev->Dev[i].DevAddr == DevAddr)
+		{
+			return pDev->Dev[i].pModel;
+		}
+	}
+
+	return NULL;
+}
+
+static void SimIntrfDisable(DEVINTRF *pDevIntrf)
+{
+	(void)pDevIntrf;
+}
+
+static void SimIntrfEnable(DEVINTRF *pDevIntrf)
+{
+	(void)pDevIntrf;
+}
+
+static int SimIntrfGetRate(DEVINTRF *pDevIntrf)
+{
+	SIMINTRFDEV *dev = (SIMINTRFDEV *)pDevIntrf->pDevData;
+
+	return dev->Rate;
+}
+
+static int SimIntrfSetRate(DEVINTRF *pDevIntrf, int Rate)
+{
+	SIMINTRFDEV *dev = (SIMINTRFDEV *)pDevIntrf->pDevData;
+
+	dev->Rate = Rate;
+	SimIntrfUpdateCost(dev);
+
+	return dev->Rate;
+}
+
+// Start or restart condition.
+// On SPI, chip select stays asserted on restart and the device sees nothing.
+// On I2C, each (re)start is a new address phase.
+static bool SimIntrfStart(DEVINTRF *pDevIntrf, int DevAddr, bool bRx)
+{
+	SIMINTRFDEV *dev = (SIMINTRFDEV *)pDevIntrf->pDevData;
+	SIMINTRF_MODEL *model;
+
+	if (dev->pActive == NULL)
+	{
+		dev->Stats.XferCnt++;
+		dev->Stats.BusNs += dev->XferNs;
+	}
+	else if (dev->Bus == SIMINTRF_BUS_SPI)
+	{
+		return true;
+	}
+
+	dev->Stats.StartCnt++;
+
+	if (dev->Bus == SIMINTRF_BUS_I2C)
+	{
+		// Address byte
+		SimIntrfCharge(dev, 1);
+	}
+
+	model = SimIntrfFind(dev, DevAddr);
+	if (model == NULL || model->Start(model, bRx) == false)
+	{
+		dev->Stats.NackCnt++;
+
+		return false;
+	}
+
+	dev->pActive = model;
+
+	return true;
+}
+
+static bool SimIntrfStartRx(DEVINTRF *pDevIntrf, int DevAddr)
+{
+	return SimIntrfStart(pDevIntrf, DevAddr, true);
+}
+
+static int SimIntrfRxData(DEVINTRF *pDevIntrf, uint8_t *pBuff, int BuffLen)
+{
+	SIMINTRFDEV *dev = (SIMINTRFDEV *)pDevIntrf->pDevData;
+
+	if (dev->pActive == NULL || BuffLen <= 0)
+		return 0;
+
+	if (dev->RxMax > 0 && BuffLen > dev->RxMax)
+	{
+		BuffLen = dev->RxMax;
+	}
+
+	int cnt = dev->pActive->Read(dev->pActive, pBuff, BuffLen);
+
+	dev->Stats.RxBytes += cnt;
+	SimIntrfCharge(dev, cnt);
+
+	return cnt;
+}
+
+static void SimIntrfStop(DEVINTRF *pDevIntrf)
+{
+	SIMINTRFDEV *dev = (SIMINTRFDEV *)pDevIntrf->pDevData;
+
+	if (dev->pActive)
+	{
+		dev->Stats.DevNs += dev->pActive->Stop(dev->pActive);
+		dev->pActive = NULL;
+	}
+}
+
+static bool SimIntrfStartTx(DEVINTRF *pDevIntrf, int DevAddr)
+{
+	return SimIntrfStart(pDevIntrf, DevAddr, false);
+}
+
+static int SimIntrfTxData(DEVINTRF *pDevIntrf, uint8_t *pData, int DataLen)
+{
+	SIMINTRFDEV *dev = (SIMINTRFDEV *)pDevIntrf->pDevData;
+
+	if (dev->pActive == NULL || DataLen <= 0)
+		return 0;
+
+	int cnt = dev->pActive->Write(dev->pActive, pData, DataLen);
+
+	dev->Stats.TxBytes += cnt;
+	SimIntrfCharge(dev, cnt);
+
+	return cnt;
+}
+
+// Native scatter-gather.  Segments go straight to the model the way chained
+// DMA descriptors would, a direction change is a restart
+static int SimIntrfTransfer(DEVINTRF *pDevIntrf, int DevAddr, const DEVINTRF_SEG *pSeg, int NbSeg)
+{
+	int count = 0;
+
+	for (int i = 0; i < NbSeg; i++)
+	{
+		int cnt;
+
+		if (i == 0 || pSeg[i].bRx != pSeg[i - 1].bRx)
+		{
+			if (SimIntrfStart(pDevIntrf, DevAddr, pSeg[i].bRx) == false)
+				break;
+		}
+
+		cnt = pSeg[i].bRx ? SimIntrfRxData(pDevIntrf, pSeg[i].pData, pSeg[i].Len) :
+							SimIntrfTxData(pDevIntrf, pSeg[i].pData, pSeg[i].Len);
+		count += cnt;
+		if (cnt < pSeg[i].Len)
+			break;
+	}
+
+	SimIntrfStop(pDevIntrf);
+
+	return count;
+}
+
+static void SimIntrfReset(DEVINTRF *pDevIntrf)
+{
+	SimIntrfStop(pDevIntrf);
+}
+
+bool SimIntrfInit(SIMINTRFDEV *pDev, const SIMINTRF_CFG *pCfgData)
+{
+	if (pDev == NULL || pCfgData == NULL)
+		return false;
+
+	memset(pDev, 0, sizeof(SIMINTRFDEV));
+
+	pDev->Bus = pCfgData->Bus;
+	pDev->Rate = pCfgData->Rate;
+	pDev->XferNs = pCfgData->XferNs;
+	pDev->ByteNs = pCfgData->ByteNs;
+	pDev->RxMax = pCfgData->RxMax;
+	SimIntrfUpdateCost(pDev);
+
+	pDev->DevIntrf.pDevData = pDev;
+	pDev->DevIntrf.MaxRetry = pCfgData->MaxRetry;
+	pDev->DevIntrf.Disable = SimIntrfDisable;
+	pDev->DevIntrf.Enable = SimIntrfEnable;
+	pDev->DevIntrf.GetRate = SimIntrfGetRate;
+	pDev->DevIntrf.SetRate = SimIntrfSetRate;
+	pDev->DevIntrf.StartRx = SimIntrfStartRx;
+	pDev->DevIntrf.RxData = SimIntrfRxData;
+	pDev->DevIntrf.StopRx = SimIntrfStop;
+	pDev->DevIntrf.StartTx = SimIntrfStartTx;
+	pDev->DevIntrf.TxData = SimIntrfTxData;
+	pDev->DevIntrf.StopTx = SimIntrfStop;
+	pDev->DevIntrf.Reset = SimIntrfReset;
+	pDev->DevIntrf.Transfer = SimIntrfTransfer;
+
+	return true;
+}
+
+bool SimIntrfAttach(SIMINTRFDEV *pDev, int DevAddr, SIMINTRF_MODEL *pModel)
+{
+	if (pModel == NULL || pDev->NbDev >= SIMINTRF_MAX_DEV)
+		return false;
+
+	pDev->Dev[pDev->NbDev].DevAddr = DevAddr;
+	pDev->Dev[pDev->NbDev].pModel = pModel;
+	pDev->NbDev++;
+
+	return true;
+}
+
+// Completion driven queue start.  Transfer is done on the models right away,
+// completion is reported once its bus time has elapsed
+static bool SimIntrfQueStart(DEVINTRFQUE *pQue, DEVINTRF_XACT *pXact)
+{
+	SIMINTRFDEV *dev = (SIMINTRFDEV *)pQue->pStartData;
+	uint64_t t = dev->Stats.BusNs;
+
+	dev->PendCount = DeviceIntrfTransfer(&dev->DevIntrf, pXact->DevAddr, pXact->Seg, pXact->NbSeg);
+	dev->PendNs = dev->Stats.BusNs - t;
+	dev->bPending = true;
+
+	return true;
+}
+
+bool SimIntrfQueInit(SIMINTRFDEV *pDev, DEVINTRFQUE *pQue)
+{
+	if (DevIntrfQueInit(pQue, &pDev->DevIntrf, SimIntrfQueStart, pDev) == false)
+		return false;
+
+	pDev->pQue = pQue;
+	pDev->bPending = false;
+
+	return true;
+}
+
+void SimIntrfRun(SIMINTRFDEV *pDev, uint64_t Ns)
+{
+	while (pDev->bPending && pDev->PendNs <= Ns)
+	{
+		Ns -= pDev->PendNs;
+		pDev->Stats.WallNs += pDev->PendNs;
+		pDev->bPending = false;
+
+		// Completion interrupt, starts next transaction if any
+		DevIntrfQueComplete(pDev->pQue, pDev->PendCount);
+	}
+
+	if (pDev->bPending)
+	{
+		pDev->PendNs -= Ns;
+	}
+	pDev->Stats.WallNs += Ns;
+}
+
+void SimIntrfRunIdle(SIMINTRFDEV *pDev)
+{
+	while (pDev->bPending)
+	{
+		SimIntrfRun(pDev, pDev->PendNs);
+	}
+}
@@ -0,0 +1,174 @@
+/**-------------------------------------------------------------------------
+@file	sim_iopin.c
+
+@brief	Simulated I/O pins.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "sim_iopin.h"
+
+typedef struct __SimIOPin_Int {
+	int PortNo;
+	int PinNo;
+	IOPINSENSE Sense;
+	IOPINEVT_CB EvtCB;
+	uint32_t Count;
+} SIMIOPIN_INT;
+
+static uint32_t s_SimIOPinLevel[SIMIOPIN_MAX_PORT];
+static SIMIOPIN_INT s_SimIOPinInt[SIMIOPIN_MAX_INT];
+
+static inline bool SimIOPinValid(int PortNo, int PinNo)
+{
+	return PortNo >= 0 && PortNo < SIMIOPIN_MAX_PORT && PinNo >= 0 && PinNo < 32;
+}
+
+void SimIOPinReset(void)
+{
+	memset(s_SimIOPinLevel, 0, sizeof(s_SimIOPinLevel));
+	memset(s_SimIOPinInt, 0, sizeof(s_SimIOPinInt));
+}
+
+void SimIOPinSet(int PortNo, int PinNo, bool bHigh)
+{
+	if (SimIOPinValid(PortNo, PinNo) == false)
+		return;
+
+	bool old = (s_SimIOPinLevel[PortNo] >> PinNo) & 1;
+
+	if (old == bHigh)
+		return;
+
+	if (bHigh)
+	{
+		s_SimIOPinLevel[PortNo] |= 1UL << PinNo;
+	}
+	else
+	{
+		s_SimIOPinLevel[PortNo] &= ~(1UL << PinNo);
+	}
+
+	for (int i = 0; i < SIMIOPIN_MAX_INT; i++)
+	{
+		SIMIOPIN_INT *p = &s_SimIOPinInt[i];
+
+		if (p->EvtCB == NULL || p->PortNo != PortNo || p->PinNo != PinNo)
+			continue;
+
+		if (p->Sense == IOPINSENSE_TOGGLE ||
+			(p->Sense == IOPINSENSE_HIGH_TRANSITION && bHigh) ||
+			(p->Sense == IOPINSENSE_LOW_TRANSITION && !bHigh))
+		{
+			p->Count++;
+			p->EvtCB(i);
+		}
+	}
+}
+
+bool SimIOPinRead(int PortNo, int PinNo)
+{
+	if (SimIOPinValid(PortNo, PinNo) == false)
+		return false;
+
+	return (s_SimIOPinLevel[PortNo] >> PinNo) & 1;
+}
+
+uint32_t SimIOPinIntCount(int IntNo)
+{
+	if (IntNo < 0 || IntNo >= SIMIOPIN_MAX_INT)
+		return 0;
+
+	return s_SimIOPinInt[IntNo].Count;
+}
+
+/******** iopincfg.h implementation ********/
+
+void IOPinConfig(int PortNo, int PinNo, int PinOp, IOPINDIR Dir, IOPINRES Resistor, IOPINTYPE Type)
+{
+	(void)PinOp;
+	(void)Dir;
+	(void)Type;
+
+	// Pull up only sets the idle level
+	if (SimIOPinValid(PortNo, PinNo) && Resistor == IOPINRES_PULLUP)
+	{
+		s_SimIOPinLevel[PortNo] |= 1UL << PinNo;
+	}
+}
+
+void IOPinDisable(int PortNo, int PinNo)
+{
+	(void)PortNo;
+	(void)PinNo;
+}
+
+void IOPinDisbleInterrupt(int IntNo)
+{
+	if (IntNo < 0 || IntNo >= SIMIOPIN_MAX_INT)
+		return;
+
+	s_SimIOPinInt[IntNo].EvtCB = NULL;
+	s_SimIOPinInt[IntNo].Sense = IOPINSENSE_DISABLE;
+}
+
+bool IOPinEnableInterrupt(int IntNo, int IntPrio, int PortNo, int PinNo, IOPINSENSE Sense, IOPINEVT_CB pEvtCB)
+{
+	(void)IntPrio;
+
+	if (IntNo < 0 || IntNo >= SIMIOPIN_MAX_INT || SimIOPinValid(PortNo, PinNo) == false)
+		return false;
+
+	s_SimIOPinInt[IntNo].PortNo = PortNo;
+	s_SimIOPinInt[IntNo].PinNo = PinNo;
+	s_SimIOPinInt[IntNo].Sense = Sense;
+	s_SimIOPinInt[IntNo].EvtCB = pEvtCB;
+
+	return true;
+}
+
+void IOPinSetSense(int PortNo, int PinNo, IOPINSENSE Sense)
+{
+	for (int i = 0; i < SIMIOPIN_MAX_INT; i++)
+	{
+		if (s_SimIOPinInt[i].EvtCB && s_SimIOPinInt[i].PortNo == PortNo && s_SimIOPinInt[i].PinNo == PinNo)
+		{
+			s_SimIOPinInt[i].Sense = Sense;
+		}
+	}
+}
+
+void IOPinSetStrength(int PortNo, int PinNo, IOPINSTRENGTH Strength)
+{
+	(void)PortNo;
+	(void)PinNo;
+	(void)Strength;
+}
@@ -0,0 +1,891 @@
+/**-------------------------------------------------------------------------
+@file	sim_models.c
+
+@brief	Device models for the simulated device interface.
+
+Register file (BME280), I2C EEPROM, SPI NOR flash and SD card in SPI mode.
+Models keep only the state needed by the EHAL drivers to run unmodified.
+
+@author	Hoang Nguyen Hoan
+@date	Oct. 15, 2026
+
+@license
+
+Copyright (c) 2026, I-SYST inc., all rights reserved
+
+Permission to use, copy, modify, and distribute this software for any purpose
+with or without fee is hereby granted, provided that the above copyright
+notice and this permission notice appear in all copies, and none of the
+names : I-SYST or its contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+For info or contributing contact : hnhoan at i-syst dot com
+
+THIS SOFTWARE IS PROVIDED BY THE REGENTS AND CONTRIBUTORS ``AS IS'' AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE REGENTS OR CONTRIBUTORS BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+----------------------------------------------------------------------------*/
+#include <stdint.h>
+#include <string.h>
+
+#include "crc.h"
+#include "sim_intrf.h"
+
+/******** Register file ********/
+
+static bool SimRegFileStart(SIMINTRF_MODEL *pModel, bool bRx)
+{
+	SIMREGFILE *rf = (SIMREGFILE *)pModel->pModelData;
+
+	(void)bRx;
+
+	// First byte written is always register address.  Restart for read
+	// does not write so the pointer is kept.
+	rf->bAddrPhase = true;
+
+	return true;
+}
+
+static int SimRegFileWrite(SIMINTRF_MODEL *pModel, const uint8_t *pData, int DataLen)
+{
+	SIMREGFILE *rf = (SIMREGFILE *)pModel->pModelData;
+
+	for (int i = 0; i < DataLen; i++)
+	{
+		if (rf->bAddrPhase)
+		{
+			rf->Ptr = (pData[i] & rf->AddrMask) | rf->AddrSet;
+			rf->bAddrPhase = false;
+		}
+		else
+		{
+			if (rf->WrHook == NULL || rf->WrHook(rf, rf->Ptr, pData[i]))
+			{
+				rf->Reg[rf->Ptr] = pData[i];
+			}
+			rf->Ptr++;
+		}
+	}
+
+	return DataLen;
+}
+
+static int SimRegFileRead(SIMINTRF_MODEL *pModel, uint8_t *pBuff, int BuffLen)
+{
+	SIMREGFILE *rf = (SIMREGFILE *)pModel->pModelData;
+
+	for (int i = 0; i < BuffLen; i++)
+	{
+		pBuff[i] = rf->Reg[rf->Ptr++];
+	}
+
+	return BuffLen;
+}
+
+static uint32_t SimRegFileStop(SIMINTRF_MODEL *pModel)
+{
+	(void)pModel;
+
+	return 0;
+}
+
+SIMINTRF_MODEL *SimRegFileInit(SIMREGFILE *pRegFile, uint8_t AddrMask, uint8_t AddrSet)
+{
+	memset(pRegFile, 0, sizeof(SIMREGFILE));
+
+	pRegFile->AddrMask = AddrMask;
+	pRegFile->AddrSet = AddrSet;
+	pRegFile->Model.pModelData = pRegFile;
+	pRegFile->Model.Start = SimRegFileStart;
+	pRegFile->Model.Write = SimRegFileWrite;
+	pRegFile->Model.Read = SimRegFileRead;
+	pRegFile->Model.Stop = SimRegFileStop;
+
+	return &pRegFile->Model;
+}
+
+/******** BME280 ********/
+
+// Calibration & measurement example from BME280 datasheet.
+// T = 25.08 C, P = 100653 Pa
+static const uint8_t s_Bme280Calib00[26] = {
+	0x70, 0x6B, 0x43, 0x67, 0x18, 0xFC,				// dig_T1..T3
+	0x7D, 0x8E, 0x43, 0xD6, 0xD0, 0x0B, 0x27, 0x0B,	// dig_P1..P4
+	0x8C, 0x00, 0xF9, 0xFF, 0x8C, 0x3C, 0xF8, 0xC6,	// dig_P5..P8
+	0x70, 0x17,										// dig_P9
+	0x00, 0x4B,										// reserved, dig_H1
+};
+
+static const uint8_t s_Bme280Calib26[7] = {
+	0x6A, 0x01, 0x00, 0x13, 0x29, 0x03, 0x1E,		// dig_H2..H6
+};
+
+static const uint8_t s_Bme280Data[8] = {
+	0x65, 0x5A, 0xC0,		// press 415148
+	0x7E, 0xED, 0x00,		// temp 519888
+	0x60, 0x00,				// hum
+};
+
+static bool SimBme280WrHook(SIMREGFILE *pRegFile, uint8_t RegAddr, uint8_t Val)
+{
+	switch (RegAddr)
+	{
+		case 0xE0:	// reset
+			if (Val == 0xB6)
+			{
+				pRegFile->Reg[0xF2] = 0;
+				pRegFile->Reg[0xF4] = 0;
+				pRegFile->Reg[0xF5] = 0;
+			}
+			return false;
+		case 0xF4:	// ctrl_meas, forced mode returns to sleep once measurement is done
+			if ((Val & 3) == 1 || (Val & 3) == 2)
+			{
+				pRegFile->Reg[0xF4] = Val & ~3;
+				return false;
+			}
+			return true;
+		case 0xF2:	// ctrl_hum
+		case 0xF5:	// config
+			return true;
+	}
+
+	// Read only
+	return false;
+}
+
+SIMINTRF_MODEL *SimBme280Init(SIMREGFILE *pRegFile, bool bSpi)
+{
+	SIMINTRF_MODEL *model = SimRegFileInit(pRegFile, bSpi ? 0x7F : 0xFF, bSpi ? 0x80 : 0);
+
+	pRegFile->Reg[0xD0] = 0x60;
+	memcpy(&pRegFile->Reg[0x88], s_Bme280Calib00, sizeof(s_Bme280Calib00));
+	memcpy(&pRegFile->Reg[0xE1], s_Bme280Calib26, sizeof(s_Bme280Calib26));
+	memcpy(&pRegFile->Reg[0xF7], s_Bme280Data, sizeof(s_Bme280Data));
+	pRegFile->WrHook = SimBme280WrHook;
+
+	return model;
+}
+
+/******** MPU9250 ********/
+
+#define SIMMPU9250_FIFO_EN		0x23
+#define SIMMPU9250_ACCEL_XOUT_H	0x3B
+#define SIMMPU9250_GYRO_XOUT_H	0x43
+#define SIMMPU9250_USER_CTRL	0x6A
+#define SIMMPU9250_PWR_MGMT_1	0x6B
+#define SIMMPU9250_FIFO_COUNT_H	0x72
+#define SIMMPU9250_FIFO_R_W		0x74
+#define SIMMPU9250_WHO_AM_I		0x75
+
+static void SimMpu9250FifoCount(SIMMPU9250 *pMpu)
+{
+	pMpu->RegFile.Reg[SIMMPU9250_FIFO_COUNT_H] = (uint8_t)(pMpu->FifoCnt >> 8);
+	pMpu->RegFile.Reg[SIMMPU9250_FIFO_COUNT_H + 1] = (uint8_t)pMpu->FifoCnt;
+}
+
+static void SimMpu9250FifoReset(SIMMPU9250 *pMpu)
+{
+	pMpu->FifoRd = 0;
+	pMpu->FifoCnt = 0;
+	SimMpu9250FifoCount(pMpu);
+}
+
+static bool SimMpu9250WrHook(SIMREGFILE *pRegFile, uint8_t RegAddr, uint8_t Val)
+{
+	SIMMPU9250 *mpu = (SIMMPU9250 *)pRegFile;
+
+	switch (RegAddr)
+	{
+		case SIMMPU9250_USER_CTRL:	// FIFO_RST self clears
+			if (Val & (1 << 2))
+			{
+				SimMpu9250FifoReset(mpu);
+			}
+			pRegFile->Reg[RegAddr] = Val & ~(1 << 2);
+			return false;
+		case SIMMPU9250_PWR_MGMT_1:	// H_RESET self clears
+			if (Val & (1 << 7))
+			{
+				pRegFile->Reg[SIMMPU9250_FIFO_EN] = 0;
+				pRegFile->Reg[SIMMPU9250_USER_CTRL] = 0;
+				pRegFile->Reg[RegAddr] = 1;
+				SimMpu9250FifoReset(mpu);
+				return false;
+			}
+			return true;
+		case SIMMPU9250_FIFO_COUNT_H:
+		case SIMMPU9250_FIFO_COUNT_H + 1:
+		case SIMMPU9250_FIFO_R_W:
+		case SIMMPU9250_WHO_AM_I:
+			return false;
+	}
+
+	return true;
+}
+
+// FIFO_R_W does not auto increment, each read pops the FIFO
+static int SimMpu9250Read(SIMINTRF_MODEL *pModel, uint8_t *pBuff, int BuffLen)
+{
+	SIMMPU9250 *mpu = (SIMMPU9250 *)pModel->pModelData;
+	SIMREGFILE *rf = &mpu->RegFile;
+
+	for (int i = 0; i < BuffLen; i++)
+	{
+		if (rf->Ptr == SIMMPU9250_FIFO_R_W)
+		{
+			pBuff[i] = 0;
+			if (mpu->FifoCnt > 0)
+			{
+				pBuff[i] = mpu->Fifo[mpu->FifoRd];
+				mpu->FifoRd = (mpu->FifoRd + 1) % sizeof(mpu->Fifo);
+				mpu->FifoCnt--;
+			}
+		}
+		else
+		{
+			pBuff[i] = rf->Reg[rf->Ptr++];
+		}
+	}
+
+	SimMpu9250FifoCount(mpu);
+
+	return BuffLen;
+}
+
+SIMINTRF_MODEL *SimMpu9250Init(SIMMPU9250 *pMpu, bool bSpi)
+{
+	memset(pMpu, 0, sizeof(SIMMPU9250));
+
+	SIMINTRF_MODEL *model = SimRegFileInit(&pMpu->RegFile, bSpi ? 0x7F : 0xFF, 0);
+
+	pMpu->RegFile.Reg[SIMMPU9250_WHO_AM_I] = 0x71;
+	pMpu->RegFile.Reg[SIMMPU9250_PWR_MGMT_1] = 1;
+	pMpu->RegFile.WrHook = SimMpu9250WrHook;
+	model->Read = SimMpu9250Read;
+
+	return model;
+}
+
+void SimMpu9250Sample(SIMMPU9250 *pMpu, const int16_t *pAccel, const int16_t *pGyro)
+{
+	uint8_t *reg = pMpu->RegFile.Reg;
+	uint8_t fifoen = reg[SIMMPU9250_FIFO_EN];
+	uint8_t frame[14];
+	int len = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		reg[SIMMPU9250_ACCEL_XOUT_H + i * 2] = (uint8_t)(pAccel[i] >> 8);
+		reg[SIMMPU9250_ACCEL_XOUT_H + i * 2 + 1] = (uint8_t)pAccel[i];
+		reg[SIMMPU9250_GYRO_XOUT_H + i * 2] = (uint8_t)(pGyro[i] >> 8);
+		reg[SIMMPU9250_GYRO_XOUT_H + i * 2 + 1] = (uint8_t)pGyro[i];
+	}
+
+	if ((reg[SIMMPU9250_USER_CTRL] & (1 << 6)) == 0)
+		return;
+
+	// Frame order : accel, temperature, gyro x, y, z
+	if (fifoen & (1 << 3))
+	{
+		memcpy(&frame[len], &reg[SIMMPU9250_ACCEL_XOUT_H], 6);
+		len += 6;
+	}
+	if (fifoen & (1 << 7))
+	{
+		memcpy(&frame[len], &reg[SIMMPU9250_ACCEL_XOUT_H + 6], 2);
+		len += 2;
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		if (fifoen & (1 << (6 - i)))
+		{
+			memcpy(&frame[len], &reg[SIMMPU9250_GYRO_XOUT_H + i * 2], 2);
+			len += 2;
+		}
+	}
+
+	if (pMpu->FifoCnt + len > (int)sizeof(pMpu->Fifo))
+	{
+		pMpu->OvrCnt++;
+		return;
+	}
+
+	for (int i = 0; i < len; i++)
+	{
+		pMpu->Fifo[(pMpu->FifoRd + pMpu->FifoCnt) % sizeof(pMpu->Fifo)] = frame[i];
+		pMpu->FifoCnt++;
+	}
+
+	SimMpu9250FifoCount(pMpu);
+}
+
+/******** I2C EEPROM ********/
+
+static bool SimEepromStart(SIMINTRF_MODEL *pModel, bool bRx)
+{
+	SIMEEPROM *ee = (SIMEEPROM *)pModel->pModelData;
+
+	(void)bRx;
+
+	// Address is kept for current address & random read after restart
+	ee->AddrCnt = 0;
+
+	return true;
+}
+
+static int SimEepromWrite(SIMINTRF_MODEL *pModel, const uint8_t *pData, int DataLen)
+{
+	SIMEEPROM *ee = (SIMEEPROM *)pModel->pModelData;
+
+	for (int i = 0; i < DataLen; i++)
+	{
+		if (ee->AddrCnt < ee->AddrLen)
+		{
+			ee->Addr = ee->AddrCnt == 0 ? pData[i] : (ee->Addr << 8) | pData[i];
+			ee->AddrCnt++;
+			if (ee->AddrCnt >= ee->AddrLen)
+			{
+				ee->Addr %= ee->Size;
+			}
+		}
+		else
+		{
+			uint32_t page = ee->Addr - (ee->Addr % ee->PageSize);
+
+			ee->pMem[ee->Addr] = pData[i];
+			ee->Addr = page + (ee->Addr + 1 - page) % ee->PageSize;
+			ee->bWrite = true;
+		}
+	}
+
+	return DataLen;
+}
+
+static int SimEepromRead(SIMINTRF_MODEL *pModel, uint8_t *pBuff, int BuffLen)
+{
+	SIMEEPROM *ee = (SIMEEPROM *)pModel->pModelData;
+
+	for (int i = 0; i < BuffLen; i++)
+	{
+		pBuff[i] = ee->pMem[ee->Addr];
+		ee->Addr = (ee->Addr + 1) % ee->Size;
+	}
+
+	return BuffLen;
+}
+
+static uint32_t SimEepromStop(SIMINTRF_MODEL *pModel)
+{
+	SIMEEPROM *ee = (SIMEEPROM *)pModel->pModelData;
+
+	if (ee->bWrite)
+	{
+		ee->bWrite = false;
+
+		return ee->WrNs;
+	}
+
+	return 0;
+}
+
+SIMINTRF_MODEL *SimEepromInit(SIMEEPROM *pEeprom, uint8_t *pMem, uint32_t Size,
+							  uint16_t PageSize, uint8_t AddrLen, uint32_t WrNs)
+{
+	memset(pEeprom, 0, sizeof(SIMEEPROM));
+
+	pEeprom->pMem = pMem;
+	pEeprom->Size = Size;
+	pEeprom->PageSize = PageSize;
+	pEeprom->AddrLen = AddrLen;
+	pEeprom->WrNs = WrNs;
+	pEeprom->Model.pModelData = pEeprom;
+	pEeprom->Model.Start = SimEepromStart;
+	pEeprom->Model.Write = SimEepromWrite;
+	pEeprom->Model.Read = SimEepromRead;
+	pEeprom->Model.Stop = SimEepromStop;
+
+	return &pEeprom->Model;
+}
+
+/******** SPI NOR flash ********/
+
+#define SIMFLASH_CMD_WRITE			0x02
+#define SIMFLASH_CMD_READ			0x03
+#define SIMFLASH_CMD_WRDISABLE		0x04
+#define SIMFLASH_CMD_READSTATUS		0x05
+#define SIMFLASH_CMD_WRENABLE		0x06
+#define SIMFLASH_CMD_SECT_ERASE		0x20
+#define SIMFLASH_CMD_CHIP_ERASE		0x60
+#define SIMFLASH_CMD_READID			0x9F
+#define SIMFLASH_CMD_BULK_ERASE		0xC7
+#define SIMFLASH_CMD_BLOCK_ERASE	0xD8
+
+#define SIMFLASH_STATUS_WEL			(1<<1)
+
+#define SIMFLASH_SECT_SIZE			4096
+
+static void SimFlashErase(SIMFLASH *pFlash, uint32_t Size)
+{
+	if (pFlash->Status & SIMFLASH_STATUS_WEL)
+	{
+		uint32_t addr = pFlash->Addr - (pFlash->Addr % Size);
+
+		memset(&pFlash->pMem[addr], 0xFF, Size);
+		pFlash->BusyNs += pFlash->EraseNs;
+		pFlash->Status &= ~SIMFLASH_STATUS_WEL;
+	}
+}
+
+static bool SimFlashStart(SIMINTRF_MODEL *pModel, bool bRx)
+{
+	SIMFLASH *fl = (SIMFLASH *)pModel->pModelData;
+
+	(void)bRx;
+
+	fl->Cmd = -1;
+	fl->AddrCnt = 0;
+	fl->IdIdx = 0;
+
+	return true;
+}
+
+static int SimFlashWrite(SIMINTRF_MODEL *pModel, const uint8_t *pData, int DataLen)
+{
+	SIMFLASH *fl = (SIMFLASH *)pModel->pModelData;
+
+	for (int i = 0; i < DataLen; i++)
+	{
+		if (fl->Cmd < 0)
+		{
+			fl->Cmd = pData[i];
+
+			switch (fl->Cmd)
+			{
+				case SIMFLASH_CMD_WRENABLE:
+					fl->Status |= SIMFLASH_STATUS_WEL;
+					break;
+				case SIMFLASH_CMD_WRDISABLE:
+					fl->Status &= ~SIMFLASH_STATUS_WEL;
+					break;
+				case SIMFLASH_CMD_CHIP_ERASE:
+				case SIMFLASH_CMD_BULK_ERASE:
+					fl->Addr = 0;
+					SimFlashErase(fl, fl->Size);
+					break;
+			}
+			continue;
+		}
+
+		switch (fl->Cmd)
+		{
+			case SIMFLASH_CMD_READ:
+			case SIMFLASH_CMD_WRITE:
+			case SIMFLASH_CMD_SECT_ERASE:
+			case SIMFLASH_CMD_BLOCK_ERASE:
+				if (fl->AddrCnt < fl->AddrLen)
+				{
+					fl->Addr = fl->AddrCnt == 0 ? pData[i] : (fl->Addr << 8) | pData[i];
+					fl->AddrCnt++;
+					if (fl->AddrCnt < fl->AddrLen)
+						break;
+
+					fl->Addr %= fl->Size;
+					if (fl->Cmd == SIMFLASH_CMD_SECT_ERASE)
+					{
+						SimFlashErase(fl, SIMFLASH_SECT_SIZE);
+					}
+					else if (fl->Cmd == SIMFLASH_CMD_BLOCK_ERASE)
+					{
+						SimFlashErase(fl, fl->BlkSize);
+					}
+				}
+				else if (fl->Cmd == SIMFLASH_CMD_WRITE && (fl->Status & SIMFLASH_STATUS_WEL))
+				{
+					// Program only clears bits, address wraps within page
+					uint32_t page = fl->Addr - (fl->Addr % fl->PageSize);
+
+					fl->pMem[fl->Addr] &= pData[i];
+					fl->Addr = page + (fl->Addr + 1 - page) % fl->PageSize;
+					fl->BusyNs = fl->ProgNs;
+				}
+				break;
+		}
+	}
+
+	return DataLen;
+}
+
+static int SimFlashRead(SIMINTRF_MODEL *pModel, uint8_t *pBuff, int BuffLen)
+{
+	SIMFLASH *fl = (SIMFLASH *)pModel->pModelData;
+
+	switch (fl->Cmd)
+	{
+		case SIMFLASH_CMD_READ:
+			if (fl->AddrCnt >= fl->AddrLen)
+			{
+				int cnt = BuffLen;
+				uint8_t *p = pBuff;
+
+				while (cnt > 0)
+				{
+					int l = fl->Size - fl->Addr;
+
+					if (l > cnt)
+						l = cnt;
+					memcpy(p, &fl->pMem[fl->Addr], l);
+					fl->Addr = (fl->Addr + l) % fl->Size;
+					p += l;
+					cnt -= l;
+				}
+				return BuffLen;
+			}
+			break;
+		case SIMFLASH_CMD_READSTATUS:
+			memset(pBuff, fl->Status, BuffLen);
+			return BuffLen;
+		case SIMFLASH_CMD_READID:
+			for (int i = 0; i < BuffLen; i++)
+			{
+				pBuff[i] = fl->IdIdx < 4 ? (fl->Id >> (fl->IdIdx << 3)) & 0xFF : 0;
+				fl->IdIdx++;
+			}
+			return BuffLen;
+	}
+
+	// Nothing driven
+	memset(pBuff, 0xFF, BuffLen);
+
+	return BuffLen;
+}
+
+static uint32_t SimFlashStop(SIMINTRF_MODEL *pModel)
+{
+	SIMFLASH *fl = (SIMFLASH *)pModel->pModelData;
+	uint32_t t = fl->BusyNs;
+
+	if (fl->Cmd == SIMFLASH_CMD_WRITE && t > 0)
+	{
+		fl->Status &= ~SIMFLASH_STATUS_WEL;
+	}
+	fl->BusyNs = 0;
+	fl->Cmd = -1;
+
+	return t;
+}
+
+SIMINTRF_MODEL *SimFlashInit(SIMFLASH *pFlash, uint8_t *pMem, uint32_t Size, int AddrLen)
+{
+	memset(pFlash, 0, sizeof(SIMFLASH));
+	memset(pMem, 0xFF, Size);
+
+	pFlash->pMem = pMem;
+	pFlash->Size = Size;
+	pFlash->AddrLen = AddrLen;
+	pFlash->PageSize = 256;
+	pFlash->BlkSize = 65536;
+	pFlash->Id = 0x1840EF;
+	pFlash->ProgNs = 700000;
+	pFlash->EraseNs = 50000000;
+	pFlash->Cmd = -1;
+	pFlash->Model.pModelData = pFlash;
+	pFlash->Model.Start = SimFlashStart;
+	pFlash->Model.Write = SimFlashWrite;
+	pFlash->Model.Read = SimFlashRead;
+	pFlash->Model.Stop = SimFlashStop;
+
+	return &pFlash->Model;
+}
+
+/******** SD card SPI mode ********/
+
+#define SIMSDCARD_SECT_SIZE			512
+#define SIMSDCARD_R1_IDLE			0x01
+#define SIMSDCARD_R1_ILLEGAL_CMD	0x04
+#define SIMSDCARD_R1_PARAM_ERR		0x40
+#define SIMSDCARD_DATA_TOKEN		0xFE
+#define SIMSDCARD_MULTI_WR_TOKEN	0xFC
+#define SIMSDCARD_STOP_TRAN_TOKEN	0xFD
+#define SIMSDCARD_DATA_ACCEPTED		0x05
+#define SIMSDCARD_DATA_CRC_ERR		0x0B
+#define SIMSDCARD_DATA_WR_ERR		0x0D
+#define SIMSDCARD_STUFF_BYTE		0x5A	// Whatever was on the data line
+
+static inline void SimSDCardResp(SIMSDCARD *pCard, uint8_t Val)
+{
+	pCard->Resp[pCard->RespLen++] = Val;
+}
+
+// Queue data token, block & CRC16
+static void SimSDCardRespData(SIMSDCARD *pCard, uint8_t *pData, int Len)
+{
+	uint16_t crc = crc16_ccitt(pData, Len, 0);
+
+	SimSDCardResp(pCard, 0xFF);
+	SimSDCardResp(pCard, SIMSDCARD_DATA_TOKEN);
+	memcpy(&pCard->Resp[pCard->RespLen], pData, Len);
+	pCard->RespLen += Len;
+	SimSDCardResp(pCard, crc >> 8);
+	SimSDCardResp(pCard, crc & 0xFF);
+}
+
+static void SimSDCardCmd(SIMSDCARD *pCard)
+{
+	int cmd = pCard->Cmd[0] & 0x3F;
+	uint32_t arg = ((uint32_t)pCard->Cmd[1] << 24) | ((uint32_t)pCard->Cmd[2] << 16) |
+				   ((uint32_t)pCard->Cmd[3] << 8) | pCard->Cmd[4];
+	uint8_t r1 = pCard->bIdle ? SIMSDCARD_R1_IDLE : 0;
+
+	pCard->RespLen = 0;
+	pCard->RespIdx = 0;
+	pCard->CmdCnt++;
+
+	if (pCard->bAppCmd)
+	{
+		pCard->bAppCmd = false;
+		if (cmd == 41)
+		{
+			pCard->bIdle = false;
+			SimSDCardResp(pCard, 0);
+			return;
+		}
+	}
+
+	switch (cmd)
+	{
+		case 0:		// GO_IDLE_STATE
+			pCard->bIdle = true;
+			pCard->WrState = 0;
+			pCard->bRdMulti = false;
+			SimSDCardResp(pCard, SIMSDCARD_R1_IDLE);
+			break;
+		case 1:		// SEND_OP_COND
+			pCard->bIdle = false;
+			SimSDCardResp(pCard, 0);
+			break;
+		case 8:		// SEND_IF_COND, R7 echo voltage & check pattern
+			SimSDCardResp(pCard, r1);
+			SimSDCardResp(pCard, 0);
+			SimSDCardResp(pCard, 0);
+			SimSDCardResp(pCard, (arg >> 8) & 0xF);
+			SimSDCardResp(pCard, arg & 0xFF);
+			break;
+		case 9:		// SEND_CSD, version 2.0
+			{
+				uint32_t csize = pCard->NbSect / 1024 - 1;
+				uint8_t csd[16] = {
+					0x40, 0x0E, 0x00, 0x32, 0x5B, 0x59, 0x00,
+					(csize >> 16) & 0x3F, (csize >> 8) & 0xFF, csize & 0xFF,
+					0x7F, 0x80, 0x0A, 0x40, 0x00, 0x00
+				};
+
+				csd[15] = crc8_ccitt(csd, 15, 0) | 1;
+				SimSDCardResp(pCard, r1);
+				SimSDCardRespData(pCard, csd, 16);
+			}
+			break;
+		case 12:	// STOP_TRANSMISSION, R1b
+			pCard->bRdMulti = false;
+			SimSDCardResp(pCard, SIMSDCARD_STUFF_BYTE);
+			SimSDCardResp(pCard, r1);
+			SimSDCardResp(pCard, 0);
+			break;
+		case 13:	// SEND_STATUS, R2
+			SimSDCardResp(pCard, r1);
+			SimSDCardResp(pCard, 0);
+			break;
+		case 17:	// READ_SINGLE_BLOCK
+			if (arg >= pCard->NbSect)
+			{
+				SimSDCardResp(pCard, r1 | SIMSDCARD_R1_PARAM_ERR);
+				break;
+			}
+			SimSDCardResp(pCard, r1);
+			SimSDCardRespData(pCard, &pCard->pMem[arg * SIMSDCARD_SECT_SIZE], SIMSDCARD_SECT_SIZE);
+			pCard->BusyNs += pCard->RdNs;
+			break;
+		case 18:	// READ_MULTIPLE_BLOCK, next block queued as each is read
+			if (arg >= pCard->NbSect)
+			{
+				SimSDCardResp(pCard, r1 | SIMSDCARD_R1_PARAM_ERR);
+				break;
+			}
+			SimSDCardResp(pCard, r1);
+			SimSDCardRespData(pCard, &pCard->pMem[arg * SIMSDCARD_SECT_SIZE], SIMSDCARD_SECT_SIZE);
+			pCard->BusyNs += pCard->RdNs;
+			pCard->RdSect = arg + 1;
+			pCard->bRdMulti = true;
+			break;
+		case 24:	// WRITE_BLOCK
+		case 25:	// WRITE_MULTIPLE_BLOCK
+			if (arg >= pCard->NbSect)
+			{
+				SimSDCardResp(pCard, r1 | SIMSDCARD_R1_PARAM_ERR);
+				break;
+			}
+			SimSDCardResp(pCard, r1);
+			pCard->WrSect = arg;
+			pCard->WrState = 1;
+			pCard->bWrMulti = cmd == 25;
+			break;
+		case 55:	// APP_CMD
+			pCard->bAppCmd = true;
+			SimSDCardResp(pCard, r1);
+			break;
+		case 58:	// READ_OCR, powered up, CCS set
+			SimSDCardResp(pCard, r1);
+			SimSDCardResp(pCard, 0xC0);
+			SimSDCardResp(pCard, 0xFF);
+			SimSDCardResp(pCard, 0x80);
+			SimSDCardResp(pCard, 0x00);
+			break;
+		default:
+			SimSDCardResp(pCard, r1 | SIMSDCARD_R1_ILLEGAL_CMD);
+	}
+}
+
+// Chip select is toggled per byte by the driver, state is kept across
+// transactions
+static bool SimSDCardStart(SIMINTRF_MODEL *pModel, bool bRx)
+{
+	(void)pModel;
+	(void)bRx;
+
+	return true;
+}
+
+static int SimSDCardWrite(SIMINTRF_MODEL *pModel, const uint8_t *pData, int DataLen)
+{
+	SIMSDCARD *sd = (SIMSDCARD *)pModel->pModelData;
+
+	for (int i = 0; i < DataLen; i++)
+	{
+		uint8_t d = pData[i];
+
+		if (sd->WrState == 1)
+		{
+			// Wait for start block token
+			if (d == (sd->bWrMulti ? SIMSDCARD_MULTI_WR_TOKEN : SIMSDCARD_DATA_TOKEN))
+			{
+				sd->WrState = 2;
+				sd->WrIdx = 0;
+			}
+			else if (sd->bWrMulti && d == SIMSDCARD_STOP_TRAN_TOKEN)
+			{
+				sd->bWrMulti = false;
+				sd->WrState = 0;
+			}
+		}
+		else if (sd->WrState == 2)
+		{
+			sd->WrData[sd->WrIdx++] = d;
+			if (sd->WrIdx >= SIMSDCARD_SECT_SIZE + 2)
+			{
+				uint16_t crc = ((uint16_t)sd->WrData[SIMSDCARD_SECT_SIZE] << 8) |
+							   sd->WrData[SIMSDCARD_SECT_SIZE + 1];
+
+				sd->RespLen = 0;
+				sd->RespIdx = 0;
+				if (sd->WrSect == sd->WrErrSect)
+				{
+					SimSDCardResp(sd, SIMSDCARD_DATA_WR_ERR);
+				}
+				else if (crc16_ccitt(sd->WrData, SIMSDCARD_SECT_SIZE, 0) == crc)
+				{
+					memcpy(&sd->pMem[sd->WrSect * SIMSDCARD_SECT_SIZE], sd->WrData, SIMSDCARD_SECT_SIZE);
+					SimSDCardResp(sd, SIMSDCARD_DATA_ACCEPTED);
+					sd->BusyNs += sd->WrNs;
+				}
+				else
+				{
+					SimSDCardResp(sd, SIMSDCARD_DATA_CRC_ERR);
+				}
+
+				// Multiple block write continues with next sector
+				sd->WrState = 0;
+				if (sd->bWrMulti && ++sd->WrSect < sd->NbSect)
+				{
+					sd->WrState = 1;
+				}
+			}
+		}
+		else if (sd->CmdIdx > 0 || (d & 0xC0) == 0x40)
+		{
+			// Command frame, start bit 0, transmission bit 1
+			sd->Cmd[sd->CmdIdx++] = d;
+			if (sd->CmdIdx >= 6)
+			{
+				sd->CmdIdx = 0;
+				SimSDCardCmd(sd);
+			}
+		}
+	}
+
+	return DataLen;
+}
+
+static int SimSDCardRead(SIMINTRF_MODEL *pModel, uint8_t *pBuff, int BuffLen)
+{
+	SIMSDCARD *sd = (SIMSDCARD *)pModel->pModelData;
+	int l = sd->RespLen - sd->RespIdx;
+
+	if (l > BuffLen)
+		l = BuffLen;
+
+	memcpy(pBuff, &sd->Resp[sd->RespIdx], l);
+	sd->RespIdx += l;
+
+	// Bus idles high
+	memset(&pBuff[l], 0xFF, BuffLen - l);
+
+	// Block fully read, queue next one of multiple block read
+	if (sd->bRdMulti && sd->RespIdx >= sd->RespLen && sd->RdSect < sd->NbSect)
+	{
+		sd->RespLen = 0;
+		sd->RespIdx = 0;
+		SimSDCardRespData(sd, &sd->pMem[sd->RdSect * SIMSDCARD_SECT_SIZE], SIMSDCARD_SECT_SIZE);
+		sd->BusyNs += sd->RdNextNs;
+		sd->RdSect++;
+	}
+
+	return BuffLen;
+}
+
+static uint32_t SimSDCardStop(SIMINTRF_MODEL *pModel)
+{
+	SIMSDCARD *sd = (SIMSDCARD *)pModel->pModelData;
+	uint32_t t = sd->BusyNs;
+
+	sd->BusyNs = 0;
+
+	return t;
+}
+
+SIMINTRF_MODEL *SimSDCardInit(SIMSDCARD *pCard, uint8_t *pMem, uint32_t NbSect)
+{
+	memset(pCard, 0, sizeof(SIMSDCARD));
+
+	pCard->pMem = pMem;
+	pCard->NbSect = NbSect;
+	pCard->RdNs = 100000;
+	pCard->RdNextNs = 10000;
+	pCard->WrNs = 250000;
+	pCard->WrErrSect = (uint32_t)-1;
+	pCard->Model.pModelData = pCard;
+	pCard->Model.Start = SimSDCardStart;
+	pCard->Model.Write = SimSDCardWrite;
+	pCard->Model.Read = SimSDCardRead;
+	pCard->Model.Stop = SimSDCardStop;
+
+	return &pCard->Model;
+}